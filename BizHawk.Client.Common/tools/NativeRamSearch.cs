@@ -0,0 +1,157 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+using BizHawk.Emulation.Common;
+
+namespace BizHawk.Client.Common
+{
+	/// <summary>
+	/// RAM search candidate filtering in unmanaged code, for memory domains backed by a raw pointer.
+	/// Candidates are kept as a bitmap and compared 16 bytes at a time, so whole work RAMs
+	/// can be filtered every frame
+	/// </summary>
+	public sealed class NativeRamSearch : IDisposable
+	{
+		static class RamSearchDll
+		{
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr ramsearch_new(int size, int width, Flags flags);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ramsearch_start(IntPtr context, IntPtr mem);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ramsearch_snapshot(IntPtr context, IntPtr mem);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ramsearch_filter_previous(IntPtr context, IntPtr mem, RamSearchEngine.ComparisonOperator op, long diff);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ramsearch_filter_value(IntPtr context, IntPtr mem, RamSearchEngine.ComparisonOperator op, long value, long diff);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ramsearch_count(IntPtr context);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern int ramsearch_candidates(IntPtr context, int start, int[] @out, int max);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ramsearch_remove(IntPtr context, int addr);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern IntPtr ramsearch_previous(IntPtr context);
+
+			[DllImport("ramsearch.dll", CallingConvention = CallingConvention.Cdecl)]
+			public static extern void ramsearch_delete(IntPtr context);
+
+			[Flags]
+			public enum Flags : int
+			{
+				BigEndian = 1,
+				Signed = 2,
+				Misaligned = 4
+			}
+		}
+
+		private IntPtr _context;
+		private readonly MemoryDomainIntPtr _domain;
+
+		public NativeRamSearch(MemoryDomainIntPtr domain, WatchSize size, bool bigEndian, bool signed, bool checkMisaligned)
+		{
+			var flags = (bigEndian ? RamSearchDll.Flags.BigEndian : 0)
+				| (signed ? RamSearchDll.Flags.Signed : 0)
+				| (checkMisaligned ? RamSearchDll.Flags.Misaligned : 0);
+
+			_domain = domain;
+			_context = RamSearchDll.ramsearch_new((int)domain.Size, (int)size, flags);
+			if (_context == IntPtr.Zero)
+			{
+				throw new InvalidOperationException("ramsearch_new returned NULL!");
+			}
+		}
+
+		~NativeRamSearch()
+		{
+			Dispose();
+		}
+
+		public void Dispose()
+		{
+			if (_context != IntPtr.Zero)
+			{
+				RamSearchDll.ramsearch_delete(_context);
+				_context = IntPtr.Zero;
+				GC.SuppressFinalize(this);
+			}
+		}
+
+		/// <summary>
+		/// Makes every address a candidate and takes the current memory as the previous values
+		/// </summary>
+		public void Start()
+		{
+			RamSearchDll.ramsearch_start(_context, _domain.Data);
+		}
+
+		/// <summary>
+		/// Takes the current memory as the previous values, for the pages that still hold candidates
+		/// </summary>
+		public void SetPreviousToCurrent()
+		{
+			RamSearchDll.ramsearch_snapshot(_context, _domain.Data);
+		}
+
+		/// <returns>the number of candidates left</returns>
+		public int ComparePrevious(RamSearchEngine.ComparisonOperator op, int differentBy = 0)
+		{
+			return RamSearchDll.ramsearch_filter_previous(_context, _domain.Data, op, differentBy);
+		}
+
+		/// <returns>the number of candidates left</returns>
+		public int CompareSpecificValue(RamSearchEngine.ComparisonOperator op, long value, int differentBy = 0)
+		{
+			return RamSearchDll.ramsearch_filter_value(_context, _domain.Data, op, value, differentBy);
+		}
+
+		public int Count
+		{
+			get { return RamSearchDll.ramsearch_count(_context); }
+		}
+
+		/// <summary>
+		/// Candidate addresses, in ascending order
+		/// </summary>
+		public IEnumerable<long> Addresses
+		{
+			get
+			{
+				var buff = new int[4096];
+				int start = 0;
+				int n;
+				while ((n = RamSearchDll.ramsearch_candidates(_context, start, buff, buff.Length)) > 0)
+				{
+					for (int i = 0; i < n; i++)
+					{
+						yield return buff[i];
+					}
+
+					start = buff[n - 1] + 1;
+				}
+			}
+		}
+
+		public void Remove(long address)
+		{
+			RamSearchDll.ramsearch_remove(_context, (int)address);
+		}
+
+		/// <summary>
+		/// The previous values, as raw memory the size of the domain. Only valid around candidates
+		/// </summary>
+		public IntPtr Previous
+		{
+			get { return RamSearchDll.ramsearch_previous(_context); }
+		}
+	}
+}
@@ -1624,6 +1624,12 @@ namespace BizHawk.Client.EmuHawk
 
 				writer.Write(saveram, 0, saveram.Length);
 				writer.Close();
+
+				var baseline = Emulator.AsSaveRam() as ISaveRamBaseline;
+				if (baseline != null)
+				{
+					baseline.SaveRamSaved();
+				}
 			}
 		}
 
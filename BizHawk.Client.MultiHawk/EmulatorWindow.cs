@@ -405,6 +405,12 @@ namespace BizHawk.Client.MultiHawk
 
 				writer.Write(saveram, 0, saveram.Length);
 				writer.Close();
+
+				var baseline = Emulator.AsSaveRam() as ISaveRamBaseline;
+				if (baseline != null)
+				{
+					baseline.SaveRamSaved();
+				}
 			}
 		}
 	}
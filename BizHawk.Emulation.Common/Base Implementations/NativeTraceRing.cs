@@ -0,0 +1,73 @@
+﻿using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace BizHawk.Emulation.Common
+{
+	/// <summary>
+	/// One executed instruction from a native trace ring; mirrors trace_record in tracering/tracering.h.
+	/// The meaning of Registers and Flags is defined by each core
+	/// </summary>
+	[StructLayout(LayoutKind.Sequential)]
+	public unsafe struct TraceRecord
+	{
+		public ulong Cycle;
+		public uint PC;
+		public fixed byte Opcode[8];
+		public byte OpcodeLength;
+		public byte RegisterCount;
+		public ushort Flags;
+		public fixed uint Registers[10];
+	}
+
+	/// <summary>
+	/// Reads a trace_ring (tracering/tracering.h) owned by a native core.
+	/// The core writes one binary TraceRecord per instruction, and the records are drained here in bulk,
+	/// so disassembly and formatting happen on the managed side instead of in a callback per instruction
+	/// </summary>
+	public unsafe class NativeTraceRing
+	{
+		// field offsets in trace_ring
+		private const int HeadOffset = 0;
+		private const int TailOffset = 64;
+		private const int MaskOffset = 128;
+		private const int DroppedOffset = 132;
+		private const int RecordsOffset = 192;
+
+		private readonly byte* _ring;
+
+		/// <param name="ring">trace_ring pointer returned by the core</param>
+		public NativeTraceRing(IntPtr ring)
+		{
+			if (ring == IntPtr.Zero)
+			{
+				throw new ArgumentNullException(nameof(ring));
+			}
+
+			_ring = (byte*)ring;
+		}
+
+		/// <summary>
+		/// Number of records the core could not write because the ring was full
+		/// </summary>
+		public int Dropped => Thread.VolatileRead(ref *(int*)(_ring + DroppedOffset));
+
+		/// <summary>
+		/// Removes all records currently in the ring, passing each to put, oldest first
+		/// </summary>
+		public void Drain(Action<TraceRecord> put)
+		{
+			int tail = *(int*)(_ring + TailOffset);
+			int head = Thread.VolatileRead(ref *(int*)(_ring + HeadOffset));
+			uint mask = *(uint*)(_ring + MaskOffset);
+			var records = (TraceRecord*)(_ring + RecordsOffset);
+
+			for (int i = tail; i != head; i++)
+			{
+				put(records[(uint)i & mask]);
+			}
+
+			Thread.VolatileWrite(ref *(int*)(_ring + TailOffset), head);
+		}
+	}
+}
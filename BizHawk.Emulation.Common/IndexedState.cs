@@ -0,0 +1,148 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+
+namespace BizHawk.Emulation.Common
+{
+	/// <summary>
+	/// Reads an indexed binary savestate, as written by the NewStateIndexedWriter of the native cores
+	/// (see IndexedStateHeader in their newstate.h). It holds the same data as the core's plain binary
+	/// savestate, after a table with the offset, size and hash of every section and of every larger field,
+	/// so states can be compared, deduplicated or picked apart without loading them into a core
+	/// </summary>
+	public class IndexedState
+	{
+		public const int Version = 1;
+		private const int HeaderSize = 32;
+		private const int EntrySize = 80;
+		private const int NameSize = 48;
+
+		public class Entry
+		{
+			public string Name { get; internal set; }
+
+			/// <summary>
+			/// 1 is outermost; a field is one deeper than its section
+			/// </summary>
+			public int Depth { get; internal set; }
+
+			public bool IsSection { get; internal set; }
+
+			/// <summary>
+			/// offset from the start of the data
+			/// </summary>
+			public long Offset { get; internal set; }
+
+			public long Size { get; internal set; }
+
+			/// <summary>
+			/// XXH64 of the bytes the entry covers
+			/// </summary>
+			public ulong Hash { get; internal set; }
+		}
+
+		private readonly byte[] _state;
+
+		/// <exception cref="InvalidDataException">state is not an indexed savestate this can read</exception>
+		public IndexedState(byte[] state)
+		{
+			_state = state;
+			if (state.Length < HeaderSize || Encoding.ASCII.GetString(state, 0, 4) != "EWSI")
+			{
+				throw new InvalidDataException("Not an indexed savestate");
+			}
+
+			if (BitConverter.ToUInt32(state, 4) != Version || BitConverter.ToUInt32(state, 12) != EntrySize)
+			{
+				throw new InvalidDataException("Unsupported indexed savestate version");
+			}
+
+			long count = BitConverter.ToUInt32(state, 8);
+			DataOffset = HeaderSize + count * EntrySize;
+			DataSize = (long)BitConverter.ToUInt64(state, 16);
+			DataHash = BitConverter.ToUInt64(state, 24);
+			if (DataOffset > state.Length || DataSize != state.Length - DataOffset)
+			{
+				throw new InvalidDataException("Truncated indexed savestate");
+			}
+
+			var entries = new List<Entry>();
+			for (long i = 0; i < count; i++)
+			{
+				int at = (int)(HeaderSize + i * EntrySize);
+				int len = Array.IndexOf(state, (byte)0, at, NameSize) - at;
+				var e = new Entry
+				{
+					Name = Encoding.ASCII.GetString(state, at, len < 0 ? NameSize : len),
+					Depth = (int)BitConverter.ToUInt32(state, at + NameSize),
+					IsSection = BitConverter.ToUInt32(state, at + NameSize + 4) == 0,
+					Offset = (long)BitConverter.ToUInt64(state, at + NameSize + 8),
+					Size = (long)BitConverter.ToUInt64(state, at + NameSize + 16),
+					Hash = BitConverter.ToUInt64(state, at + NameSize + 24)
+				};
+				if (e.Offset + e.Size > DataSize)
+				{
+					throw new InvalidDataException("Indexed savestate entry out of range");
+				}
+
+				entries.Add(e);
+			}
+
+			Entries = entries.AsReadOnly();
+		}
+
+		/// <summary>
+		/// sections and larger fields in the order they were saved; a section comes before what it holds
+		/// </summary>
+		public IList<Entry> Entries { get; }
+
+		/// <summary>
+		/// where the plain binary savestate starts in the indexed one
+		/// </summary>
+		public long DataOffset { get; }
+
+		public long DataSize { get; }
+
+		/// <summary>
+		/// XXH64 of the data, which equals the core's native state hash
+		/// </summary>
+		public ulong DataHash { get; }
+
+		/// <summary>
+		/// the first entry with this name, or null
+		/// </summary>
+		public Entry Find(string name)
+		{
+			foreach (var e in Entries)
+			{
+				if (e.Name == name)
+				{
+					return e;
+				}
+			}
+
+			return null;
+		}
+
+		/// <summary>
+		/// a copy of the bytes an entry covers, such as a core's main RAM
+		/// </summary>
+		public byte[] GetBytes(Entry e)
+		{
+			var ret = new byte[e.Size];
+			Buffer.BlockCopy(_state, (int)(DataOffset + e.Offset), ret, 0, (int)e.Size);
+			return ret;
+		}
+
+		/// <summary>
+		/// a copy of the plain binary savestate
+		/// </summary>
+		public byte[] GetData()
+		{
+			var ret = new byte[DataSize];
+			Buffer.BlockCopy(_state, (int)DataOffset, ret, 0, (int)DataSize);
+			return ret;
+		}
+	}
+}
@@ -23,4 +23,17 @@
 		/// </summary>
 		bool SaveRamModified { get; }
 	}
+
+	/// <summary>
+	/// Implemented alongside ISaveRam by cores that work out SaveRamModified themselves, by comparing a write count
+	/// in the core against the count at the last load or save
+	/// </summary>
+	public interface ISaveRamBaseline
+	{
+		/// <summary>
+		/// Called by the client once the data from CloneSaveRam() has been written out, so that SaveRamModified
+		/// reads false again until the next write
+		/// </summary>
+		void SaveRamSaved();
+	}
 }
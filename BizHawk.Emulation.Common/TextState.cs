@@ -136,4 +136,10 @@ namespace BizHawk.Emulation.Common
 		public SectionFunction EnterSection;
 		public SectionFunction ExitSection;
 	}
+
+	/// <summary>
+	/// receives the hash of one savestate section from a core's native state hash; depth 1 is outermost
+	/// </summary>
+	[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+	public delegate void StateHashSectionCallback(string name, int depth, ulong hash);
 }
@@ -19,12 +19,27 @@ namespace BizHawk.Emulation.Cores.Atari.Lynx
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void Destroy(IntPtr s);
 
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern IntPtr Clone(IntPtr s);
+
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool CopyInto(IntPtr dst, IntPtr src);
+
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void Reset(IntPtr s);
 
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool Advance(IntPtr s, Buttons buttons, int[] vbuff, short[] sbuff, ref int sbuffsize);
 
+		/// <summary>
+		/// run many frames in one call.  dest gets one record per frame: uint flags (1 = lag, 2 = sound didn't fit),
+		/// uint hash of RAM, then the sampled bytes, padded to 4.  vbuff only receives the last frame.
+		/// </summary>
+		/// <returns>number of frames run, or -1 on bad ram ranges or a short dest</returns>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern int AdvanceBatch(IntPtr s, int[] buttons, int nframes, BatchFlags flags, BatchRam[] ram, int nram,
+			byte[] dest, int destsize, int[] vbuff, short[] sbuff, ref int sbuffsize);
+
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void SetRotation(IntPtr s, int value);
 
@@ -41,6 +56,22 @@ namespace BizHawk.Emulation.Cores.Atari.Lynx
 		public static extern bool BinStateSave(IntPtr s, byte[] data, int length);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool BinStateLoad(IntPtr s, byte[] data, int length);
+		/// <summary>
+		/// hash the savestate without saving it. equal to XXH64 of what BinStateSave writes
+		/// </summary>
+		/// <param name="cb">if not null, also receives the hash of every section</param>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern ulong StateHash(IntPtr s, StateHashSectionCallback cb);
+		/// <summary>
+		/// a savestate with a table of its sections and larger fields in front; see IndexedState
+		/// </summary>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern int IndexedStateSize(IntPtr s);
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool IndexedStateSave(IntPtr s, byte[] data, int length);
+		/// <param name="skip">fields to leave as they are, or null</param>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool IndexedStateLoad(IntPtr s, byte[] data, int length, string[] skip, int skipcount);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void TxtStateSave(IntPtr s, [In]ref TextStateFPtrs ff);
 		[DllImport(dllname, CallingConvention = cc)]
@@ -49,6 +80,24 @@ namespace BizHawk.Emulation.Cores.Atari.Lynx
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern IntPtr GetRamPointer(IntPtr s);
 
+		[Flags]
+		public enum BatchFlags : int
+		{
+			None = 0,
+			NoVideo = 1,
+			NoAudio = 2,
+			NoHash = 4
+		}
+
+		[StructLayout(LayoutKind.Sequential)]
+		public struct BatchRam
+		{
+			/// <summary>0 = RAM, 1 = save RAM, 2 = cart bank 0, 3 = cart bank 1</summary>
+			public int area;
+			public int addr;
+			public int size;
+		}
+
 		[Flags]
 		public enum Buttons : ushort
 		{
@@ -8,58 +8,72 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 	/// </summary>
 	public static class LibMeteor
 	{
+		/// <summary>
+		/// create a new emulation core.  any number of them can exist at once, and separate cores can run on separate threads
+		/// </summary>
+		/// <returns>instance to pass to all other calls</returns>
+		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr libmeteor_create();
+
+		/// <summary>
+		/// destroy a core returned by libmeteor_create()
+		/// </summary>
+		/// <param name="core"></param>
+		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern void libmeteor_destroy(IntPtr core);
+
 		/// <summary>
 		/// power cycle the emulation core
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_hardreset();
+		public static extern void libmeteor_hardreset(IntPtr core);
 
 		/// <summary>
 		/// signal that you are removing data from the sound buffer.
 		/// the next time frameadvance() is called, writing will start from the beginning
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <returns>the valid length of the buffer, in bytes</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern uint libmeteor_emptysound();
+		public static extern uint libmeteor_emptysound(IntPtr core);
 
 		/// <summary>
 		/// set up buffers for libmeteor to dump data to.  these must be valid before every frameadvance
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="vid">buffer to hold video data as BGRA32</param>
 		/// <param name="vidlen">length in bytes.  must be at least 240 * 160 * 4</param>
 		/// <param name="aud">buffer to hold audio data as stereo s16le</param>
 		/// <param name="audlen">length in bytes.  must be 0 mod 4 (hold a full stereo sample set)</param>
 		/// <returns>false if some problem.  buffers will not be valid in this case</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_setbuffers(IntPtr vid, uint vidlen, IntPtr aud, uint audlen);
-
-		/// <summary>
-		/// initialize the library
-		/// </summary>
-		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_init();
+		public static extern bool libmeteor_setbuffers(IntPtr core, IntPtr vid, uint vidlen, IntPtr aud, uint audlen);
 
 		/// <summary>
 		/// run emulation for one frame, updating sound and video along the way
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_frameadvance();
+		public static extern void libmeteor_frameadvance(IntPtr core);
 
 		/// <summary>
 		/// load a rom image
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data">raw rom data. need not persist past this call</param>
 		/// <param name="datalen">length of data in bytes</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_loadrom(byte[] data, uint datalen);
+		public static extern void libmeteor_loadrom(IntPtr core, byte[] data, uint datalen);
 
 		/// <summary>
 		/// load a bios image
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data">raw bios data. need not persist past this call</param>
 		/// <param name="datalen">length of data in bytes</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_loadbios(byte[] data, uint datalen);
+		public static extern void libmeteor_loadbios(IntPtr core, byte[] data, uint datalen);
 
 		/// <summary>
 		/// core callback to print meaningful (or meaningless) log messages
@@ -72,9 +86,10 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// set callback for log messages.  this can (and should) be called first
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="cb"></param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_setmessagecallback(MessageCallback cb);
+		public static extern void libmeteor_setmessagecallback(IntPtr core, MessageCallback cb);
 
 		/// <summary>
 		/// combination of button flags used by the key callback
@@ -104,9 +119,10 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// set callback for whenever input is requested
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="callback"></param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_setkeycallback(InputCallback callback);
+		public static extern void libmeteor_setkeycallback(IntPtr core, InputCallback callback);
 
 		/// <summary>
 		/// parameter to libmeteor_getmemoryarea
@@ -150,10 +166,11 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// return a pointer to a memory area
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="which"></param>
 		/// <returns>IntPtr.Zero if which is unrecognized</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern IntPtr libmeteor_getmemoryarea(MemoryArea which);
+		public static extern IntPtr libmeteor_getmemoryarea(IntPtr core, MemoryArea which);
 
 		/// <summary>
 		/// core callback for tracelogging
@@ -165,56 +182,74 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// set callback to run before each instruction is executed
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="callback">null to clear</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_settracecallback(TraceCallback callback);
+		public static extern void libmeteor_settracecallback(IntPtr core, TraceCallback callback);
 
 		/// <summary>
 		/// load saveram from a byte buffer
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data"></param>
 		/// <param name="size"></param>
 		/// <returns>success</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_loadsaveram(byte[] data, uint size);
+		public static extern bool libmeteor_loadsaveram(IntPtr core, byte[] data, uint size);
 
 		/// <summary>
 		/// save saveram to a byte buffer
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data">buffer generated by core.  copy from, but do not modify</param>
 		/// <param name="size">length of buffer</param>
 		/// <returns>success</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_savesaveram(ref IntPtr data, ref uint size);
+		public static extern bool libmeteor_savesaveram(IntPtr core, ref IntPtr data, ref uint size);
 
 		/// <summary>
 		/// destroy a buffer previously returned by libmeteor_savesaveram() to avoid leakage
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data"></param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_savesaveram_destroy(IntPtr data);
+		public static extern void libmeteor_savesaveram_destroy(IntPtr core, IntPtr data);
+
+		/// <summary>
+		/// get saveram in place, as libmeteor_savesaveram() would copy it, without allocating
+		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
+		/// <param name="data">valid until the next call into the core</param>
+		/// <param name="size"></param>
+		/// <param name="generation">changes whenever saveram may have been written</param>
+		/// <returns>false if there is no saveram</returns>
+		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern bool libmeteor_saveramdirect(IntPtr core, ref IntPtr data, ref uint size, ref uint generation);
 
 		/// <summary>
 		/// return true if there is saveram installed on currently loaded cart
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <returns></returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_hassaveram();
+		public static extern bool libmeteor_hassaveram(IntPtr core);
 
 		/// <summary>
 		/// resets the current cart's saveram
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_clearsaveram();
+		public static extern void libmeteor_clearsaveram(IntPtr core);
 
 		/// <summary>
 		/// serialize state
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data">buffer generated by core</param>
 		/// <param name="size">size of buffer</param>
 		/// <returns>success</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_savestate(ref IntPtr data, ref uint size);
+		public static extern bool libmeteor_savestate(IntPtr core, ref IntPtr data, ref uint size);
 
 		/// <summary>
 		/// destroy a buffer previously returned by libmeteor_savestate() to avoid leakage
@@ -226,27 +261,30 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// unserialize state
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="data"></param>
 		/// <param name="size"></param>
 		/// <returns>success</returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern bool libmeteor_loadstate(byte[] data, uint size);
+		public static extern bool libmeteor_loadstate(IntPtr core, byte[] data, uint size);
 
 		/// <summary>
 		/// read a byte off the system bus.  guaranteed to have no side effects
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="addr"></param>
 		/// <returns></returns>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern byte libmeteor_peekbus(uint addr);
+		public static extern byte libmeteor_peekbus(IntPtr core, uint addr);
 
 		/// <summary>
 		/// write a byte to the system bus.
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="addr"></param>
 		/// <param name="val"></param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_writebus(uint addr, byte val);
+		public static extern void libmeteor_writebus(IntPtr core, uint addr, byte val);
 
 		/// <summary>
 		/// type of the scanline callback
@@ -257,17 +295,19 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		/// <summary>
 		/// set a callback to coincide with vcount interrupts
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="callback">null to clear</param>
 		/// <param name="scanline">0-227, 160 occurring first in a frame</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_setscanlinecallback(ScanlineCallback callback, int scanline);
+		public static extern void libmeteor_setscanlinecallback(IntPtr core, ScanlineCallback callback, int scanline);
 
 		/// <summary>
 		/// get current cpu regs
 		/// </summary>
+		/// <param name="core">instance from libmeteor_create()</param>
 		/// <param name="dest">length 18 please</param>
 		[DllImport("libmeteor.dll", CallingConvention = CallingConvention.Cdecl)]
-		public static extern void libmeteor_getregs(int[] dest);
+		public static extern void libmeteor_getregs(IntPtr core, int[] dest);
 
 		public static readonly string[] regnames = new string[]
 		{
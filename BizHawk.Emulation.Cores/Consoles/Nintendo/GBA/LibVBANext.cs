@@ -74,6 +74,23 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void Destroy(IntPtr g);
 
+		/// <summary>
+		/// create a new context sharing g's rom, starting from its current state.  callbacks are not copied
+		/// </summary>
+		/// <param name="g"></param>
+		/// <returns></returns>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern IntPtr Clone(IntPtr g);
+
+		/// <summary>
+		/// copy the emulation state of src into dst, which must have the same rom loaded
+		/// </summary>
+		/// <param name="dst"></param>
+		/// <param name="src"></param>
+		/// <returns>false if the two contexts don't match</returns>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool CopyInto(IntPtr dst, IntPtr src);
+
 		/// <summary>
 		/// load a rom
 		/// </summary>
@@ -106,12 +123,48 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool FrameAdvance(IntPtr g, Buttons input, int[] videobuffer, short[] audiobuffer, out int numsamp, int[] videopalette);
 
+		/// <summary>
+		/// run many frames in one call
+		/// </summary>
+		/// <param name="g"></param>
+		/// <param name="input">input for each frame</param>
+		/// <param name="nframes">number of frames to run</param>
+		/// <param name="flags"></param>
+		/// <param name="ram">memory ranges to sample after each frame</param>
+		/// <param name="nram">length of ram</param>
+		/// <param name="dest">one record per frame: uint flags (1 = lag, 2 = sound didn't fit), uint hash of iwram and ewram, then the sampled bytes, padded to 4</param>
+		/// <param name="destsize">length of dest</param>
+		/// <param name="videobuffer">receives the last frame, unless BatchFlags.NoVideo</param>
+		/// <param name="videopalette"></param>
+		/// <param name="audiobuffer">stereo audio for all frames, or null</param>
+		/// <param name="numsamp">[In] capacity of audiobuffer [Out] number of samples created</param>
+		/// <returns>number of frames run, or -1 on bad ram ranges or a short dest</returns>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern int AdvanceBatch(IntPtr g, Buttons[] input, int nframes, BatchFlags flags, BatchRam[] ram, int nram, byte[] dest, int destsize,
+			int[] videobuffer, int[] videopalette, short[] audiobuffer, ref int numsamp);
+
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern int BinStateSize(IntPtr g);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool BinStateSave(IntPtr g, byte[] data, int length);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool BinStateLoad(IntPtr g, byte[] data, int length);
+		/// <summary>
+		/// hash the savestate without saving it. equal to XXH64 of what BinStateSave writes
+		/// </summary>
+		/// <param name="cb">if not null, also receives the hash of every section</param>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern ulong StateHash(IntPtr g, StateHashSectionCallback cb);
+		/// <summary>
+		/// a savestate with a table of its sections and larger fields in front; see IndexedState
+		/// </summary>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern int IndexedStateSize(IntPtr g);
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool IndexedStateSave(IntPtr g, byte[] data, int length);
+		/// <param name="skip">fields to leave as they are, or null</param>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern bool IndexedStateLoad(IntPtr g, byte[] data, int length, string[] skip, int skipcount);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void TxtStateSave(IntPtr g, [In]ref TextStateFPtrs ff);
 		[DllImport(dllname, CallingConvention = cc)]
@@ -123,6 +176,11 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		public static extern bool SaveRamSave(IntPtr g, byte[] data, int length);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern bool SaveRamLoad(IntPtr g, byte[] data, int length);
+		/// <summary>
+		/// saveram in place, as SaveRamSave() would copy it; generation changes whenever it may have been written
+		/// </summary>
+		[DllImport(dllname, CallingConvention = cc)]
+		public static extern IntPtr SaveRamDirect(IntPtr g, out int length, out uint generation);
 		[DllImport(dllname, CallingConvention = cc)]
 		public static extern void GetMemoryAreas(IntPtr g, [Out]MemoryAreas mem);
 
@@ -163,6 +221,24 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		public static extern void SetTraceCallback(IntPtr g, TraceCallback cb);
 
 
+		[Flags]
+		public enum BatchFlags : int
+		{
+			None = 0,
+			NoVideo = 1,
+			NoAudio = 2,
+			NoHash = 4
+		}
+
+		[StructLayout(LayoutKind.Sequential)]
+		public struct BatchRam
+		{
+			/// <summary>0 iwram, 1 ewram, 2 bios, 3 palram, 4 vram, 5 oam, 6 rom, 7 sram, 8 mmio</summary>
+			public int area;
+			public int addr;
+			public int size;
+		}
+
 		[StructLayout(LayoutKind.Sequential)]
 		public class MemoryAreas
 		{
@@ -10,10 +10,10 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 	{
 		public GBAGPUMemoryAreas GetMemoryAreas()
 		{
-			IntPtr _vram = LibMeteor.libmeteor_getmemoryarea(LibMeteor.MemoryArea.vram);
-			IntPtr _palram = LibMeteor.libmeteor_getmemoryarea(LibMeteor.MemoryArea.palram);
-			IntPtr _oam = LibMeteor.libmeteor_getmemoryarea(LibMeteor.MemoryArea.oam);
-			IntPtr _mmio = LibMeteor.libmeteor_getmemoryarea(LibMeteor.MemoryArea.io);
+			IntPtr _vram = LibMeteor.libmeteor_getmemoryarea(core, LibMeteor.MemoryArea.vram);
+			IntPtr _palram = LibMeteor.libmeteor_getmemoryarea(core, LibMeteor.MemoryArea.palram);
+			IntPtr _oam = LibMeteor.libmeteor_getmemoryarea(core, LibMeteor.MemoryArea.oam);
+			IntPtr _mmio = LibMeteor.libmeteor_getmemoryarea(core, LibMeteor.MemoryArea.io);
 
 			if (_vram == IntPtr.Zero || _palram == IntPtr.Zero || _oam == IntPtr.Zero || _mmio == IntPtr.Zero)
 				throw new Exception("libmeteor_getmemoryarea() failed!");
@@ -37,12 +37,12 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			if (callback == null)
 			{
 				scanlinecb = null;
-				LibMeteor.libmeteor_setscanlinecallback(null, 0);
+				LibMeteor.libmeteor_setscanlinecallback(core, null, 0);
 			}
 			else
 			{
 				scanlinecb = new LibMeteor.ScanlineCallback(callback);
-				LibMeteor.libmeteor_setscanlinecallback(scanlinecb, scanline);
+				LibMeteor.libmeteor_setscanlinecallback(core, scanlinecb, scanline);
 			}
 		}
 
@@ -11,13 +11,13 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		private List<MemoryDomain> _domainList = new List<MemoryDomain>();
 		private IMemoryDomains _memoryDomains;
 
-		private void AddMemoryDomain(LibMeteor.MemoryArea which, int size, string name)
+		private void AddMemoryDomain(LibMeteor.MemoryArea which, int size, string name, bool writable = true)
 		{
-			IntPtr data = LibMeteor.libmeteor_getmemoryarea(which);
+			IntPtr data = LibMeteor.libmeteor_getmemoryarea(core, which);
 			if (data == IntPtr.Zero)
 				throw new Exception("libmeteor_getmemoryarea() returned NULL??");
 
-			MemoryDomain md = MemoryDomain.FromIntPtr(name, size, MemoryDomain.Endian.Little, data);
+			MemoryDomain md = MemoryDomain.FromIntPtr(name, size, MemoryDomain.Endian.Little, data, writable);
 			_domainList.Add(md);
 		}
 
@@ -33,7 +33,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			AddMemoryDomain(LibMeteor.MemoryArea.vram, 96 * 1024, "VRAM");
 			AddMemoryDomain(LibMeteor.MemoryArea.oam, 1024, "OAM");
 			// even if the rom is less than 32MB, the whole is still valid in meteor
-			AddMemoryDomain(LibMeteor.MemoryArea.rom, 32 * 1024 * 1024, "ROM");
+			AddMemoryDomain(LibMeteor.MemoryArea.rom, 32 * 1024 * 1024, "ROM", false);
 			// special domain for system bus
 			{
 				MemoryDomain sb = new MemoryDomainDelegate("System Bus", 1 << 28, MemoryDomain.Endian.Little,
@@ -41,13 +41,13 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 					{
 						if (addr < 0 || addr >= 0x10000000)
 							throw new IndexOutOfRangeException();
-						return LibMeteor.libmeteor_peekbus((uint)addr);
+						return LibMeteor.libmeteor_peekbus(core, (uint)addr);
 					},
 					delegate(long addr, byte val)
 					{
 						if (addr < 0 || addr >= 0x10000000)
 							throw new IndexOutOfRangeException();
-						LibMeteor.libmeteor_writebus((uint)addr, val);
+						LibMeteor.libmeteor_writebus(core, (uint)addr, val);
 					}, 4);
 				_domainList.Add(sb);
 			}
@@ -11,7 +11,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			{
 				if (disposed)
 					throw new ObjectDisposedException(this.GetType().ToString());
-				return LibMeteor.libmeteor_hassaveram();
+				return LibMeteor.libmeteor_hassaveram(core);
 			}
 		}
 
@@ -21,15 +21,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 #if false
 			if (disposed)
 				throw new ObjectDisposedException(this.GetType().ToString());
-			if (!LibMeteor.libmeteor_hassaveram())
+			if (!LibMeteor.libmeteor_hassaveram(core))
 				return null;
 			IntPtr data = IntPtr.Zero;
 			uint size = 0;
-			if (!LibMeteor.libmeteor_savesaveram(ref data, ref size))
+			if (!LibMeteor.libmeteor_savesaveram(core, ref data, ref size))
 				throw new Exception("libmeteor_savesaveram() returned false!");
 			byte[] ret = new byte[size];
 			Marshal.Copy(data, ret, 0, (int)size);
-			LibMeteor.libmeteor_savesaveram_destroy(data);
+			LibMeteor.libmeteor_savesaveram_destroy(core, data);
 			return ret;
 #endif
 		}
@@ -40,7 +40,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 #if false
 			if (disposed)
 				throw new ObjectDisposedException(this.GetType().ToString());
-			if (!LibMeteor.libmeteor_loadsaveram(data, (uint)data.Length))
+			if (!LibMeteor.libmeteor_loadsaveram(core, data, (uint)data.Length))
 				throw new Exception("libmeteor_loadsaveram() returned false!");
 #endif
 		}
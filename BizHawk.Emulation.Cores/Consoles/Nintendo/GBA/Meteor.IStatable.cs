@@ -63,7 +63,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		{
 			IntPtr ndata = IntPtr.Zero;
 			uint nsize = 0;
-			if (!LibMeteor.libmeteor_savestate(ref ndata, ref nsize))
+			if (!LibMeteor.libmeteor_savestate(core, ref ndata, ref nsize))
 				throw new Exception("libmeteor_savestate() failed!");
 			if (ndata == IntPtr.Zero || nsize == 0)
 				throw new Exception("libmeteor_savestate() returned bad!");
@@ -76,7 +76,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 
 		private void LoadCoreBinary(byte[] data)
 		{
-			if (!LibMeteor.libmeteor_loadstate(data, (uint)data.Length))
+			if (!LibMeteor.libmeteor_loadstate(core, data, (uint)data.Length))
 				throw new Exception("libmeteor_loadstate() failed!");
 		}
 	}
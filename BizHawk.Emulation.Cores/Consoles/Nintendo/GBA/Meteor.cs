@@ -12,8 +12,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		"Meteor",
 		"blastrock",
 		isPorted: true,
-		isReleased: false,
-		singleInstance: true
+		isReleased: false
 		)]
 	[ServiceNotApplicable(typeof(IDriveLight), typeof(IRegionable))]
 	public partial class GBA : IEmulator, IVideoProvider, ISoundProvider, IGBAGPUViewable, ISaveRam, IStatable, IInputPollable
@@ -43,9 +42,9 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			if (file.Length > 32 * 1024 * 1024)
 				throw new InvalidDataException("Rom file is too big!  No GBA game is larger than 32MB");
 			Init();
-			LibMeteor.libmeteor_hardreset();
-			LibMeteor.libmeteor_loadbios(bios, (uint)bios.Length);
-			LibMeteor.libmeteor_loadrom(file, (uint)file.Length);
+			LibMeteor.libmeteor_hardreset(core);
+			LibMeteor.libmeteor_loadbios(core, bios, (uint)bios.Length);
+			LibMeteor.libmeteor_loadrom(core, file, (uint)file.Length);
 
 			SetUpMemoryDomains();
 		}
@@ -56,7 +55,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 		{
 			var ret = new Dictionary<string, RegisterValue>();
 			int[] data = new int[LibMeteor.regnames.Length];
-			LibMeteor.libmeteor_getregs(data);
+			LibMeteor.libmeteor_getregs(core, data);
 			for (int i = 0; i < data.Length; i++)
 				ret.Add(LibMeteor.regnames[i], data[i]);
 			return ret;
@@ -91,11 +90,11 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			IsLagFrame = true;
 
 			if (Controller.IsPressed("Power"))
-				LibMeteor.libmeteor_hardreset();
+				LibMeteor.libmeteor_hardreset(core);
 			// due to the design of the tracing api, we have to poll whether it's active each frame
-			LibMeteor.libmeteor_settracecallback(Tracer.Enabled ? tracecallback : null);
+			LibMeteor.libmeteor_settracecallback(core, Tracer.Enabled ? tracecallback : null);
 			if (!coredead)
-				LibMeteor.libmeteor_frameadvance();
+				LibMeteor.libmeteor_frameadvance(core);
 			if (IsLagFrame)
 				LagCount++;
 		}
@@ -126,8 +125,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 
 		public CoreComm CoreComm { get; private set; }
 
-		/// <summary>like libsnes, the library is single-instance</summary>
-		static GBA attachedcore;
+		/// <summary>native core instance</summary>
+		IntPtr core;
 		/// <summary>hold pointer to message callback so it won't get GCed</summary>
 		LibMeteor.MessageCallback messagecallback;
 		/// <summary>hold pointer to input callback so it won't get GCed</summary>
@@ -243,18 +242,16 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 
 		private void Init()
 		{
-			if (attachedcore != null)
-				attachedcore.Dispose();
+			core = LibMeteor.libmeteor_create();
 
 			messagecallback = PrintMessage;
 			inputcallback = GetInput;
 
 			// Tracer refactor TODO - rehook up meteor, if it is worth it
 			//tracecallback = Trace; // don't set this callback now, only set if enabled
-			LibMeteor.libmeteor_setmessagecallback(messagecallback);
-			LibMeteor.libmeteor_setkeycallback(inputcallback);
+			LibMeteor.libmeteor_setmessagecallback(core, messagecallback);
+			LibMeteor.libmeteor_setkeycallback(core, inputcallback);
 
-			LibMeteor.libmeteor_init();
 			videobuffer = new int[240 * 160];
 			videohandle = GCHandle.Alloc(videobuffer, GCHandleType.Pinned);
 			soundbuffer = new short[2048]; // nominal length of one frame is something like 1480 shorts?
@@ -264,8 +261,6 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 				(videohandle.AddrOfPinnedObject(), (uint)(sizeof(int) * videobuffer.Length),
 				soundhandle.AddrOfPinnedObject(), (uint)(sizeof(short) * soundbuffer.Length)))
 				throw new Exception("libmeteor_setbuffers() returned false??");
-
-			attachedcore = this;
 		}
 
 		private bool disposed = false;
@@ -274,16 +269,13 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			if (!disposed)
 			{
 				disposed = true;
+				LibMeteor.libmeteor_destroy(core);
+				core = IntPtr.Zero;
 				videohandle.Free();
 				soundhandle.Free();
-				// guarantee crash if it gets accessed
-				LibMeteor.libmeteor_setbuffers(IntPtr.Zero, 240 * 160 * 4, IntPtr.Zero, 4);
 				messagecallback = null;
 				inputcallback = null;
 				tracecallback = null;
-				LibMeteor.libmeteor_setmessagecallback(messagecallback);
-				LibMeteor.libmeteor_setkeycallback(inputcallback);
-				LibMeteor.libmeteor_settracecallback(tracecallback);
 				_domainList.Clear();
 			}
 		}
@@ -295,7 +287,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 
 		public void GetSamplesSync(out short[] samples, out int nsamp)
 		{
-			uint nbytes = LibMeteor.libmeteor_emptysound();
+			uint nbytes = LibMeteor.libmeteor_emptysound(core);
 			samples = soundbuffer;
 			if (!coredead)
 				nsamp = (int)(nbytes / 4);
@@ -305,7 +297,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 
 		public void DiscardSamples()
 		{
-			LibMeteor.libmeteor_emptysound();
+			LibMeteor.libmeteor_emptysound(core);
 		}
 
 		public bool CanProvideAsync
@@ -1,29 +1,50 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Runtime.InteropServices;
 
 using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.GBA
 {
-	public partial class VBANext : ISaveRam
+	public partial class VBANext : ISaveRam, ISaveRamBaseline
 	{
+		// generation of the saveram as it was loaded or last saved
+		private uint saveRamGeneration;
+
+		private uint SaveRamGeneration()
+		{
+			int length;
+			uint generation;
+			LibVBANext.SaveRamDirect(Core, out length, out generation);
+			return generation;
+		}
+
+		private void InitSaveRam()
+		{
+			saveRamGeneration = SaveRamGeneration();
+		}
+
 		public bool SaveRamModified
 		{
 			get
 			{
-				return LibVBANext.SaveRamSize(Core) != 0;
+				return LibVBANext.SaveRamSize(Core) != 0 && SaveRamGeneration() != saveRamGeneration;
 			}
 		}
 
 		public byte[] CloneSaveRam()
 		{
-			var data = new byte[LibVBANext.SaveRamSize(Core)];
-			if (!LibVBANext.SaveRamSave(Core, data, data.Length))
+			int length;
+			uint generation;
+			var src = LibVBANext.SaveRamDirect(Core, out length, out generation);
+			if (src == IntPtr.Zero || length == 0)
 			{
-				throw new InvalidOperationException("SaveRamSave() failed!");
+				throw new InvalidOperationException("SaveRamDirect() failed!");
 			}
 
+			var data = new byte[length];
+			Marshal.Copy(src, data, 0, length);
 			return data;
 		}
 
@@ -34,6 +55,13 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 			{
 				throw new InvalidOperationException("SaveRamLoad() failed!");
 			}
+
+			InitSaveRam();
+		}
+
+		public void SaveRamSaved()
+		{
+			InitSaveRam();
 		}
 	}
 }
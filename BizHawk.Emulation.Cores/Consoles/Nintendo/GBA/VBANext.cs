@@ -81,6 +81,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.GBA
 				savebuff = new byte[LibVBANext.BinStateSize(Core)];
 				savebuff2 = new byte[savebuff.Length + 13];
 				InitMemoryDomains();
+				InitSaveRam();
 				InitRegisters();
 				InitCallbacks();
 
@@ -3,8 +3,16 @@ using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 {
-	public partial class Gameboy : ISaveRam
+	public partial class Gameboy : ISaveRam, ISaveRamBaseline
 	{
+		// generation of the savedata as it was loaded or last saved; also arms the core's write watch
+		private uint saveRamGeneration;
+
+		private void InitSaveRam()
+		{
+			saveRamGeneration = LibGambatte.gambatte_saveramgeneration(GambatteState);
+		}
+
 		public bool SaveRamModified
 		{
 			get
@@ -12,7 +20,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 				if (LibGambatte.gambatte_savesavedatalength(GambatteState) == 0)
 					return false;
 				else
-					return true; // need to wire more stuff into the core to actually know this
+					return LibGambatte.gambatte_saveramgeneration(GambatteState) != saveRamGeneration;
 			}
 		}
 
@@ -47,6 +55,12 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 					break;
 			}
 			LibGambatte.gambatte_loadsavedata(GambatteState, data);
+			InitSaveRam();
+		}
+
+		public void SaveRamSaved()
+		{
+			InitSaveRam();
 		}
 
 		private byte[] FixRTC(byte[] data, int offset)
@@ -8,37 +8,65 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 	public partial class Gameboy
 	{
 		private ITraceable Tracer { get; set; }
-		private LibGambatte.TraceCallback tracecb;
+		private LibGambatte.TraceRingFullCallback traceringfullcb;
+		private NativeTraceRing tracering;
 
-		private void MakeTrace(IntPtr _s)
+		// the core writes binary records into a native ring, which is only drained
+		// here when it fills up and at the end of each frame
+		private void UpdateTraceRing()
 		{
-			int[] s = new int[14];
-			System.Runtime.InteropServices.Marshal.Copy(_s, s, 0, 14);
+			if (Tracer.Enabled && tracering == null)
+			{
+				traceringfullcb = DrainTrace;
+				tracering = new NativeTraceRing(LibGambatte.gambatte_settracering(GambatteState, 65536, traceringfullcb));
+			}
+			else if (!Tracer.Enabled && tracering != null)
+			{
+				LibGambatte.gambatte_settracering(GambatteState, 0, null);
+				tracering = null;
+				traceringfullcb = null;
+			}
+		}
+
+		private void DrainTrace()
+		{
+			if (tracering != null)
+			{
+				tracering.Drain(MakeTrace);
+			}
+		}
+
+		private readonly byte[] traceopcode = new byte[3];
+
+		private unsafe void MakeTrace(TraceRecord r)
+		{
+			for (int i = 0; i < 3; i++)
+				traceopcode[i] = r.Opcode[i];
+			ushort pc = (ushort)r.PC;
 			ushort unused;
 
 			Tracer.Put(new TraceInfo
 			{
+				// disassemble from the bytes as fetched, since memory may have changed since
 				Disassembly =
 					NewDisassembler
-						.Disassemble((ushort)s[1], (addr) => LibGambatte.gambatte_cpuread(GambatteState, addr), out unused)
+						.Disassemble(pc, (addr) => traceopcode[(ushort)(addr - pc) % 3], out unused)
 						.PadRight(36),
 				RegisterInfo =
 					string.Format(
-					"A:{3:x2} B:{4:x2} C:{5:x2} D:{6:x2} E:{7:x2} F:{8:x2} H:{9:x2} L:{10:x2} LY:{13:x2} SP:{2:x2} {11} Cy:{0}",
-					s[0],
-					s[1] & 0xffff,
-					s[2] & 0xffff,
-					s[3] & 0xff,
-					s[4] & 0xff,
-					s[5] & 0xff,
-					s[6] & 0xff,
-					s[7] & 0xff,
-					s[8] & 0xff,
-					s[9] & 0xff,
-					s[10] & 0xff,
-					s[11] != 0 ? "skip" : "",
-					s[12] & 0xff,
-					s[13] & 0xff
+					"A:{1:x2} B:{2:x2} C:{3:x2} D:{4:x2} E:{5:x2} F:{6:x2} H:{7:x2} L:{8:x2} LY:{9:x2} SP:{0:x2} {10} Cy:{11}",
+					r.Registers[0] & 0xffff,
+					r.Registers[1] & 0xff,
+					r.Registers[2] & 0xff,
+					r.Registers[3] & 0xff,
+					r.Registers[4] & 0xff,
+					r.Registers[5] & 0xff,
+					r.Registers[6] & 0xff,
+					r.Registers[7] & 0xff,
+					r.Registers[8] & 0xff,
+					r.Registers[9] & 0xff,
+					r.Flags != 0 ? "skip" : "",
+					(int)r.Cycle
 				)
 			});
 		}
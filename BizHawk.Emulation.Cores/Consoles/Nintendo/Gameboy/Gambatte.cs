@@ -154,6 +154,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 				LibGambatte.gambatte_setinputgetter(GambatteState, InputCallback);
 
 				InitMemoryDomains();
+				InitSaveRam();
 
 				CoreComm.RomStatusDetails = string.Format("{0}\r\nSHA1:{1}\r\nMD5:{2}\r\n",
 					game.Name,
@@ -290,17 +291,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 			if (Controller.IsPressed("Power"))
 				LibGambatte.gambatte_reset(GambatteState, GetCurrentTime());
 
-			if (Tracer.Enabled)
-				tracecb = MakeTrace;
-			else
-				tracecb = null;
-			LibGambatte.gambatte_settracecallback(GambatteState, tracecb);
+			UpdateTraceRing();
 
 			LibGambatte.gambatte_setlayers(GambatteState, (_settings.DisplayBG ? 1 : 0) | (_settings.DisplayOBJ ? 2 : 0) | (_settings.DisplayWindow ? 4 : 0 ) );
 		}
 
 		internal void FrameAdvancePost()
 		{
+			DrainTrace();
+
 			if (IsLagFrame)
 				LagCount++;
 
@@ -311,6 +310,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		public void FrameAdvance(bool render, bool rendersound)
 		{
 			FrameAdvancePrep();
+			LibGambatte.gambatte_setvideoenabled(GambatteState, render);
 			if (_syncSettings.EqualLengthFrames)
 			{
 				while (true)
@@ -318,7 +318,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 					// target number of samples to emit: length of 1 frame minus whatever overflow
 					uint samplesEmitted = TICKSINFRAME - frameOverflow;
 					System.Diagnostics.Debug.Assert(samplesEmitted * 2 <= soundbuff.Length);
-					if (LibGambatte.gambatte_runfor(GambatteState, soundbuff, ref samplesEmitted) > 0)
+					if (LibGambatte.gambatte_runfor(GambatteState, soundbuff, ref samplesEmitted) > 0 && render)
 						LibGambatte.gambatte_blitto(GambatteState, VideoBuffer, 160);
 
 					// account for actual number of samples emitted
@@ -343,7 +343,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 				// runfor() always ends after creating a video frame, so sync-up is guaranteed
 				// when the display has been off, some frames can be markedly shorter than expected
 				uint samplesEmitted = TICKSINFRAME;
-				if (LibGambatte.gambatte_runfor(GambatteState, soundbuff, ref samplesEmitted) > 0)
+				if (LibGambatte.gambatte_runfor(GambatteState, soundbuff, ref samplesEmitted) > 0 && render)
 					LibGambatte.gambatte_blitto(GambatteState, VideoBuffer, 160);
 
 				_cycleCount += (ulong)samplesEmitted;
@@ -3,7 +3,7 @@ using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 {
-	public partial class GambatteLink : ISaveRam
+	public partial class GambatteLink : ISaveRam, ISaveRamBaseline
 	{
 		public bool SaveRamModified
 		{
@@ -32,5 +32,11 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 			L.StoreSaveRam(lb);
 			R.StoreSaveRam(rb);
 		}
+
+		public void SaveRamSaved()
+		{
+			L.SaveRamSaved();
+			R.SaveRamSaved();
+		}
 	}
 }
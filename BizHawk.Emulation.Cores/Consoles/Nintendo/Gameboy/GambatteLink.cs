@@ -138,55 +138,14 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 
 						const int step = 32; // could be 1024 for GB
 
-						int nL = overflowL;
-						int nR = overflowR;
-
 						// slowly step our way through the frame, while continually checking and resolving link cable status
-						for (int target = 0; target < SampPerFrame;)
-						{
-							target += step;
-							if (target > SampPerFrame)
-								target = SampPerFrame; // don't run for slightly too long depending on step
-
-							// gambatte_runfor() aborts early when a frame is produced, but we don't want that, hence the while()
-							while (nL < target)
-							{
-								uint nsamp = (uint)(target - nL);
-								if (LibGambatte.gambatte_runfor(L.GambatteState, leftsbuff + nL * 2, ref nsamp) > 0)
-									LibGambatte.gambatte_blitto(L.GambatteState, leftvbuff, pitch);
-								nL += (int)nsamp;
-							}
-							while (nR < target)
-							{
-								uint nsamp = (uint)(target - nR);
-								if (LibGambatte.gambatte_runfor(R.GambatteState, rightsbuff + nR * 2, ref nsamp) > 0)
-									LibGambatte.gambatte_blitto(R.GambatteState, rightvbuff, pitch);
-								nR += (int)nsamp;
-							}
-
-							// poll link cable statuses, but not when the cable is disconnected
-							if (!cableconnected)
-								continue;
-
-							if (LibGambatte.gambatte_linkstatus(L.GambatteState, 256) != 0) // ClockTrigger
-							{
-								LibGambatte.gambatte_linkstatus(L.GambatteState, 257); // ack
-								int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
-								int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
-								LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
-								LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
-							}
-							if (LibGambatte.gambatte_linkstatus(R.GambatteState, 256) != 0) // ClockTrigger
-							{
-								LibGambatte.gambatte_linkstatus(R.GambatteState, 257); // ack
-								int lo = LibGambatte.gambatte_linkstatus(L.GambatteState, 258); // GetOut
-								int ro = LibGambatte.gambatte_linkstatus(R.GambatteState, 258);
-								LibGambatte.gambatte_linkstatus(L.GambatteState, ro & 0xff); // ShiftIn
-								LibGambatte.gambatte_linkstatus(R.GambatteState, lo & 0xff); // ShiftIn
-							}
-						}
-						overflowL = nL - SampPerFrame;
-						overflowR = nR - SampPerFrame;
+						uint* overflows = stackalloc uint[2];
+						overflows[0] = (uint)overflowL;
+						overflows[1] = (uint)overflowR;
+						LibGambatte.gambatte_linked_runfor(L.GambatteState, R.GambatteState, leftsbuff, rightsbuff, leftvbuff, rightvbuff,
+							pitch, (uint)SampPerFrame, step, cableconnected ? 1 : 0, overflows);
+						overflowL = (int)overflows[0];
+						overflowR = (int)overflows[1];
 						if (overflowL < 0 || overflowR < 0)
 							throw new Exception("Timing problem?");
 
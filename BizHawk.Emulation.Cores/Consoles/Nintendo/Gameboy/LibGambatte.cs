@@ -23,6 +23,24 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void gambatte_destroy(IntPtr core);
 
+		/// <summary>
+		/// create a new instance running the same rom, starting from core's current state.
+		/// callbacks, including the input getter, are not copied
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <returns>opaque state pointer</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr gambatte_clone(IntPtr core);
+
+		/// <summary>
+		/// copy the emulation state of src into dst, which must have the same rom loaded
+		/// </summary>
+		/// <param name="dst">opaque state pointer</param>
+		/// <param name="src">opaque state pointer</param>
+		/// <returns>false if the two instances don't match</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern bool gambatte_copyinto(IntPtr dst, IntPtr src);
+
 		[Flags]
 		public enum LoadFlags : uint
 		{
@@ -225,6 +243,23 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void gambatte_settracecallback(IntPtr core, TraceCallback callback);
 
+		/// <summary>
+		/// type of the trace ring full callback
+		/// </summary>
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		public delegate void TraceRingFullCallback();
+
+		/// <summary>
+		/// replace the cpu trace callback with a binary trace ring (see tracering.h), read with NativeTraceRing.
+		/// registers are SP, A, B, C, D, E, F, H, L, LY; flags is 1 when the halt bug repeats the opcode
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="capacity">number of records, rounded up to a power of two; 0 to remove the ring</param>
+		/// <param name="full">called when the ring is full, so it can be drained before records are dropped</param>
+		/// <returns>trace_ring pointer, owned by the core; null if removed or out of memory</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr gambatte_settracering(IntPtr core, uint capacity, TraceRingFullCallback full);
+
 		/// <summary>
 		/// sets layers to be rendered
 		/// </summary>
@@ -233,6 +268,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void gambatte_setlayers(IntPtr core, int mask);
 
+		/// <summary>
+		/// turns drawing into the video buffer on or off.  timing and state are the same either way;
+		/// while off, gambatte_blitto keeps returning the last frame drawn, and savestates keep it too
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="enabled">false to skip pixel output</param>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern void gambatte_setvideoenabled(IntPtr core, bool enabled);
+
 		/// <summary>
 		/// type of the scanline callback
 		/// </summary>
@@ -305,6 +349,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern int gambatte_savesavedatalength(IntPtr core);
 
+		/// <summary>
+		/// get a count that changes whenever the persistant cart memory may have been written.
+		/// the cart ram itself can be read in place with gambatte_getmemoryarea(MemoryAreas.cartram)
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <returns>generation; only compare it for equality</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern uint gambatte_saveramgeneration(IntPtr core);
+
 		/// <summary>
 		/// new savestate method
 		/// </summary>
@@ -333,6 +386,45 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern bool gambatte_newstateload(IntPtr core, byte[] data, int len);
 
+		/// <summary>
+		/// hash the savestate without saving it. equal to XXH64 of what gambatte_newstatesave writes
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="cb">if not null, also receives the hash of every section</param>
+		/// <returns>64 bit hash</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern ulong gambatte_statehash(IntPtr core, StateHashSectionCallback cb);
+
+		/// <summary>
+		/// a savestate with a table of its sections and larger fields in front; see IndexedState
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <returns>length in bytes</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern int gambatte_indexedstatelen(IntPtr core);
+
+		/// <summary>
+		/// save an indexed savestate
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="data">buffer of exactly gambatte_indexedstatelen() bytes</param>
+		/// <param name="len">length of buffer</param>
+		/// <returns>success</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern bool gambatte_indexedstatesave(IntPtr core, byte[] data, int len);
+
+		/// <summary>
+		/// load an indexed savestate
+		/// </summary>
+		/// <param name="core">opaque state pointer</param>
+		/// <param name="data">the savestate</param>
+		/// <param name="len">length of data</param>
+		/// <param name="skip">fields to leave as they are, or null</param>
+		/// <param name="skipcount">length of skip</param>
+		/// <returns>success</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern bool gambatte_indexedstateload(IntPtr core, byte[] data, int len, string[] skip, int skipcount);
+
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern void gambatte_newstatesave_ex(IntPtr core, ref TextStateFPtrs ff);
 
@@ -404,6 +496,26 @@ namespace BizHawk.Emulation.Cores.Nintendo.Gameboy
 		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern int gambatte_linkstatus(IntPtr core, int which);
 
+		/// <summary>
+		/// run two linked cores in lock step for a fixed number of samples, resolving link cable transfers
+		/// every step samples.  equivalent to calling runfor, blitto and linkstatus from the frontend, but in one call
+		/// </summary>
+		/// <param name="a">opaque state pointer of the left core</param>
+		/// <param name="b">opaque state pointer of the right core</param>
+		/// <param name="soundbufa">sound buffer of the left core; must have room for samples + 2064 stereo samples</param>
+		/// <param name="soundbufb">sound buffer of the right core; must have room for samples + 2064 stereo samples</param>
+		/// <param name="videobufa">160x144 video buffer of the left core</param>
+		/// <param name="videobufb">160x144 video buffer of the right core</param>
+		/// <param name="pitch">pitch of both video buffers, in pixels</param>
+		/// <param name="samples">number of samples to run both cores for</param>
+		/// <param name="step">number of samples between link cable checks</param>
+		/// <param name="connected">zero to run the cores without resolving link cable transfers</param>
+		/// <param name="overflows">on input, samples already in each sound buffer from the last call; on output, samples past the end of this one</param>
+		/// <returns>bit 0 set if the left core produced a frame, bit 1 set if the right core did</returns>
+		[DllImport("libgambatte.dll", CallingConvention = CallingConvention.Cdecl)]
+		unsafe public static extern int gambatte_linked_runfor(IntPtr a, IntPtr b, short* soundbufa, short* soundbufb, int* videobufa, int* videobufb,
+			int pitch, uint samples, uint step, int connected, uint* overflows);
+
 		/// <summary>
 		/// get reg and flag values
 		/// </summary>
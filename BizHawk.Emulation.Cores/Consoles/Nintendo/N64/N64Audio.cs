@@ -46,6 +46,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64
 		public N64Audio(mupen64plusApi core)
 		{
 			this.api = new mupen64plusAudioApi(core);
+			// the plugin's band-limited resampler gives a steady 44100 stream, so the one here only ever sees 1:1
+			api.SetFixedSamplingRate(44100);
 
 			_samplingRate = api.GetSamplingRate();
 			Resampler = new SpeexResampler(6, SamplingRate, 44100,
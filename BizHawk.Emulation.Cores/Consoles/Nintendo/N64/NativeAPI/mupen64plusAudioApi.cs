@@ -38,6 +38,14 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 		private delegate int GetAudioRate();
 		GetAudioRate dllGetAudioRate;
 
+		/// <summary>
+		/// Makes the plugin resample to a fixed rate instead of passing through whatever rate the game set
+		/// </summary>
+		/// <param name="freq">The output rate, or 0 for the game's rate</param>
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate void SetOutputRate(int freq);
+		SetOutputRate dllSetOutputRate;
+
 		/// <summary>
 		/// Loads native functions and attaches itself to the core
 		/// </summary>
@@ -51,6 +59,7 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 			dllGetBufferSize = (GetBufferSize)Marshal.GetDelegateForFunctionPointer(GetProcAddress(AudDll, "GetBufferSize"), typeof(GetBufferSize));
 			dllReadAudioBuffer = (ReadAudioBuffer)Marshal.GetDelegateForFunctionPointer(GetProcAddress(AudDll, "ReadAudioBuffer"), typeof(ReadAudioBuffer));
 			dllGetAudioRate = (GetAudioRate)Marshal.GetDelegateForFunctionPointer(GetProcAddress(AudDll, "GetAudioRate"), typeof(GetAudioRate));
+			dllSetOutputRate = (SetOutputRate)Marshal.GetDelegateForFunctionPointer(GetProcAddress(AudDll, "SetOutputRate"), typeof(SetOutputRate));
 		}
 
 		/// <summary>
@@ -62,6 +71,15 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 			return (uint)dllGetAudioRate();
 		}
 
+		/// <summary>
+		/// Sets a fixed output rate; the plugin resamples to it with blip_buf
+		/// </summary>
+		/// <param name="freq">rate in Hz, or 0 to return the game's own rate</param>
+		public void SetFixedSamplingRate(int freq)
+		{
+			dllSetOutputRate(freq);
+		}
+
 		/// <summary>
 		/// Returns size of bytes currently in the audio buffer
 		/// </summary>
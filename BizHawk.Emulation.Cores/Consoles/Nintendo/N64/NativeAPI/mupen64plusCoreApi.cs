@@ -272,6 +272,25 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 		delegate int savestates_load_bkm(byte[] buffer);
 		savestates_load_bkm m64pCoreLoadState;
 
+		/// <summary>
+		/// Snapshots the mupen64plus state, then writes it out (and optionally deflates it) on a worker thread
+		/// </summary>
+		/// <param name="level">zlib compression level, or 0 for the plain savestates_save_bkm format</param>
+		/// <returns>0 if the previous asynchronous save hasn't been collected yet</returns>
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		delegate int savestates_save_bkm_async(int level);
+		savestates_save_bkm_async m64pCoreSaveStateAsync;
+
+		/// <summary>
+		/// Waits for the asynchronous save to finish
+		/// </summary>
+		/// <param name="buffer">null to only get the size, otherwise where to copy the state; the save is then collected</param>
+		/// <param name="maxsize">size of buffer</param>
+		/// <returns>size of the state, or -1 if there is none outstanding or buffer is too small</returns>
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		delegate int savestates_save_bkm_async_result(byte[] buffer, int maxsize);
+		savestates_save_bkm_async_result m64pCoreSaveStateAsyncResult;
+
 		/// <summary>
 		/// Gets a pointer to a section of the mupen64plus core
 		/// </summary>
@@ -618,6 +637,8 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 			m64pConfigSetParameterStr = (ConfigSetParameterStr)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "ConfigSetParameter"), typeof(ConfigSetParameterStr));
 			m64pCoreSaveState = (savestates_save_bkm)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "savestates_save_bkm"), typeof(savestates_save_bkm));
 			m64pCoreLoadState = (savestates_load_bkm)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "savestates_load_bkm"), typeof(savestates_load_bkm));
+			m64pCoreSaveStateAsync = (savestates_save_bkm_async)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "savestates_save_bkm_async"), typeof(savestates_save_bkm_async));
+			m64pCoreSaveStateAsyncResult = (savestates_save_bkm_async_result)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "savestates_save_bkm_async_result"), typeof(savestates_save_bkm_async_result));
 			m64pDebugMemGetPointer = (DebugMemGetPointer)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "DebugMemGetPointer"), typeof(DebugMemGetPointer));
 			m64pDebugSetCallbacks = (DebugSetCallbacks)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "DebugSetCallbacks"), typeof(DebugSetCallbacks));
 			m64pDebugBreakpointLookup = (DebugBreakpointLookup)Marshal.GetDelegateForFunctionPointer(GetProcAddress(CoreDll, "DebugBreakpointLookup"), typeof(DebugBreakpointLookup));
@@ -796,6 +817,28 @@ namespace BizHawk.Emulation.Cores.Nintendo.N64.NativeApi
 			m64pCoreLoadState(buffer);
 		}
 
+		/// <summary>
+		/// Starts a savestate that completes in the background; emulation can continue as soon as this returns
+		/// </summary>
+		/// <param name="compressionLevel">zlib level 1-9, or 0 for none</param>
+		/// <returns>false if the previous one hasn't been collected with EndSaveStateAsync()</returns>
+		public bool BeginSaveStateAsync(int compressionLevel)
+		{
+			return m64pCoreSaveStateAsync(compressionLevel) != 0;
+		}
+
+		/// <summary>
+		/// Waits for the savestate started by BeginSaveStateAsync() and copies it to buffer
+		/// </summary>
+		/// <returns>number of bytes used</returns>
+		public int EndSaveStateAsync(byte[] buffer)
+		{
+			int size = m64pCoreSaveStateAsyncResult(buffer, buffer.Length);
+			if (size < 0)
+				throw new InvalidOperationException("No asynchronous savestate outstanding, or buffer too small");
+			return size;
+		}
+
 		byte[] saveram_backup;
 
 		public void InitSaveram()
@@ -29,6 +29,21 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 		[BizImport(CallingConvention.Cdecl)]
 		public abstract void qn_delete(IntPtr e);
 		/// <summary>
+		/// create a new context sharing e's cart, with the same settings and emulation state
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <returns>NULL on failure</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_clone(IntPtr e);
+		/// <summary>
+		/// copy the emulation state of src into dst, which must have the same game loaded
+		/// </summary>
+		/// <param name="dst">context to overwrite</param>
+		/// <param name="src">context to copy from</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_copy_into(IntPtr dst, IntPtr src);
+		/// <summary>
 		/// load an ines file
 		/// </summary>
 		/// <param name="e">context</param>
@@ -54,6 +69,41 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 		/// <returns>string error</returns>
 		[BizImport(CallingConvention.Cdecl)]
 		public abstract IntPtr qn_emulate_frame(IntPtr e, int pad1, int pad2);
+		/// <summary>
+		/// emulate many frames in one call.  only the last frame is rendered, and only without BatchFlags.NoVideo
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <param name="pads">pad 1 and pad 2 input for each frame, interleaved</param>
+		/// <param name="nframes">number of frames to run</param>
+		/// <param name="flags"></param>
+		/// <param name="spec">memory ranges to sample after each frame</param>
+		/// <param name="nspec">length of spec</param>
+		/// <param name="dest">one record per frame: int flags (1 = lag, 2 = audio didn't fit), uint hash of RAM and WRAM, then the sampled bytes, padded to 4</param>
+		/// <param name="size">length of dest</param>
+		/// <param name="audio">sound for all frames, or null</param>
+		/// <param name="audio_size">[In] capacity of audio [Out] number of samples written</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_emulate_frames(IntPtr e, int[] pads, int nframes, BatchFlags flags, BatchRam[] spec, int nspec, byte[] dest, int size, short[] audio, ref int audio_size);
+
+		[Flags]
+		public enum BatchFlags : int
+		{
+			None = 0,
+			NoVideo = 1,
+			NoAudio = 2,
+			NoHash = 4
+		}
+
+		[StructLayout(LayoutKind.Sequential)]
+		public struct BatchRam
+		{
+			/// <summary>memory area, as in qn_get_memory_area()</summary>
+			public int area;
+			public int addr;
+			public int size;
+		}
+
 		/// <summary>
 		/// blit to rgb32
 		/// </summary>
@@ -126,6 +176,14 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 		[BizImport(CallingConvention.Cdecl)]
 		public abstract IntPtr qn_state_load(IntPtr e, byte[] src, int size);
 		/// <summary>
+		/// hash the savestate without keeping it. equal to XXH64 of what qn_state_save writes
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <param name="hash">hash is returned</param>
+		/// <returns>string error</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_state_hash(IntPtr e, ref ulong hash);
+		/// <summary>
 		/// query battery ram state
 		/// </summary>
 		/// <param name="e">context</param>
@@ -166,6 +224,15 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 		[BizImport(CallingConvention.Cdecl)]
 		public abstract IntPtr qn_battery_ram_clear(IntPtr e);
 		/// <summary>
+		/// get battery ram in place, as qn_battery_ram_save() would copy it
+		/// </summary>
+		/// <param name="e">context</param>
+		/// <param name="size">size is returned</param>
+		/// <param name="generation">changes whenever battery ram may have been written</param>
+		/// <returns>battery ram</returns>
+		[BizImport(CallingConvention.Cdecl)]
+		public abstract IntPtr qn_battery_ram_direct(IntPtr e, ref int size, ref uint generation);
+		/// <summary>
 		/// set sprite limit; does not affect emulation
 		/// </summary>
 		/// <param name="e">context</param>
@@ -1,35 +1,54 @@
-﻿using BizHawk.Emulation.Common;
+﻿using System.Runtime.InteropServices;
+
+using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 {
-	public partial class QuickNES : ISaveRam
+	public partial class QuickNES : ISaveRam, ISaveRamBaseline
 	{
 		public byte[] CloneSaveRam()
 		{
-			LibQuickNES.ThrowStringError(QN.qn_battery_ram_save(Context, SaveRamBuff, SaveRamBuff.Length));
-			return (byte[])SaveRamBuff.Clone();
+			int size = 0;
+			uint generation = 0;
+			var data = QN.qn_battery_ram_direct(Context, ref size, ref generation);
+			var ret = new byte[size];
+			Marshal.Copy(data, ret, 0, size);
+			return ret;
 		}
 
 		public void StoreSaveRam(byte[] data)
 		{
 			LibQuickNES.ThrowStringError(QN.qn_battery_ram_load(Context, data, data.Length));
+			InitSaveRam();
 		}
 
 		public bool SaveRamModified
 		{
 			get
 			{
-				return QN.qn_has_battery_ram(Context);
+				return QN.qn_has_battery_ram(Context) && SaveRamGeneration() != saveRamGeneration;
 			}
 		}
 
-		private byte[] SaveRamBuff;
+		public void SaveRamSaved()
+		{
+			InitSaveRam();
+		}
+
+		// generation of the battery ram as it was loaded or last saved
+		private uint saveRamGeneration;
 
-		private void InitSaveRamBuff()
+		private uint SaveRamGeneration()
 		{
 			int size = 0;
-			LibQuickNES.ThrowStringError(QN.qn_battery_ram_size(Context, ref size));
-			SaveRamBuff = new byte[size];
+			uint generation = 0;
+			QN.qn_battery_ram_direct(Context, ref size, ref generation);
+			return generation;
+		}
+
+		private void InitSaveRam()
+		{
+			saveRamGeneration = SaveRamGeneration();
 		}
 	}
 }
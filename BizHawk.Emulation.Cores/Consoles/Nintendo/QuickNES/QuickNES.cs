@@ -56,7 +56,7 @@ namespace BizHawk.Emulation.Cores.Consoles.Nintendo.QuickNES
 
 					
 
-					InitSaveRamBuff();
+					InitSaveRam();
 					InitSaveStateBuff();
 					InitAudio();
 					InitMemoryDomains();
@@ -133,6 +133,11 @@ namespace BizHawk.Emulation.Cores.Sega.Saturn
 		public static extern void libyabause_clearsaveram();
 		[DllImport("libyabause.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern bool libyabause_saveramodified();
+		/// <summary>
+		/// backup ram in place, as libyabause_savesaveram() would write it; generation changes whenever it may have been written
+		/// </summary>
+		[DllImport("libyabause.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern IntPtr libyabause_saveramdirect(out int size, out uint generation);
 
 		public struct NativeMemoryDomain
 		{
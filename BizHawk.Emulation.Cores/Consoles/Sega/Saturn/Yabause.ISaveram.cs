@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Runtime.InteropServices;
 using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.Sega.Saturn
@@ -23,15 +24,11 @@ namespace BizHawk.Emulation.Cores.Sega.Saturn
 			}
 			else
 			{
-				var ms = new MemoryStream();
-				var fp = new FilePiping();
-				fp.Get(ms);
-				bool success = LibYabause.libyabause_savesaveram(fp.GetPipeNameNative());
-				fp.Finish();
-				if (!success)
-					throw new Exception("libyabause_savesaveram() failed!");
-				var ret = ms.ToArray();
-				ms.Dispose();
+				int size;
+				uint generation;
+				var data = LibYabause.libyabause_saveramdirect(out size, out generation);
+				var ret = new byte[size];
+				Marshal.Copy(data, ret, 0, size);
 				return ret;
 			}
 
@@ -62,6 +62,11 @@ namespace BizHawk.Emulation.Cores.Consoles.Sega.gpgx
 		public static extern bool gpgx_state_save(byte[] dest, int size);
 		[DllImport("libgenplusgx.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern bool gpgx_state_load(byte[] src, int size);
+		/// <summary>
+		/// XXH64 of what gpgx_state_save would write
+		/// </summary>
+		[DllImport("libgenplusgx.dll", CallingConvention = CallingConvention.Cdecl)]
+		public static extern bool gpgx_state_hash(out ulong hash);
 
 		[DllImport("libgenplusgx.dll", CallingConvention = CallingConvention.Cdecl)]
 		public static extern bool gpgx_get_control([Out]InputData dest, int bytes);
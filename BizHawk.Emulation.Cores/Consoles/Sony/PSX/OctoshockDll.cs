@@ -26,9 +26,11 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			PAL = 1,
 		}
 
+		[Flags]
 		public enum eShockStep
 		{
-			Frame
+			Frame = 0,
+			Flag_NoAudio = 0x100
 		};
 
 		public enum eShockFramebufferFlags
@@ -53,7 +55,10 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 			BinaryLoad = 1,
 			BinarySave = 2,
 			TextLoad = 3,
-			TextSave = 4
+			TextSave = 4,
+			IndexedSize = 5,
+			IndexedLoad = 6,
+			IndexedSave = 7
 		}
 
 		public enum eShockMemcardTransaction
@@ -275,6 +280,13 @@ namespace BizHawk.Emulation.Cores.Sony.PSX
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern int shock_StateTransaction(IntPtr psx, ref ShockStateTransaction transaction);
 
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern int shock_StateHash(IntPtr psx, StateHashSectionCallback callback, out ulong hash);
+
+		/// <param name="skip">fields to leave as they are, such as "MainRAM.data8" or "SPURAM", or null</param>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern int shock_StateLoadIndexed(IntPtr psx, byte[] buffer, int bufferLength, string[] skip, int skipCount);
+
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern int shock_GetRegisters_CPU(IntPtr psx, ref ShockRegisters_CPU buffer);
 
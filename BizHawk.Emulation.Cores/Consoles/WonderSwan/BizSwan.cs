@@ -26,6 +26,23 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern void bizswan_delete(IntPtr core);
 
+		/// <summary>
+		/// create a new instance sharing core's rom, starting from its current state.  callbacks are not copied
+		/// </summary>
+		/// <param name="core"></param>
+		/// <returns></returns>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern IntPtr bizswan_clone(IntPtr core);
+
+		/// <summary>
+		/// copy the emulation state of src into dst, which must have the same game loaded
+		/// </summary>
+		/// <param name="dst"></param>
+		/// <param name="src"></param>
+		/// <returns>false if the two instances don't match</returns>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern bool bizswan_copyinto(IntPtr dst, IntPtr src);
+
 		/// <summary>
 		/// hard reset
 		/// </summary>
@@ -39,7 +56,7 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 		/// <param name="core"></param>
 		/// <param name="buttons">input to use on this frame</param>
 		/// <param name="novideo">true to skip all video rendering</param>
-		/// <param name="surface">uint32 video output buffer</param>
+		/// <param name="surface">uint32 video output buffer.  should hold whatever the last rendered frame left in it; unchanged lines are not redrawn</param>
 		/// <param name="soundbuff">int16 sound output buffer</param>
 		/// <param name="soundbuffsize">[In] max hold size of soundbuff [Out] number of samples actually deposited</param>
 		/// <param name="IsRotated">(out) true if the screen is rotated left 90</param>
@@ -47,6 +64,26 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern bool bizswan_advance(IntPtr core, Buttons buttons, bool novideo, int[] surface, short[] soundbuff, ref int soundbuffsize, ref bool IsRotated);
 
+		/// <summary>
+		/// run many frames in one call
+		/// </summary>
+		/// <param name="core"></param>
+		/// <param name="buttons">input for each frame</param>
+		/// <param name="nframes">number of frames to run</param>
+		/// <param name="flags"></param>
+		/// <param name="ram">memory ranges to sample after each frame</param>
+		/// <param name="nram">length of ram</param>
+		/// <param name="dest">one record per frame: uint flags (1 = lag, 2 = sound didn't fit), uint hash of RAM, then the sampled bytes, padded to 4</param>
+		/// <param name="destsize">length of dest</param>
+		/// <param name="surface">receives the last frame, unless BatchFlags.NoVideo</param>
+		/// <param name="soundbuff">sound for all frames, or null</param>
+		/// <param name="soundbuffsize">[In] max hold size of soundbuff [Out] number of samples actually deposited</param>
+		/// <param name="IsRotated">(out) true if the screen is rotated left 90</param>
+		/// <returns>number of frames run, or -1 on bad ram ranges or a short dest</returns>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern int bizswan_advance_batch(IntPtr core, Buttons[] buttons, int nframes, BatchFlags flags, BatchRam[] ram, int nram,
+			byte[] dest, int destsize, int[] surface, short[] soundbuff, ref int soundbuffsize, ref bool IsRotated);
+
 		/// <summary>
 		/// load rom
 		/// </summary>
@@ -87,6 +124,18 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern bool bizswan_saveramsave(IntPtr core, byte[] data, int maxsize);
 
+		/// <summary>
+		/// get one piece of saveram in place; bizswan_saveramsave() concatenates them in index order
+		/// </summary>
+		/// <param name="core"></param>
+		/// <param name="index">0 to 2; some pieces may be empty</param>
+		/// <param name="data"></param>
+		/// <param name="size"></param>
+		/// <param name="generation">changes whenever any saveram may have been written</param>
+		/// <returns>false if index is out of range</returns>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern bool bizswan_saveramarea(IntPtr core, int index, out IntPtr data, out int size, out uint generation);
+
 		/// <summary>
 		/// put non-sync settings, can be done at any time
 		/// </summary>
@@ -107,12 +156,39 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern bool bizswan_getmemoryarea(IntPtr core, int index, out IntPtr name, out int size, out IntPtr data);
 
+		/// <summary>
+		/// write a byte of RAM as the cpu would, invalidating cached tiles and the video generation
+		/// </summary>
+		/// <param name="core"></param>
+		/// <param name="addr">0 to 65535</param>
+		/// <param name="val"></param>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern void bizswan_pokeram(IntPtr core, uint addr, byte val);
+
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern int bizswan_binstatesize(IntPtr core);
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern bool bizswan_binstatesave(IntPtr core, byte[] data, int length);
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern bool bizswan_binstateload(IntPtr core, byte[] data, int length);
+		/// <summary>
+		/// hash the savestate without saving it. equal to XXH64 of what bizswan_binstatesave writes
+		/// </summary>
+		/// <param name="core"></param>
+		/// <param name="cb">if not null, also receives the hash of every section</param>
+		/// <returns></returns>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern ulong bizswan_statehash(IntPtr core, StateHashSectionCallback cb);
+		/// <summary>
+		/// a savestate with a table of its sections and larger fields in front; see IndexedState
+		/// </summary>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern int bizswan_indexedstatesize(IntPtr core);
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern bool bizswan_indexedstatesave(IntPtr core, byte[] data, int length);
+		/// <param name="skip">fields to leave as they are, or null</param>
+		[DllImport(dd, CallingConvention = cc)]
+		public static extern bool bizswan_indexedstateload(IntPtr core, byte[] data, int length, string[] skip, int skipcount);
 
 		[DllImport(dd, CallingConvention = cc)]
 		public static extern void bizswan_txtstatesave(IntPtr core, [In]ref TextStateFPtrs ff);
@@ -191,6 +267,24 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 			Rotate = 0x80000000,
 		}
 
+		[Flags]
+		public enum BatchFlags : int
+		{
+			None = 0,
+			NoVideo = 1,
+			NoAudio = 2,
+			NoHash = 4
+		}
+
+		[StructLayout(LayoutKind.Sequential)]
+		public struct BatchRam
+		{
+			/// <summary>memory area, as in bizswan_getmemoryarea()</summary>
+			public int index;
+			public int addr;
+			public int size;
+		}
+
 		public enum Language : uint
 		{
 			Japanese = 0,
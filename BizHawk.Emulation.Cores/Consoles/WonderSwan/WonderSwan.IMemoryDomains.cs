@@ -24,7 +24,26 @@ namespace BizHawk.Emulation.Cores.WonderSwan
 				if (size == 0)
 					continue;
 				string sname = Marshal.PtrToStringAnsi(name);
-				mmd.Add(MemoryDomain.FromIntPtr(sname, size, MemoryDomain.Endian.Little, data));
+				if (sname == "RAM")
+				{
+					// ram pokes need to go through the core, which invalidates cached tiles
+					mmd.Add(new MemoryDomainDelegate(sname, size, MemoryDomain.Endian.Little,
+						delegate (long addr)
+						{
+							if (addr < 0 || addr >= size)
+								throw new ArgumentOutOfRangeException();
+							return Marshal.ReadByte(data, (int)addr);
+						},
+						delegate (long addr, byte val)
+						{
+							if (addr < 0 || addr >= size)
+								throw new ArgumentOutOfRangeException();
+							BizSwan.bizswan_pokeram(Core, (uint)addr, val);
+						},
+						wordSize: 1));
+					continue;
+				}
+				mmd.Add(MemoryDomain.FromIntPtr(sname, size, MemoryDomain.Endian.Little, data, sname != "ROM"));
 			}
 			(ServiceProvider as BasicServiceProvider).Register<IMemoryDomains>(new MemoryDomainList(mmd));
 		}
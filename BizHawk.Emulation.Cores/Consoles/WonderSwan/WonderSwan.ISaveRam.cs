@@ -1,6 +1,7 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Runtime.InteropServices;
 using System.Text;
 
 using BizHawk.Emulation.Common;
@@ -8,31 +9,56 @@ using BizHawk.Emulation.Common;
 
 namespace BizHawk.Emulation.Cores.WonderSwan
 {
-	partial class WonderSwan : ISaveRam
+	partial class WonderSwan : ISaveRam, ISaveRamBaseline
 	{
-		byte[] saverambuff;
+		int saveramsize;
+		uint saveramgeneration; // as it was loaded or last saved
 
 		void InitISaveRam()
 		{
-			saverambuff = new byte[BizSwan.bizswan_saveramsize(Core)];
+			saveramsize = BizSwan.bizswan_saveramsize(Core);
+			saveramgeneration = SaveRamGeneration();
+		}
+
+		uint SaveRamGeneration()
+		{
+			IntPtr data;
+			int size;
+			uint generation;
+			BizSwan.bizswan_saveramarea(Core, 0, out data, out size, out generation);
+			return generation;
 		}
 
 		public byte[] CloneSaveRam()
 		{
-			if (!BizSwan.bizswan_saveramsave(Core, saverambuff, saverambuff.Length))
-				throw new InvalidOperationException("bizswan_saveramsave() returned false!");
-			return (byte[])saverambuff.Clone();
+			var ret = new byte[saveramsize];
+			IntPtr data;
+			int size;
+			uint generation;
+			for (int i = 0, pos = 0; BizSwan.bizswan_saveramarea(Core, i, out data, out size, out generation); i++)
+			{
+				if (size > 0)
+					Marshal.Copy(data, ret, pos, size);
+				pos += size;
+			}
+			return ret;
 		}
 
 		public void StoreSaveRam(byte[] data)
 		{
 			if (!BizSwan.bizswan_saveramload(Core, data, data.Length))
 				throw new InvalidOperationException("bizswan_saveramload() returned false!");
+			saveramgeneration = SaveRamGeneration();
+		}
+
+		public void SaveRamSaved()
+		{
+			saveramgeneration = SaveRamGeneration();
 		}
 
 		public bool SaveRamModified
 		{
-			get { return BizSwan.bizswan_saveramsize(Core) > 0; }
+			get { return saveramsize > 0 && SaveRamGeneration() != saveramgeneration; }
 		}
 	}
 }
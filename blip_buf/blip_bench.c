@@ -0,0 +1,187 @@
+/* Benchmark of stereo synthesis: separate per-channel calls, batched deltas,
+and the multi-channel functions. All three must give identical output; the
+checksum printed to stdout must also match between SSE2 and BLIP_NO_SSE2
+builds. Timings go to stderr. */
+
+#include "blip_buf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum { clock_rate = 53693175 }; /* Genesis master clock */
+enum { sample_rate = 44100 };
+enum { frame_clocks = 896040 };
+enum { frames = 600 };
+enum { deltas_per_frame = 2048 };
+enum { max_samples = sample_rate / 10 };
+
+static unsigned times [frames] [deltas_per_frame];
+static int deltas [frames] [2] [deltas_per_frame];
+static short out [3] [frames] [max_samples * 2];
+static int out_count [frames];
+
+static unsigned rng = 1;
+
+static unsigned rand32( void )
+{
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static void make_input( void )
+{
+	int f, i;
+	for ( f = 0; f < frames; f++ )
+	{
+		/* Sorted clock times across the frame, like a sound chip's output */
+		unsigned t = 0;
+		int level [2] = { 0, 0 };
+		for ( i = 0; i < deltas_per_frame; i++ )
+		{
+			int c;
+			t += rand32() % (2 * frame_clocks / deltas_per_frame);
+			if ( t >= frame_clocks )
+				t = frame_clocks - 1;
+			times [f] [i] = t;
+
+			for ( c = 0; c < 2; c++ )
+			{
+				int next = (int) (rand32() % 40000) - 20000;
+				deltas [f] [c] [i] = next - level [c];
+				level [c] = next;
+			}
+		}
+	}
+}
+
+static double now( void )
+{
+	return (double) clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+typedef enum { run_separate, run_batched, run_multi } run_mode;
+
+static double run( run_mode mode, int fast )
+{
+	blip_t* bufs [2];
+	double start;
+	int f, c;
+
+	for ( c = 0; c < 2; c++ )
+	{
+		bufs [c] = blip_new( max_samples );
+		if ( !bufs [c] )
+			exit( EXIT_FAILURE );
+		blip_set_rates( bufs [c], clock_rate, sample_rate );
+	}
+
+	start = now();
+	for ( f = 0; f < frames; f++ )
+	{
+		int i;
+		switch ( mode )
+		{
+		case run_separate:
+			for ( i = 0; i < deltas_per_frame; i++ )
+			{
+				for ( c = 0; c < 2; c++ )
+				{
+					if ( fast )
+						blip_add_delta_fast( bufs [c], times [f] [i], deltas [f] [c] [i] );
+					else
+						blip_add_delta( bufs [c], times [f] [i], deltas [f] [c] [i] );
+				}
+			}
+			break;
+
+		case run_batched:
+			for ( c = 0; c < 2; c++ )
+			{
+				if ( fast )
+					blip_add_deltas_fast( bufs [c], times [f], deltas [f] [c], deltas_per_frame );
+				else
+					blip_add_deltas( bufs [c], times [f], deltas [f] [c], deltas_per_frame );
+			}
+			break;
+
+		case run_multi:
+			for ( i = 0; i < deltas_per_frame; i++ )
+			{
+				int pair [2];
+				pair [0] = deltas [f] [0] [i];
+				pair [1] = deltas [f] [1] [i];
+				if ( fast )
+					blip_add_delta_fast_multi( bufs, 2, times [f] [i], pair );
+				else
+					blip_add_delta_multi( bufs, 2, times [f] [i], pair );
+			}
+			break;
+		}
+
+		for ( c = 0; c < 2; c++ )
+			blip_end_frame( bufs [c], frame_clocks );
+
+		if ( mode == run_multi )
+		{
+			out_count [f] = blip_read_samples_multi( bufs, 2, out [mode] [f], max_samples );
+		}
+		else
+		{
+			out_count [f] = blip_read_samples( bufs [0], out [mode] [f], max_samples, 1 );
+			blip_read_samples( bufs [1], out [mode] [f] + 1, max_samples, 1 );
+		}
+	}
+	start = now() - start;
+
+	for ( c = 0; c < 2; c++ )
+		blip_delete( bufs [c] );
+
+	return start;
+}
+
+int main( void )
+{
+	static char const* const names [3] = { "separate", "batched", "multi" };
+	int fast;
+
+	make_input();
+
+	for ( fast = 0; fast < 2; fast++ )
+	{
+		unsigned long sum = 0;
+		int mode, f;
+
+		for ( mode = 0; mode < 3; mode++ )
+		{
+			double best = 0;
+			int pass;
+			for ( pass = 0; pass < 5; pass++ )
+			{
+				double t = run( (run_mode) mode, fast );
+				if ( pass == 0 || t < best )
+					best = t;
+			}
+			fprintf( stderr, "%s %-8s %7.2f ms\n", fast ? "fast" : "full", names [mode], best );
+		}
+
+		for ( f = 0; f < frames; f++ )
+		{
+			int i, n = out_count [f] * 2;
+			if ( memcmp( out [0] [f], out [1] [f], n * sizeof (short) ) ||
+					memcmp( out [0] [f], out [2] [f], n * sizeof (short) ) )
+			{
+				printf( "%s: output differs in frame %d\n", fast ? "fast" : "full", f );
+				return EXIT_FAILURE;
+			}
+			for ( i = 0; i < n; i++ )
+				sum = sum * 31 + (unsigned short) out [0] [f] [i];
+		}
+		printf( "%s: %d frames, checksum %08lX\n", fast ? "fast" : "full", frames, sum & 0xFFFFFFFF );
+	}
+
+	return 0;
+}
@@ -35,6 +35,26 @@ void blip_add_delta( blip_t*, unsigned int clock_time, int delta );
 /** Same as blip_add_delta(), but uses faster, lower-quality synthesis. */
 void blip_add_delta_fast( blip_t*, unsigned int clock_time, int delta );
 
+/** Adds 'count' deltas, each at the clock time with the same index. Same as
+calling blip_add_delta() for each in turn. */
+void blip_add_deltas( blip_t*, unsigned int const clock_times [],
+		int const deltas [], int count );
+
+/** Same as blip_add_deltas(), but uses faster, lower-quality synthesis. */
+void blip_add_deltas_fast( blip_t*, unsigned int const clock_times [],
+		int const deltas [], int count );
+
+/** Adds deltas [i] to bufs [i] for each of 'channels' buffers, all at the same
+clock time. The buffers must have the same rates and have been cleared, ended
+and read together, such as the left and right buffers of a stereo stream. Same
+as calling blip_add_delta() on each, but the step is only worked out once. */
+void blip_add_delta_multi( blip_t* const bufs [], int channels,
+		unsigned int clock_time, int const deltas [] );
+
+/** Same as blip_add_delta_multi(), but uses faster, lower-quality synthesis. */
+void blip_add_delta_fast_multi( blip_t* const bufs [], int channels,
+		unsigned int clock_time, int const deltas [] );
+
 /** Length of time frame, in clocks, needed to make sample_count additional
 samples available. */
 int blip_clocks_needed( const blip_t*, int sample_count );
@@ -58,6 +78,14 @@ interleaving of two buffers into a stereo sample stream. Outputs 16-bit signed
 samples. Returns number of samples actually read.  */
 int blip_read_samples( blip_t*, short out [], int count, int stereo );
 
+/** Reads and removes at most 'count' samples from each of 'channels' buffers
+kept in step as for blip_add_delta_multi(), and writes them interleaved to
+'out', sample i of bufs [c] going to out [i*channels + c]. Gives the same
+samples as blip_read_samples() on each. Returns number of samples actually read
+from each buffer. */
+int blip_read_samples_multi( blip_t* const bufs [], int channels, short out [],
+		int count );
+
 /** Frees buffer. No effect if NULL is passed. */
 void blip_delete( blip_t* );
 
@@ -10,6 +10,7 @@
 #include "shared.h"
 #include "libretro.h"
 #include "state.h"
+#include "xxhash.h"
 #include "genesis.h"
 #include "md_ntsc.h"
 #include "sms_ntsc.h"
@@ -145,6 +146,26 @@ GPGX_EX int gpgx_state_save(void *dest, int size)
 	return state_save((unsigned char*) dest) == size;
 }
 
+static void state_hash_sink(void *opaque, const void *data, int size)
+{
+	xxh64_update((xxh64_state *)opaque, data, size);
+}
+
+// XXH64 of what gpgx_state_save would write, hashed as state_save produces it
+// without writing it out anywhere
+GPGX_EX int gpgx_state_hash(uint64_t *hash)
+{
+	xxh64_state s;
+	xxh64_reset(&s);
+	state_sink = state_hash_sink;
+	state_sink_opaque = &s;
+	state_save(NULL);
+	state_sink = NULL;
+	state_sink_opaque = NULL;
+	*hash = xxh64_digest(&s);
+	return 1;
+}
+
 GPGX_EX int gpgx_state_load(void *src, int size)
 {
 	if (!size)
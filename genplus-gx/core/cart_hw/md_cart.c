@@ -769,7 +769,7 @@ int md_cart_context_save(uint8 *state)
 {
   int i;
   int bufferptr = 0;
-  uint8 *base;
+  uint8 *base, id;
 
   /* cartridge mapping */
   for (i=0; i<0x40; i++)
@@ -780,13 +780,14 @@ int md_cart_context_save(uint8 *state)
     if (base == sram.sram)
     {
       /* SRAM */
-      state[bufferptr++] = 0xff;
+      id = 0xff;
     }
     else
     {
       /* ROM */
-      state[bufferptr++] = ((base - cart.rom) >> 16) & 0xff;
+      id = ((base - cart.rom) >> 16) & 0xff;
     }
+    save_param(&id, 1);
   }
 
   /* hardware registers */
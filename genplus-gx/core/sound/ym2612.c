@@ -2170,7 +2170,9 @@ int YM2612SaveContext(unsigned char *state)
     {
       index = (ym2612.CH[c].SLOT[s].DT - ym2612.OPN.ST.dt_tab[0]) >> 5;
       save_param(&index,sizeof(index));
-      bufferptr += sizeof(index);
+      /* each index is followed by an unused byte, written as 0 so the state is fully defined */
+      index = 0;
+      save_param(&index,sizeof(index));
     }
   }
 
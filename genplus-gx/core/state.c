@@ -38,6 +38,21 @@
 
 #include "shared.h"
 
+state_sink_t state_sink = NULL;
+void *state_sink_opaque = NULL;
+
+void state_write(unsigned char *dest, const void *src, int size)
+{
+  if (state_sink)
+  {
+    state_sink(state_sink_opaque, src, size);
+  }
+  else
+  {
+    memcpy(dest, src, size);
+  }
+}
+
 int state_load(unsigned char *state)
 {
   int i, bufferptr = 0;
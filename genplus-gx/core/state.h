@@ -47,11 +47,18 @@
   bufferptr+= size;
 
 #define save_param(param, size) \
-  memcpy(&state[bufferptr], param, size); \
+  state_write(&state[bufferptr], param, size); \
   bufferptr+= size;
 
+/* when set, state_save() hands everything it saves to the sink instead of */
+/* writing it to the state buffer, which is then never touched */
+typedef void (*state_sink_t)(void *opaque, const void *data, int size);
+extern state_sink_t state_sink;
+extern void *state_sink_opaque;
+
 /* Function prototypes */
 extern int state_load(unsigned char *state);
 extern int state_save(unsigned char *state);
+extern void state_write(unsigned char *dest, const void *src, int size);
 
 #endif
@@ -25,6 +25,8 @@
 #include <cstdint>
 #include "newstate.h"
 
+struct trace_ring;
+
 namespace gambatte {
 enum { BG_PALETTE = 0, SP1_PALETTE = 1, SP2_PALETTE = 2 };
 
@@ -62,6 +64,19 @@ public:
 	  */
 	int load(const char *romfiledata, unsigned romfilelength, std::uint32_t now, unsigned flags = 0);
 	
+	/** Creates an independent instance running the same ROM, starting from the current state.
+	  * The ROM is copied rather than shared, as it lives in the same block as the cartridge and work RAM.
+	  * Callbacks and the input getter are not carried over.
+	  */
+	GB * clone();
+	
+	/** Copies the complete emulation state of another instance running the same ROM directly
+	  * into this one, without going through a savestate buffer.
+	  *
+	  * @return false if the two instances have different memory layouts.
+	  */
+	bool copyFrom(GB &src);
+	
 	/** Emulates until at least 'samples' stereo sound samples are produced in the supplied buffer,
 	  * or until a video frame has been drawn.
 	  *
@@ -87,6 +102,13 @@ public:
 
 	void setLayers(unsigned mask);
 
+	/** Turns drawing into the video buffer on or off; on by default. While off, the PPU keeps
+	  * its exact timing and ends up in the same state, but skips the palette lookups and pixel
+	  * stores, and blitTo() keeps returning the last frame drawn. That frame is still part of
+	  * savestates, so only the video buffer in them differs from a run with video on.
+	  */
+	void setVideoEnabled(bool enabled);
+
 	/** Reset to initial state.
 	  * Equivalent to reloading a ROM image, or turning a Game Boy Color off and on again.
 	  */
@@ -107,6 +129,12 @@ public:
 	void setExecCallback(void (*callback)(unsigned));
 	void setCDCallback(CDCallback);
 	void setTraceCallback(void (*callback)(void *));
+	
+	/** Replaces the trace callback with a binary trace ring of at least capacity records,
+	  * or removes the ring if capacity is 0. full is called when the ring fills up.
+	  * The ring is owned by this object; returns NULL if it was removed or could not be allocated.
+	  */
+	trace_ring *setTraceRing(unsigned capacity, void (*full)());
 	void setScanlineCallback(void (*callback)(), int sl);
 	void setRTCCallback(std::uint32_t (*callback)());
 
@@ -120,6 +148,11 @@ public:
 	void loadSavedata(const char *data);
 	int saveSavedataLength();
 	void saveSavedata(char *dest);
+
+	/** Returns a count that has changed if the savedata (cartridge RAM, which is memory area 3,
+	  * or RTC) may have been written since the previous call. Costs nothing while it is not being written.
+	  */
+	unsigned long saveRamGeneration();
 	
 	// 0 = vram, 1 = rom, 2 = wram, 3 = cartram, 4 = oam, 5 = hram
 	bool getMemoryArea(int which, unsigned char **data, int *length);
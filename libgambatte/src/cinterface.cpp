@@ -29,6 +29,16 @@ GBEXPORT void gambatte_destroy(GB *g)
 	delete g;
 }
 
+GBEXPORT GB *gambatte_clone(GB *g)
+{
+	return g->clone();
+}
+
+GBEXPORT int gambatte_copyinto(GB *dst, GB *src)
+{
+	return dst->copyFrom(*src);
+}
+
 GBEXPORT int gambatte_load(GB *g, const char *romfiledata, unsigned romfilelength, long long now, unsigned flags)
 {
 	int ret = g->load(romfiledata, romfilelength, now, flags);
@@ -53,6 +63,11 @@ GBEXPORT void gambatte_setlayers(GB *g, unsigned mask)
 	g->setLayers(mask);
 }
 
+GBEXPORT void gambatte_setvideoenabled(GB *g, int enabled)
+{
+	g->setVideoEnabled(enabled);
+}
+
 GBEXPORT void gambatte_reset(GB *g, long long now)
 {
 	g->reset(now);
@@ -99,6 +114,11 @@ GBEXPORT void gambatte_settracecallback(GB *g, void (*callback)(void *))
 	g->setTraceCallback(callback);
 }
 
+GBEXPORT trace_ring *gambatte_settracering(GB *g, unsigned capacity, void (*full)())
+{
+	return g->setTraceRing(capacity, full);
+}
+
 GBEXPORT void gambatte_setscanlinecallback(GB *g, void (*callback)(), int sl)
 {
 	g->setScanlineCallback(callback, sl);
@@ -134,6 +154,11 @@ GBEXPORT int gambatte_savesavedatalength(GB *g)
 	return g->saveSavedataLength();
 }
 
+GBEXPORT unsigned gambatte_saveramgeneration(GB *g)
+{
+	return g->saveRamGeneration();
+}
+
 GBEXPORT int gambatte_newstatelen(GB *g)
 {
 	NewStateDummy dummy;
@@ -155,6 +180,40 @@ GBEXPORT int gambatte_newstateload(GB *g, const char *data, int len)
 	return !loader.Overflow() && loader.GetLength() == len;
 }
 
+// hash of the complete state, equal to XXH64 of what gambatte_newstatesave writes.
+// cb, if not null, receives a hash for each section as well
+GBEXPORT uint64_t gambatte_statehash(GB *g, NewStateHasher::SectionCallback cb)
+{
+	NewStateHasher hasher(cb);
+	g->SyncState<false>(&hasher);
+	return hasher.GetHash();
+}
+
+// an indexed state: the same data as gambatte_newstatesave, after a table of its sections and
+// larger fields.  a load leaves the fields named in skip as they are
+GBEXPORT int gambatte_indexedstatelen(GB *g)
+{
+	NewStateIndexedWriter writer;
+	g->SyncState<false>(&writer);
+	return writer.GetLength();
+}
+
+GBEXPORT int gambatte_indexedstatesave(GB *g, char *data, int length)
+{
+	NewStateIndexedWriter writer;
+	g->SyncState<false>(&writer);
+	return writer.Write(data, length);
+}
+
+GBEXPORT int gambatte_indexedstateload(GB *g, const char *data, int length, const char *const *skip, int skipcount)
+{
+	NewStateIndexedReader loader(data, length);
+	for (int i = 0; i < skipcount; i++)
+		loader.Skip(skip[i]);
+	g->SyncState<true>(&loader);
+	return loader.Done();
+}
+
 GBEXPORT void gambatte_newstatesave_ex(GB *g, FPtrs *ff)
 {
 	NewStateExternalFunctions saver(ff);
@@ -192,6 +251,58 @@ GBEXPORT int gambatte_linkstatus(GB *g, int which)
 	return g->LinkStatus(which);
 }
 
+GBEXPORT int gambatte_linked_runfor(GB *a, GB *b, short *soundbufa, short *soundbufb, unsigned int *videobufa, unsigned int *videobufb,
+	int pitch, unsigned samples, unsigned step, int connected, unsigned *overflows)
+{
+	GB *const gb[2] = { a, b };
+	short *const soundbuf[2] = { soundbufa, soundbufb };
+	unsigned int *const videobuf[2] = { videobufa, videobufb };
+	unsigned n[2] = { overflows[0], overflows[1] };
+	int ret = 0;
+
+	for (unsigned target = 0; target < samples;)
+	{
+		target += step;
+		if (target > samples)
+			target = samples;
+
+		// runFor() returns early when a frame is produced, so keep going until the target
+		for (int i = 0; i < 2; i++)
+		{
+			while (n[i] < target)
+			{
+				unsigned nsamp = target - n[i];
+				if (gb[i]->runFor((gambatte::uint_least32_t *)(soundbuf[i] + n[i] * 2), nsamp) > 0)
+				{
+					gb[i]->blitTo((gambatte::uint_least32_t *)videobuf[i], pitch);
+					ret |= 1 << i;
+				}
+				n[i] += nsamp;
+			}
+		}
+
+		if (!connected)
+			continue;
+
+		// a clock signaled by either side shifts both bytes across
+		for (int i = 0; i < 2; i++)
+		{
+			if (gb[i]->LinkStatus(256))
+			{
+				gb[i]->LinkStatus(257);
+				int ao = a->LinkStatus(258);
+				int bo = b->LinkStatus(258);
+				a->LinkStatus(bo & 0xff);
+				b->LinkStatus(ao & 0xff);
+			}
+		}
+	}
+
+	overflows[0] = n[0] - samples;
+	overflows[1] = n[1] - samples;
+	return ret;
+}
+
 GBEXPORT void gambatte_getregs(GB *g, int *dest)
 {
 	g->GetRegs(dest);
@@ -39,7 +39,8 @@ CPU::CPU()
   H(0x01),
   L(0x4D),
   skip(false),
-  tracecallback(0)
+  tracecallback(0),
+  tracering(0)
 {
 }
 
@@ -505,7 +506,34 @@ void CPU::process(const unsigned long cycles) {
 		} else while (cycleCounter < memory.nextEventTime()) {
 			unsigned char opcode;
 			
-			if (tracecallback) {
+			if (tracering) {
+				if (trace_record *const rec = trace_ring_begin(tracering)) {
+					rec->cycle = cycleCounter;
+					rec->pc = PC;
+					rec->regs[0] = SP;
+					rec->regs[1] = A;
+					rec->regs[2] = B;
+					rec->regs[3] = C;
+					rec->regs[4] = D;
+					rec->regs[5] = E;
+					rec->regs[6] = F();
+					rec->regs[7] = H;
+					rec->regs[8] = L;
+					rec->regs[9] = memory.debugGetLY();
+					rec->nregs = 10;
+					rec->flags = skip;
+					PC_READ_FIRST(opcode);
+					// operands are fetched from the opcode's own address after the halt bug
+					const unsigned operands = skip ? rec->pc : PC;
+					rec->opcode[0] = opcode;
+					rec->opcode[1] = memory.peek(operands);
+					rec->opcode[2] = memory.peek((operands + 1) & 0xFFFF);
+					rec->oplen = 3;
+					trace_ring_commit(tracering);
+				} else {
+					PC_READ_FIRST(opcode);
+				}
+			} else if (tracecallback) {
 				int result[14];
 				result[0] = cycleCounter;
 				result[1] = PC;
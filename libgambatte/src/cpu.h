@@ -21,6 +21,7 @@
 
 #include "memory.h"
 #include "newstate.h"
+#include "tracering.h"
 
 namespace gambatte {
 
@@ -41,6 +42,7 @@ class CPU {
 	void process(unsigned long cycles);
 	
 	void (*tracecallback)(void *);
+	trace_ring *tracering;
 
 public:
 	
@@ -53,10 +55,12 @@ public:
 	void setStatePtrs(SaveState &state);
 	void loadState(const SaveState &state);
 	void setLayers(unsigned mask) { memory.setLayers(mask); }
+	void copyOutputSettings(const CPU &src) { memory.copyOutputSettings(src.memory); }
 	
 	void loadSavedata(const char *data) { memory.loadSavedata(data); }
 	int saveSavedataLength() {return memory.saveSavedataLength(); }
 	void saveSavedata(char *dest) { memory.saveSavedata(dest); }
+	unsigned long saveRamGeneration() { return memory.saveRamGeneration(); }
 	
 	bool getMemoryArea(int which, unsigned char **data, int *length) { return memory.getMemoryArea(which, data, length); }
 
@@ -88,6 +92,10 @@ public:
 		tracecallback = callback;
 	}
 
+	void setTraceRing(trace_ring *ring) {
+		tracering = ring;
+	}
+
 	void setScanlineCallback(void (*callback)(), int sl) {
 		memory.setScanlineCallback(callback, sl);
 	}
@@ -28,15 +28,21 @@ struct GB::Priv {
 	CPU cpu;
 	bool gbaCgbMode;
 	unsigned layersMask;
+	bool videoEnabled;
+	unsigned loadFlags;
+	NewStateCopier copier; // reused by copyFrom()
+
+	trace_ring *tracering;
 
 	uint_least32_t vbuff[160*144];
 	
-	Priv() : gbaCgbMode(false), layersMask(LAYER_MASK_BG | LAYER_MASK_OBJ)
+	Priv() : gbaCgbMode(false), layersMask(LAYER_MASK_BG | LAYER_MASK_OBJ), videoEnabled(true), tracering(0)
 	{
 	}
 
 	~Priv()
 	{
+		trace_ring_delete(tracering);
 	}
 };
 	
@@ -55,7 +61,8 @@ long GB::runFor(gambatte::uint_least32_t *const soundBuf, unsigned &samples) {
 		return -1;
 	}
 	
-	p_->cpu.setVideoBuffer(p_->vbuff, 160);
+	// without a frame buffer, the PPU skips pixel output
+	p_->cpu.setVideoBuffer(p_->videoEnabled ? p_->vbuff : 0, 160);
 	p_->cpu.setSoundBuffer(soundBuf);
 	const long cyclesSinceBlit = p_->cpu.runFor(samples * 2);
 	samples = p_->cpu.fillSoundBuffer();
@@ -68,6 +75,11 @@ void GB::setLayers(unsigned mask)
 	p_->cpu.setLayers(mask);
 }
 
+void GB::setVideoEnabled(bool enabled)
+{
+	p_->videoEnabled = enabled;
+}
+
 void GB::blitTo(gambatte::uint_least32_t *videoBuf, int pitch)
 {
 	gambatte::uint_least32_t *src = p_->vbuff;
@@ -128,6 +140,16 @@ void GB::setTraceCallback(void (*callback)(void *)) {
 	p_->cpu.setTraceCallback(callback);
 }
 
+trace_ring *GB::setTraceRing(unsigned capacity, void (*full)()) {
+	p_->cpu.setTraceRing(0);
+	trace_ring_delete(p_->tracering);
+	p_->tracering = capacity ? trace_ring_new(capacity) : 0;
+	if (p_->tracering)
+		p_->tracering->full = full;
+	p_->cpu.setTraceRing(p_->tracering);
+	return p_->tracering;
+}
+
 void GB::setScanlineCallback(void (*callback)(), int sl) {
 	p_->cpu.setScanlineCallback(callback, sl);
 }
@@ -143,6 +165,7 @@ int GB::load(const char *romfiledata, unsigned romfilelength, const std::uint32_
 	const int failed = p_->cpu.load(romfiledata, romfilelength, flags & FORCE_DMG, flags & MULTICART_COMPAT);
 	
 	if (!failed) {
+		p_->loadFlags = flags;
 		SaveState state;
 		p_->cpu.setStatePtrs(state);
 		setInitState(state, p_->cpu.isCgb(), p_->gbaCgbMode = flags & GBA_CGB, now);
@@ -153,6 +176,42 @@ int GB::load(const char *romfiledata, unsigned romfilelength, const std::uint32_
 	return failed;
 }
 
+GB * GB::clone() {
+	GB *const g = new GB;
+	
+	if (p_->cpu.loaded()) {
+		unsigned char *rom;
+		int romsize;
+		p_->cpu.getMemoryArea(1, &rom, &romsize);
+		g->load(reinterpret_cast<const char *>(rom), romsize, 0, p_->loadFlags);
+		g->p_->cpu.copyOutputSettings(p_->cpu);
+		g->copyFrom(*this);
+	}
+	
+	return g;
+}
+
+bool GB::copyFrom(GB &src) {
+	if (!p_->cpu.loaded() || !src.p_->cpu.loaded())
+		return false;
+	
+	// vram, rom, wram and cart ram all have to line up
+	for (int i = 0; i < 4; i++) {
+		unsigned char *data;
+		unsigned char *srcdata;
+		int length = 0;
+		int srclength = 0;
+		if (p_->cpu.getMemoryArea(i, &data, &length) != src.p_->cpu.getMemoryArea(i, &srcdata, &srclength)
+				|| length != srclength)
+			return false;
+	}
+	
+	p_->copier.Rewind();
+	src.SyncState<false>(&p_->copier);
+	SyncState<true>(&p_->copier);
+	return !p_->copier.Mismatch();
+}
+
 bool GB::isCgb() const {
 	return p_->cpu.isCgb();
 }
@@ -169,6 +228,10 @@ void GB::loadSavedata(const char *data) {
 	if (p_->cpu.loaded())
 		p_->cpu.loadSavedata(data);
 }
+unsigned long GB::saveRamGeneration() {
+	return p_->cpu.loaded() ? p_->cpu.saveRamGeneration() : 0;
+}
+
 int GB::saveSavedataLength() {
 	if (p_->cpu.loaded())
 		return p_->cpu.saveSavedataLength();
@@ -788,6 +788,7 @@ void Cartridge::loadSavedata(const char *data) {
 		std::memcpy(memptrs.rambankdata(), data, length);
 		data += length;
 		enforce8bit(memptrs.rambankdata(), length);
+		memptrs.sramReplaced();
 	}
 
 	if (hasRtc(memptrs.romdata())) {
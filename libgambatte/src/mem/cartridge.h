@@ -96,6 +96,8 @@ public:
 	void loadSavedata(const char *data);
 	int saveSavedataLength();
 	void saveSavedata(char *dest);
+	unsigned long saveRamGeneration() { return memptrs.watchSram(); }
+	void saveRamWritten() { memptrs.sramWritten(); }
 
 	bool getMemoryArea(int which, unsigned char **data, int *length) const;
 
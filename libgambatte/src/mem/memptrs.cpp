@@ -25,7 +25,7 @@ namespace gambatte {
 MemPtrs::MemPtrs()
 : rmem_(), wmem_(), romdata_(), wramdata_(), vrambankptr_(0), rsrambankptr_(0),
   wsrambankptr_(0), memchunk_(0), rambankdata_(0), wramdataend_(0), oamDmaSrc_(OAM_DMA_SRC_OFF),
-  memchunk_len(0)
+  sramGeneration_(0), sramWatch_(false), memchunk_len(0)
 {
 }
 
@@ -140,6 +140,17 @@ void MemPtrs::disconnectOamDmaAreas() {
 			break;
 		}
 	}
+
+	if (sramWatch_)
+		wmem_[0xB] = wmem_[0xA] = 0;
+}
+
+void MemPtrs::setSramWatch(const bool watch) {
+	if (watch != sramWatch_) {
+		sramWatch_ = watch;
+		wmem_[0xB] = wmem_[0xA] = wsrambankptr_;
+		disconnectOamDmaAreas();
+	}
 }
 
 // all pointers here are relative to memchunk_
@@ -154,6 +165,10 @@ SYNCFUNC(MemPtrs)
 	int memchunk_savelen_old = memchunk_savelen;
 	*/
 
+	// the watch is not part of the machine state; save and load the pointers as they are without it
+	const bool sramWatch = sramWatch_;
+	setSramWatch(false);
+
 	NSS(memchunk_len);
 	NSS(memchunk_saveoffs);
 	NSS(memchunk_savelen);
@@ -215,6 +230,10 @@ SYNCFUNC(MemPtrs)
 	MSS(rambankdata_);
 	MSS(wramdataend_);
 	NSS(oamDmaSrc_);
+
+	if (isReader)
+		sramReplaced();
+	setSramWatch(sramWatch);
 }
 
 }
@@ -41,6 +41,9 @@ class MemPtrs {
 	
 	OamDmaSrc oamDmaSrc_;
 
+	unsigned long sramGeneration_;
+	bool sramWatch_;
+
 	int memchunk_len;
 	int memchunk_saveoffs;
 	int memchunk_savelen;
@@ -48,6 +51,7 @@ class MemPtrs {
 	MemPtrs(const MemPtrs &);
 	MemPtrs & operator=(const MemPtrs &);
 	void disconnectOamDmaAreas();
+	void setSramWatch(bool watch);
 	unsigned char * rdisabledRamw() const { return wramdataend_         ; }
 	unsigned char * wdisabledRam()  const { return wramdataend_ + 0x2000; }
 public:
@@ -81,6 +85,12 @@ public:
 	void setWrambank(unsigned bank);
 	void setOamDmaSrc(OamDmaSrc oamDmaSrc);
 
+	// While watched, the cartridge RAM write pointers are left disconnected so that the
+	// next write takes the slow path, which calls sramWritten() and reconnects them.
+	unsigned long watchSram() { setSramWatch(true); return sramGeneration_; }
+	void sramWritten() { setSramWatch(false); ++sramGeneration_; }
+	void sramReplaced() { ++sramGeneration_; }
+
 	template<bool isReader>void SyncState(NewState *ns);
 };
 
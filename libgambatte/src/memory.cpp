@@ -992,7 +992,9 @@ void Memory::nontrivial_write(const unsigned P, const unsigned data, const unsig
 		} else if (P < 0xC000) {
 			if (cart.wsrambankptr()) cart.wsrambankptr()[P] = data;
 			else if (cart.isTPP1()) cart.TPP1Write(P, data);
-			else cart.rtcWrite(data);
+			else cart.rtcWrite(data);
+
+			cart.saveRamWritten(); // the rtc base time is part of the savedata too
 		} else
 			cart.wramdata(P >> 12 & 1)[P & 0xFFF] = data;
 	} else if (P - 0xFF80u >= 0x7Fu) {
@@ -94,6 +94,7 @@ public:
 	void loadSavedata(const char *data) { cart.loadSavedata(data); }
 	int saveSavedataLength() {return cart.saveSavedataLength(); }
 	void saveSavedata(char *dest) { cart.saveSavedata(dest); }
+	unsigned long saveRamGeneration() { return cart.saveRamGeneration(); }
 	void updateInput();
 
 	bool getMemoryArea(int which, unsigned char **data, int *length); // { return cart.getMemoryArea(which, data, length); }
@@ -105,6 +106,7 @@ public:
 	unsigned long nextEventTime() const { return intreq.minEventTime(); }
 
 	void setLayers(unsigned mask) { display.setLayers(mask); }
+	void copyOutputSettings(const Memory &src) { display.copyOutputSettings(src.display); }
 	
 	bool isActive() const { return intreq.eventTime(END) != DISABLED_TIME; }
 	
@@ -732,6 +732,13 @@ void LCD::setDmgPaletteColor(const unsigned palNum, const unsigned colorNum, con
 	refreshPalettes();
 }
 
+void LCD::copyOutputSettings(const LCD &src) {
+	std::memcpy(dmgColorsRgb32, src.dmgColorsRgb32, sizeof dmgColorsRgb32);
+	std::memcpy(cgbColorsRgb32, src.cgbColorsRgb32, sizeof cgbColorsRgb32);
+	ppu.setLayers(src.ppu.layers());
+	refreshPalettes();
+}
+
 // don't need to save or load rgb32 color data
 
 SYNCFUNC(LCD)
@@ -175,6 +175,7 @@ public:
 	void setCgbPalette(unsigned *lut);
 	void setVideoBuffer(uint_least32_t *videoBuf, int pitch);
 	void setLayers(unsigned mask) { ppu.setLayers(mask); }
+	void copyOutputSettings(const LCD &src);
 
 	int debugGetLY() const { return ppu.lyCounter().ly(); }
 
@@ -293,6 +293,10 @@ namespace M3Start {
 }
 
 namespace M3Loop {
+	// render is false when there is no frame buffer to draw to. The tile and sprite fetches and
+	// every piece of state they leave behind stay the same; only the palette lookups and the
+	// stores into the line are left out.
+	template<bool render>
 	static void doFullTilesUnrolledDmg(PPUPriv &p, const int xend, uint_least32_t *const dbufline,
 			const unsigned char *const tileMapLine, const unsigned tileline, unsigned tileMapXpos) {
 		const unsigned tileIndexSign = ~p.lcdc << 3 & 0x80;
@@ -359,21 +363,25 @@ namespace M3Loop {
 				xpos += n;
 				
 				if (!(p.lcdc & 1)) {
-					do { *dst++ = p.bgPalette[0]; } while (dst != dstend);
+					if (render)
+						do { *dst++ = p.bgPalette[0]; } while (dst != dstend);
 					tileMapXpos += n >> 3;
 
 					unsigned const tno = tileMapLine[(tileMapXpos - 1) & 0x1F];
 					ntileword = expand_lut[(tileDataLine + tno * 16 - (tno & tileIndexSign) * 32)[0]]
 					          + expand_lut[(tileDataLine + tno * 16 - (tno & tileIndexSign) * 32)[1]] * 2;
 				} else do {
-					dst[0] = p.bgPalette[ ntileword & 0x0003       ];
-					dst[1] = p.bgPalette[(ntileword & 0x000C) >>  2];
-					dst[2] = p.bgPalette[(ntileword & 0x0030) >>  4];
-					dst[3] = p.bgPalette[(ntileword & 0x00C0) >>  6];
-					dst[4] = p.bgPalette[(ntileword & 0x0300) >>  8];
-					dst[5] = p.bgPalette[(ntileword & 0x0C00) >> 10];
-					dst[6] = p.bgPalette[(ntileword & 0x3000) >> 12];
-					dst[7] = p.bgPalette[ ntileword           >> 14];
+					if (render) {
+						dst[0] = p.bgPalette[ ntileword & 0x0003       ];
+						dst[1] = p.bgPalette[(ntileword & 0x000C) >>  2];
+						dst[2] = p.bgPalette[(ntileword & 0x0030) >>  4];
+						dst[3] = p.bgPalette[(ntileword & 0x00C0) >>  6];
+						dst[4] = p.bgPalette[(ntileword & 0x0300) >>  8];
+						dst[5] = p.bgPalette[(ntileword & 0x0C00) >> 10];
+						dst[6] = p.bgPalette[(ntileword & 0x3000) >> 12];
+						dst[7] = p.bgPalette[ ntileword           >> 14];
+					}
+					
 					dst += 8;
 					
 					unsigned const tno = tileMapLine[tileMapXpos & 0x1F];
@@ -397,14 +405,16 @@ namespace M3Loop {
 				uint_least32_t *const dst = dbufline + (xpos - 8);
 				const unsigned tileword = -(p.lcdc & 1U) & p.ntileword;
 				
-				dst[0] = p.bgPalette[ tileword & 0x0003       ];
-				dst[1] = p.bgPalette[(tileword & 0x000C) >>  2];
-				dst[2] = p.bgPalette[(tileword & 0x0030) >>  4];
-				dst[3] = p.bgPalette[(tileword & 0x00C0) >>  6];
-				dst[4] = p.bgPalette[(tileword & 0x0300) >>  8];
-				dst[5] = p.bgPalette[(tileword & 0x0C00) >> 10];
-				dst[6] = p.bgPalette[(tileword & 0x3000) >> 12];
-				dst[7] = p.bgPalette[ tileword           >> 14];
+				if (render) {
+					dst[0] = p.bgPalette[ tileword & 0x0003       ];
+					dst[1] = p.bgPalette[(tileword & 0x000C) >>  2];
+					dst[2] = p.bgPalette[(tileword & 0x0030) >>  4];
+					dst[3] = p.bgPalette[(tileword & 0x00C0) >>  6];
+					dst[4] = p.bgPalette[(tileword & 0x0300) >>  8];
+					dst[5] = p.bgPalette[(tileword & 0x0C00) >> 10];
+					dst[6] = p.bgPalette[(tileword & 0x3000) >> 12];
+					dst[7] = p.bgPalette[ tileword           >> 14];
+				}
 				
 				int i = nextSprite - 1;
 			
@@ -432,7 +442,9 @@ namespace M3Loop {
 							const unsigned long *const spPalette = p.spPalette + (attrib >> 2 & 4);
 							uint_least32_t *d = dst + pos;
 
-							if (!(attrib & 0x80)) {
+							if (!render) {
+								spword >>= n * 2;
+							} else if (!(attrib & 0x80)) {
 								switch (n) {
 								case 8: if (spword >> 14    ) { d[7] = spPalette[spword >> 14    ]; }
 								case 7: if (spword >> 12 & 3) { d[6] = spPalette[spword >> 12 & 3]; }
@@ -489,6 +501,7 @@ namespace M3Loop {
 		p.xpos = xpos;
 	}
 	
+	template<bool render>
 	static void doFullTilesUnrolledCgb(PPUPriv &p, const int xend, uint_least32_t *const dbufline,
 			const unsigned char *const tileMapLine, const unsigned tileline, unsigned tileMapXpos) {
 		int xpos = p.xpos;
@@ -497,8 +510,9 @@ namespace M3Loop {
 
 		if(!(p.layersMask & LAYER_MASK_BG))
 		{
-			for(int x=xpos,i=0;x<xend;x++,i++)
-				dbufline[i] = p.bgPalette[0]; //guessing?
+			if (render)
+				for(int x=xpos,i=0;x<xend;x++,i++)
+					dbufline[i] = p.bgPalette[0]; //guessing?
 			return;
 		}
 		
@@ -553,15 +567,18 @@ namespace M3Loop {
 				xpos += n;
 				
 				do {
-					const unsigned long *const bgPalette = p.bgPalette + (nattrib & 7) * 4;
-					dst[0] = bgPalette[ ntileword & 0x0003       ];
-					dst[1] = bgPalette[(ntileword & 0x000C) >>  2];
-					dst[2] = bgPalette[(ntileword & 0x0030) >>  4];
-					dst[3] = bgPalette[(ntileword & 0x00C0) >>  6];
-					dst[4] = bgPalette[(ntileword & 0x0300) >>  8];
-					dst[5] = bgPalette[(ntileword & 0x0C00) >> 10];
-					dst[6] = bgPalette[(ntileword & 0x3000) >> 12];
-					dst[7] = bgPalette[ ntileword           >> 14];
+					if (render) {
+						const unsigned long *const bgPalette = p.bgPalette + (nattrib & 7) * 4;
+						dst[0] = bgPalette[ ntileword & 0x0003       ];
+						dst[1] = bgPalette[(ntileword & 0x000C) >>  2];
+						dst[2] = bgPalette[(ntileword & 0x0030) >>  4];
+						dst[3] = bgPalette[(ntileword & 0x00C0) >>  6];
+						dst[4] = bgPalette[(ntileword & 0x0300) >>  8];
+						dst[5] = bgPalette[(ntileword & 0x0C00) >> 10];
+						dst[6] = bgPalette[(ntileword & 0x3000) >> 12];
+						dst[7] = bgPalette[ ntileword           >> 14];
+					}
+					
 					dst += 8;
 					
 					unsigned const tno = tileMapLine[ tileMapXpos & 0x1F          ];
@@ -593,14 +610,16 @@ namespace M3Loop {
 				const unsigned attrib   = p.nattrib;
 				const unsigned long *const bgPalette = p.bgPalette + (attrib & 7) * 4;
 				
-				dst[0] = bgPalette[ tileword & 0x0003       ];
-				dst[1] = bgPalette[(tileword & 0x000C) >>  2];
-				dst[2] = bgPalette[(tileword & 0x0030) >>  4];
-				dst[3] = bgPalette[(tileword & 0x00C0) >>  6];
-				dst[4] = bgPalette[(tileword & 0x0300) >>  8];
-				dst[5] = bgPalette[(tileword & 0x0C00) >> 10];
-				dst[6] = bgPalette[(tileword & 0x3000) >> 12];
-				dst[7] = bgPalette[ tileword           >> 14];
+				if (render) {
+					dst[0] = bgPalette[ tileword & 0x0003       ];
+					dst[1] = bgPalette[(tileword & 0x000C) >>  2];
+					dst[2] = bgPalette[(tileword & 0x0030) >>  4];
+					dst[3] = bgPalette[(tileword & 0x00C0) >>  6];
+					dst[4] = bgPalette[(tileword & 0x0300) >>  8];
+					dst[5] = bgPalette[(tileword & 0x0C00) >> 10];
+					dst[6] = bgPalette[(tileword & 0x3000) >> 12];
+					dst[7] = bgPalette[ tileword           >> 14];
+				}
 				
 				int i = nextSprite - 1;
 
@@ -631,7 +650,9 @@ namespace M3Loop {
 							unsigned spword        = p.spwordList[i];
 							const unsigned long *const spPalette = p.spPalette + (sattrib & 7) * 4;
 
-							if (!((attrib | sattrib) & bgenmask)) {
+							if (!render) {
+								spword >>= n * 2;
+							} else if (!((attrib | sattrib) & bgenmask)) {
 								unsigned char  *const idt = idtab + pos;
 								uint_least32_t *const   d =   dst + pos;
 
@@ -722,6 +743,7 @@ namespace M3Loop {
 		p.xpos = xpos;
 	}
 	
+	template<bool render>
 	static void doFullTilesUnrolled(PPUPriv &p) {
 		int xpos = p.xpos;
 		const int xend = static_cast<int>(p.wx) < xpos || p.wx >= 168 ? 161 : static_cast<int>(p.wx) - 7;
@@ -748,14 +770,15 @@ namespace M3Loop {
 			uint_least32_t prebuf[16];
 			
 			if (p.cgb) {
-				doFullTilesUnrolledCgb(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
+				doFullTilesUnrolledCgb<render>(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
 			} else
-				doFullTilesUnrolledDmg(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
+				doFullTilesUnrolledDmg<render>(p, xend < 8 ? xend : 8, prebuf + (8 - xpos), tileMapLine, tileline, tileMapXpos);
 			
 			const int newxpos = p.xpos;
 			
 			if (newxpos > 8) {
-				std::memcpy(dbufline, prebuf + (8 - xpos), (newxpos - 8) * sizeof *dbufline);
+				if (render)
+					std::memcpy(dbufline, prebuf + (8 - xpos), (newxpos - 8) * sizeof *dbufline);
 			} else if (newxpos < 8)
 				return;
 			
@@ -766,9 +789,9 @@ namespace M3Loop {
 		}
 		
 		if (p.cgb) {
-			doFullTilesUnrolledCgb(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
+			doFullTilesUnrolledCgb<render>(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
 		} else
-			doFullTilesUnrolledDmg(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
+			doFullTilesUnrolledDmg<render>(p, xend, dbufline, tileMapLine, tileline, tileMapXpos);
 	}
 	
 	static void plotPixel(PPUPriv &p) {
@@ -786,18 +809,11 @@ namespace M3Loop {
 		}
 		
 		const unsigned twdata = tileword & ((p.lcdc & 1) | p.cgb) * 3;
-		unsigned long pixel = p.bgPalette[twdata + (p.attrib & 7) * 4];
+		unsigned spdata = 0;
+		unsigned attrib = 0;
 		int i = static_cast<int>(p.nextSprite) - 1;
-
-		if(!(p.layersMask & LAYER_MASK_BG))
-		{
-			pixel = p.bgPalette[0]; //guessing? clobber the tile that was read
-		}
 		
 		if (i >= 0 && static_cast<int>(p.spriteList[i].spx) > xpos - 8) {
-			unsigned spdata = 0;
-			unsigned attrib = 0;
-			
 			if (p.cgb) {
 				unsigned minId = 0xFF;
 				
@@ -811,12 +827,6 @@ namespace M3Loop {
 					p.spwordList[i] >>= 2;
 					--i;
 				} while (i >= 0 && static_cast<int>(p.spriteList[i].spx) > xpos - 8);
-				
-				if(p.layersMask & LAYER_MASK_OBJ)
-				{
-					if (spdata && (p.lcdc & 2) && (!((attrib | p.attrib) & 0x80) || !twdata || !(p.lcdc & 1)))
-						pixel = p.spPalette[(attrib & 7) * 4 + spdata];
-				}
 			} else {
 				do {
 					if (p.spwordList[i] & 3) {
@@ -827,17 +837,30 @@ namespace M3Loop {
 					p.spwordList[i] >>= 2;
 					--i;
 				} while (i >= 0 && static_cast<int>(p.spriteList[i].spx) > xpos - 8);
-				
-				if(p.layersMask & LAYER_MASK_OBJ)
-				{
-					if (spdata && (p.lcdc & 2) && (!(attrib & 0x80) || !twdata))
-						pixel = p.spPalette[(attrib >> 2 & 4) + spdata];
-				}
 			}
 		}
 		
-		if (xpos - 8 >= 0)
+		if (xpos - 8 >= 0 && p.framebuf.fb()) {
+			unsigned long pixel = p.bgPalette[twdata + (p.attrib & 7) * 4];
+
+			if(!(p.layersMask & LAYER_MASK_BG))
+			{
+				pixel = p.bgPalette[0]; //guessing? clobber the tile that was read
+			}
+			
+			if(spdata && (p.layersMask & LAYER_MASK_OBJ))
+			{
+				if (p.cgb) {
+					if ((p.lcdc & 2) && (!((attrib | p.attrib) & 0x80) || !twdata || !(p.lcdc & 1)))
+						pixel = p.spPalette[(attrib & 7) * 4 + spdata];
+				} else {
+					if ((p.lcdc & 2) && (!(attrib & 0x80) || !twdata))
+						pixel = p.spPalette[(attrib >> 2 & 4) + spdata];
+				}
+			}
+			
 			fbline[xpos - 8] = pixel;
+		}
 		
 		p.xpos = xpos + 1;
 		p.tileword = tileword >> 2;
@@ -1065,7 +1088,10 @@ namespace M3Loop {
 			if ((p.winDrawState & WIN_DRAW_START) && handleWinDrawStartReq(p))
 				return StartWindowDraw::f0(p);
 			
- 			doFullTilesUnrolled(p);
+ 			if (p.framebuf.fb())
+				doFullTilesUnrolled<true>(p);
+			else
+				doFullTilesUnrolled<false>(p);
 			
 			if (p.xpos == 168) {
 				++p.cycles;
@@ -133,6 +133,7 @@ public:
 	unsigned long * spPalette() { return p_.spPalette; }
 	void update(unsigned long cc);
 	void setLayers(unsigned mask) { p_.layersMask = mask; }
+	unsigned layers() const { return p_.layersMask; }
 
 	template<bool isReader>void SyncState(NewState *ns);
 };
@@ -0,0 +1,303 @@
+/* Checks that turning video output off leaves emulation untouched.
+ *
+ * Builds a small ROM that keeps the PPU busy: random tiles, maps, CGB
+ * attributes and palettes, 40 tall sprites packed into the upper half of the
+ * screen, a moving window, and a main loop that waits on STAT and LY to
+ * change SCX and LCDC (BG enable, sprite size) every line. It runs as DMG and
+ * as CGB in three instances side by side: video always on, always off, and
+ * toggled every call. After every call, each field of the savestate but the
+ * frame buffer must be the same in all three.
+ *
+ * The line printed per model hashes the frames and states of the video-on
+ * instance; it must match golden.txt, which was recorded before video could
+ * be turned off.
+ *
+ *   videotest            run the check, print one line per model
+ *   videotest -bench     time the video-on and video-off instances (to stderr)
+ */
+
+#include "gambatte.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// same as cinterface.cpp: the state must not depend on leftover heap contents
+void *operator new(std::size_t n)
+{
+	void *p = std::malloc(n);
+	std::memset(p, 0, n);
+	return p;
+}
+
+void operator delete(void *p)
+{
+	std::free(p);
+}
+
+namespace {
+
+enum { FRAMES = 300, SAMPLES = 35112 };
+
+class Asm {
+	std::vector<unsigned char> &rom_;
+	unsigned pc_;
+public:
+	Asm(std::vector<unsigned char> &rom, unsigned pc) : rom_(rom), pc_(pc) {}
+	void org(unsigned pc) { pc_ = pc; }
+	unsigned here() const { return pc_; }
+	Asm & operator()(unsigned b) { rom_[pc_++] = b; return *this; }
+	Asm & operator()(unsigned b0, unsigned b1) { return (*this)(b0)(b1); }
+	Asm & operator()(unsigned b0, unsigned b1, unsigned b2) { return (*this)(b0)(b1)(b2); }
+	// jr cc to an earlier address
+	void jrBack(unsigned op, unsigned target) { (*this)(op, (target - (pc_ + 2)) & 0xFF); }
+	// jr cc to a later address, patched by land()
+	unsigned jrFwd(unsigned op) { (*this)(op, 0); return pc_ - 1; }
+	void land(unsigned at) { rom_[at] = (pc_ - (at + 1)) & 0xFF; }
+	// e = e * 5 + 1, leaving the result in a as well
+	Asm & rnd() { return (*this)(0x7B)(0x87)(0x87)(0x83)(0x3C)(0x5F); }
+};
+
+std::vector<unsigned char> makeRom() {
+	std::vector<unsigned char> rom(0x8000);
+	Asm a(rom, 0x100);
+	a(0x00)(0xC3, 0x50, 0x01);                   // nop; jp $0150
+	std::memcpy(&rom[0x134], "VIDEOTEST", 9);
+	rom[0x143] = 0x80;                           // CGB compatible; FORCE_DMG picks the model
+
+	a.org(0x150);
+	a(0xF3)(0x31, 0xFE, 0xFF);                   // di; ld sp,$fffe
+	const unsigned waitVblank = a.here();
+	a(0xF0, 0x44)(0xFE, 144);                    // ldh a,(LY); cp 144
+	a.jrBack(0x38, waitVblank);                  // jr c
+	a(0xAF)(0xE0, 0x40);                         // xor a; ldh (LCDC),a
+	a(0x1E, 0x01);                               // ld e,1
+
+	// both VRAM banks: tiles, maps and (bank 1) CGB attributes
+	for (unsigned bank = 0; bank < 2; ++bank) {
+		a(0x3E, bank)(0xE0, 0x4F);               // ld a,bank; ldh (VBK),a
+		a(0x21, 0x00, 0x80)(0x01, 0x00, 0x20);   // ld hl,$8000; ld bc,$2000
+		const unsigned fill = a.here();
+		a.rnd()(0x22)(0x0B)(0x78)(0xB1);         // ld (hl+),a; dec bc; ld a,b; or c
+		a.jrBack(0x20, fill);                    // jr nz
+	}
+
+	a(0xAF)(0xE0, 0x4F);                         // xor a; ldh (VBK),a
+
+	// CGB BG and OBJ palettes
+	for (unsigned reg = 0x68; reg < 0x6C; reg += 2) {
+		a(0x3E, 0x80)(0xE0, reg)(0x06, 64);      // ld a,$80; ldh (xCPS),a; ld b,64
+		const unsigned pal = a.here();
+		a.rnd()(0xE0, reg + 1)(0x05);            // ldh (xCPD),a; dec b
+		a.jrBack(0x20, pal);
+	}
+
+	a(0x3E, 0xE4)(0xE0, 0x47);                   // BGP
+	a(0x3E, 0xD2)(0xE0, 0x48);                   // OBP0
+	a(0x3E, 0x1B)(0xE0, 0x49);                   // OBP1
+
+	// 40 sprites on lines 0 to 127, most lines hit the 10 sprite limit in 8x16 mode
+	a(0x21, 0x00, 0xFE)(0x06, 40);               // ld hl,$fe00; ld b,40
+	const unsigned oam = a.here();
+	a.rnd()(0xE6, 0x7F)(0xC6, 16)(0x22);         // and $7f; add 16; ld (hl+),a
+	a.rnd()(0x22).rnd()(0x22).rnd()(0x22)(0x05); // x, tile, attributes; dec b
+	a.jrBack(0x20, oam);
+
+	a(0x3E, 0x40)(0xE0, 0x4A);                   // WY
+	a(0x3E, 0x50)(0xE0, 0x4B);                   // WX
+	a(0x3E, 0xF7)(0xE0, 0x40);                   // LCDC: on, window at $9c00, 8x16 sprites
+	a(0x16, 0x00);                               // ld d,0
+
+	const unsigned line = a.here();
+	a(0xF0, 0x44)(0xFE, 144);                    // ldh a,(LY); cp 144
+	const unsigned toVblank = a.jrFwd(0x30);     // jr nc
+	a(0xF0, 0x41)(0xE6, 0x03);                   // ldh a,(STAT); and 3
+	a.jrBack(0x20, line);                        // jr nz: wait for mode 0
+	a(0xF0, 0x44)(0x82)(0xE0, 0x43);             // SCX = LY + d
+	a(0xF0, 0x44)(0xAA)(0xE6, 0x05)(0xF6, 0xF2); // LCDC = $f2 | ((LY ^ d) & 5)
+	a(0xE0, 0x40);
+	const unsigned leaveM0 = a.here();
+	a(0xF0, 0x41)(0xE6, 0x03);
+	a.jrBack(0x28, leaveM0);                     // jr z: wait for mode 0 to end
+	a.jrBack(0x18, line);
+
+	a.land(toVblank);
+	a(0x14)(0x7A)(0xE0, 0x42);                   // inc d; SCY = d
+	a(0xE6, 0x7F)(0xC6, 0x07)(0xE0, 0x4B);       // WX = (d & $7f) + 7
+	a(0x3E, 0x20)(0xE0, 0x00)(0xF0, 0x00);       // read the d-pad
+	a(0xE6, 0x0F)(0xAA)(0xE0, 0x47);             // BGP = buttons ^ d
+	a(0x21, 0x01, 0xFE)(0x06, 8);                // ld hl,$fe01; ld b,8
+	const unsigned move = a.here();
+	a(0x34)(0x2C)(0x2C)(0x2C)(0x2C)(0x05);       // inc (hl); l += 4; dec b
+	a.jrBack(0x20, move);
+	const unsigned waitLy0 = a.here();
+	a(0xF0, 0x44)(0xB7);                         // ldh a,(LY); or a
+	a.jrBack(0x20, waitLy0);
+	a.jrBack(0x18, line);
+
+	return rom;
+}
+
+unsigned input;
+unsigned cgbLut[32768];
+
+unsigned getInput() {
+	return input;
+}
+
+// collects the savestate field by field
+class Fields : public gambatte::NewState {
+public:
+	std::vector<std::string> names;
+	std::vector<std::vector<char> > data;
+
+	virtual void Save(const void *ptr, size_t size, const char *name) {
+		names.push_back(name);
+		data.push_back(std::vector<char>(static_cast<const char *>(ptr), static_cast<const char *>(ptr) + size));
+	}
+
+	virtual void Load(void *, size_t, const char *) {}
+};
+
+Fields fields(gambatte::GB &gb) {
+	Fields f;
+	gb.SyncState<false>(&f);
+	return f;
+}
+
+unsigned long long fnv(unsigned long long h, const void *data, size_t size) {
+	const unsigned char *p = static_cast<const unsigned char *>(data);
+
+	for (size_t i = 0; i < size; ++i)
+		h = (h ^ p[i]) * 0x100000001B3ULL;
+
+	return h;
+}
+
+// returns the first field other than the frame buffer that differs, or 0
+const char * compare(const Fields &a, const Fields &b) {
+	if (a.names.size() != b.names.size())
+		return "(field count)";
+
+	for (size_t i = 0; i < a.names.size(); ++i) {
+		if (a.names[i] != b.names[i])
+			return a.names[i].c_str();
+		if (a.names[i] != "p_->vbuff" && a.data[i] != b.data[i])
+			return a.names[i].c_str();
+	}
+
+	return 0;
+}
+
+int check(const std::vector<unsigned char> &rom, const char *model, unsigned flags) {
+	gambatte::GB on, off, toggled;
+	gambatte::GB *const gbs[] = { &on, &off, &toggled };
+	static gambatte::uint_least32_t soundBuf[(SAMPLES + 2064) * 2];
+	static gambatte::uint_least32_t frame[160 * 144];
+	static gambatte::uint_least32_t offFrame[160 * 144];
+	unsigned long long h = 0xCBF29CE484222325ULL;
+	int frames = 0;
+
+	for (int i = 0; i < 3; ++i) {
+		if (gbs[i]->load(reinterpret_cast<const char *>(&rom[0]), rom.size(), 0, flags)) {
+			std::printf("%s: load failed\n", model);
+			return 1;
+		}
+
+		gbs[i]->setInputGetter(getInput);
+		gbs[i]->setCgbPalette(cgbLut);
+	}
+
+	off.setVideoEnabled(false);
+	off.blitTo(offFrame, 160);
+
+	for (int n = 0; n < FRAMES; ++n) {
+		input = n * 0x35 >> 2 & 0xFF;
+		toggled.setVideoEnabled(n & 1);
+		long ret = 0;
+
+		for (int i = 0; i < 3; ++i) {
+			unsigned samples = SAMPLES;
+			const long r = gbs[i]->runFor(soundBuf, samples);
+
+			if (i == 0) {
+				ret = r;
+				h = fnv(h, &samples, sizeof samples);
+				h = fnv(h, soundBuf, samples * sizeof *soundBuf);
+			} else if (r != ret) {
+				std::printf("%s: call %d: runFor returned %ld with video off, %ld with video on\n", model, n, r, ret);
+				return 1;
+			}
+		}
+
+		if (ret >= 0) {
+			on.blitTo(frame, 160);
+			h = fnv(h, frame, sizeof frame);
+			++frames;
+		}
+
+		const Fields ref = fields(on);
+
+		for (size_t i = 0; i < ref.names.size(); ++i)
+			h = fnv(h, &ref.data[i][0], ref.data[i].size());
+
+		for (int i = 1; i < 3; ++i) {
+			if (const char *const name = compare(ref, fields(*gbs[i]))) {
+				std::printf("%s: call %d: %s differs from the video-on state (%s)\n",
+				            model, n, name, i == 1 ? "video off" : "video toggled");
+				return 1;
+			}
+		}
+	}
+
+	off.blitTo(frame, 160);
+
+	if (std::memcmp(frame, offFrame, sizeof frame)) {
+		std::printf("%s: frame buffer written with video off\n", model);
+		return 1;
+	}
+
+	std::printf("%s %d frames %016llx\n", model, frames, h);
+	return 0;
+}
+
+void bench(const std::vector<unsigned char> &rom, const char *model, unsigned flags) {
+	static gambatte::uint_least32_t soundBuf[(SAMPLES + 2064) * 2];
+
+	for (int video = 1; video >= 0; --video) {
+		gambatte::GB gb;
+		gb.load(reinterpret_cast<const char *>(&rom[0]), rom.size(), 0, flags);
+		gb.setInputGetter(getInput);
+		gb.setCgbPalette(cgbLut);
+		gb.setVideoEnabled(video);
+
+		const std::clock_t start = std::clock();
+
+		for (int n = 0; n < FRAMES * 10; ++n) {
+			unsigned samples = SAMPLES;
+			gb.runFor(soundBuf, samples);
+		}
+
+		const double us = (std::clock() - start) * 1e6 / CLOCKS_PER_SEC / (FRAMES * 10);
+		std::fprintf(stderr, "%s video %-3s %8.1f us/frame\n", model, video ? "on" : "off", us);
+	}
+}
+
+}
+
+int main(int argc, char **argv) {
+	const std::vector<unsigned char> rom = makeRom();
+
+	for (unsigned i = 0; i < 32768; ++i)
+		cgbLut[i] = (i & 0x1F) << 19 | (i >> 5 & 0x1F) << 11 | (i >> 10) << 3;
+
+	if (argc > 1 && !std::strcmp(argv[1], "-bench")) {
+		bench(rom, "dmg", gambatte::GB::FORCE_DMG);
+		bench(rom, "cgb", 0);
+		return 0;
+	}
+
+	return check(rom, "dmg", gambatte::GB::FORCE_DMG) | check(rom, "cgb", 0);
+}
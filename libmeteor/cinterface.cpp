@@ -2,72 +2,97 @@
 #include "ameteor/cartmem.hpp"
 #include "source/debug.hpp"
 #include <sstream>
+#include <cstring>
 
 #define EXPORT extern "C" __declspec(dllexport)
 
-void (*messagecallback)(const char *msg, int abort) = NULL;
+// one emulated GBA and everything the frontend attached to it
+struct Meteor
+{
+	AMeteor::Context *ctx;
+
+	void (*messagecallback)(const char *msg, int abort);
+	uint16_t (*keycallback)();
+	void (*tracecallback)(const char *msg);
+	void (*slcallback)();
+
+	uint32_t *videobuff;
+	int16_t *soundbuff;
+	int16_t *soundbuffcur;
+	int16_t *soundbuffend;
+};
+
+// the core reports back through these without knowing which instance it is
+// running, so everything goes through the context of the calling thread
+static Meteor *current()
+{
+	return AMeteor::_context ? (Meteor *)AMeteor::_context->userdata : NULL;
+}
+
+static void enter(Meteor *m)
+{
+	AMeteor::_context = m->ctx;
+}
 
-EXPORT void libmeteor_setmessagecallback(void (*callback)(const char *msg, int abort))
+EXPORT void libmeteor_setmessagecallback(Meteor *m, void (*callback)(const char *msg, int abort))
 {
-	messagecallback = callback;
+	enter(m);
+	m->messagecallback = callback;
 	print_bizhawk("libmeteor message stream operational.");
 }
 
 void print_bizhawk(const char *msg)
 {
-	if (messagecallback)
-		messagecallback(msg, 0);
+	Meteor *m = current();
+	if (m && m->messagecallback)
+		m->messagecallback(msg, 0);
 }
 void print_bizhawk(std::string &msg)
 {
-	if (messagecallback)
-		messagecallback(msg.c_str(), 0);
+	print_bizhawk(msg.c_str());
 }
 void abort_bizhawk(const char *msg)
 {
-	if (messagecallback)
-		messagecallback(msg, 1);
+	Meteor *m = current();
+	if (m && m->messagecallback)
+		m->messagecallback(msg, 1);
 	AMeteor::Stop(); // makes it easy to pick apart what happened
 }
 
-uint16_t (*keycallback)() = NULL;
-
 void keyupdate_bizhawk()
 {
-	if (keycallback)
-		AMeteor::_keypad.SetPadState(keycallback() ^ 0x3FF);
+	Meteor *m = current();
+	if (m && m->keycallback)
+		m->ctx->keypad.SetPadState(m->keycallback() ^ 0x3FF);
 }
 
-EXPORT void libmeteor_setkeycallback(uint16_t (*callback)())
+EXPORT void libmeteor_setkeycallback(Meteor *m, uint16_t (*callback)())
 {
-	keycallback = callback;
+	m->keycallback = callback;
 }
 
-bool traceenabled = false;
-void (*tracecallback)(const char *msg) = NULL;
-
-EXPORT void libmeteor_settracecallback(void (*callback)(const char*msg))
+EXPORT void libmeteor_settracecallback(Meteor *m, void (*callback)(const char*msg))
 {
-	tracecallback = callback;
-	traceenabled = tracecallback != NULL;
+	m->tracecallback = callback;
+	m->ctx->traceenabled = callback != NULL;
 }
 
 void trace_bizhawk(std::string msg)
 {
-	if (tracecallback)
-		tracecallback(msg.c_str());
+	Meteor *m = current();
+	if (m && m->tracecallback)
+		m->tracecallback(msg.c_str());
 }
 
-EXPORT void libmeteor_hardreset()
+EXPORT void libmeteor_hardreset(Meteor *m)
 {
+	enter(m);
 	AMeteor::Reset(AMeteor::UNIT_ALL ^ (AMeteor::UNIT_MEMORY_BIOS | AMeteor::UNIT_MEMORY_ROM));
 }
 
-uint32_t *videobuff;
-
 void videocb(const uint16_t *frame)
 {
-	uint32_t *dest = videobuff;
+	uint32_t *dest = current()->videobuff;
 	const uint16_t *src = frame;
 	for (int i = 0; i < 240 * 160; i++, src++, dest++)
 	{
@@ -83,105 +108,122 @@ void videocb(const uint16_t *frame)
 	AMeteor::Stop(); // to the end of frame only
 }
 
-int16_t *soundbuff;
-int16_t *soundbuffcur;
-int16_t *soundbuffend;
-
 void soundcb(const int16_t *samples)
 {
-	if (soundbuffcur < soundbuffend)
+	Meteor *m = current();
+	if (m->soundbuffcur < m->soundbuffend)
 	{
-		*soundbuffcur++ = *samples++;
-		*soundbuffcur++ = *samples++;
+		*m->soundbuffcur++ = *samples++;
+		*m->soundbuffcur++ = *samples++;
 	}
 }
 
-EXPORT unsigned libmeteor_emptysound()
+EXPORT unsigned libmeteor_emptysound(Meteor *m)
 {
-	unsigned ret = (soundbuffcur - soundbuff) * sizeof(int16_t);
-	soundbuffcur = soundbuff;
+	unsigned ret = (m->soundbuffcur - m->soundbuff) * sizeof(int16_t);
+	m->soundbuffcur = m->soundbuff;
 	return ret;
 }
 
-EXPORT int libmeteor_setbuffers(uint32_t *vid, unsigned vidlen, int16_t *aud, unsigned audlen)
+EXPORT int libmeteor_setbuffers(Meteor *m, uint32_t *vid, unsigned vidlen, int16_t *aud, unsigned audlen)
 {
 	if (vidlen < 240 * 160 * sizeof(uint32_t))
 		return 0;
 	if (audlen < 4 || audlen % 4 != 0)
 		return 0;
-	videobuff = vid;
-	soundbuff = aud;
-	soundbuffend = soundbuff + audlen / sizeof(int16_t);
-	libmeteor_emptysound();
+	m->videobuff = vid;
+	m->soundbuff = aud;
+	m->soundbuffend = m->soundbuff + audlen / sizeof(int16_t);
+	libmeteor_emptysound(m);
 	return 1;
 }
 
-EXPORT void libmeteor_init()
+EXPORT Meteor *libmeteor_create()
 {
-	static bool first = true;
-	if (first)
-	{
-		AMeteor::_lcd.GetScreen().GetRenderer().SetFrameSlot(syg::ptr_fun(videocb));
-		AMeteor::_sound.GetSpeaker().SetFrameSlot(syg::ptr_fun(soundcb));
-		first = false;
-	}
+	Meteor *m = new Meteor();
+	m->ctx = AMeteor::CreateContext();
+	m->ctx->userdata = m;
+	m->ctx->lcd.GetScreen().GetRenderer().SetFrameSlot(syg::ptr_fun(videocb));
+	m->ctx->sound.GetSpeaker().SetFrameSlot(syg::ptr_fun(soundcb));
+	return m;
 }
 
-EXPORT void libmeteor_frameadvance()
+EXPORT void libmeteor_destroy(Meteor *m)
 {
+	if (!m)
+		return;
+	AMeteor::DestroyContext(m->ctx);
+	delete m;
+}
+
+EXPORT void libmeteor_frameadvance(Meteor *m)
+{
+	enter(m);
 	AMeteor::Run(10000000);
 }
 
-EXPORT void libmeteor_loadrom(const void *data, unsigned size)
+EXPORT void libmeteor_loadrom(Meteor *m, const void *data, unsigned size)
 {
-	AMeteor::_memory.LoadRom((const uint8_t*)data, size);
+	enter(m);
+	m->ctx->memory.LoadRom((const uint8_t*)data, size);
 }
 
-EXPORT void libmeteor_loadbios(const void *data, unsigned size)
+EXPORT void libmeteor_loadbios(Meteor *m, const void *data, unsigned size)
 {
-	AMeteor::_memory.LoadBios((const uint8_t*)data, size);
+	enter(m);
+	m->ctx->memory.LoadBios((const uint8_t*)data, size);
 }
 
-EXPORT uint8_t *libmeteor_getmemoryarea(int which)
+EXPORT uint8_t *libmeteor_getmemoryarea(Meteor *m, int which)
 {
 	if (which < 7)
-		return AMeteor::_memory.GetMemoryArea(which);
+		return m->ctx->memory.GetMemoryArea(which);
 	else if (which == 7)
-		return AMeteor::_io.GetIoPointer();
+		return m->ctx->io.GetIoPointer();
 	else
 		return NULL;
 }
 
-EXPORT int libmeteor_loadsaveram(const void *data, unsigned size)
+EXPORT int libmeteor_loadsaveram(Meteor *m, const void *data, unsigned size)
 {
-	return AMeteor::_memory.LoadCart((const uint8_t*)data, size);
+	enter(m);
+	return m->ctx->memory.LoadCart((const uint8_t*)data, size);
 }
 
-EXPORT int libmeteor_savesaveram(void **data, unsigned *size)
+EXPORT int libmeteor_savesaveram(Meteor *m, void **data, unsigned *size)
 {
-	return AMeteor::_memory.SaveCart((uint8_t **)data, size);
+	enter(m);
+	return m->ctx->memory.SaveCart((uint8_t **)data, size);
 }
 
-EXPORT void libmeteor_savesaveram_destroy(void *data)
+EXPORT void libmeteor_savesaveram_destroy(Meteor *m, void *data)
 {
-	AMeteor::_memory.SaveCartDestroy((uint8_t *)data);
+	m->ctx->memory.SaveCartDestroy((uint8_t *)data);
 }
 
-EXPORT int libmeteor_hassaveram()
+EXPORT int libmeteor_saveramdirect(Meteor *m, const void **data, unsigned *size, unsigned *generation)
+{
+	*generation = m->ctx->memory.GetCartGeneration();
+	return m->ctx->memory.GetCart((const uint8_t **)data, size);
+}
+
+EXPORT int libmeteor_hassaveram(Meteor *m)
 {
-	return AMeteor::_memory.HasCart();
+	return m->ctx->memory.HasCart();
 }
 
-EXPORT void libmeteor_clearsaveram()
+EXPORT void libmeteor_clearsaveram(Meteor *m)
 {
-	AMeteor::_memory.DeleteCart();
+	enter(m);
+	m->ctx->memory.DeleteCart();
 }
 
-EXPORT int libmeteor_savestate(void **data, unsigned *size)
+EXPORT int libmeteor_savestate(Meteor *m, void **data, unsigned *size)
 {
 	if (!data || !size)
 		return 0;
 
+	enter(m);
 	std::ostringstream ss = std::ostringstream(std::ios_base::binary);
 	AMeteor::SaveState(ss);
 
@@ -201,46 +243,48 @@ EXPORT void libmeteor_savestate_destroy(void *data)
 	std::free(data);
 }
 
-EXPORT int libmeteor_loadstate(const void *data, unsigned size)
+EXPORT int libmeteor_loadstate(Meteor *m, const void *data, unsigned size)
 {
+	enter(m);
 	std::istringstream ss = std::istringstream(std::string((const char*)data, size), std::ios_base::binary);
 	return AMeteor::LoadState(ss);
 }
 
 // TODO: cartram memory domain, cartram in system bus memory domain
-EXPORT uint8_t libmeteor_peekbus(uint32_t addr)
+EXPORT uint8_t libmeteor_peekbus(Meteor *m, uint32_t addr)
 {
-	return AMeteor::_memory.Peek8(addr);
+	enter(m);
+	return m->ctx->memory.Peek8(addr);
 }
 
-EXPORT void libmeteor_writebus(uint32_t addr, uint8_t val)
+EXPORT void libmeteor_writebus(Meteor *m, uint32_t addr, uint8_t val)
 {
-	AMeteor::_memory.Write8(addr, val);
+	enter(m);
+	m->ctx->memory.Write8(addr, val);
 }
 
-int slcallbackline = 400;
-void (*slcallback)() = NULL;
-
-EXPORT void libmeteor_setscanlinecallback(void (*callback)(), int scanline)
+EXPORT void libmeteor_setscanlinecallback(Meteor *m, void (*callback)(), int scanline)
 {
 	if (!callback)
-		slcallbackline = 400;
+		m->ctx->slcallbackline = 400;
 	else
-		slcallbackline = scanline;
-	slcallback = callback;
+		m->ctx->slcallbackline = scanline;
+	m->slcallback = callback;
 }
 
 void scanlinecallback_bizhawk()
 {
-	if (slcallback)
-		slcallback();
+	Meteor *m = current();
+	if (m && m->slcallback)
+		m->slcallback();
 }
 
-EXPORT void libmeteor_getregs(int *dest)
+EXPORT void libmeteor_getregs(Meteor *m, int *dest)
 {
-	AMeteor::_cpu.UpdateCpsr();	
+	AMeteor::Interpreter &cpu = m->ctx->cpu;
+	cpu.UpdateCpsr();
 	for (int i = 0; i < 16; i++)
-		dest[i] = AMeteor::_cpu.Reg(i);
-	dest[16] = AMeteor::_cpu.Cpsr().dw;
-	dest[17] = AMeteor::_cpu.Spsr().dw;
+		dest[i] = cpu.Reg(i);
+	dest[16] = cpu.Cpsr().dw;
+	dest[17] = cpu.Spsr().dw;
 }
@@ -29,18 +29,58 @@
 
 namespace AMeteor
 {
-	extern Clock _clock;
-	extern Io _io;
-	extern Interpreter _cpu;
-	extern Memory _memory;
-	extern Dma _dma;
-	extern Lcd _lcd;
-	extern Sound _sound;
-	extern Keypad _keypad;
-	extern Timer _timer0;
-	extern Timer _timer1;
-	extern Timer _timer2;
-	extern Timer _timer3;
+	// All the state of one emulated GBA.  The components find each other
+	// through _context, which is per thread, so several contexts can run at
+	// the same time as long as each one stays on the thread that selected it.
+	class Context
+	{
+		public :
+			Context ();
+
+			// the clock must be initialized first since there are devices like
+			// lcd which needs to set the timer
+			Clock clock;
+			Io io;
+			// the interpreter (which is in the cpu) takes io addresses, thus the
+			// cpu must be initialized after io
+			Interpreter cpu;
+			Memory memory;
+			Dma dma;
+			// the lcd must be initialized after the memory since it takes
+			// pointers from it
+			Lcd lcd;
+			// the sound must be initialized after the io since it takes
+			// references from it
+			Sound sound;
+			// the keypad needs to take the vblank event from lcd, so it must be
+			// initialized after lcd
+			// it must also be initialized after io since it takes the keyinput
+			// reference
+			Keypad keypad;
+			Timer timer3;
+			Timer timer2;
+			Timer timer1;
+			Timer timer0;
+
+			// frontend hooks, owned by cinterface.cpp
+			bool traceenabled;
+			int slcallbackline;
+			void* userdata;
+	};
+
+#ifdef _MSC_VER
+#define AMETEOR_THREAD __declspec(thread)
+#else
+#define AMETEOR_THREAD __thread
+#endif
+
+	// the context the calling thread works on
+	extern AMETEOR_THREAD Context* _context;
+
+	// the components use _context while they are constructed, so contexts
+	// must be created through these and not with new
+	Context* CreateContext ();
+	void DestroyContext (Context* ctx);
 
 	const uint32_t UNIT_CLOCK  = 0x0001;
 	const uint32_t UNIT_IO     = 0x0002;
@@ -68,12 +108,12 @@ namespace AMeteor
 
 	inline void Run (unsigned int cycles)
 	{
-		_cpu.Run(cycles);
+		_context->cpu.Run(cycles);
 	}
 
 	inline void Stop ()
 	{
-		_cpu.Stop();
+		_context->cpu.Stop();
 	}
 }
 
@@ -44,6 +44,16 @@ namespace AMeteor
 			virtual bool SaveState (std::ostream& stream);
 			virtual bool LoadState (std::istream& stream);
 
+			// what Save() writes, in place
+			const uint8_t* GetData () const
+			{
+				return m_data;
+			}
+			uint32_t GetDataSize () const
+			{
+				return m_size;
+			}
+
 		protected:
 			uint8_t* m_data;
 			uint32_t m_size;
@@ -22,6 +22,7 @@
 #include "eeprom.hpp"
 
 #include <stdint.h>
+#include <memory>
 #include <string>
 #include <istream>
 #include <ostream>
@@ -89,6 +90,13 @@ namespace AMeteor
 			bool LoadCart (const uint8_t* data, uint32_t size);
 			bool SaveCart (uint8_t** data, uint32_t* size);
 			void SaveCartDestroy(uint8_t* data);
+			// SaveCart() without the copy; the generation changes whenever
+			// the cart memory may have been written
+			bool GetCart (const uint8_t** data, uint32_t* size) const;
+			uint32_t GetCartGeneration () const
+			{
+				return m_cartGeneration;
+			}
 #ifdef __LIBRETRO__
 			bool LoadCartInferred ();
 #endif
@@ -149,9 +157,11 @@ namespace AMeteor
 			uint8_t* m_oram;  // OAM - OBJ Attributes
 			// External Memory (Game Pak)
 			uint8_t* m_rom;   // Game Pake ROM/FlashROM (max 32MB)
+			std::shared_ptr<uint8_t> m_romOwner;
 
 			uint8_t m_carttype;
 			CartMem* m_cart;
+			uint32_t m_cartGeneration;
 			//std::string m_cartfile;
 
 			uint8_t ReadCart (uint16_t add);
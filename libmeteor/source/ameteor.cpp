@@ -19,6 +19,7 @@
 #include "globals.hpp"
 #include <cstring>
 #include <sstream>
+#include <new>
 
 // TODO add version
 #define SS_MAGIC_STRING ("AMeteor SaveState")
@@ -38,36 +39,49 @@ namespace AMeteor
 		} __ameteor;
 	}
 
-	// the clock must be initialized first since there are devices like
-	// lcd which needs to set the timer
-	Clock _clock;
-	Io _io;
-	// the interpreter (which is in the cpu) takes io addresses, thus the
-	// cpu must be initialized after io
-	Interpreter _cpu;
-	Memory _memory;
-	Dma _dma;
-	// the lcd must be initialized after the memory since it takes
-	// pointers from it
-	Lcd _lcd;
-	// the sound must be initialized after the io since it takes references
-	// from it
-	Sound _sound;
-	// the keypad needs to take the vblank event from lcd, so it must be
-	// initialized after lcd
-	// it must also be initialized after io since it takes the keyinput
-	// reference
-	Keypad _keypad;
-	Timer _timer3(3, NULL);
-	Timer _timer2(2, &_timer3);
-	Timer _timer1(1, &_timer2);
-	Timer _timer0(0, &_timer1);
+	AMETEOR_THREAD Context* _context = NULL;
+
+	Context::Context () :
+		timer3(3, NULL),
+		timer2(2, &timer3),
+		timer1(1, &timer2),
+		timer0(0, &timer1),
+		traceenabled(false),
+		slcallbackline(400),
+		userdata(NULL)
+	{
+	}
+
+	Context* CreateContext ()
+	{
+		Context* prev = _context;
+		void* mem = ::operator new(sizeof(Context));
+		// the components were written as globals and some of them count on
+		// their members starting out zeroed like static storage does
+		std::memset(mem, 0, sizeof(Context));
+		_context = static_cast<Context*>(mem);
+		new (mem) Context();
+		Context* ctx = _context;
+		_context = prev;
+		return ctx;
+	}
+
+	void DestroyContext (Context* ctx)
+	{
+		if (!ctx)
+			return;
+		Context* prev = _context;
+		_context = ctx;
+		ctx->~Context();
+		::operator delete(ctx);
+		_context = prev == ctx ? NULL : prev;
+	}
 
 	void Reset (uint32_t units)
 	{
 #define RESET(u, e) \
 	if (units & UNIT_##e) \
-		_##u.Reset();
+		_context->u.Reset();
 		RESET(clock, CLOCK);
 		RESET(io, IO);
 		RESET(cpu, CPU);
@@ -81,12 +95,12 @@ namespace AMeteor
 		RESET(timer3, TIMER3);
 #undef RESET
 		if (units & UNIT_MEMORY)
-			_memory.Reset(units);
+			_context->memory.Reset(units);
 	}
 
 	bool SaveState (const char* filename)
 	{
-		if (_cpu.IsRunning())
+		if (_context->cpu.IsRunning())
 			return false;
 
 		std::ostringstream ss;
@@ -112,7 +126,7 @@ namespace AMeteor
 
 	bool LoadState (const char* filename)
 	{
-		if (_cpu.IsRunning())
+		if (_context->cpu.IsRunning())
 			return false;
 
 		std::istringstream ss;
@@ -139,7 +153,7 @@ namespace AMeteor
 
 	bool SaveState (std::ostream& stream)
 	{
-		if (_cpu.IsRunning())
+		if (_context->cpu.IsRunning())
 			return false;
 
 		SS_WRITE_DATA(SS_MAGIC_STRING, SS_MS_SIZE);
@@ -147,18 +161,18 @@ namespace AMeteor
 #define SAVE(dev) \
 	if (!dev.SaveState(stream)) \
 		return false
-		SAVE(_clock);
-		SAVE(_io);
-		SAVE(_cpu);
-		SAVE(_memory);
-		SAVE(_dma);
-		SAVE(_lcd);
-		SAVE(_sound);
-		//SAVE(_keypad);
-		SAVE(_timer0);
-		SAVE(_timer1);
-		SAVE(_timer2);
-		SAVE(_timer3);
+		SAVE(_context->clock);
+		SAVE(_context->io);
+		SAVE(_context->cpu);
+		SAVE(_context->memory);
+		SAVE(_context->dma);
+		SAVE(_context->lcd);
+		SAVE(_context->sound);
+		//SAVE(_context->keypad);
+		SAVE(_context->timer0);
+		SAVE(_context->timer1);
+		SAVE(_context->timer2);
+		SAVE(_context->timer3);
 #undef SAVE
 
 		return true;
@@ -166,7 +180,7 @@ namespace AMeteor
 
 	bool LoadState (std::istream& stream)
 	{
-		if (_cpu.IsRunning())
+		if (_context->cpu.IsRunning())
 			return false;
 
 		{
@@ -180,18 +194,18 @@ namespace AMeteor
 #define LOAD(dev) \
 	if (!dev.LoadState(stream)) \
 		return false
-		LOAD(_clock);
-		LOAD(_io);
-		LOAD(_cpu);
-		LOAD(_memory);
-		LOAD(_dma);
-		LOAD(_lcd);
-		LOAD(_sound);
-		//LOAD(_keypad);
-		LOAD(_timer0);
-		LOAD(_timer1);
-		LOAD(_timer2);
-		LOAD(_timer3);
+		LOAD(_context->clock);
+		LOAD(_context->io);
+		LOAD(_context->cpu);
+		LOAD(_context->memory);
+		LOAD(_context->dma);
+		LOAD(_context->lcd);
+		LOAD(_context->sound);
+		//LOAD(_context->keypad);
+		LOAD(_context->timer0);
+		LOAD(_context->timer1);
+		LOAD(_context->timer2);
+		LOAD(_context->timer3);
 #undef LOAD
 
 		uint8_t xxx;
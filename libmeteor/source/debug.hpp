@@ -30,9 +30,7 @@ void print_bizhawk(const char *msg);
 void print_bizhawk(std::string &msg);
 void abort_bizhawk(const char *msg);
 void keyupdate_bizhawk();
-extern bool traceenabled;
 void trace_bizhawk(std::string msg);
-extern int slcallbackline;
 void scanlinecallback_bizhawk();
 
 #if 0
@@ -40,9 +38,9 @@ void scanlinecallback_bizhawk();
 	{ \
 		std::cerr << IOS_NOR << "Fatal error :\n" << str << "\nFile : " \
 		<< __FILE__ << "\nLine : " << __LINE__ << "\nr15 = " \
-		<< IOS_ADD << ::AMeteor::_cpu.Reg(15) << "\n[r15] = " << IOS_ADD \
-		<< ::AMeteor::_memory.Read32(::AMeteor::_cpu.Reg(15)) \
-		<< "\nFlag T : " << ::AMeteor::_cpu.ICpsr().thumb << std::endl; \
+		<< IOS_ADD << ::AMeteor::_context->cpu.Reg(15) << "\n[r15] = " << IOS_ADD \
+		<< ::AMeteor::_context->memory.Read32(::AMeteor::_context->cpu.Reg(15)) \
+		<< "\nFlag T : " << ::AMeteor::_context->cpu.ICpsr().thumb << std::endl; \
 		abort(); \
 	}
 #endif
@@ -54,9 +52,9 @@ void scanlinecallback_bizhawk();
 		std::stringstream _zisrny; \
 		_zisrny << IOS_NOR << "Fatal error :\n" << _str << "\nFile : " \
 		<< __FILE__ << "\nLine : " << __LINE__ << "\nr15 = " \
-		<< IOS_ADD << ::AMeteor::_cpu.Reg(15) << "\n[r15] = " << IOS_ADD \
-		<< ::AMeteor::_memory.Read32(::AMeteor::_cpu.Reg(15)) \
-		<< "\nFlag T : " << ::AMeteor::_cpu.ICpsr().thumb << std::endl; \
+		<< IOS_ADD << ::AMeteor::_context->cpu.Reg(15) << "\n[r15] = " << IOS_ADD \
+		<< ::AMeteor::_context->memory.Read32(::AMeteor::_context->cpu.Reg(15)) \
+		<< "\nFlag T : " << ::AMeteor::_context->cpu.ICpsr().thumb << std::endl; \
 		abort_bizhawk(_zisrny.str().c_str()); \
 	}
 
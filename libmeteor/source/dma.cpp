@@ -153,7 +153,7 @@ namespace AMeteor
 				<< " to " << IOS_ADD << chan.dest
 				<< " of " << IOS_NOR << (chan.count ? chan.count : 0x10000)
 				<< (chan.control.b.type ? " words" : " halfwords"));
-		if (traceenabled)
+		if (_context->traceenabled)
 		{
 			std::stringstream ss;
 			ss << "DMA" << IOS_NOR << (int)channum << ", from " << IOS_ADD << chan.src
@@ -25,18 +25,18 @@
 
 #define R(reg) CPU.Reg(reg)
 
-#define CPU    _cpu
-#define MEM    _memory
-#define IO     _io
-#define DMA    _dma
-#define LCD    _lcd
-#define SOUND  _sound
-#define KEYPAD _keypad
-#define CLOCK  _clock
-#define TIMER0 _timer0
-#define TIMER1 _timer1
-#define TIMER2 _timer2
-#define TIMER3 _timer3
+#define CPU    (_context->cpu)
+#define MEM    (_context->memory)
+#define IO     (_context->io)
+#define DMA    (_context->dma)
+#define LCD    (_context->lcd)
+#define SOUND  (_context->sound)
+#define KEYPAD (_context->keypad)
+#define CLOCK  (_context->clock)
+#define TIMER0 (_context->timer0)
+#define TIMER1 (_context->timer1)
+#define TIMER2 (_context->timer2)
+#define TIMER3 (_context->timer3)
 
 #define CYCLES16NSeq(add, count) \
 	CLOCK.TimePass(MEM.GetCycles16NoSeq(add, count))
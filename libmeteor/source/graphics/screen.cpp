@@ -32,7 +32,7 @@ namespace AMeteor
 		// TODO there is no more need to pass theses references
 		Screen::Screen (Memory& memory, Io& io) :
 			m_io(io),
-			m_surface(new uint16_t[WIDTH*HEIGHT]),
+			m_surface(new uint16_t[WIDTH*HEIGHT]()),
 			m_renderer(m_surface),
 			m_frameskip(0),
 			m_curframe(0),
@@ -71,7 +71,7 @@ namespace AMeteor
 							met_abort("PC not 16 bit aligned : " << IOS_ADD << R(15));
 
 						code = MEM.Read16(R(15)-2);
-						if (traceenabled)
+						if (_context->traceenabled)
 						{
 							std::stringstream ss;
 							ss << IOS_TRACE << R(15) - 2 << ':' << std::setw(4) << code << "     ";
@@ -123,7 +123,7 @@ namespace AMeteor
 						else
 						{
 							code = MEM.Read32(R(15)-4);
-							if (traceenabled)
+							if (_context->traceenabled)
 							{
 								std::stringstream ss;
 								ss << IOS_TRACE << R(15) - 4 << ':' << std::setw(8) << code << ' ';
@@ -23,9 +23,12 @@
 #include "ameteor.hpp"
 
 #include "debug.hpp"
+#include "romimage.h"
 
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <vector>
 #include <sstream>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -45,14 +48,15 @@ namespace AMeteor
 	Memory::Memory () :
 		m_brom(NULL),
 		m_carttype(CTYPE_UNKNOWN),
-		m_cart(NULL)
+		m_cart(NULL),
+		m_cartGeneration(0)
 	{
 		m_wbram = new uint8_t[0x00040000];
 		m_wcram = new uint8_t[0x00008000];
 		m_pram  = new uint8_t[0x00000400];
 		m_vram  = new uint8_t[0x00018000];
 		m_oram  = new uint8_t[0x00000400];
-		m_rom   = new uint8_t[0x02000000];
+		m_rom   = NULL;
 
 		Reset();
 	}
@@ -66,7 +70,6 @@ namespace AMeteor
 		delete [] m_pram;
 		delete [] m_vram;
 		delete [] m_oram;
-		delete [] m_rom;
 		if (m_cart)
 			delete m_cart;
 	}
@@ -101,6 +104,7 @@ namespace AMeteor
 		if (m_cart)
 			delete m_cart;
 		m_cart = NULL;
+		++m_cartGeneration;
 		print_bizhawk("Cart Memory unloaded.\n");
 	}
 
@@ -144,6 +148,7 @@ namespace AMeteor
 				break;
 		}
 		m_carttype = type;
+		++m_cartGeneration;
 	}
 
 	void Memory::Reset (uint32_t params)
@@ -185,7 +190,7 @@ namespace AMeteor
 		std::memset(m_vram , 0, 0x00018000);
 		std::memset(m_oram , 0, 0x00000400);
 		if (params & UNIT_MEMORY_ROM)
-			std::memset(m_rom  , 0, 0x02000000);
+			LoadRom(NULL, 0);
 		SetCartType(CTYPE_UNKNOWN);
 		//m_cartfile.clear();
 	}
@@ -258,18 +263,28 @@ namespace AMeteor
 	bool Memory::LoadRom (const char* filename)
 	{
 		std::ifstream file(filename);
-		std::memset(m_rom, 0, 0x02000000);
-		file.read((char*)m_rom, 0x02000000);
+		std::vector<char> data(0x02000000);
+		file.read(&data[0], data.size());
 		if (file.bad())
 			return false;
+		LoadRom((const uint8_t*)&data[0], file.gcount());
 		return true;
 	}
 
+	// the rom is read only and shared with every other instance that loads
+	// the same one; no rom at all is a shared blank image
 	void Memory::LoadRom (const uint8_t* data, uint32_t size)
 	{
 		uint32_t until = std::min(size, 0x02000000u);
-		std::memcpy(m_rom, data, until);
-		std::memset(m_rom+until, 0, 0x02000000-until);
+		m_romOwner = romimage::Registry::acquire(data, until, 0, 0x02000000,
+				[&](uint8_t* rom)
+				{
+					if (until)
+						std::memcpy(rom, data, until);
+				});
+		m_rom = m_romOwner.get();
+		if (!m_rom)
+			std::abort(); // out of memory, as new would
 	}
 
 	bool Memory::LoadCart(const uint8_t* data, uint32_t size)
@@ -278,6 +293,7 @@ namespace AMeteor
 		if (!m_cart)
 			return false;
 		std::stringstream ss = std::stringstream(std::string((const char*)data, size), std::ios_base::in | std::ios_base::binary);
+		++m_cartGeneration;
 		return m_cart->Load(ss);
 	}
 
@@ -303,6 +319,17 @@ namespace AMeteor
 		std::free(data);
 	}
 
+	bool Memory::GetCart(const uint8_t** data, uint32_t* size) const
+	{
+		if (!m_cart)
+			return false;
+		if (!data || !size)
+			return false;
+		*data = m_cart->GetData();
+		*size = m_cart->GetDataSize();
+		return true;
+	}
+
 	/*
 	Memory::CartError Memory::LoadCart ()
 	{
@@ -841,7 +868,8 @@ namespace AMeteor
 
 		//if (eeprom->Write((uint16_t*)GetRealAddress(src), size))
 		//	CLOCK.SetBattery(CART_SAVE_TIME);
-		eeprom->Write((uint16_t*)GetRealAddress(src), size);
+		if (eeprom->Write((uint16_t*)GetRealAddress(src), size))
+			++m_cartGeneration;
 	}
 
 #if 0
@@ -897,7 +925,8 @@ namespace AMeteor
 				SetCartType(CTYPE_SRAM);
 		//if (m_cart->Write(add, val))
 		//	CLOCK.SetBattery(CART_SAVE_TIME);
-		m_cart->Write(add, val);
+		if (m_cart->Write(add, val))
+			++m_cartGeneration;
 	}
 
 	uint8_t *Memory::GetMemoryArea(int which)
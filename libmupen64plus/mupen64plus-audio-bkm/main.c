@@ -35,6 +35,12 @@
 
 #include "main.h"
 #include "osal_dynamiclib.h"
+#include "blip_buf.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BKM_SSE2 1
+#endif
 
 /* This sets default frequency what is used if rom doesn't want to change it.
    Probably only game that needs this is Zelda: Ocarina Of Time Master Quest 
@@ -61,9 +67,17 @@ static char* audioBuffer = NULL;
 static size_t bufferBack = 0;
 static size_t bufferSize = 0;
 
+/* Fixed output rate requested by the frontend, or 0 to pass the DAC rate through */
+static int OutputFreq = 0;
+static blip_t* blips[2] = { NULL, NULL };
+static int lastSample[2] = { 0, 0 };
+
 // Prototype of local functions
 static void SetSamplingRate(int freq);
-static void SetBufferSize(size_t size);
+static int SetBufferSize(size_t size);
+static size_t ReserveBuffer(size_t bytes);
+static void CopySwapped(char* dest, const unsigned char* src, unsigned int len);
+static void ResampleToBuffer(const unsigned char* src, unsigned int len);
 
 static int critical_failure = 0;
 
@@ -158,6 +172,14 @@ EXPORT void CALL RomClosed( void )
 		free(audioBuffer);
 		audioBuffer = NULL;
     }
+
+	// the resamplers stay configured for the next rom, but shouldn't carry anything over
+	if (blips[0] != NULL)
+	{
+		blip_clear(blips[0]);
+		blip_clear(blips[1]);
+	}
+	lastSample[0] = lastSample[1] = 0;
 }
 
 EXPORT int CALL InitiateAudio( AUDIO_INFO Audio_Info )
@@ -169,17 +191,36 @@ EXPORT int CALL InitiateAudio( AUDIO_INFO Audio_Info )
     return 1;
 }
 
-static void SetBufferSize(size_t size)
+/* Returns 0, with the old buffer and size kept, if the new buffer can't be allocated */
+static int SetBufferSize(size_t size)
 {
-	char* oldBuffer = audioBuffer;
-	audioBuffer = (char*)malloc(size);
-	if(audioBuffer != NULL)
+	char* newBuffer = (char*)malloc(size);
+	if (newBuffer == NULL)
 	{
-		memcpy(audioBuffer, oldBuffer, min(size, bufferBack));
-		free(oldBuffer);
+		DebugMessage(M64MSG_WARNING, "Couldn't allocate a %u byte audio buffer", (unsigned int)size);
+		return 0;
 	}
-	bufferSize = size;
 	bufferBack = min(size, bufferBack);
+	if (audioBuffer != NULL)
+		memcpy(newBuffer, audioBuffer, bufferBack);
+	free(audioBuffer);
+	audioBuffer = newBuffer;
+	bufferSize = size;
+	return 1;
+}
+
+/* Grows the buffer so that 'bytes' more fit, and returns how many do: all of them unless
+   the buffer couldn't grow, in which case the caller drops the rest */
+static size_t ReserveBuffer(size_t bytes)
+{
+	if (bufferBack + bytes > bufferSize)
+	{
+		size_t size = bufferSize ? bufferSize : DEFAULT_BUFFER_SIZE;
+		while (size < bufferBack + bytes)
+			size *= 2;
+		SetBufferSize(size);
+	}
+	return min(bytes, bufferSize - bufferBack);
 }
 #pragma endregion
 
@@ -251,35 +292,110 @@ EXPORT void CALL AiLenChanged( void )
     if (!l_PluginInit)
         return;
 
-    LenReg = *AudioInfo.AI_LEN_REG;
+    LenReg = *AudioInfo.AI_LEN_REG & ~3u;
     p = AudioInfo.RDRAM + (*AudioInfo.AI_DRAM_ADDR_REG & 0xFFFFFF);
 
-	if (bufferBack + LenReg < bufferSize)
-    {
-        unsigned int i;
+	if (OutputFreq)
+	{
+		ResampleToBuffer(p, LenReg);
+	}
+	else
+	{
+		LenReg = (unsigned int)ReserveBuffer(LenReg) & ~3u;
+		if (LenReg == 0)
+			return;
+		CopySwapped(audioBuffer + bufferBack, p, LenReg);
+		bufferBack += LenReg;
+	}
+}
+
+/* RDRAM holds each stereo sample as a native 32 bit word, right channel in the low half.
+   Output wants left first, so that's a swap of the two halves of every word */
+static void CopySwapped(char* dest, const unsigned char* src, unsigned int len)
+{
+	unsigned int i = 0;
+#ifdef BKM_SSE2
+	for ( ; i + 16 <= len ; i += 16 )
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+		v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+		_mm_storeu_si128((__m128i*)(dest + i), v);
+	}
+#endif
+	for ( ; i < len ; i += 4 )
+	{
+		// Left channel
+		dest[ i ] = src[ i + 2 ];
+		dest[ i + 1 ] = src[ i + 3 ];
 
-        for ( i = 0 ; i < LenReg ; i += 4 )
-        {
-            // Left channel
-			audioBuffer[ bufferBack + i ] = p[ i + 2 ];
-            audioBuffer[ bufferBack + i + 1 ] = p[ i + 3 ];
+		// Right channel
+		dest[ i + 2 ] = src[ i ];
+		dest[ i + 3 ] = src[ i + 1 ];
+	}
+}
 
-            // Right channel
-            audioBuffer[ bufferBack + i + 2 ] = p[ i ];
-            audioBuffer[ bufferBack + i + 3 ] = p[ i + 1 ];
-        }
-        bufferBack += i;
+/* Feeds len bytes of RDRAM samples through the band-limited resamplers, one input sample
+   per blip clock, and appends whatever output that produces to the audio buffer */
+static void ResampleToBuffer(const unsigned char* src, unsigned int len)
+{
+	unsigned int count = len / 4;
+	/* keep each blip frame well under blip_max_frame output samples */
+	unsigned int chunk = (unsigned int)((blip_max_frame / 2) * (double)GameFreq / OutputFreq);
+	if (chunk < 1)
+		chunk = 1;
 
-    }
-    else
-    {
-        DebugMessage(M64MSG_WARNING, "AiLenChanged(): Audio buffer overflow.");
-    }
+	while (count > 0)
+	{
+		unsigned int n = min(count, chunk);
+		unsigned int t;
+		int avail, fit;
+
+		for ( t = 0 ; t < n ; t++ )
+		{
+			int left = (short)(src[ 2 ] | src[ 3 ] << 8);
+			int right = (short)(src[ 0 ] | src[ 1 ] << 8);
+			src += 4;
+
+			if (left != lastSample[0])
+			{
+				blip_add_delta(blips[0], t, left - lastSample[0]);
+				lastSample[0] = left;
+			}
+			if (right != lastSample[1])
+			{
+				blip_add_delta(blips[1], t, right - lastSample[1]);
+				lastSample[1] = right;
+			}
+		}
+		blip_end_frame(blips[0], n);
+		blip_end_frame(blips[1], n);
+		count -= n;
+
+		avail = blip_samples_avail(blips[0]);
+		fit = (int)(ReserveBuffer(avail * N64_SAMPLE_BYTES) / N64_SAMPLE_BYTES);
+		if (fit > 0)
+		{
+			blip_read_samples(blips[0], (short*)(audioBuffer + bufferBack), fit, 1);
+			blip_read_samples(blips[1], (short*)(audioBuffer + bufferBack) + 1, fit, 1);
+			bufferBack += fit * N64_SAMPLE_BYTES;
+		}
+		if (fit < avail)
+		{
+			// out of memory: drop what didn't fit so the resamplers can't overflow
+			blip_clear(blips[0]);
+			blip_clear(blips[1]);
+		}
+	}
 }
 
 static void SetSamplingRate(int freq)
 {
     GameFreq = freq; // This is important for the sync
+	if (blips[0] != NULL)
+	{
+		blip_set_rates(blips[0], GameFreq, OutputFreq);
+		blip_set_rates(blips[1], GameFreq, OutputFreq);
+	}
 }
 #pragma endregion
 
@@ -347,6 +463,23 @@ EXPORT int CALL GetBufferSize()
 /* --- Returns current sampling rate --- */
 EXPORT int CALL GetAudioRate()
 {
-	return GameFreq;
+	return OutputFreq ? OutputFreq : GameFreq;
+}
+
+/* --- Resample everything to a fixed rate from now on; 0 goes back to the DAC rate --- */
+EXPORT void CALL SetOutputRate(int freq)
+{
+	blip_delete(blips[0]);
+	blip_delete(blips[1]);
+	blips[0] = blips[1] = NULL;
+	lastSample[0] = lastSample[1] = 0;
+
+	OutputFreq = freq;
+	if (OutputFreq)
+	{
+		blips[0] = blip_new(blip_max_frame);
+		blips[1] = blip_new(blip_max_frame);
+		SetSamplingRate(GameFreq);
+	}
 }
 #pragma endregion
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <SDL_thread.h>
+#include <zlib.h>
 
 #define M64P_CORE_PROTOTYPES 1
 #include "api/m64p_types.h"
@@ -76,6 +77,80 @@ struct savestate_work {
     struct work_struct work;
 };
 
+/* Size of a bkm/m64p savestate without the event queue, with and without the expansion pak */
+#define BKM_STATE_SIZE 16788288
+#define BKM_STATE_SIZE_NO_EXPANSION (BKM_STATE_SIZE - 0x400000)
+
+/* Largest possible savestates_save_bkm() output; save_eventqueue_infos() fills at most 1024 bytes */
+#define BKM_STATE_MAX_SIZE (BKM_STATE_SIZE + 1024)
+
+/* Compressed bkm states start with this instead of savestate_magic, followed by the inflated
+   and deflated sizes (little endian) and the zlib stream. */
+static const char *bkm_deflate_magic = "M64+BKMZ";
+#define BKM_DEFLATE_HEADER_SIZE 16
+
+/* Everything savestates_save_bkm() writes.  The memory arrays are pointers, so a synchronous save
+   can read them in place while an asynchronous one points them at copies. */
+struct bkm_snapshot {
+    char md5[32];
+    int hasExpansion;
+
+    RDRAM_register rdram_register;
+    mips_register MI_register;
+    PI_register pi_register;
+    SP_register sp_register;
+    RSP_register rsp_register;
+    SI_register si_register;
+    VI_register vi_register;
+    RI_register ri_register;
+    AI_register ai_register;
+    DPC_register dpc_register;
+    DPS_register dps_register;
+
+    const unsigned int *rdram;
+    const unsigned int *sp_dmem;
+    const unsigned int *sp_imem;
+    const unsigned int *pif_ram;
+    const unsigned int *tlb_lut_r;
+    const unsigned int *tlb_lut_w;
+
+    Flashram_info flashram_info;
+
+    unsigned int llbit;
+    long long int reg[32];
+    unsigned int reg_cop0[32];
+    long long int lo, hi;
+    long long int reg_cop1_fgr_64[32];  /* always in 64-bit FGR layout */
+    int FCR0, FCR31;
+    tlb tlb_e[32];
+    unsigned int pc;
+    unsigned int next_interupt, next_vi, vi_field;
+
+    char queue[1024];
+    int queuelength;
+};
+
+/* Bytes needed for the copies of the memory arrays in a bkm_snapshot */
+#define BKM_SNAPSHOT_MEM_SIZE (0x800000 + 0x1000 + 0x1000 + 0x40 + 0x400000 + 0x400000)
+
+/* An asynchronous bkm save: only the snapshot is taken on the emulation thread; writing it out
+   in savestates_save_bkm() format and deflating it happen on the workqueue. */
+struct savestate_bkm_job {
+    struct bkm_snapshot snap;
+    unsigned char *mem; /* memory arrays snap points at; kept for reuse */
+    char *data;         /* written state; kept for reuse */
+    size_t size;
+    char *result;       /* deflated state, or data itself when level == 0 */
+    size_t result_size;
+    int level;
+    int pending;        /* started and not yet collected */
+    int finished;       /* worker done; done has been waited on */
+    SDL_sem *done;
+    struct work_struct work;
+};
+
+static struct savestate_bkm_job bkm_job;
+
 /* Returns the malloc'd full path of the currently selected savestate. */
 static char *savestates_generate_path(savestates_type type)
 {
@@ -474,7 +549,13 @@ static int savestates_load_m64p(char *filepath)
     return 1;
 }
 
-EXPORT int CALL savestates_load_bkm(char * curr)
+/* Size of a bkm state without the event queue for the current expansion pak setting */
+static size_t savestates_bkm_size(void)
+{
+    return ConfigGetParamInt(g_CoreConfig, "DisableExtraMem") ? BKM_STATE_SIZE_NO_EXPANSION : BKM_STATE_SIZE;
+}
+
+static int savestates_load_bkm_data(char * curr)
 {
     unsigned char header[44];
     int version;
@@ -487,8 +568,8 @@ EXPORT int CALL savestates_load_bkm(char * curr)
 
     char *queue;
 
-	hasExpansion = !(ConfigGetParamInt(g_CoreConfig, "DisableExtraMem"));
-	savestateSize = hasExpansion ? 16788288 : 12593984;
+	savestateSize = savestates_bkm_size();
+	hasExpansion = savestateSize == BKM_STATE_SIZE;
 	queue = curr + savestateSize;
 
 	curr += 44;
@@ -676,6 +757,62 @@ EXPORT int CALL savestates_load_bkm(char * curr)
     return 1;
 }
 
+static unsigned int bkm_get_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static void bkm_put_le32(unsigned char *p, unsigned int value)
+{
+    p[0] = value & 0xff;
+    p[1] = (value >> 8) & 0xff;
+    p[2] = (value >> 16) & 0xff;
+    p[3] = (value >> 24) & 0xff;
+}
+
+/* Loads a state written by savestates_save_bkm() or, deflated, by savestates_save_bkm_async().
+   Like the output of savestates_save_bkm(), curr must hold BKM_STATE_MAX_SIZE bytes. */
+EXPORT int CALL savestates_load_bkm(char * curr)
+{
+    unsigned char *header = (unsigned char *)curr;
+    unsigned char *inflated;
+    uLongf inflated_size;
+    unsigned int expected_size, deflated_size;
+    int ret;
+
+    if (memcmp(curr, bkm_deflate_magic, 8) != 0)
+        return savestates_load_bkm_data(curr);
+
+    /* savestates_load_bkm_data() reads a fixed layout, so the stream must inflate to exactly the
+       size in the header, and that must be a whole state for this expansion pak setting */
+    expected_size = bkm_get_le32(header + 8);
+    deflated_size = bkm_get_le32(header + 12);
+    if (expected_size < savestates_bkm_size() || expected_size > BKM_STATE_MAX_SIZE
+        || deflated_size > BKM_STATE_MAX_SIZE - BKM_DEFLATE_HEADER_SIZE)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Compressed savestate is corrupt.");
+        return 0;
+    }
+    inflated_size = expected_size;
+    inflated = malloc(inflated_size);
+    if (inflated == NULL)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to load state.");
+        return 0;
+    }
+    if (uncompress(inflated, &inflated_size, header + BKM_DEFLATE_HEADER_SIZE, deflated_size) != Z_OK
+        || inflated_size != expected_size)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Compressed savestate is corrupt.");
+        free(inflated);
+        return 0;
+    }
+
+    ret = savestates_load_bkm_data((char *)inflated);
+    free(inflated);
+    return ret;
+}
+
 static int savestates_load_pj64(char *filepath, void *handle,
                                 int (*read_func)(void *, void *, size_t))
 {
@@ -1205,7 +1342,7 @@ static int savestates_save_m64p(char *filepath)
     queuelength = save_eventqueue_infos(queue);
 
     // Allocate memory for the save state data
-    save->size = 16788288 + queuelength;
+    save->size = BKM_STATE_SIZE + queuelength;
     save->data = curr = malloc(save->size);
     if (save->data == NULL)
     {
@@ -1444,30 +1581,63 @@ static int savestates_save_m64p(char *filepath)
     return 1;
 }
 
-EXPORT int CALL savestates_save_bkm(char *curr)
+/* Captures what savestates_save_bkm() writes.  The memory arrays are referenced, not copied. */
+static void savestates_snapshot_bkm(struct bkm_snapshot *s)
 {
-    unsigned char outbuf[4];
-    int i;
+    s->queuelength = save_eventqueue_infos(s->queue);
+
+    s->hasExpansion = !(ConfigGetParamInt(g_CoreConfig, "DisableExtraMem"));
+    memcpy(s->md5, ROM_SETTINGS.MD5, 32);
+
+    s->rdram_register = rdram_register;
+    s->MI_register = MI_register;
+    s->pi_register = pi_register;
+    s->sp_register = sp_register;
+    s->rsp_register = rsp_register;
+    s->si_register = si_register;
+    s->vi_register = vi_register;
+    s->ri_register = ri_register;
+    s->ai_register = ai_register;
+    s->dpc_register = dpc_register;
+    s->dps_register = dps_register;
+
+    s->rdram = rdram;
+    s->sp_dmem = SP_DMEM;
+    s->sp_imem = SP_IMEM;
+    s->pif_ram = PIF_RAM;
+    s->tlb_lut_r = tlb_LUT_r;
+    s->tlb_lut_w = tlb_LUT_w;
+
+    s->flashram_info = flashram_info;
+
+    s->llbit = llbit;
+    memcpy(s->reg, reg, sizeof(s->reg));
+    memcpy(s->reg_cop0, reg_cop0, sizeof(s->reg_cop0));
+    s->lo = lo;
+    s->hi = hi;
 
-    char queue[1024];
-    int queuelength;
-	int savestate_size;
-
-	int hasExpansion;
+    if ((Status & 0x04000000) == 0) // FR bit == 0 means 32-bit (MIPS I) FGR mode
+        shuffle_fpr_data(0, 0x04000000);  // shuffle data into 64-bit register format for storage
+    memcpy(s->reg_cop1_fgr_64, reg_cop1_fgr_64, sizeof(s->reg_cop1_fgr_64));
+    if ((Status & 0x04000000) == 0)
+        shuffle_fpr_data(0x04000000, 0);  // put it back in 32-bit mode
 
-    queuelength = save_eventqueue_infos(queue);
+    s->FCR0 = FCR0;
+    s->FCR31 = FCR31;
+    memcpy(s->tlb_e, tlb_e, sizeof(s->tlb_e));
 
-	hasExpansion = !(ConfigGetParamInt(g_CoreConfig, "DisableExtraMem"));
+    s->pc = PC != NULL ? PC->addr : 0xa4000040;
+    s->next_interupt = next_interupt;
+    s->next_vi = next_vi;
+    s->vi_field = vi_field;
+}
 
-    // Allocate memory for the save state data
-	if (hasExpansion)
-	{
-		savestate_size = 16788288 + queuelength;
-	}
-	else
-	{
-		savestate_size = 12593984 + queuelength;
-	}
+/* Writes a snapshot in savestates_save_bkm() format and returns its size. */
+static int savestates_write_bkm(char *curr, struct bkm_snapshot *s)
+{
+    unsigned char outbuf[4];
+    int i;
+    int savestate_size = (s->hasExpansion ? BKM_STATE_SIZE : BKM_STATE_SIZE_NO_EXPANSION) + s->queuelength;
 
     // Write the save state data to memory
     PUTARRAY(savestate_magic, curr, unsigned char, 8);
@@ -1478,222 +1648,342 @@ EXPORT int CALL savestates_save_bkm(char *curr)
     outbuf[3] = (savestate_latest_version >>  0) & 0xff;
     PUTARRAY(outbuf, curr, unsigned char, 4);
 
-    PUTARRAY(ROM_SETTINGS.MD5, curr, char, 32);
-
-    PUTDATA(curr, unsigned int, rdram_register.rdram_config);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_device_id);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_delay);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_mode);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_ref_interval);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_ref_row);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_ras_interval);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_min_interval);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_addr_select);
-    PUTDATA(curr, unsigned int, rdram_register.rdram_device_manuf);
-
-    PUTDATA(curr, unsigned int, MI_register.w_mi_init_mode_reg);
-    PUTDATA(curr, unsigned int, MI_register.mi_init_mode_reg);
-    PUTDATA(curr, unsigned char, MI_register.mi_init_mode_reg & 0x7F);
-    PUTDATA(curr, unsigned char, (MI_register.mi_init_mode_reg & 0x80) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_init_mode_reg & 0x100) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_init_mode_reg & 0x200) != 0);
-    PUTDATA(curr, unsigned int, MI_register.mi_version_reg);
-    PUTDATA(curr, unsigned int, MI_register.mi_intr_reg);
-    PUTDATA(curr, unsigned int, MI_register.mi_intr_mask_reg);
-    PUTDATA(curr, unsigned int, MI_register.w_mi_intr_mask_reg);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x1) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x2) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x4) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x8) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x10) != 0);
-    PUTDATA(curr, unsigned char, (MI_register.mi_intr_mask_reg & 0x20) != 0);
+    PUTARRAY(s->md5, curr, char, 32);
+
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_config);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_device_id);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_delay);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_mode);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_ref_interval);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_ref_row);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_ras_interval);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_min_interval);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_addr_select);
+    PUTDATA(curr, unsigned int, s->rdram_register.rdram_device_manuf);
+
+    PUTDATA(curr, unsigned int, s->MI_register.w_mi_init_mode_reg);
+    PUTDATA(curr, unsigned int, s->MI_register.mi_init_mode_reg);
+    PUTDATA(curr, unsigned char, s->MI_register.mi_init_mode_reg & 0x7F);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_init_mode_reg & 0x80) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_init_mode_reg & 0x100) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_init_mode_reg & 0x200) != 0);
+    PUTDATA(curr, unsigned int, s->MI_register.mi_version_reg);
+    PUTDATA(curr, unsigned int, s->MI_register.mi_intr_reg);
+    PUTDATA(curr, unsigned int, s->MI_register.mi_intr_mask_reg);
+    PUTDATA(curr, unsigned int, s->MI_register.w_mi_intr_mask_reg);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x1) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x2) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x4) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x8) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x10) != 0);
+    PUTDATA(curr, unsigned char, (s->MI_register.mi_intr_mask_reg & 0x20) != 0);
     PUTDATA(curr, unsigned short, 0); // Padding from old implementation
 
-    PUTDATA(curr, unsigned int, pi_register.pi_dram_addr_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_cart_addr_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_rd_len_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_wr_len_reg);
-    PUTDATA(curr, unsigned int, pi_register.read_pi_status_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom1_lat_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom1_pwd_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom1_pgs_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom1_rls_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom2_lat_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom2_pwd_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom2_pgs_reg);
-    PUTDATA(curr, unsigned int, pi_register.pi_bsd_dom2_rls_reg);
-
-    PUTDATA(curr, unsigned int, sp_register.sp_mem_addr_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_dram_addr_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_rd_len_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_wr_len_reg);
-    PUTDATA(curr, unsigned int, sp_register.w_sp_status_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_status_reg);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x1) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x2) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x4) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x8) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x10) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x20) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x40) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x80) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x100) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x200) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x400) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x800) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x1000) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x2000) != 0);
-    PUTDATA(curr, unsigned char, (sp_register.sp_status_reg & 0x4000) != 0);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_dram_addr_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_cart_addr_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_rd_len_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_wr_len_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.read_pi_status_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom1_lat_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom1_pwd_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom1_pgs_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom1_rls_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom2_lat_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom2_pwd_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom2_pgs_reg);
+    PUTDATA(curr, unsigned int, s->pi_register.pi_bsd_dom2_rls_reg);
+
+    PUTDATA(curr, unsigned int, s->sp_register.sp_mem_addr_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_dram_addr_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_rd_len_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_wr_len_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.w_sp_status_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_status_reg);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x1) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x2) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x4) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x8) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x10) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x20) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x40) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x80) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x100) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x200) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x400) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x800) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x1000) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x2000) != 0);
+    PUTDATA(curr, unsigned char, (s->sp_register.sp_status_reg & 0x4000) != 0);
     PUTDATA(curr, unsigned char, 0);
-    PUTDATA(curr, unsigned int, sp_register.sp_dma_full_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_dma_busy_reg);
-    PUTDATA(curr, unsigned int, sp_register.sp_semaphore_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_dma_full_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_dma_busy_reg);
+    PUTDATA(curr, unsigned int, s->sp_register.sp_semaphore_reg);
+
+    PUTDATA(curr, unsigned int, s->rsp_register.rsp_pc);
+    PUTDATA(curr, unsigned int, s->rsp_register.rsp_ibist);
+
+    PUTDATA(curr, unsigned int, s->si_register.si_dram_addr);
+    PUTDATA(curr, unsigned int, s->si_register.si_pif_addr_rd64b);
+    PUTDATA(curr, unsigned int, s->si_register.si_pif_addr_wr64b);
+    PUTDATA(curr, unsigned int, s->si_register.si_stat);
+
+    PUTDATA(curr, unsigned int, s->vi_register.vi_status);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_origin);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_width);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_v_intr);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_current);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_burst);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_v_sync);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_h_sync);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_leap);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_h_start);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_v_start);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_v_burst);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_x_scale);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_y_scale);
+    PUTDATA(curr, unsigned int, s->vi_register.vi_delay);
+
+    PUTDATA(curr, unsigned int, s->ri_register.ri_mode);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_config);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_current_load);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_select);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_refresh);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_latency);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_error);
+    PUTDATA(curr, unsigned int, s->ri_register.ri_werror);
+
+    PUTDATA(curr, unsigned int, s->ai_register.ai_dram_addr);
+    PUTDATA(curr, unsigned int, s->ai_register.ai_len);
+    PUTDATA(curr, unsigned int, s->ai_register.ai_control);
+    PUTDATA(curr, unsigned int, s->ai_register.ai_status);
+    PUTDATA(curr, unsigned int, s->ai_register.ai_dacrate);
+    PUTDATA(curr, unsigned int, s->ai_register.ai_bitrate);
+    PUTDATA(curr, unsigned int, s->ai_register.next_delay);
+    PUTDATA(curr, unsigned int, s->ai_register.next_len);
+    PUTDATA(curr, unsigned int, s->ai_register.current_delay);
+    PUTDATA(curr, unsigned int, s->ai_register.current_len);
+
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_start);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_end);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_current);
+    PUTDATA(curr, unsigned int, s->dpc_register.w_dpc_status);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_status);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x1) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x2) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x4) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x8) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x10) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x20) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x40) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x80) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x100) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x200) != 0);
+    PUTDATA(curr, unsigned char, (s->dpc_register.dpc_status & 0x400) != 0);
+    PUTDATA(curr, unsigned char, 0);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_clock);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_bufbusy);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_pipebusy);
+    PUTDATA(curr, unsigned int, s->dpc_register.dpc_tmem);
+
+    PUTDATA(curr, unsigned int, s->dps_register.dps_tbist);
+    PUTDATA(curr, unsigned int, s->dps_register.dps_test_mode);
+    PUTDATA(curr, unsigned int, s->dps_register.dps_buftest_addr);
+    PUTDATA(curr, unsigned int, s->dps_register.dps_buftest_data);
+
+    PUTARRAY(s->rdram, curr, unsigned int, (s->hasExpansion ? 0x800000 : 0x400000) / 4);
+    PUTARRAY(s->sp_dmem, curr, unsigned int, 0x1000/4);
+    PUTARRAY(s->sp_imem, curr, unsigned int, 0x1000/4);
+    PUTARRAY(s->pif_ram, curr, unsigned char, 0x40);
+
+    PUTDATA(curr, int, s->flashram_info.use_flashram);
+    PUTDATA(curr, int, s->flashram_info.mode);
+    PUTDATA(curr, unsigned long long, s->flashram_info.status);
+    PUTDATA(curr, unsigned int, s->flashram_info.erase_offset);
+    PUTDATA(curr, unsigned int, s->flashram_info.write_pointer);
+
+    PUTARRAY(s->tlb_lut_r, curr, unsigned int, 0x100000);
+    PUTARRAY(s->tlb_lut_w, curr, unsigned int, 0x100000);
+
+    PUTDATA(curr, unsigned int, s->llbit);
+    PUTARRAY(s->reg, curr, long long int, 32);
+    PUTARRAY(s->reg_cop0, curr, unsigned int, 32);
+    PUTDATA(curr, long long int, s->lo);
+    PUTDATA(curr, long long int, s->hi);
+
+    PUTARRAY(s->reg_cop1_fgr_64, curr, long long int, 32);
+
+    PUTDATA(curr, int, s->FCR0);
+    PUTDATA(curr, int, s->FCR31);
+    for (i = 0; i < 32; i++)
+    {
+        PUTDATA(curr, short, s->tlb_e[i].mask);
+        PUTDATA(curr, short, 0);
+        PUTDATA(curr, int, s->tlb_e[i].vpn2);
+        PUTDATA(curr, char, s->tlb_e[i].g);
+        PUTDATA(curr, unsigned char, s->tlb_e[i].asid);
+        PUTDATA(curr, short, 0);
+        PUTDATA(curr, int, s->tlb_e[i].pfn_even);
+        PUTDATA(curr, char, s->tlb_e[i].c_even);
+        PUTDATA(curr, char, s->tlb_e[i].d_even);
+        PUTDATA(curr, char, s->tlb_e[i].v_even);
+        PUTDATA(curr, char, 0);
+        PUTDATA(curr, int, s->tlb_e[i].pfn_odd);
+        PUTDATA(curr, char, s->tlb_e[i].c_odd);
+        PUTDATA(curr, char, s->tlb_e[i].d_odd);
+        PUTDATA(curr, char, s->tlb_e[i].v_odd);
+        PUTDATA(curr, char, s->tlb_e[i].r);
+   
+        PUTDATA(curr, unsigned int, s->tlb_e[i].start_even);
+        PUTDATA(curr, unsigned int, s->tlb_e[i].end_even);
+        PUTDATA(curr, unsigned int, s->tlb_e[i].phys_even);
+        PUTDATA(curr, unsigned int, s->tlb_e[i].start_odd);
+        PUTDATA(curr, unsigned int, s->tlb_e[i].end_odd);
+        PUTDATA(curr, unsigned int, s->tlb_e[i].phys_odd);
+    }
 
-    PUTDATA(curr, unsigned int, rsp_register.rsp_pc);
-    PUTDATA(curr, unsigned int, rsp_register.rsp_ibist);
+    PUTDATA(curr, unsigned int, s->pc);
 
-    PUTDATA(curr, unsigned int, si_register.si_dram_addr);
-    PUTDATA(curr, unsigned int, si_register.si_pif_addr_rd64b);
-    PUTDATA(curr, unsigned int, si_register.si_pif_addr_wr64b);
-    PUTDATA(curr, unsigned int, si_register.si_stat);
+    PUTDATA(curr, unsigned int, s->next_interupt);
+    PUTDATA(curr, unsigned int, s->next_vi);
+    PUTDATA(curr, unsigned int, s->vi_field);
 
-    PUTDATA(curr, unsigned int, vi_register.vi_status);
-    PUTDATA(curr, unsigned int, vi_register.vi_origin);
-    PUTDATA(curr, unsigned int, vi_register.vi_width);
-    PUTDATA(curr, unsigned int, vi_register.vi_v_intr);
-    PUTDATA(curr, unsigned int, vi_register.vi_current);
-    PUTDATA(curr, unsigned int, vi_register.vi_burst);
-    PUTDATA(curr, unsigned int, vi_register.vi_v_sync);
-    PUTDATA(curr, unsigned int, vi_register.vi_h_sync);
-    PUTDATA(curr, unsigned int, vi_register.vi_leap);
-    PUTDATA(curr, unsigned int, vi_register.vi_h_start);
-    PUTDATA(curr, unsigned int, vi_register.vi_v_start);
-    PUTDATA(curr, unsigned int, vi_register.vi_v_burst);
-    PUTDATA(curr, unsigned int, vi_register.vi_x_scale);
-    PUTDATA(curr, unsigned int, vi_register.vi_y_scale);
-    PUTDATA(curr, unsigned int, vi_register.vi_delay);
+    to_little_endian_buffer(s->queue, 4, s->queuelength/4);
+    PUTARRAY(s->queue, curr, char, s->queuelength);
 
-    PUTDATA(curr, unsigned int, ri_register.ri_mode);
-    PUTDATA(curr, unsigned int, ri_register.ri_config);
-    PUTDATA(curr, unsigned int, ri_register.ri_current_load);
-    PUTDATA(curr, unsigned int, ri_register.ri_select);
-    PUTDATA(curr, unsigned int, ri_register.ri_refresh);
-    PUTDATA(curr, unsigned int, ri_register.ri_latency);
-    PUTDATA(curr, unsigned int, ri_register.ri_error);
-    PUTDATA(curr, unsigned int, ri_register.ri_werror);
+    // assert(curr == save->data + save->size)
 
-    PUTDATA(curr, unsigned int, ai_register.ai_dram_addr);
-    PUTDATA(curr, unsigned int, ai_register.ai_len);
-    PUTDATA(curr, unsigned int, ai_register.ai_control);
-    PUTDATA(curr, unsigned int, ai_register.ai_status);
-    PUTDATA(curr, unsigned int, ai_register.ai_dacrate);
-    PUTDATA(curr, unsigned int, ai_register.ai_bitrate);
-    PUTDATA(curr, unsigned int, ai_register.next_delay);
-    PUTDATA(curr, unsigned int, ai_register.next_len);
-    PUTDATA(curr, unsigned int, ai_register.current_delay);
-    PUTDATA(curr, unsigned int, ai_register.current_len);
+    return savestate_size;
+}
 
-    PUTDATA(curr, unsigned int, dpc_register.dpc_start);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_end);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_current);
-    PUTDATA(curr, unsigned int, dpc_register.w_dpc_status);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_status);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x1) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x2) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x4) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x8) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x10) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x20) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x40) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x80) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x100) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x200) != 0);
-    PUTDATA(curr, unsigned char, (dpc_register.dpc_status & 0x400) != 0);
-    PUTDATA(curr, unsigned char, 0);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_clock);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_bufbusy);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_pipebusy);
-    PUTDATA(curr, unsigned int, dpc_register.dpc_tmem);
+EXPORT int CALL savestates_save_bkm(char *curr)
+{
+    struct bkm_snapshot snap;
 
-    PUTDATA(curr, unsigned int, dps_register.dps_tbist);
-    PUTDATA(curr, unsigned int, dps_register.dps_test_mode);
-    PUTDATA(curr, unsigned int, dps_register.dps_buftest_addr);
-    PUTDATA(curr, unsigned int, dps_register.dps_buftest_data);
+    savestates_snapshot_bkm(&snap);
+    return savestates_write_bkm(curr, &snap);
+}
 
-    PUTARRAY(rdram, curr, unsigned int, (hasExpansion ? 0x800000 : 0x400000) / 4);
-    PUTARRAY(SP_DMEM, curr, unsigned int, 0x1000/4);
-    PUTARRAY(SP_IMEM, curr, unsigned int, 0x1000/4);
-    PUTARRAY(PIF_RAM, curr, unsigned char, 0x40);
+static void savestates_save_bkm_work(struct work_struct *work)
+{
+    struct savestate_bkm_job *job = container_of(work, struct savestate_bkm_job, work);
 
-    PUTDATA(curr, int, flashram_info.use_flashram);
-    PUTDATA(curr, int, flashram_info.mode);
-    PUTDATA(curr, unsigned long long, flashram_info.status);
-    PUTDATA(curr, unsigned int, flashram_info.erase_offset);
-    PUTDATA(curr, unsigned int, flashram_info.write_pointer);
+    job->size = savestates_write_bkm(job->data, &job->snap);
 
-    PUTARRAY(tlb_LUT_r, curr, unsigned int, 0x100000);
-    PUTARRAY(tlb_LUT_w, curr, unsigned int, 0x100000);
+    if (job->level > 0)
+    {
+        uLongf destlen = compressBound(job->size);
+        job->result = malloc(BKM_DEFLATE_HEADER_SIZE + destlen);
+        if (job->result != NULL && compress2((Bytef *)job->result + BKM_DEFLATE_HEADER_SIZE, &destlen, (const Bytef *)job->data, job->size, job->level) == Z_OK
+            && BKM_DEFLATE_HEADER_SIZE + destlen < job->size)
+        {
+            memcpy(job->result, bkm_deflate_magic, 8);
+            bkm_put_le32((unsigned char *)job->result + 8, (unsigned int)job->size);
+            bkm_put_le32((unsigned char *)job->result + 12, (unsigned int)destlen);
+            job->result_size = BKM_DEFLATE_HEADER_SIZE + destlen;
+        }
+        else
+        {
+            DebugMessage(M64MSG_WARNING, "Could not compress savestate; returning it uncompressed");
+            free(job->result);
+            job->result = job->data;
+            job->result_size = job->size;
+        }
+    }
+    else
+    {
+        job->result = job->data;
+        job->result_size = job->size;
+    }
 
-    PUTDATA(curr, unsigned int, llbit);
-    PUTARRAY(reg, curr, long long int, 32);
-    PUTARRAY(reg_cop0, curr, unsigned int, 32);
-    PUTDATA(curr, long long int, lo);
-    PUTDATA(curr, long long int, hi);
+    SDL_SemPost(job->done);
+}
 
-    if ((Status & 0x04000000) == 0) // FR bit == 0 means 32-bit (MIPS I) FGR mode
-        shuffle_fpr_data(0, 0x04000000);  // shuffle data into 64-bit register format for storage
-    PUTARRAY(reg_cop1_fgr_64, curr, long long int, 32);
-    if ((Status & 0x04000000) == 0)
-        shuffle_fpr_data(0x04000000, 0);  // put it back in 32-bit mode
+/* Begins a savestate.  The register snapshot and a copy of the memory arrays are taken here;
+   writing the state out and deflating it (zlib level 1-9, or 0 for the plain savestates_save_bkm()
+   format) run on the workqueue, and emulation may continue right away.  savestates_load_bkm()
+   reads either form.  Returns 0 if the previous asynchronous save hasn't been collected yet.
+   The copy is up to 16MB (RDRAM and both TLB tables), so this stalls about as long as a plain
+   savestates_save_bkm() does; what moves off the emulation thread is the deflate. */
+EXPORT int CALL savestates_save_bkm_async(int level)
+{
+    struct bkm_snapshot *s = &bkm_job.snap;
+    unsigned char *mem;
 
-    PUTDATA(curr, int, FCR0);
-    PUTDATA(curr, int, FCR31);
-    for (i = 0; i < 32; i++)
+    if (bkm_job.pending)
+        return 0;
+
+    if (bkm_job.done == NULL)
     {
-        PUTDATA(curr, short, tlb_e[i].mask);
-        PUTDATA(curr, short, 0);
-        PUTDATA(curr, int, tlb_e[i].vpn2);
-        PUTDATA(curr, char, tlb_e[i].g);
-        PUTDATA(curr, unsigned char, tlb_e[i].asid);
-        PUTDATA(curr, short, 0);
-        PUTDATA(curr, int, tlb_e[i].pfn_even);
-        PUTDATA(curr, char, tlb_e[i].c_even);
-        PUTDATA(curr, char, tlb_e[i].d_even);
-        PUTDATA(curr, char, tlb_e[i].v_even);
-        PUTDATA(curr, char, 0);
-        PUTDATA(curr, int, tlb_e[i].pfn_odd);
-        PUTDATA(curr, char, tlb_e[i].c_odd);
-        PUTDATA(curr, char, tlb_e[i].d_odd);
-        PUTDATA(curr, char, tlb_e[i].v_odd);
-        PUTDATA(curr, char, tlb_e[i].r);
-   
-        PUTDATA(curr, unsigned int, tlb_e[i].start_even);
-        PUTDATA(curr, unsigned int, tlb_e[i].end_even);
-        PUTDATA(curr, unsigned int, tlb_e[i].phys_even);
-        PUTDATA(curr, unsigned int, tlb_e[i].start_odd);
-        PUTDATA(curr, unsigned int, tlb_e[i].end_odd);
-        PUTDATA(curr, unsigned int, tlb_e[i].phys_odd);
+        bkm_job.done = SDL_CreateSemaphore(0);
+        if (bkm_job.done == NULL)
+            return 0;
+    }
+    if (bkm_job.data == NULL)
+        bkm_job.data = malloc(BKM_STATE_MAX_SIZE);
+    if (bkm_job.mem == NULL)
+        bkm_job.mem = malloc(BKM_SNAPSHOT_MEM_SIZE);
+    if (bkm_job.data == NULL || bkm_job.mem == NULL)
+    {
+        main_message(M64MSG_STATUS, OSD_BOTTOM_LEFT, "Insufficient memory to save state.");
+        return 0;
     }
 
-	if (PC != NULL)
-	{
-		PUTDATA(curr, unsigned int, PC->addr);
-	}
-	else
-	{
-		PUTDATA(curr, unsigned int, 0xa4000040);
-	}
+    savestates_snapshot_bkm(s);
+
+    mem = bkm_job.mem;
+    memcpy(mem, s->rdram, s->hasExpansion ? 0x800000 : 0x400000);
+    s->rdram = (const unsigned int *)mem; mem += 0x800000;
+    memcpy(mem, s->sp_dmem, 0x1000);
+    s->sp_dmem = (const unsigned int *)mem; mem += 0x1000;
+    memcpy(mem, s->sp_imem, 0x1000);
+    s->sp_imem = (const unsigned int *)mem; mem += 0x1000;
+    memcpy(mem, s->pif_ram, 0x40);
+    s->pif_ram = (const unsigned int *)mem; mem += 0x40;
+    memcpy(mem, s->tlb_lut_r, 0x400000);
+    s->tlb_lut_r = (const unsigned int *)mem; mem += 0x400000;
+    memcpy(mem, s->tlb_lut_w, 0x400000);
+    s->tlb_lut_w = (const unsigned int *)mem;
+
+    bkm_job.level = level;
+    bkm_job.size = 0;
+    bkm_job.result = NULL;
+    bkm_job.result_size = 0;
+    bkm_job.pending = 1;
+    bkm_job.finished = 0;
+
+    init_work(&bkm_job.work, savestates_save_bkm_work);
+    queue_work(&bkm_job.work);
+    return 1;
+}
 
-    PUTDATA(curr, unsigned int, next_interupt);
-    PUTDATA(curr, unsigned int, next_vi);
-    PUTDATA(curr, unsigned int, vi_field);
+/* Waits for the asynchronous save to finish and returns its size.  With dest == NULL that's all;
+   otherwise the state is copied to dest (if it fits) and the save is collected.
+   Returns -1 if there is no save outstanding or dest is too small. */
+EXPORT int CALL savestates_save_bkm_async_result(char *dest, int maxsize)
+{
+    int size;
 
-    to_little_endian_buffer(queue, 4, queuelength/4);
-    PUTARRAY(queue, curr, char, queuelength);
+    if (!bkm_job.pending)
+        return -1;
 
-    // assert(curr == save->data + save->size)
+    if (!bkm_job.finished)
+    {
+        SDL_SemWait(bkm_job.done);
+        bkm_job.finished = 1;
+    }
 
-    return savestate_size;
+    size = (int)bkm_job.result_size;
+    if (dest == NULL)
+        return size;
+    if (maxsize < size)
+        return -1;
+
+    memcpy(dest, bkm_job.result, size);
+    if (bkm_job.result != bkm_job.data)
+        free(bkm_job.result);
+    bkm_job.result = NULL;
+    bkm_job.pending = 0;
+    return size;
 }
 
 static int savestates_save_pj64(char *filepath, void *handle,
@@ -1985,4 +2275,14 @@ void savestates_deinit(void)
 {
     SDL_DestroyMutex(savestates_lock);
     savestates_clear_job();
+
+    if (bkm_job.pending && !bkm_job.finished)
+        SDL_SemWait(bkm_job.done);
+    if (bkm_job.result != bkm_job.data)
+        free(bkm_job.result);
+    free(bkm_job.data);
+    free(bkm_job.mem);
+    if (bkm_job.done != NULL)
+        SDL_DestroySemaphore(bkm_job.done);
+    memset(&bkm_job, 0, sizeof(bkm_job));
 }
\ No newline at end of file
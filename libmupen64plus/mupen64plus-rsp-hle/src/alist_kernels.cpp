@@ -0,0 +1,525 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus-rsp-hle - alist_kernels.cpp                               *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stddef.h>
+
+#include "alist_kernels.h"
+
+// The vector paths assume the RSP's 16-bit words are pair-swapped in memory,
+// as they are on little-endian hosts (S == 1)
+#if !defined(HLE_NO_SSE2) && !defined(M64P_BIG_ENDIAN) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define ALIST_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+extern const u16 ResampleLUT [0x200];
+
+extern u8 BufferSpace[0x10000];
+
+static inline s32 clamp_s16(s32 x)
+{
+    if (x > 32767) return 32767;
+    if (x < -32768) return -32768;
+    return x;
+}
+
+#ifdef ALIST_SSE2
+
+// Swaps each pair of 16-bit lanes: RSP word order <-> sample order
+static inline __m128i swap_pairs(__m128i v)
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// Sign-extended 32-bit products of 8 lanes, low and high halves
+static inline void mul_s32(__m128i a, __m128i b, __m128i *lo, __m128i *hi)
+{
+    __m128i l = _mm_mullo_epi16(a, b);
+    __m128i h = _mm_mulhi_epi16(a, b);
+    *lo = _mm_unpacklo_epi16(l, h);
+    *hi = _mm_unpackhi_epi16(l, h);
+}
+
+// Bits 16..31 of a signed sample times an unsigned 16-bit factor
+static inline __m128i mulhi_su(__m128i s, u16 e)
+{
+    __m128i h = _mm_mulhi_epi16(s, _mm_set1_epi16((s16)e));
+    return (e & 0x8000) ? _mm_add_epi16(h, s) : h;
+}
+
+static inline bool overlaps(const void *a, size_t asize, const void *b, size_t bsize)
+{
+    return (const u8 *)a < (const u8 *)b + bsize && (const u8 *)b < (const u8 *)a + asize;
+}
+
+#endif
+
+void alist_mix(s16 *dst, const s16 *src, u32 count, s16 gain)
+{
+    u32 i = 0;
+
+#ifdef ALIST_SSE2
+    // Unless dst starts within 8 samples after src, a vector of src never
+    // holds samples written by the previous ones
+    ptrdiff_t d = (const u8 *)dst - (const u8 *)src;
+    if (d <= 0 || d >= 16) {
+        const __m128i g = _mm_set1_epi16(gain);
+        for (; i + 8 <= count; i += 8) {
+            __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+            __m128i o = _mm_loadu_si128((const __m128i *)(dst + i));
+            __m128i p0, p1;
+            mul_s32(s, g, &p0, &p1);
+            p0 = _mm_add_epi32(_mm_srai_epi32(p0, 15), _mm_srai_epi32(_mm_unpacklo_epi16(o, o), 16));
+            p1 = _mm_add_epi32(_mm_srai_epi32(p1, 15), _mm_srai_epi32(_mm_unpackhi_epi16(o, o), 16));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(p0, p1));
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        dst[i] = (s16)clamp_s16(((src[i] * gain) >> 15) + dst[i]);
+}
+
+void alist_interleave(u16 *dst, const u16 *left, const u16 *right, u32 count)
+{
+    u32 x = 0;
+
+#ifdef ALIST_SSE2
+    if (!overlaps(dst, count * 8, left, count * 4) && !overlaps(dst, count * 8, right, count * 4)) {
+        for (; x + 4 <= count; x += 4) {
+            __m128i l = swap_pairs(_mm_loadu_si128((const __m128i *)(left + 2 * x)));
+            __m128i r = swap_pairs(_mm_loadu_si128((const __m128i *)(right + 2 * x)));
+            _mm_storeu_si128((__m128i *)(dst + 4 * x), _mm_unpacklo_epi16(r, l));
+            _mm_storeu_si128((__m128i *)(dst + 4 * x + 8), _mm_unpackhi_epi16(r, l));
+        }
+    }
+#endif
+
+    left += 2 * x;
+    right += 2 * x;
+    dst += 4 * x;
+    for (; x < count; x++) {
+        u16 Left = *(left++);
+        u16 Right = *(right++);
+        u16 Left2 = *(left++);
+        u16 Right2 = *(right++);
+
+#ifdef M64P_BIG_ENDIAN
+        *(dst++) = Right;
+        *(dst++) = Left;
+        *(dst++) = Right2;
+        *(dst++) = Left2;
+#else
+        *(dst++) = Right2;
+        *(dst++) = Left2;
+        *(dst++) = Right;
+        *(dst++) = Left;
+#endif
+    }
+}
+
+void alist_adpcm_predict(s16 *dst, const s16 *book1, const s16 *book2, const int *inp, int *l1, int *l2)
+{
+#ifdef ALIST_SSE2
+    // a[j] = book1[j]*l1 + book2[j]*l2 + sum(c[j-i]*inp[i]), where c is book2
+    // moved up one place with the 2048 that scales a residual's own sample
+    const __m128i b1 = _mm_loadu_si128((const __m128i *)book1);
+    const __m128i b2 = _mm_loadu_si128((const __m128i *)book2);
+    const __m128i c0 = _mm_insert_epi16(_mm_slli_si128(b2, 2), 2048, 0);
+    const __m128i c1 = _mm_slli_si128(c0, 2);
+    const __m128i c2 = _mm_slli_si128(c0, 4);
+    const __m128i c3 = _mm_slli_si128(c0, 6);
+    const __m128i c4 = _mm_slli_si128(c0, 8);
+    const __m128i c5 = _mm_slli_si128(c0, 10);
+    const __m128i c6 = _mm_slli_si128(c0, 12);
+    const __m128i c7 = _mm_slli_si128(c0, 14);
+
+    // residuals fit in 16 bits, so the packs is exact
+    const __m128i x = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)inp),
+                                      _mm_loadu_si128((const __m128i *)(inp + 4)));
+    const __m128i x01 = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i x23 = _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i x45 = _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i x67 = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i prev = _mm_set1_epi32((int)((u32)(u16)*l1 | ((u32)*l2 << 16)));
+
+    // outputs 0..3 only depend on residuals 0..3
+    __m128i lo = _mm_madd_epi16(prev, _mm_unpacklo_epi16(b1, b2));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(x01, _mm_unpacklo_epi16(c0, c1)));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(x23, _mm_unpacklo_epi16(c2, c3)));
+
+    __m128i hi = _mm_madd_epi16(prev, _mm_unpackhi_epi16(b1, b2));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(x01, _mm_unpackhi_epi16(c0, c1)));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(x23, _mm_unpackhi_epi16(c2, c3)));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(x45, _mm_unpackhi_epi16(c4, c5)));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(x67, _mm_unpackhi_epi16(c6, c7)));
+
+    const __m128i a = _mm_packs_epi32(_mm_srai_epi32(lo, 11), _mm_srai_epi32(hi, 11));
+    _mm_storeu_si128((__m128i *)dst, swap_pairs(a));
+    *l1 = (s16)_mm_extract_epi16(a, 6);
+    *l2 = (s16)_mm_extract_epi16(a, 7);
+#else
+    int a[8];
+    int j;
+
+    a[0]= (int)book1[0]*(int)*l1;
+    a[0]+=(int)book2[0]*(int)*l2;
+    a[0]+=(int)inp[0]*(int)2048;
+
+    a[1] =(int)book1[1]*(int)*l1;
+    a[1]+=(int)book2[1]*(int)*l2;
+    a[1]+=(int)book2[0]*inp[0];
+    a[1]+=(int)inp[1]*(int)2048;
+
+    a[2] =(int)book1[2]*(int)*l1;
+    a[2]+=(int)book2[2]*(int)*l2;
+    a[2]+=(int)book2[1]*inp[0];
+    a[2]+=(int)book2[0]*inp[1];
+    a[2]+=(int)inp[2]*(int)2048;
+
+    a[3] =(int)book1[3]*(int)*l1;
+    a[3]+=(int)book2[3]*(int)*l2;
+    a[3]+=(int)book2[2]*inp[0];
+    a[3]+=(int)book2[1]*inp[1];
+    a[3]+=(int)book2[0]*inp[2];
+    a[3]+=(int)inp[3]*(int)2048;
+
+    a[4] =(int)book1[4]*(int)*l1;
+    a[4]+=(int)book2[4]*(int)*l2;
+    a[4]+=(int)book2[3]*inp[0];
+    a[4]+=(int)book2[2]*inp[1];
+    a[4]+=(int)book2[1]*inp[2];
+    a[4]+=(int)book2[0]*inp[3];
+    a[4]+=(int)inp[4]*(int)2048;
+
+    a[5] =(int)book1[5]*(int)*l1;
+    a[5]+=(int)book2[5]*(int)*l2;
+    a[5]+=(int)book2[4]*inp[0];
+    a[5]+=(int)book2[3]*inp[1];
+    a[5]+=(int)book2[2]*inp[2];
+    a[5]+=(int)book2[1]*inp[3];
+    a[5]+=(int)book2[0]*inp[4];
+    a[5]+=(int)inp[5]*(int)2048;
+
+    a[6] =(int)book1[6]*(int)*l1;
+    a[6]+=(int)book2[6]*(int)*l2;
+    a[6]+=(int)book2[5]*inp[0];
+    a[6]+=(int)book2[4]*inp[1];
+    a[6]+=(int)book2[3]*inp[2];
+    a[6]+=(int)book2[2]*inp[3];
+    a[6]+=(int)book2[1]*inp[4];
+    a[6]+=(int)book2[0]*inp[5];
+    a[6]+=(int)inp[6]*(int)2048;
+
+    a[7] =(int)book1[7]*(int)*l1;
+    a[7]+=(int)book2[7]*(int)*l2;
+    a[7]+=(int)book2[6]*inp[0];
+    a[7]+=(int)book2[5]*inp[1];
+    a[7]+=(int)book2[4]*inp[2];
+    a[7]+=(int)book2[3]*inp[3];
+    a[7]+=(int)book2[2]*inp[4];
+    a[7]+=(int)book2[1]*inp[5];
+    a[7]+=(int)book2[0]*inp[6];
+    a[7]+=(int)inp[7]*(int)2048;
+
+    for (j = 0; j < 8; j++) {
+        a[j^S] = clamp_s16(a[j^S] >> 11);
+        *(dst++) = a[j^S];
+    }
+    *l1 = a[6];
+    *l2 = a[7];
+#endif
+}
+
+void alist_envmix8(s16 *bufft6, s16 *bufft7, s16 *buffs0, s16 *buffs1, const s16 *buffs3,
+                   u16 env_l, u16 env_r, u16 env_wet, const s16 *v2, bool swap_wet)
+{
+#ifdef ALIST_SSE2
+    // The buffers are whole 16 byte blocks, so any two are either the same or
+    // disjoint; updating them one at a time in the loop's order is exact
+    const __m128i in = _mm_loadu_si128((const __m128i *)buffs3);
+    __m128i vec9 = _mm_xor_si128(mulhi_su(in, env_l), _mm_set1_epi16(v2[0]));
+    __m128i vec10 = _mm_xor_si128(mulhi_su(in, env_r), _mm_set1_epi16(v2[1]));
+
+    _mm_storeu_si128((__m128i *)bufft6, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)bufft6), vec9));
+    _mm_storeu_si128((__m128i *)bufft7, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)bufft7), vec10));
+
+    vec9 = _mm_xor_si128(mulhi_su(vec9, env_wet), _mm_set1_epi16(v2[2]));
+    vec10 = _mm_xor_si128(mulhi_su(vec10, env_wet), _mm_set1_epi16(v2[3]));
+    if (swap_wet) {
+        __m128i t = vec9;
+        vec9 = vec10;
+        vec10 = t;
+    }
+
+    _mm_storeu_si128((__m128i *)buffs0, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)buffs0), vec9));
+    _mm_storeu_si128((__m128i *)buffs1, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)buffs1), vec10));
+#else
+    s16 vec9, vec10;
+    int temp, x;
+
+    for (x = 0; x < 8; x++) {
+        vec9  = (s16)(((s32)buffs3[x^S] * (u32)env_l) >> 0x10) ^ v2[0];
+        vec10 = (s16)(((s32)buffs3[x^S] * (u32)env_r) >> 0x10) ^ v2[1];
+        temp = bufft6[x^S] + vec9;
+        bufft6[x^S] = clamp_s16(temp);
+        temp = bufft7[x^S] + vec10;
+        bufft7[x^S] = clamp_s16(temp);
+        vec9  = (s16)(((s32)vec9  * (u32)env_wet) >> 0x10) ^ v2[2];
+        vec10 = (s16)(((s32)vec10 * (u32)env_wet) >> 0x10) ^ v2[3];
+        if (swap_wet) {
+            temp = buffs0[x^S] + vec10;
+            buffs0[x^S] = clamp_s16(temp);
+            temp = buffs1[x^S] + vec9;
+            buffs1[x^S] = clamp_s16(temp);
+        } else {
+            temp = buffs0[x^S] + vec9;
+            buffs0[x^S] = clamp_s16(temp);
+            temp = buffs1[x^S] + vec10;
+            buffs1[x^S] = clamp_s16(temp);
+        }
+    }
+#endif
+}
+
+// One output of the resampler, as the original loop computed it
+static inline void resample_one(s16 *buf, u32 dstPtr, u32 *srcPtr, u32 *accum, u32 pitch)
+{
+    u32 src = *srcPtr;
+    // location is the fractional position between two samples
+    const s16 *lut = (const s16 *)ResampleLUT + (*accum >> 0xa) * 4;
+    s32 temp, sum;
+
+    temp = ((s32)buf[(src+0)^S] * (s32)lut[0]);
+    sum = (s32)(temp >> 15);
+
+    temp = ((s32)buf[(src+1)^S] * (s32)lut[1]);
+    sum += (s32)(temp >> 15);
+
+    temp = ((s32)buf[(src+2)^S] * (s32)lut[2]);
+    sum += (s32)(temp >> 15);
+
+    temp = ((s32)buf[(src+3)^S] * (s32)lut[3]);
+    sum += (s32)(temp >> 15);
+
+    buf[dstPtr^S] = (s16)clamp_s16(sum);
+    *accum += pitch;
+    *srcPtr = src + (*accum >> 16);
+    *accum &= 0xffff;
+}
+
+u32 alist_resample(u32 dstPtr, u32 *srcPtr, u32 count, u32 accum, u32 pitch)
+{
+    s16 *buf = (s16 *)BufferSpace;
+    u32 src = *srcPtr;
+    u32 i = 0;
+
+#ifdef ALIST_SSE2
+    for (; i + 8 <= count; i += 8) {
+        // The pitch is below 2.0, so 8 outputs read at most 21 input words;
+        // they are copied to sample order, so that each output's taps are
+        // four consecutive samples
+        const u32 slo = src & ~1u;
+        const u32 next = accum + 8 * pitch;
+        const u32 dlo = (dstPtr + i) & ~1u;
+        s16 in[24];
+        __m128i t[8], c[8];
+        int k;
+
+        // The block is computed before any of it is stored, so it must not
+        // write words it reads
+        if ((dlo < slo + 24 && slo < dlo + 10) || slo + 24 > sizeof(BufferSpace) / 2) {
+            for (k = 0; k < 8; k++)
+                resample_one(buf, dstPtr + i + k, &src, &accum, pitch);
+            continue;
+        }
+
+        _mm_storeu_si128((__m128i *)in, swap_pairs(_mm_loadu_si128((const __m128i *)(buf + slo))));
+        _mm_storeu_si128((__m128i *)(in + 8), swap_pairs(_mm_loadu_si128((const __m128i *)(buf + slo + 8))));
+        _mm_storeu_si128((__m128i *)(in + 16), swap_pairs(_mm_loadu_si128((const __m128i *)(buf + slo + 16))));
+
+        for (k = 0; k < 8; k++) {
+            u32 a = accum + k * pitch;
+            t[k] = _mm_loadl_epi64((const __m128i *)(in + (src & 1) + (a >> 16)));
+            c[k] = _mm_loadl_epi64((const __m128i *)(ResampleLUT + ((a & 0xffff) >> 0xa) * 4));
+        }
+        src += next >> 16;
+        accum = next & 0xffff;
+
+        // transpose to one vector per tap
+        for (int pass = 0; pass < 2; pass++) {
+            __m128i *r = pass ? c : t;
+            __m128i r01 = _mm_unpacklo_epi16(r[0], r[1]);
+            __m128i r23 = _mm_unpacklo_epi16(r[2], r[3]);
+            __m128i r45 = _mm_unpacklo_epi16(r[4], r[5]);
+            __m128i r67 = _mm_unpacklo_epi16(r[6], r[7]);
+            __m128i q0 = _mm_unpacklo_epi32(r01, r23);
+            __m128i q1 = _mm_unpackhi_epi32(r01, r23);
+            __m128i q2 = _mm_unpacklo_epi32(r45, r67);
+            __m128i q3 = _mm_unpackhi_epi32(r45, r67);
+            r[0] = _mm_unpacklo_epi64(q0, q2);
+            r[1] = _mm_unpackhi_epi64(q0, q2);
+            r[2] = _mm_unpacklo_epi64(q1, q3);
+            r[3] = _mm_unpackhi_epi64(q1, q3);
+        }
+
+        __m128i sum0 = _mm_setzero_si128(), sum1 = _mm_setzero_si128();
+        for (k = 0; k < 4; k++) {
+            __m128i p0, p1;
+            mul_s32(t[k], c[k], &p0, &p1);
+            sum0 = _mm_add_epi32(sum0, _mm_srai_epi32(p0, 15));
+            sum1 = _mm_add_epi32(sum1, _mm_srai_epi32(p1, 15));
+        }
+
+        __m128i out = _mm_packs_epi32(sum0, sum1);
+        if (((dstPtr + i) & 1) == 0) {
+            _mm_storeu_si128((__m128i *)(buf + dstPtr + i), swap_pairs(out));
+        } else {
+            s16 tmp[8];
+            _mm_storeu_si128((__m128i *)tmp, out);
+            for (k = 0; k < 8; k++)
+                buf[(dstPtr + i + k)^S] = tmp[k];
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        resample_one(buf, dstPtr + i, &src, &accum, pitch);
+
+    *srcPtr = src;
+    return accum;
+}
+
+void alist_filter(s16 *dst, const s16 *inp1, const s16 *inp2, const s16 *lut)
+{
+#ifdef ALIST_SSE2
+    // In sample order, output n is the dot product of samples n+1..n+8 with
+    // lut[6], lut[7], lut[4], lut[5], lut[2], lut[3], lut[0], lut[1]
+    const __m128i c = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)lut), _MM_SHUFFLE(0, 1, 2, 3));
+    const __m128i lo = swap_pairs(_mm_loadu_si128((const __m128i *)inp1));
+    const __m128i hi = swap_pairs(_mm_loadu_si128((const __m128i *)inp2));
+
+#define FILTER_TAPS(n) _mm_madd_epi16(c, _mm_or_si128(_mm_srli_si128(lo, 2 * (n) + 2), _mm_slli_si128(hi, 14 - 2 * (n))))
+    __m128i m0 = FILTER_TAPS(0), m1 = FILTER_TAPS(1), m2 = FILTER_TAPS(2), m3 = FILTER_TAPS(3);
+    __m128i m4 = FILTER_TAPS(4), m5 = FILTER_TAPS(5), m6 = FILTER_TAPS(6), m7 = FILTER_TAPS(7);
+#undef FILTER_TAPS
+
+    // horizontal sums of m0..m3 and m4..m7
+    __m128i s01 = _mm_add_epi32(_mm_unpacklo_epi32(m0, m1), _mm_unpackhi_epi32(m0, m1));
+    __m128i s23 = _mm_add_epi32(_mm_unpacklo_epi32(m2, m3), _mm_unpackhi_epi32(m2, m3));
+    __m128i s45 = _mm_add_epi32(_mm_unpacklo_epi32(m4, m5), _mm_unpackhi_epi32(m4, m5));
+    __m128i s67 = _mm_add_epi32(_mm_unpacklo_epi32(m6, m7), _mm_unpackhi_epi32(m6, m7));
+    __m128i y0 = _mm_add_epi32(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+    __m128i y1 = _mm_add_epi32(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+
+    // rounded and truncated to 16 bits, not clamped
+    const __m128i round = _mm_set1_epi32(0x4000);
+    y0 = _mm_srai_epi32(_mm_add_epi32(y0, round), 15);
+    y1 = _mm_srai_epi32(_mm_add_epi32(y1, round), 15);
+    y0 = _mm_srai_epi32(_mm_slli_epi32(y0, 16), 16);
+    y1 = _mm_srai_epi32(_mm_slli_epi32(y1, 16), 16);
+    _mm_storeu_si128((__m128i *)dst, swap_pairs(_mm_packs_epi32(y0, y1)));
+#else
+    // the word order of inp and dst is fixed here, as in the original handler
+    s32 sum[8];
+
+    sum[1] =  inp1[0]*lut[6];
+    sum[1] += inp1[3]*lut[7];
+    sum[1] += inp1[2]*lut[4];
+    sum[1] += inp1[5]*lut[5];
+    sum[1] += inp1[4]*lut[2];
+    sum[1] += inp1[7]*lut[3];
+    sum[1] += inp1[6]*lut[0];
+    sum[1] += inp2[1]*lut[1]; // 1
+
+    sum[0] =  inp1[3]*lut[6];
+    sum[0] += inp1[2]*lut[7];
+    sum[0] += inp1[5]*lut[4];
+    sum[0] += inp1[4]*lut[5];
+    sum[0] += inp1[7]*lut[2];
+    sum[0] += inp1[6]*lut[3];
+    sum[0] += inp2[1]*lut[0];
+    sum[0] += inp2[0]*lut[1];
+
+    sum[3] =  inp1[2]*lut[6];
+    sum[3] += inp1[5]*lut[7];
+    sum[3] += inp1[4]*lut[4];
+    sum[3] += inp1[7]*lut[5];
+    sum[3] += inp1[6]*lut[2];
+    sum[3] += inp2[1]*lut[3];
+    sum[3] += inp2[0]*lut[0];
+    sum[3] += inp2[3]*lut[1];
+
+    sum[2] =  inp1[5]*lut[6];
+    sum[2] += inp1[4]*lut[7];
+    sum[2] += inp1[7]*lut[4];
+    sum[2] += inp1[6]*lut[5];
+    sum[2] += inp2[1]*lut[2];
+    sum[2] += inp2[0]*lut[3];
+    sum[2] += inp2[3]*lut[0];
+    sum[2] += inp2[2]*lut[1];
+
+    sum[5] =  inp1[4]*lut[6];
+    sum[5] += inp1[7]*lut[7];
+    sum[5] += inp1[6]*lut[4];
+    sum[5] += inp2[1]*lut[5];
+    sum[5] += inp2[0]*lut[2];
+    sum[5] += inp2[3]*lut[3];
+    sum[5] += inp2[2]*lut[0];
+    sum[5] += inp2[5]*lut[1];
+
+    sum[4] =  inp1[7]*lut[6];
+    sum[4] += inp1[6]*lut[7];
+    sum[4] += inp2[1]*lut[4];
+    sum[4] += inp2[0]*lut[5];
+    sum[4] += inp2[3]*lut[2];
+    sum[4] += inp2[2]*lut[3];
+    sum[4] += inp2[5]*lut[0];
+    sum[4] += inp2[4]*lut[1];
+
+    sum[7] =  inp1[6]*lut[6];
+    sum[7] += inp2[1]*lut[7];
+    sum[7] += inp2[0]*lut[4];
+    sum[7] += inp2[3]*lut[5];
+    sum[7] += inp2[2]*lut[2];
+    sum[7] += inp2[5]*lut[3];
+    sum[7] += inp2[4]*lut[0];
+    sum[7] += inp2[7]*lut[1];
+
+    sum[6] =  inp2[1]*lut[6];
+    sum[6] += inp2[0]*lut[7];
+    sum[6] += inp2[3]*lut[4];
+    sum[6] += inp2[2]*lut[5];
+    sum[6] += inp2[5]*lut[2];
+    sum[6] += inp2[4]*lut[3];
+    sum[6] += inp2[7]*lut[0];
+    sum[6] += inp2[6]*lut[1];
+    dst[1] = /*CLAMP*/((sum[1]+0x4000) >> 0xF);
+    dst[0] = /*CLAMP*/((sum[0]+0x4000) >> 0xF);
+    dst[3] = /*CLAMP*/((sum[3]+0x4000) >> 0xF);
+    dst[2] = /*CLAMP*/((sum[2]+0x4000) >> 0xF);
+    dst[5] = /*CLAMP*/((sum[5]+0x4000) >> 0xF);
+    dst[4] = /*CLAMP*/((sum[4]+0x4000) >> 0xF);
+    dst[7] = /*CLAMP*/((sum[7]+0x4000) >> 0xF);
+    dst[6] = /*CLAMP*/((sum[6]+0x4000) >> 0xF);
+#endif
+}
@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus-rsp-hle - alist_kernels.h                                 *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef ALIST_KERNELS_H
+#define ALIST_KERNELS_H
+
+extern "C" {
+  #include "hle.h"
+}
+
+// Inner loops shared by the audio list handlers of the three ABIs. Each one
+// gives bit-exact results of the loop it replaced; they use SSE2 when the
+// compiler targets it, unless HLE_NO_SSE2 is defined.
+
+// dst[i] = clamp(dst[i] + ((src[i] * gain) >> 15)), for MIXER, MIXER2, MIXER3
+void alist_mix(s16 *dst, const s16 *src, u32 count, s16 gain);
+
+// Interleaves count pairs of left and right samples into dst, for INTERLEAVE,
+// INTERLEAVE2, INTERLEAVE3
+void alist_interleave(u16 *dst, const u16 *left, const u16 *right, u32 count);
+
+// Predicts 8 samples of an ADPCM frame from the 8 decoded residuals in inp and
+// the two previous samples l1, l2, which are updated; writes them to dst in
+// RSP word order
+void alist_adpcm_predict(s16 *dst, const s16 *book1, const s16 *book2, const int *inp, int *l1, int *l2);
+
+// One 8 sample block of ENVMIXER2: buffs3 scaled by the envelope into the
+// dry (bufft6, bufft7) and wet (buffs0, buffs1) buffers
+void alist_envmix8(s16 *bufft6, s16 *bufft7, s16 *buffs0, s16 *buffs1, const s16 *buffs3,
+                   u16 env_l, u16 env_r, u16 env_wet, const s16 *v2, bool swap_wet);
+
+// Four tap resampler of RESAMPLE, RESAMPLE2, RESAMPLE3. Writes count samples at
+// word dstPtr of BufferSpace from input at word *srcPtr, which is advanced;
+// returns the new fractional position
+u32 alist_resample(u32 dstPtr, u32 *srcPtr, u32 count, u32 accum, u32 pitch);
+
+// 8 outputs of the FILTER2 FIR from the 8 samples of inp1 followed by inp2
+void alist_filter(s16 *dst, const s16 *inp1, const s16 *inp2, const s16 *lut);
+
+#endif
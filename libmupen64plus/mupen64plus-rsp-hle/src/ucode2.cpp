@@ -29,6 +29,8 @@ extern "C" {
   #include "alist_internal.h"
 }
 
+#include "alist_kernels.h"
+
 extern u8 BufferSpace[0x10000];
 
 static void SPNOOP (u32 inst1, u32 inst2) {
@@ -94,7 +96,6 @@ static void ADPCM2 (u32 inst1, u32 inst2) { // Verified to be 100% Accurate...
     int vscale;
     unsigned short index;
     unsigned short j;
-    int a[8];
     short *book1,*book2;
 
     u8 srange;
@@ -210,145 +211,11 @@ static void ADPCM2 (u32 inst1, u32 inst2) { // Verified to be 100% Accurate...
             } // end flags
         }
 
-        a[0]= (int)book1[0]*(int)l1;
-        a[0]+=(int)book2[0]*(int)l2;
-        a[0]+=(int)inp1[0]*(int)2048;
-
-        a[1] =(int)book1[1]*(int)l1;
-        a[1]+=(int)book2[1]*(int)l2;
-        a[1]+=(int)book2[0]*inp1[0];
-        a[1]+=(int)inp1[1]*(int)2048;
-
-        a[2] =(int)book1[2]*(int)l1;
-        a[2]+=(int)book2[2]*(int)l2;
-        a[2]+=(int)book2[1]*inp1[0];
-        a[2]+=(int)book2[0]*inp1[1];
-        a[2]+=(int)inp1[2]*(int)2048;
-
-        a[3] =(int)book1[3]*(int)l1;
-        a[3]+=(int)book2[3]*(int)l2;
-        a[3]+=(int)book2[2]*inp1[0];
-        a[3]+=(int)book2[1]*inp1[1];
-        a[3]+=(int)book2[0]*inp1[2];
-        a[3]+=(int)inp1[3]*(int)2048;
-
-        a[4] =(int)book1[4]*(int)l1;
-        a[4]+=(int)book2[4]*(int)l2;
-        a[4]+=(int)book2[3]*inp1[0];
-        a[4]+=(int)book2[2]*inp1[1];
-        a[4]+=(int)book2[1]*inp1[2];
-        a[4]+=(int)book2[0]*inp1[3];
-        a[4]+=(int)inp1[4]*(int)2048;
-
-        a[5] =(int)book1[5]*(int)l1;
-        a[5]+=(int)book2[5]*(int)l2;
-        a[5]+=(int)book2[4]*inp1[0];
-        a[5]+=(int)book2[3]*inp1[1];
-        a[5]+=(int)book2[2]*inp1[2];
-        a[5]+=(int)book2[1]*inp1[3];
-        a[5]+=(int)book2[0]*inp1[4];
-        a[5]+=(int)inp1[5]*(int)2048;
-
-        a[6] =(int)book1[6]*(int)l1;
-        a[6]+=(int)book2[6]*(int)l2;
-        a[6]+=(int)book2[5]*inp1[0];
-        a[6]+=(int)book2[4]*inp1[1];
-        a[6]+=(int)book2[3]*inp1[2];
-        a[6]+=(int)book2[2]*inp1[3];
-        a[6]+=(int)book2[1]*inp1[4];
-        a[6]+=(int)book2[0]*inp1[5];
-        a[6]+=(int)inp1[6]*(int)2048;
-
-        a[7] =(int)book1[7]*(int)l1;
-        a[7]+=(int)book2[7]*(int)l2;
-        a[7]+=(int)book2[6]*inp1[0];
-        a[7]+=(int)book2[5]*inp1[1];
-        a[7]+=(int)book2[4]*inp1[2];
-        a[7]+=(int)book2[3]*inp1[3];
-        a[7]+=(int)book2[2]*inp1[4];
-        a[7]+=(int)book2[1]*inp1[5];
-        a[7]+=(int)book2[0]*inp1[6];
-        a[7]+=(int)inp1[7]*(int)2048;
-
-        for(j=0;j<8;j++)
-        {
-            a[j^S]>>=11;
-            if(a[j^S]>32767) a[j^S]=32767;
-            else if(a[j^S]<-32768) a[j^S]=-32768;
-            *(out++)=a[j^S];
-        }
-        l1=a[6];
-        l2=a[7];
-
-        a[0]= (int)book1[0]*(int)l1;
-        a[0]+=(int)book2[0]*(int)l2;
-        a[0]+=(int)inp2[0]*(int)2048;
-
-        a[1] =(int)book1[1]*(int)l1;
-        a[1]+=(int)book2[1]*(int)l2;
-        a[1]+=(int)book2[0]*inp2[0];
-        a[1]+=(int)inp2[1]*(int)2048;
-
-        a[2] =(int)book1[2]*(int)l1;
-        a[2]+=(int)book2[2]*(int)l2;
-        a[2]+=(int)book2[1]*inp2[0];
-        a[2]+=(int)book2[0]*inp2[1];
-        a[2]+=(int)inp2[2]*(int)2048;
-
-        a[3] =(int)book1[3]*(int)l1;
-        a[3]+=(int)book2[3]*(int)l2;
-        a[3]+=(int)book2[2]*inp2[0];
-        a[3]+=(int)book2[1]*inp2[1];
-        a[3]+=(int)book2[0]*inp2[2];
-        a[3]+=(int)inp2[3]*(int)2048;
-
-        a[4] =(int)book1[4]*(int)l1;
-        a[4]+=(int)book2[4]*(int)l2;
-        a[4]+=(int)book2[3]*inp2[0];
-        a[4]+=(int)book2[2]*inp2[1];
-        a[4]+=(int)book2[1]*inp2[2];
-        a[4]+=(int)book2[0]*inp2[3];
-        a[4]+=(int)inp2[4]*(int)2048;
-
-        a[5] =(int)book1[5]*(int)l1;
-        a[5]+=(int)book2[5]*(int)l2;
-        a[5]+=(int)book2[4]*inp2[0];
-        a[5]+=(int)book2[3]*inp2[1];
-        a[5]+=(int)book2[2]*inp2[2];
-        a[5]+=(int)book2[1]*inp2[3];
-        a[5]+=(int)book2[0]*inp2[4];
-        a[5]+=(int)inp2[5]*(int)2048;
-
-        a[6] =(int)book1[6]*(int)l1;
-        a[6]+=(int)book2[6]*(int)l2;
-        a[6]+=(int)book2[5]*inp2[0];
-        a[6]+=(int)book2[4]*inp2[1];
-        a[6]+=(int)book2[3]*inp2[2];
-        a[6]+=(int)book2[2]*inp2[3];
-        a[6]+=(int)book2[1]*inp2[4];
-        a[6]+=(int)book2[0]*inp2[5];
-        a[6]+=(int)inp2[6]*(int)2048;
-
-        a[7] =(int)book1[7]*(int)l1;
-        a[7]+=(int)book2[7]*(int)l2;
-        a[7]+=(int)book2[6]*inp2[0];
-        a[7]+=(int)book2[5]*inp2[1];
-        a[7]+=(int)book2[4]*inp2[2];
-        a[7]+=(int)book2[3]*inp2[3];
-        a[7]+=(int)book2[2]*inp2[4];
-        a[7]+=(int)book2[1]*inp2[5];
-        a[7]+=(int)book2[0]*inp2[6];
-        a[7]+=(int)inp2[7]*(int)2048;
-
-        for(j=0;j<8;j++)
-        {
-            a[j^S]>>=11;
-            if(a[j^S]>32767) a[j^S]=32767;
-            else if(a[j^S]<-32768) a[j^S]=-32768;
-            *(out++)=a[j^S];
-        }
-        l1=a[6];
-        l2=a[7];
+        alist_adpcm_predict(out, book1, book2, inp1, &l1, &l2);
+        out+=8;
+
+        alist_adpcm_predict(out, book1, book2, inp2, &l1, &l2);
+        out+=8;
 
         count-=32;
     }
@@ -383,20 +250,8 @@ static void MIXER2 (u32 inst1, u32 inst2) { // Needs accuracy verification...
     u16 dmemout = (u16)(inst2 & 0xFFFF);
     u32 count   = ((inst1 >> 12) & 0xFF0);
     s32 gain    = (s16)(inst1 & 0xFFFF);
-    s32 temp;
-
-    for (unsigned int x=0; x < count; x+=2) { // I think I can do this a lot easier 
 
-        temp = (*(s16 *)(BufferSpace+dmemin+x) * gain) >> 15;
-        temp += *(s16 *)(BufferSpace+dmemout+x);
-            
-        if ((s32)temp > 32767) 
-            temp = 32767;
-        if ((s32)temp < -32768) 
-            temp = -32768;
-
-        *(u16 *)(BufferSpace+dmemout+x) = (u16)(temp & 0xFFFF);
-    }
+    alist_mix((s16 *)(BufferSpace+dmemout), (s16 *)(BufferSpace+dmemin), count/2, (s16)gain);
 }
 
 
@@ -405,16 +260,10 @@ static void RESAMPLE2 (u32 inst1, u32 inst2) {
     unsigned int Pitch=((inst1&0xffff))<<1;
     u32 addy = (inst2 & 0xffffff);// + SEGMENTS[(inst2>>24)&0xf];
     unsigned int Accum=0;
-    unsigned int location;
-    s16 *lut;
-    short *dst;
     s16 *src;
-    dst=(short *)(BufferSpace);
     src=(s16 *)(BufferSpace);
     u32 srcPtr=(AudioInBuffer/2);
     u32 dstPtr=(AudioOutBuffer/2);
-    s32 temp;
-    s32 accum;
 
     if (addy > (1024*1024*8))
         addy = (inst2 & 0xffffff);
@@ -430,32 +279,7 @@ static void RESAMPLE2 (u32 inst1, u32 inst2) {
             src[(srcPtr+x)^S] = 0;//*(u16 *)(rsp.RDRAM+((addy+x)^2));
     }
 
-    for(int i=0;i < ((AudioCount+0xf)&0xFFF0)/2;i++)    {
-        location = (((Accum * 0x40) >> 0x10) * 8);
-        //location = (Accum >> 0xa) << 0x3;
-        lut = (s16 *)(((u8 *)ResampleLUT) + location);
-
-        temp =  ((s32)*(s16*)(src+((srcPtr+0)^S))*((s32)((s16)lut[0])));
-        accum = (s32)(temp >> 15);
-
-        temp = ((s32)*(s16*)(src+((srcPtr+1)^S))*((s32)((s16)lut[1])));
-        accum += (s32)(temp >> 15);
-
-        temp = ((s32)*(s16*)(src+((srcPtr+2)^S))*((s32)((s16)lut[2])));
-        accum += (s32)(temp >> 15);
-        
-        temp = ((s32)*(s16*)(src+((srcPtr+3)^S))*((s32)((s16)lut[3])));
-        accum += (s32)(temp >> 15);
-
-        if (accum > 32767) accum = 32767;
-        if (accum < -32768) accum = -32768;
-
-        dst[dstPtr^S] = (s16)(accum);
-        dstPtr++;
-        Accum += Pitch;
-        srcPtr += (Accum>>16);
-        Accum&=0xffff;
-    }
+    Accum = alist_resample(dstPtr, &srcPtr, ((AudioCount+0xf)&0xFFF0)/2, Accum, Pitch);
     for (int x=0; x < 4; x++)
         ((u16 *)rsp.RDRAM)[((addy/2)+x)^S] = src[(srcPtr+x)^S];
     *(u16 *)(rsp.RDRAM+addy+10) = (u16)Accum;
@@ -521,8 +345,6 @@ static void ENVMIXER2 (u32 inst1, u32 inst2) {
     s32 count;
     u32 adder;
 
-    s16 vec9, vec10;
-
     s16 v2[8];
 
     buffs3 = (s16 *)(BufferSpace + ((inst1 >> 0x0c)&0x0ff0));
@@ -550,63 +372,9 @@ static void ENVMIXER2 (u32 inst1, u32 inst2) {
 
 
     while (count > 0) {
-        int temp, x;
-        for (x=0; x < 0x8; x++) {
-            vec9  = (s16)(((s32)buffs3[x^S] * (u32)env[0]) >> 0x10) ^ v2[0];
-            vec10 = (s16)(((s32)buffs3[x^S] * (u32)env[2]) >> 0x10) ^ v2[1];
-            temp = bufft6[x^S] + vec9;
-            if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-            bufft6[x^S] = temp;
-            temp = bufft7[x^S] + vec10;
-            if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-            bufft7[x^S] = temp;
-            vec9  = (s16)(((s32)vec9  * (u32)env[4]) >> 0x10) ^ v2[2];
-            vec10 = (s16)(((s32)vec10 * (u32)env[4]) >> 0x10) ^ v2[3];
-            if (inst1 & 0x10) {
-                temp = buffs0[x^S] + vec10;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs0[x^S] = temp;
-                temp = buffs1[x^S] + vec9;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs1[x^S] = temp;
-            } else {
-                temp = buffs0[x^S] + vec9;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs0[x^S] = temp;
-                temp = buffs1[x^S] + vec10;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs1[x^S] = temp;
-            }
-        }
-
+        alist_envmix8(bufft6, bufft7, buffs0, buffs1, buffs3, env[0], env[2], env[4], v2, (inst1 & 0x10) != 0);
         if (!isMKABI)
-        for (x=0x8; x < 0x10; x++) {
-            vec9  = (s16)(((s32)buffs3[x^S] * (u32)env[1]) >> 0x10) ^ v2[0];
-            vec10 = (s16)(((s32)buffs3[x^S] * (u32)env[3]) >> 0x10) ^ v2[1];
-            temp = bufft6[x^S] + vec9;
-            if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-            bufft6[x^S] = temp;
-           temp = bufft7[x^S] + vec10;
-            if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-            bufft7[x^S] = temp;
-            vec9  = (s16)(((s32)vec9  * (u32)env[5]) >> 0x10) ^ v2[2];
-            vec10 = (s16)(((s32)vec10 * (u32)env[5]) >> 0x10) ^ v2[3];
-            if (inst1 & 0x10) {
-                temp = buffs0[x^S] + vec10;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs0[x^S] = temp;
-                temp = buffs1[x^S] + vec9;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs1[x^S] = temp;
-            } else {
-                temp = buffs0[x^S] + vec9;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs0[x^S] = temp;
-                temp = buffs1[x^S] + vec10;
-                if (temp > 32767)  temp = 32767; if (temp < -32768) temp = -32768;
-                buffs1[x^S] = temp;
-            }
-        }
+            alist_envmix8(bufft6+8, bufft7+8, buffs0+8, buffs1+8, buffs3+8, env[1], env[3], env[5], v2, (inst1 & 0x10) != 0);
         bufft6 += adder; bufft7 += adder;
         buffs0 += adder; buffs1 += adder;
         buffs3 += adder; count  -= adder;
@@ -684,7 +452,6 @@ static void INTERLEAVE2 (u32 inst1, u32 inst2) { // Needs accuracy verification.
     u16 *outbuff;
     u16 *inSrcR;
     u16 *inSrcL;
-    u16 Left, Right, Left2, Right2;
     u32 count;
     count   = ((inst1 >> 12) & 0xFF0);
     if (count == 0) {
@@ -700,24 +467,7 @@ static void INTERLEAVE2 (u32 inst1, u32 inst2) { // Needs accuracy verification.
     inSrcR = (u16 *)(BufferSpace+inR);
     inSrcL = (u16 *)(BufferSpace+inL);
 
-    for (u32 x = 0; x < (count/4); x++) {
-        Left=*(inSrcL++);
-        Right=*(inSrcR++);
-        Left2=*(inSrcL++);
-        Right2=*(inSrcR++);
-
-#ifdef M64P_BIG_ENDIAN
-        *(outbuff++)=Right;
-        *(outbuff++)=Left;
-        *(outbuff++)=Right2;
-        *(outbuff++)=Left2;
-#else
-        *(outbuff++)=Right2;
-        *(outbuff++)=Left2;
-        *(outbuff++)=Right;
-        *(outbuff++)=Left;
-#endif
-    }
+    alist_interleave(outbuff, inSrcL, inSrcR, count/4);
 }
 
 static void ADDMIXER (u32 inst1, u32 inst2) {
@@ -789,92 +539,13 @@ static void FILTER2 (u32 inst1, u32 inst2) {
                 lutt5[x] = lutt6[x] = (short)a;
             }
             short *inp1, *inp2; 
-            s32 out1[8];
             s16 outbuff[0x3c0], *outp;
             u32 inPtr = (u32)(inst1&0xffff);
             inp1 = (short *)(save);
             outp = outbuff;
             inp2 = (short *)(BufferSpace+inPtr);
             for (x = 0; x < cnt; x+=0x10) {
-                out1[1] =  inp1[0]*lutt6[6];
-                out1[1] += inp1[3]*lutt6[7];
-                out1[1] += inp1[2]*lutt6[4];
-                out1[1] += inp1[5]*lutt6[5];
-                out1[1] += inp1[4]*lutt6[2];
-                out1[1] += inp1[7]*lutt6[3];
-                out1[1] += inp1[6]*lutt6[0];
-                out1[1] += inp2[1]*lutt6[1]; // 1
-
-                out1[0] =  inp1[3]*lutt6[6];
-                out1[0] += inp1[2]*lutt6[7];
-                out1[0] += inp1[5]*lutt6[4];
-                out1[0] += inp1[4]*lutt6[5];
-                out1[0] += inp1[7]*lutt6[2];
-                out1[0] += inp1[6]*lutt6[3];
-                out1[0] += inp2[1]*lutt6[0];
-                out1[0] += inp2[0]*lutt6[1];
-
-                out1[3] =  inp1[2]*lutt6[6];
-                out1[3] += inp1[5]*lutt6[7];
-                out1[3] += inp1[4]*lutt6[4];
-                out1[3] += inp1[7]*lutt6[5];
-                out1[3] += inp1[6]*lutt6[2];
-                out1[3] += inp2[1]*lutt6[3];
-                out1[3] += inp2[0]*lutt6[0];
-                out1[3] += inp2[3]*lutt6[1];
-
-                out1[2] =  inp1[5]*lutt6[6];
-                out1[2] += inp1[4]*lutt6[7];
-                out1[2] += inp1[7]*lutt6[4];
-                out1[2] += inp1[6]*lutt6[5];
-                out1[2] += inp2[1]*lutt6[2];
-                out1[2] += inp2[0]*lutt6[3];
-                out1[2] += inp2[3]*lutt6[0];
-                out1[2] += inp2[2]*lutt6[1];
-
-                out1[5] =  inp1[4]*lutt6[6];
-                out1[5] += inp1[7]*lutt6[7];
-                out1[5] += inp1[6]*lutt6[4];
-                out1[5] += inp2[1]*lutt6[5];
-                out1[5] += inp2[0]*lutt6[2];
-                out1[5] += inp2[3]*lutt6[3];
-                out1[5] += inp2[2]*lutt6[0];
-                out1[5] += inp2[5]*lutt6[1];
-
-                out1[4] =  inp1[7]*lutt6[6];
-                out1[4] += inp1[6]*lutt6[7];
-                out1[4] += inp2[1]*lutt6[4];
-                out1[4] += inp2[0]*lutt6[5];
-                out1[4] += inp2[3]*lutt6[2];
-                out1[4] += inp2[2]*lutt6[3];
-                out1[4] += inp2[5]*lutt6[0];
-                out1[4] += inp2[4]*lutt6[1];
-
-                out1[7] =  inp1[6]*lutt6[6];
-                out1[7] += inp2[1]*lutt6[7];
-                out1[7] += inp2[0]*lutt6[4];
-                out1[7] += inp2[3]*lutt6[5];
-                out1[7] += inp2[2]*lutt6[2];
-                out1[7] += inp2[5]*lutt6[3];
-                out1[7] += inp2[4]*lutt6[0];
-                out1[7] += inp2[7]*lutt6[1];
-
-                out1[6] =  inp2[1]*lutt6[6];
-                out1[6] += inp2[0]*lutt6[7];
-                out1[6] += inp2[3]*lutt6[4];
-                out1[6] += inp2[2]*lutt6[5];
-                out1[6] += inp2[5]*lutt6[2];
-                out1[6] += inp2[4]*lutt6[3];
-                out1[6] += inp2[7]*lutt6[0];
-                out1[6] += inp2[6]*lutt6[1];
-                outp[1] = /*CLAMP*/((out1[1]+0x4000) >> 0xF);
-                outp[0] = /*CLAMP*/((out1[0]+0x4000) >> 0xF);
-                outp[3] = /*CLAMP*/((out1[3]+0x4000) >> 0xF);
-                outp[2] = /*CLAMP*/((out1[2]+0x4000) >> 0xF);
-                outp[5] = /*CLAMP*/((out1[5]+0x4000) >> 0xF);
-                outp[4] = /*CLAMP*/((out1[4]+0x4000) >> 0xF);
-                outp[7] = /*CLAMP*/((out1[7]+0x4000) >> 0xF);
-                outp[6] = /*CLAMP*/((out1[6]+0x4000) >> 0xF);
+                alist_filter(outp, inp1, inp2, lutt6);
                 inp1 = inp2;
                 inp2 += 8;
                 outp += 8;
@@ -29,6 +29,8 @@ extern "C" {
   #include "alist_internal.h"
 }
 
+#include "alist_kernels.h"
+
 /*
 static void SPNOOP (u32 inst1, u32 inst2) {
     DebugMessage(M64MSG_ERROR, "Unknown/Unimplemented Audio Command %i in ABI 3", (int)(inst1 >> 24));
@@ -261,19 +263,8 @@ static void MIXER3 (u32 inst1, u32 inst2) { // Needs accuracy verification...
     u16 dmemout = (u16)(inst2 & 0xFFFF) + 0x4f0;
     //u8  flags   = (u8)((inst1 >> 16) & 0xff);
     s32 gain    = (s16)(inst1 & 0xFFFF);
-    s32 temp;
-
-    for (int x=0; x < 0x170; x+=2) { // I think I can do this a lot easier
-        temp = (*(s16 *)(BufferSpace+dmemin+x) * gain) >> 15;
-        temp += *(s16 *)(BufferSpace+dmemout+x);
-            
-        if ((s32)temp > 32767) 
-            temp = 32767;
-        if ((s32)temp < -32768) 
-            temp = -32768;
 
-        *(u16 *)(BufferSpace+dmemout+x) = (u16)(temp & 0xFFFF);
-    }
+    alist_mix((s16 *)(BufferSpace+dmemout), (s16 *)(BufferSpace+dmemin), 0x170/2, (s16)gain);
 }
 
 static void LOADBUFF3 (u32 inst1, u32 inst2) {
@@ -345,7 +336,6 @@ static void ADPCM3 (u32 inst1, u32 inst2) { // Verified to be 100% Accurate...
     int vscale;
     unsigned short index;
     unsigned short j;
-    int a[8];
     short *book1,*book2;
 
     memset(out,0,32);
@@ -438,148 +428,11 @@ static void ADPCM3 (u32 inst1, u32 inst2) { // Verified to be 100% Accurate...
             j++;
         }
 
-        a[0]= (int)book1[0]*(int)l1;
-        a[0]+=(int)book2[0]*(int)l2;
-        a[0]+=(int)inp1[0]*(int)2048;
-
-        a[1] =(int)book1[1]*(int)l1;
-        a[1]+=(int)book2[1]*(int)l2;
-        a[1]+=(int)book2[0]*inp1[0];
-        a[1]+=(int)inp1[1]*(int)2048;
-
-        a[2] =(int)book1[2]*(int)l1;
-        a[2]+=(int)book2[2]*(int)l2;
-        a[2]+=(int)book2[1]*inp1[0];
-        a[2]+=(int)book2[0]*inp1[1];
-        a[2]+=(int)inp1[2]*(int)2048;
-
-        a[3] =(int)book1[3]*(int)l1;
-        a[3]+=(int)book2[3]*(int)l2;
-        a[3]+=(int)book2[2]*inp1[0];
-        a[3]+=(int)book2[1]*inp1[1];
-        a[3]+=(int)book2[0]*inp1[2];
-        a[3]+=(int)inp1[3]*(int)2048;
-
-        a[4] =(int)book1[4]*(int)l1;
-        a[4]+=(int)book2[4]*(int)l2;
-        a[4]+=(int)book2[3]*inp1[0];
-        a[4]+=(int)book2[2]*inp1[1];
-        a[4]+=(int)book2[1]*inp1[2];
-        a[4]+=(int)book2[0]*inp1[3];
-        a[4]+=(int)inp1[4]*(int)2048;
-
-        a[5] =(int)book1[5]*(int)l1;
-        a[5]+=(int)book2[5]*(int)l2;
-        a[5]+=(int)book2[4]*inp1[0];
-        a[5]+=(int)book2[3]*inp1[1];
-        a[5]+=(int)book2[2]*inp1[2];
-        a[5]+=(int)book2[1]*inp1[3];
-        a[5]+=(int)book2[0]*inp1[4];
-        a[5]+=(int)inp1[5]*(int)2048;
-
-        a[6] =(int)book1[6]*(int)l1;
-        a[6]+=(int)book2[6]*(int)l2;
-        a[6]+=(int)book2[5]*inp1[0];
-        a[6]+=(int)book2[4]*inp1[1];
-        a[6]+=(int)book2[3]*inp1[2];
-        a[6]+=(int)book2[2]*inp1[3];
-        a[6]+=(int)book2[1]*inp1[4];
-        a[6]+=(int)book2[0]*inp1[5];
-        a[6]+=(int)inp1[6]*(int)2048;
-
-        a[7] =(int)book1[7]*(int)l1;
-        a[7]+=(int)book2[7]*(int)l2;
-        a[7]+=(int)book2[6]*inp1[0];
-        a[7]+=(int)book2[5]*inp1[1];
-        a[7]+=(int)book2[4]*inp1[2];
-        a[7]+=(int)book2[3]*inp1[3];
-        a[7]+=(int)book2[2]*inp1[4];
-        a[7]+=(int)book2[1]*inp1[5];
-        a[7]+=(int)book2[0]*inp1[6];
-        a[7]+=(int)inp1[7]*(int)2048;
-
-        for(j=0;j<8;j++)
-        {
-            a[j^S]>>=11;
-            if(a[j^S]>32767) a[j^S]=32767;
-            else if(a[j^S]<-32768) a[j^S]=-32768;
-            *(out++)=a[j^S];
-            //*(out+j)=a[j^S];
-        }
-        //out += 0x10;
-        l1=a[6];
-        l2=a[7];
-
-        a[0]= (int)book1[0]*(int)l1;
-        a[0]+=(int)book2[0]*(int)l2;
-        a[0]+=(int)inp2[0]*(int)2048;
-
-        a[1] =(int)book1[1]*(int)l1;
-        a[1]+=(int)book2[1]*(int)l2;
-        a[1]+=(int)book2[0]*inp2[0];
-        a[1]+=(int)inp2[1]*(int)2048;
-
-        a[2] =(int)book1[2]*(int)l1;
-        a[2]+=(int)book2[2]*(int)l2;
-        a[2]+=(int)book2[1]*inp2[0];
-        a[2]+=(int)book2[0]*inp2[1];
-        a[2]+=(int)inp2[2]*(int)2048;
-
-        a[3] =(int)book1[3]*(int)l1;
-        a[3]+=(int)book2[3]*(int)l2;
-        a[3]+=(int)book2[2]*inp2[0];
-        a[3]+=(int)book2[1]*inp2[1];
-        a[3]+=(int)book2[0]*inp2[2];
-        a[3]+=(int)inp2[3]*(int)2048;
-
-        a[4] =(int)book1[4]*(int)l1;
-        a[4]+=(int)book2[4]*(int)l2;
-        a[4]+=(int)book2[3]*inp2[0];
-        a[4]+=(int)book2[2]*inp2[1];
-        a[4]+=(int)book2[1]*inp2[2];
-        a[4]+=(int)book2[0]*inp2[3];
-        a[4]+=(int)inp2[4]*(int)2048;
-
-        a[5] =(int)book1[5]*(int)l1;
-        a[5]+=(int)book2[5]*(int)l2;
-        a[5]+=(int)book2[4]*inp2[0];
-        a[5]+=(int)book2[3]*inp2[1];
-        a[5]+=(int)book2[2]*inp2[2];
-        a[5]+=(int)book2[1]*inp2[3];
-        a[5]+=(int)book2[0]*inp2[4];
-        a[5]+=(int)inp2[5]*(int)2048;
-
-        a[6] =(int)book1[6]*(int)l1;
-        a[6]+=(int)book2[6]*(int)l2;
-        a[6]+=(int)book2[5]*inp2[0];
-        a[6]+=(int)book2[4]*inp2[1];
-        a[6]+=(int)book2[3]*inp2[2];
-        a[6]+=(int)book2[2]*inp2[3];
-        a[6]+=(int)book2[1]*inp2[4];
-        a[6]+=(int)book2[0]*inp2[5];
-        a[6]+=(int)inp2[6]*(int)2048;
-
-        a[7] =(int)book1[7]*(int)l1;
-        a[7]+=(int)book2[7]*(int)l2;
-        a[7]+=(int)book2[6]*inp2[0];
-        a[7]+=(int)book2[5]*inp2[1];
-        a[7]+=(int)book2[4]*inp2[2];
-        a[7]+=(int)book2[3]*inp2[3];
-        a[7]+=(int)book2[2]*inp2[4];
-        a[7]+=(int)book2[1]*inp2[5];
-        a[7]+=(int)book2[0]*inp2[6];
-        a[7]+=(int)inp2[7]*(int)2048;
-
-        for(j=0;j<8;j++)
-        {
-            a[j^S]>>=11;
-            if(a[j^S]>32767) a[j^S]=32767;
-            else if(a[j^S]<-32768) a[j^S]=-32768;
-            *(out++)=a[j^S];
-            //*(out+j+0x1f8)=a[j^S];
-        }
-        l1=a[6];
-        l2=a[7];
+        alist_adpcm_predict(out, book1, book2, inp1, &l1, &l2);
+        out+=8;
+
+        alist_adpcm_predict(out, book1, book2, inp2, &l1, &l2);
+        out+=8;
 
         count-=32;
     }
@@ -592,16 +445,10 @@ static void RESAMPLE3 (u32 inst1, u32 inst2) {
     unsigned int Pitch=((inst2>>0xe)&0xffff)<<1;
     u32 addy = (inst1 & 0xffffff);
     unsigned int Accum=0;
-    unsigned int location;
-    s16 *lut;
-    short *dst;
     s16 *src;
-    dst=(short *)(BufferSpace);
     src=(s16 *)(BufferSpace);
     u32 srcPtr=((((inst2>>2)&0xfff)+0x4f0)/2);
     u32 dstPtr;//=(AudioOutBuffer/2);
-    s32 temp;
-    s32 accum;
 
     //if (addy > (1024*1024*8))
     //  addy = (inst2 & 0xffffff);
@@ -623,63 +470,7 @@ static void RESAMPLE3 (u32 inst1, u32 inst2) {
             src[(srcPtr+x)^S] = 0;//*(u16 *)(rsp.RDRAM+((addy+x)^2));
     }
 
-    for(int i=0;i < 0x170/2;i++)    {
-        location = (((Accum * 0x40) >> 0x10) * 8);
-        //location = (Accum >> 0xa) << 0x3;
-        lut = (s16 *)(((u8 *)ResampleLUT) + location);
-
-        temp =  ((s32)*(s16*)(src+((srcPtr+0)^S))*((s32)((s16)lut[0])));
-        accum = (s32)(temp >> 15);
-
-        temp = ((s32)*(s16*)(src+((srcPtr+1)^S))*((s32)((s16)lut[1])));
-        accum += (s32)(temp >> 15);
-
-        temp = ((s32)*(s16*)(src+((srcPtr+2)^S))*((s32)((s16)lut[2])));
-        accum += (s32)(temp >> 15);
-        
-        temp = ((s32)*(s16*)(src+((srcPtr+3)^S))*((s32)((s16)lut[3])));
-        accum += (s32)(temp >> 15);
-/*      temp =  ((s64)*(s16*)(src+((srcPtr+0)^S))*((s64)((s16)lut[0]<<1)));
-        if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-        else temp = (temp^0x8000);
-        temp = (s32)(temp >> 16);
-        if ((s32)temp > 32767) temp = 32767;
-        if ((s32)temp < -32768) temp = -32768;
-        accum = (s32)(s16)temp;
-
-        temp = ((s64)*(s16*)(src+((srcPtr+1)^S))*((s64)((s16)lut[1]<<1)));
-        if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-        else temp = (temp^0x8000);
-        temp = (s32)(temp >> 16);
-        if ((s32)temp > 32767) temp = 32767;
-        if ((s32)temp < -32768) temp = -32768;
-        accum += (s32)(s16)temp;
-
-        temp = ((s64)*(s16*)(src+((srcPtr+2)^S))*((s64)((s16)lut[2]<<1)));
-        if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-        else temp = (temp^0x8000);
-        temp = (s32)(temp >> 16);
-        if ((s32)temp > 32767) temp = 32767;
-        if ((s32)temp < -32768) temp = -32768;
-        accum += (s32)(s16)temp;
-
-        temp = ((s64)*(s16*)(src+((srcPtr+3)^S))*((s64)((s16)lut[3]<<1)));
-        if (temp & 0x8000) temp = (temp^0x8000) + 0x10000;
-        else temp = (temp^0x8000);
-        temp = (s32)(temp >> 16);
-        if ((s32)temp > 32767) temp = 32767;
-        if ((s32)temp < -32768) temp = -32768;
-        accum += (s32)(s16)temp;*/
-
-        if (accum > 32767) accum = 32767;
-        if (accum < -32768) accum = -32768;
-
-        dst[dstPtr^S] = (accum);
-        dstPtr++;
-        Accum += Pitch;
-        srcPtr += (Accum>>16);
-        Accum&=0xffff;
-    }
+    Accum = alist_resample(dstPtr, &srcPtr, 0x170/2, Accum, Pitch);
     for (int x=0; x < 4; x++)
         ((u16 *)rsp.RDRAM)[((addy/2)+x)^S] = src[(srcPtr+x)^S];
     *(u16 *)(rsp.RDRAM+addy+10) = Accum;
@@ -690,7 +481,6 @@ static void INTERLEAVE3 (u32 inst1, u32 inst2) { // Needs accuracy verification.
     u16 *outbuff = (u16 *)(BufferSpace + 0x4f0);//(u16 *)(AudioOutBuffer+dmem);
     u16 *inSrcR;
     u16 *inSrcL;
-    u16 Left, Right, Left2, Right2;
 
     //inR = inst2 & 0xFFFF;
     //inL = (inst2 >> 16) & 0xFFFF;
@@ -698,33 +488,7 @@ static void INTERLEAVE3 (u32 inst1, u32 inst2) { // Needs accuracy verification.
     inSrcR = (u16 *)(BufferSpace+0xb40);
     inSrcL = (u16 *)(BufferSpace+0x9d0);
 
-    for (int x = 0; x < (0x170/4); x++) {
-        Left=*(inSrcL++);
-        Right=*(inSrcR++);
-        Left2=*(inSrcL++);
-        Right2=*(inSrcR++);
-
-#ifdef M64P_BIG_ENDIAN
-        *(outbuff++)=Right;
-        *(outbuff++)=Left;
-        *(outbuff++)=Right2;
-        *(outbuff++)=Left2;
-#else
-        *(outbuff++)=Right2;
-        *(outbuff++)=Left2;
-        *(outbuff++)=Right;
-        *(outbuff++)=Left;
-#endif
-/*
-        Left=*(inSrcL++);
-        Right=*(inSrcR++);
-        *(outbuff++)=(u16)Left;
-        Left >>= 16;
-        *(outbuff++)=(u16)Right;
-        Right >>= 16;
-        *(outbuff++)=(u16)Left;
-        *(outbuff++)=(u16)Right;*/
-    }
+    alist_interleave(outbuff, inSrcL, inSrcR, 0x170/4);
 }
 
 //static void UNKNOWN (u32 inst1, u32 inst2);
@@ -0,0 +1,431 @@
+/* Golden-vector test and microbenchmark for the audio list handlers.
+ *
+ * Plays deterministic audio lists through the ABI1, ABI2 (plain, MK and Zelda
+ * variants) and ABI3 dispatch tables, one command per task, over random RDRAM
+ * and DMEM. After every command it hashes BufferSpace and the ADPCM table,
+ * and at the end of each list the RDRAM window. Buffer addresses are drawn
+ * close to each other often enough that inputs and outputs overlap.
+ *
+ * The output must match golden.txt, which was recorded with the original
+ * scalar handlers, in both the SSE2 and the HLE_NO_SSE2 builds.
+ *
+ *   alisttest            print one line of hashes per list
+ *   alisttest -v         also print the hash after every command
+ *   alisttest -bench     time the kernel-heavy commands (to stderr)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern "C" {
+  #include "m64p_types.h"
+  #include "hle.h"
+  #include "alist.h"
+}
+
+extern u8 BufferSpace[0x10000];
+extern u16 adpcmtable[0x88];
+
+extern "C" {
+RSP_INFO rsp;
+
+void DebugMessage(int level, const char *message, ...)
+{
+}
+}
+
+#define SEEDS 16
+#define COMMANDS 600
+
+/* RDRAM addresses used by the lists stay in this window, which is hashed */
+#define WINDOW 0x40000
+#define ALIST 0x7f0000
+
+static u8 *rdram;
+static u8 dmem[0x1000];
+static u8 imem[0x1000];
+
+static u32 rng;
+
+static u32 rand32()
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static u32 range(u32 lo, u32 hi)
+{
+    return lo + rand32() % (hi - lo);
+}
+
+static u64 hash(u64 h, const void *data, size_t size)
+{
+    const u8 *p = (const u8 *)data;
+    for (size_t i = 0; i < size; i += 8)
+    {
+        u64 v;
+        memcpy(&v, p + i, 8);
+        h = (h ^ v) * 0x100000001b3ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+/* Runs one command as a task of its own */
+static void run(void (*process)(), u32 inst1, u32 inst2)
+{
+    OSTask_t *task = (OSTask_t *)(dmem + 0xfc0);
+    *(u32 *)(rdram + ALIST) = inst1;
+    *(u32 *)(rdram + ALIST + 4) = inst2;
+    task->data_ptr = ALIST;
+    task->data_size = 8;
+    process();
+}
+
+/* DMEM buffer address; often close to the previous one so buffers overlap */
+static u32 last_addr = 0x800;
+
+static u32 dmem_addr(u32 lo, u32 hi)
+{
+    u32 a;
+    if (rand32() & 1)
+        a = range(lo, hi);
+    else
+    {
+        a = last_addr + (rand32() & 0x7e) - 0x40;
+        if (a < lo || a >= hi)
+            a = range(lo, hi);
+    }
+    if ((rand32() & 15) != 0)
+        a &= ~1u;
+    last_addr = a;
+    return a;
+}
+
+static u32 rdram_addr(u32 size)
+{
+    return range(0x1000, WINDOW - size) & ~1u;
+}
+
+/* Random ADPCM frames whose headers only select the loaded codebooks, with
+   scales below 12 (larger ones make the original compute a negative shift) */
+static void poke_adpcm(u32 in, u32 frames, u32 frame_size)
+{
+    for (u32 i = 0; i < frames * frame_size + 16; i++)
+        BufferSpace[((in + i) ^ S8) & 0xffff] = rand32();
+    for (u32 f = 0; f < frames; f++)
+    {
+        u8 *b = &BufferSpace[((in + f * frame_size) ^ S8) & 0xffff];
+        *b = ((*b >> 4) % 12) << 4 | (*b & 7);
+    }
+}
+
+static void setup(u32 seed)
+{
+    rng = seed * 2654435761u + 1;
+    for (u32 i = 0; i < WINDOW; i++)
+        rdram[i] = rand32();
+    /* FILTER2 coefficients and state live below 0x1000, which other commands
+       leave alone; coefficients in a game's range keep the sums in 32 bits */
+    for (u32 i = 0; i < 0x1000; i += 2)
+        *(u16 *)(rdram + i) = (u16)(range(0, 0x2000) - 0x1000);
+    for (u32 i = 0; i < sizeof(BufferSpace); i++)
+        BufferSpace[i] = rand32();
+    memset(adpcmtable, 0, sizeof(adpcmtable));
+    init_ucode2();
+}
+
+/* Codebook in RDRAM with coefficients in a game's range (within +-2.0 in
+   4.11), which keep the predictor sums inside 32 bits */
+static u32 codebook()
+{
+    u32 addr = rdram_addr(0x80);
+    for (u32 i = 0; i < 0x80; i += 2)
+        *(u16 *)(rdram + addr + i) = (u16)(range(0, 0x2000) - 0x1000);
+    return addr;
+}
+
+static u32 count_bytes()
+{
+    return (rand32() & 3) ? range(1, 0x18) * 0x10 : range(0, 0x400);
+}
+
+/* Main buffers of ABI1 and ABI2 */
+static u32 audiocount, in;
+
+static void setbuff(void (*process)())
+{
+    in = dmem_addr(0x100, 0xd000);
+    u32 out = dmem_addr(0x100, 0xd000);
+    audiocount = count_bytes();
+    run(process, (8u << 24) | in, (out << 16) | audiocount);
+}
+
+/* Decoding into its own input would rewrite frame headers and index past
+   adpcmtable, so ADPCM gets disjoint buffers */
+static void setbuff_adpcm(void (*process)())
+{
+    in = range(0x100, 0x6000);
+    u32 out = in + range(0x800, 0x6000);
+    audiocount = count_bytes();
+    run(process, (8u << 24) | in, (out << 16) | audiocount);
+}
+
+static void abi1_command()
+{
+    u32 cmd = rand32() % 12;
+
+    switch (cmd)
+    {
+    case 0: /* SETBUFF */
+        setbuff(alist_process_ABI1);
+        break;
+    case 1: /* LOADADPCM */
+        run(alist_process_ABI1, (11u << 24) | 0x80, codebook());
+        break;
+    case 2: /* SETLOOP */
+        run(alist_process_ABI1, 15u << 24, rdram_addr(0x20));
+        break;
+    case 3: case 4: /* ADPCM */
+        setbuff_adpcm(alist_process_ABI1);
+        poke_adpcm(in, (audiocount + 31) / 32, 9);
+        run(alist_process_ABI1, (1u << 24) | ((rand32() % 3) << 16), rdram_addr(0x20));
+        break;
+    case 5: case 6: /* RESAMPLE */
+        run(alist_process_ABI1, (5u << 24) | ((rand32() & 1) << 16) | range(1, 0x10000), rdram_addr(0x10));
+        break;
+    case 7: case 8: /* MIXER */
+        run(alist_process_ABI1, (12u << 24) | (rand32() & 0xffff), (dmem_addr(0x100, 0xd000) << 16) | dmem_addr(0x100, 0xd000));
+        break;
+    case 9: /* INTERLEAVE */
+        run(alist_process_ABI1, 13u << 24, (dmem_addr(0x100, 0xd000) << 16) | dmem_addr(0x100, 0xd000));
+        break;
+    case 10: /* LOADBUFF */
+        run(alist_process_ABI1, 4u << 24, rdram_addr(0x400));
+        break;
+    case 11: /* SAVEBUFF */
+        run(alist_process_ABI1, 6u << 24, rdram_addr(0x400));
+        break;
+    }
+}
+
+static void abi2_command(int variant)
+{
+    u32 cmd = rand32() % 17;
+
+    switch (cmd)
+    {
+    case 0: /* SETBUFF2 */
+        setbuff(alist_process_ABI2);
+        break;
+    case 1: /* LOADADPCM2 */
+        run(alist_process_ABI2, (11u << 24) | 0x80, codebook());
+        break;
+    case 2: /* SETLOOP2 */
+        run(alist_process_ABI2, 15u << 24, rdram_addr(0x20));
+        break;
+    case 3: case 4: /* ADPCM2 */
+    {
+        static const u32 flags[6] = { 0, 1, 2, 4, 5, 6 };
+        u32 f = flags[rand32() % 6];
+        setbuff_adpcm(alist_process_ABI2);
+        poke_adpcm(in, (audiocount + 31) / 32, (f & 4) ? 5 : 9);
+        run(alist_process_ABI2, (1u << 24) | (f << 16), rdram_addr(0x20));
+        break;
+    }
+    case 5: /* RESAMPLE2 */
+        run(alist_process_ABI2, (5u << 24) | ((rand32() & 1) << 16) | range(1, 0x10000), rdram_addr(0x10));
+        break;
+    case 6: /* ENVSETUP1 */
+        run(alist_process_ABI2, (18u << 24) | (rand32() & 0xffffff), rand32());
+        break;
+    case 7: /* ENVSETUP2 */
+        run(alist_process_ABI2, 22u << 24, rand32());
+        break;
+    case 8: case 9: /* ENVMIXER2, buffers from a small set so that they collide */
+    {
+        u32 b[5];
+        for (int i = 0; i < 5; i++)
+            b[i] = (rand32() & 3) ? range(0x10, 0x80) : range(0x40, 0x48);
+        run(alist_process_ABI2,
+            (19u << 24) | (b[0] << 16) | (range(1, 0x100) << 8) | (rand32() & 0x1f),
+            (b[1] << 24) | (b[2] << 16) | (b[3] << 8) | b[4]);
+        break;
+    }
+    case 10: case 11: /* MIXER2 */
+        run(alist_process_ABI2, (12u << 24) | (rand32() & 0xff0000) | (rand32() & 0xffff),
+            (dmem_addr(0x100, 0xd000) << 16) | dmem_addr(0x100, 0xd000));
+        break;
+    case 12: /* INTERLEAVE2 */
+        run(alist_process_ABI2, (13u << 24) | ((rand32() & 1) ? (rand32() & 0x3f0000) : 0) | dmem_addr(0x100, 0xd000),
+            (dmem_addr(0x100, 0xd000) << 16) | dmem_addr(0x100, 0xd000));
+        break;
+    case 13: /* FILTER2 through SEGMENT2 */
+        if (variant == 2)
+            run(alist_process_ABI2, (7u << 24) | ((rand32() & 1) << 16) | dmem_addr(0x100, 0xd000), range(8, 0x80) * 0x20);
+        break;
+    case 14: /* LOADBUFF2 */
+        run(alist_process_ABI2, (20u << 24) | (range(0, 0x40) << 16) | range(0x100, 0x1000), rdram_addr(0x400));
+        break;
+    case 15: /* SAVEBUFF2 */
+        run(alist_process_ABI2, (21u << 24) | (range(0, 0x40) << 16) | range(0x100, 0x1000), rdram_addr(0x400));
+        break;
+    case 16: /* ADDMIXER */
+        run(alist_process_ABI2, (4u << 24) | (rand32() & 0xff0000),
+            (dmem_addr(0x100, 0xd000) << 16) | dmem_addr(0x100, 0xd000));
+        break;
+    }
+}
+
+static void abi3_command()
+{
+    u32 cmd = rand32() % 9;
+
+    switch (cmd)
+    {
+    case 0: /* LOADADPCM3 */
+        run(alist_process_ABI3, (11u << 24) | 0x80, codebook());
+        break;
+    case 1: /* SETLOOP3 */
+        run(alist_process_ABI3, 15u << 24, rdram_addr(0x20));
+        break;
+    case 2: case 3: /* ADPCM3 */
+    {
+        u32 count = range(1, 0x18) * 0x20;
+        u32 inptr = rand32() & 0xf;
+        poke_adpcm(0x4f0 + inptr, count / 32, 9);
+        run(alist_process_ABI3, (1u << 24) | rdram_addr(0x20),
+            ((rand32() % 3) << 28) | (count << 16) | (inptr << 12) | range(0x600, 0xa00));
+        break;
+    }
+    case 4: /* RESAMPLE3 */
+        run(alist_process_ABI3, (5u << 24) | rdram_addr(0x10),
+            ((rand32() & 1) << 30) | (range(1, 0x10000) << 14) | (range(0x10, 0x400) << 2) | (rand32() & 3));
+        break;
+    case 5: case 6: /* MIXER3 */
+        run(alist_process_ABI3, (12u << 24) | (rand32() & 0xffff), (range(0, 0x800) << 16) | range(0, 0x800));
+        break;
+    case 7: /* INTERLEAVE3 */
+        run(alist_process_ABI3, 13u << 24, 0);
+        break;
+    case 8: /* LOADBUFF3 */
+        run(alist_process_ABI3, (4u << 24) | (range(0, 0x40) << 16) | (rand32() & 0xffc), rdram_addr(0x400));
+        break;
+    }
+}
+
+static u64 state_hash(u64 h)
+{
+    h = hash(h, BufferSpace, sizeof(BufferSpace));
+    return hash(h, adpcmtable, sizeof(adpcmtable));
+}
+
+static void trace(int abi, int variant, u32 seed, bool verbose)
+{
+    u64 h = 0xcbf29ce484222325ull;
+
+    setup(seed * 4 + variant);
+    if (abi == 1)
+        setbuff(alist_process_ABI1);
+    else if (abi == 2)
+    {
+        setbuff(alist_process_ABI2);
+        if (variant == 1) /* SEGMENT2 with no address selects the MK ABI */
+            run(alist_process_ABI2, 7u << 24, 0);
+        else if (variant == 2) /* and any other selects Zelda, where it is FILTER2 */
+            run(alist_process_ABI2, (7u << 24) | (2u << 16) | (range(1, 0x78) << 4), range(0, 0x10) * 0x10);
+    }
+
+    for (int i = 0; i < COMMANDS; i++)
+    {
+        if (abi == 1)
+            abi1_command();
+        else if (abi == 2)
+            abi2_command(variant);
+        else
+            abi3_command();
+
+        h = state_hash(h);
+        if (verbose)
+            printf("  %4d %016llx\n", i, (unsigned long long)h);
+    }
+
+    printf("abi%d.%d seed %2u: state %016llx rdram %016llx\n", abi, variant, seed,
+           (unsigned long long)h, (unsigned long long)hash(0, rdram, WINDOW));
+}
+
+/* Commands with typical game parameters, 0x170 bytes per buffer */
+static void bench()
+{
+    static const struct
+    {
+        const char *name;
+        void (*process)();
+        u32 inst1, inst2;
+    } cmds[] = {
+        { "ADPCM",       alist_process_ABI1, 1u << 24, 0x1000 },
+        { "RESAMPLE",    alist_process_ABI1, (5u << 24) | 0xc000, 0x2000 },
+        { "MIXER",       alist_process_ABI1, (12u << 24) | 0x5a5a, (0x800 << 16) | 0x1000 },
+        { "INTERLEAVE",  alist_process_ABI1, 13u << 24, (0x800 << 16) | 0xa00 },
+        { "ADPCM2",      alist_process_ABI2, 1u << 24, 0x1000 },
+        { "RESAMPLE2",   alist_process_ABI2, (5u << 24) | 0xc000, 0x2000 },
+        { "ENVMIXER2",   alist_process_ABI2, (19u << 24) | (0x40 << 16) | (0xb8 << 8) | 0x13, 0x50607080 },
+        { "MIXER2",      alist_process_ABI2, (12u << 24) | (0x17 << 16) | 0x5a5a, (0x800 << 16) | 0x1000 },
+        { "INTERLEAVE2", alist_process_ABI2, (13u << 24) | (0x17 << 16) | 0x1000, (0x800 << 16) | 0xa00 },
+        { "FILTER2",     alist_process_ABI2, (7u << 24) | 0x800, 0x200 },
+        { "ADPCM3",      alist_process_ABI3, 1u << 24 | 0x1000, (0x170 << 16) | 0x400 },
+        { "RESAMPLE3",   alist_process_ABI3, (5u << 24) | 0x2000, (0xc000 << 14) | (0x100 << 2) },
+        { "MIXER3",      alist_process_ABI3, (12u << 24) | 0x5a5a, (0x100 << 16) | 0x300 },
+        { "INTERLEAVE3", alist_process_ABI3, 13u << 24, 0 },
+    };
+    const int iterations = 200000;
+
+    for (size_t c = 0; c < sizeof(cmds) / sizeof(cmds[0]); c++)
+    {
+        setup(1);
+        run(alist_process_ABI1, 11u << 24 | 0x80, 0x4000);
+        run(alist_process_ABI1, 8u << 24 | 0x400, (0x1000 << 16) | 0x170);
+        run(alist_process_ABI2, 11u << 24 | 0x80, 0x4000);
+        run(alist_process_ABI2, 8u << 24 | 0x400, (0x1000 << 16) | 0x170);
+        if (cmds[c].process == alist_process_ABI2 && cmds[c].inst1 >> 24 == 7)
+            run(alist_process_ABI2, (7u << 24) | (2u << 16) | 0x170, 0x100);
+        poke_adpcm(0x400, 0x170 / 32, 9);
+        poke_adpcm(0x4f0 + 0x400, 0x170 / 32, 9);
+
+        clock_t start = clock();
+        for (int i = 0; i < iterations; i++)
+            run(cmds[c].process, cmds[c].inst1, cmds[c].inst2);
+        double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / iterations;
+        fprintf(stderr, "%-12s %7.1f ns\n", cmds[c].name, ns);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bool verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+    rdram = (u8 *)calloc(0x800000, 1);
+    rsp.RDRAM = rdram;
+    rsp.DMEM = dmem;
+    rsp.IMEM = imem;
+
+    if (argc > 1 && !strcmp(argv[1], "-bench"))
+    {
+        bench();
+        return 0;
+    }
+
+    for (u32 seed = 0; seed < SEEDS; seed++)
+    {
+        trace(1, 0, seed, verbose);
+        for (int variant = 0; variant < 3; variant++)
+            trace(2, variant, seed, verbose);
+        trace(3, 0, seed, verbose);
+    }
+
+    return 0;
+}
@@ -68,6 +68,7 @@ struct Cartridge : property<Cartridge> {
     unsigned addrhi;
     unsigned offset;
     unsigned size;
+    MappedRAM *backing;  //memory that read and write access, if any
 
     Mapping();
     Mapping(const function<uint8 (unsigned)>&, const function<void (unsigned, uint8)>&);
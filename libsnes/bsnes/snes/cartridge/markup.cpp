@@ -89,6 +89,7 @@ void Cartridge::parse_markup_rom(XML::Node &root) {
 		Mapping m({&Cartridge::rom_read, this}, {&Cartridge::rom_write, this});
     parse_markup_map(m, node);
     if(m.size == 0) m.size = rom.size();
+    m.backing = &rom;
     mapping.append(m);
   }
 }
@@ -100,6 +101,7 @@ void Cartridge::parse_markup_ram(XML::Node &root) {
 		Mapping m({ &Cartridge::ram_read, this }, { &Cartridge::ram_write, this });
     parse_markup_map(m, node);
     if(m.size == 0) m.size = ram_size;
+    m.backing = &ram;
     mapping.append(m);
   }
 }
@@ -578,6 +580,7 @@ void Cartridge::parse_markup_link(XML::Node &root) {
 Cartridge::Mapping::Mapping() {
   mode = Bus::MapMode::Direct;
   banklo = bankhi = addrlo = addrhi = offset = size = 0;
+  backing = nullptr;
 }
 
 Cartridge::Mapping::Mapping(Memory &memory) {
@@ -585,6 +588,7 @@ Cartridge::Mapping::Mapping(Memory &memory) {
   write = { &Memory::write, &memory };
   mode = Bus::MapMode::Direct;
   banklo = bankhi = addrlo = addrhi = offset = size = 0;
+  backing = nullptr;
 }
 
 Cartridge::Mapping::Mapping(const function<uint8 (unsigned)> &read_, const function<void (unsigned, uint8)> &write_) {
@@ -592,6 +596,7 @@ Cartridge::Mapping::Mapping(const function<uint8 (unsigned)> &read_, const funct
   write = write_;
   mode = Bus::MapMode::Direct;
   banklo = bankhi = addrlo = addrhi = offset = size = 0;
+  backing = nullptr;
 }
 
 #endif
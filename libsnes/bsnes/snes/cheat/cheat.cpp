@@ -15,54 +15,57 @@ void Cheat::enable(bool state) {
 }
 
 void Cheat::synchronize() {
-  memset(override, 0x00, 16 * 1024 * 1024);
-  code_enabled = size() > 0;
-
+  clear();
   for(unsigned i = 0; i < size(); i++) {
     const CheatCode &code = operator[](i);
-
-    unsigned addr = mirror(code.addr);
-    override[addr] = true;
-    if((addr & 0xffe000) == 0x7e0000) {
-      //mirror $7e:0000-1fff to $00-3f|80-bf:0000-1fff
-      unsigned mirroraddr;
-      for(unsigned x = 0; x <= 0x3f; x++) {
-        mirroraddr = ((0x00 + x) << 16) + (addr & 0x1fff);
-        override[mirroraddr] = true;
-
-        mirroraddr = ((0x80 + x) << 16) + (addr & 0x1fff);
-        override[mirroraddr] = true;
-      }
-    }
+    index(code.addr, code.data);
   }
+  code_enabled = size() > 0;
+  cheat_enabled = system_enabled && code_enabled;
+}
 
+void Cheat::add(unsigned addr, unsigned data) {
+  append({ addr, data });
+  index(addr, data);
+  code_enabled = true;
   cheat_enabled = system_enabled && code_enabled;
 }
 
-uint8 Cheat::read(unsigned addr) const {
+void Cheat::remove(unsigned addr) {
   addr = mirror(addr);
-
-  for(unsigned i = 0; i < size(); i++) {
-    const CheatCode &code = operator[](i);
-    if(addr == mirror(code.addr)) {
-      return code.data;
-    }
+  for(unsigned i = 0; i < size();) {
+    if(mirror(operator[](i).addr) == addr) linear_vector<CheatCode>::remove(i);
+    else i++;
   }
+  unindex(addr);
+  code_enabled = size() > 0;
+  cheat_enabled = system_enabled && code_enabled;
+}
 
-  return 0x00;
+bool Cheat::read(unsigned addr, uint8 &data) const {
+  addr = mirror(addr);
+  for(unsigned n = slot(addr);; n = (n + 1) & table_mask) {
+    if(table[n].addr == addr) { data = table[n].data; return true; }
+    if(table[n].addr == ~0u) return false;
+  }
 }
 
 void Cheat::init() {
-  memset(override, 0x00, 16 * 1024 * 1024);
+  clear();
 }
 
 Cheat::Cheat() {
-  override = new uint8[16 * 1024 * 1024];
+  table = 0;
+  table_mask = 0;
+  table_count = 0;
   system_enabled = true;
+  code_enabled = false;
+  cheat_enabled = false;
+  clear();
 }
 
 Cheat::~Cheat() {
-  delete[] override;
+  delete[] table;
 }
 
 bool Cheat::decode(const string &code, unsigned &addr, unsigned &data) {
@@ -107,4 +110,91 @@ unsigned Cheat::mirror(unsigned addr) const {
   return addr;
 }
 
+unsigned Cheat::slot(unsigned addr) const {
+  return ((addr * 0x9e3779b1u) >> 8) & table_mask;
+}
+
+void Cheat::index(unsigned addr, unsigned data) {
+  addr = mirror(addr);
+
+  if((table_count + 1) * 2 > table_mask + 1) {
+    //keep the load factor under one half so probes stay short
+    Slot *old = table;
+    unsigned oldsize = table_mask + 1;
+    table_mask = (oldsize << 1) - 1;
+    table = new Slot[table_mask + 1];
+    for(unsigned n = 0; n <= table_mask; n++) table[n].addr = ~0u;
+    for(unsigned n = 0; n < oldsize; n++) {
+      if(old[n].addr == ~0u) continue;
+      unsigned s = slot(old[n].addr);
+      while(table[s].addr != ~0u) s = (s + 1) & table_mask;
+      table[s] = old[n];
+    }
+    delete[] old;
+  }
+
+  unsigned n = slot(addr);
+  while(table[n].addr != ~0u) {
+    if(table[n].addr == addr) return;
+    n = (n + 1) & table_mask;
+  }
+  table[n].addr = addr;
+  table[n].data = data;
+  table_count++;
+  mark(addr, true);
+}
+
+void Cheat::unindex(unsigned addr) {
+  unsigned n = slot(addr);
+  while(table[n].addr != addr) {
+    if(table[n].addr == ~0u) return;
+    n = (n + 1) & table_mask;
+  }
+
+  //backward-shift deletion: pull later entries of the probe run into the hole
+  for(unsigned hole = n;;) {
+    n = (n + 1) & table_mask;
+    if(table[n].addr == ~0u) { table[hole].addr = ~0u; break; }
+    unsigned home = slot(table[n].addr);
+    if(((n - home) & table_mask) >= ((n - hole) & table_mask)) {
+      table[hole] = table[n];
+      hole = n;
+    }
+  }
+  table_count--;
+
+  //the page stays marked while any other code shares it
+  bool shared = false;
+  for(unsigned n = 0; n <= table_mask; n++) {
+    if(table[n].addr != ~0u && (table[n].addr >> 8) == (addr >> 8)) { shared = true; break; }
+  }
+  if(!shared) mark(addr, false);
+}
+
+void Cheat::mark(unsigned addr, bool state) {
+  unsigned page = addr >> 8;
+  if(state) pagemask[page >> 5] |= 1u << (page & 31);
+  else pagemask[page >> 5] &= ~(1u << (page & 31));
+
+  if((addr & 0xffe000) == 0x7e0000) {
+    //mirror $7e:0000-1fff to $00-3f|80-bf:0000-1fff
+    for(unsigned x = 0; x <= 0x3f; x++) {
+      mark(((0x00 + x) << 16) + (addr & 0x1fff), state);
+      mark(((0x80 + x) << 16) + (addr & 0x1fff), state);
+    }
+  }
+
+  active = table_count > 0;
+}
+
+void Cheat::clear() {
+  delete[] table;
+  table_mask = 15;
+  table_count = 0;
+  table = new Slot[table_mask + 1];
+  for(unsigned n = 0; n <= table_mask; n++) table[n].addr = ~0u;
+  memset(pagemask, 0, sizeof pagemask);
+  active = false;
+}
+
 }
@@ -4,24 +4,48 @@ struct CheatCode {
 };
 
 struct Cheat : public linear_vector<CheatCode> {
-  uint8 *override;
-
   bool enabled() const;
   void enable(bool);
   void synchronize();
-  uint8 read(unsigned) const;
+  void add(unsigned addr, unsigned data);
+  void remove(unsigned addr);
+  inline bool override(unsigned addr) const;
+  bool read(unsigned addr, uint8 &data) const;
   void init();
 
   Cheat();
   ~Cheat();
 
   static bool decode(const string&, unsigned&, unsigned&);
+  unsigned mirror(unsigned) const;
 
 private:
+  //open-addressed table of mirrored address -> data; the first code for an address wins
+  struct Slot {
+    unsigned addr;  //~0u when empty
+    uint8 data;
+  };
+  Slot *table;
+  unsigned table_mask;
+  unsigned table_count;
+
+  //one bit per 256-byte bus page that contains a code (including WRAM mirrors)
+  uint32 pagemask[65536 / 32];
+  bool active;
+
   bool system_enabled;
   bool code_enabled;
   bool cheat_enabled;
-  unsigned mirror(unsigned) const;
+  unsigned slot(unsigned) const;
+  void index(unsigned addr, unsigned data);
+  void unindex(unsigned addr);
+  void mark(unsigned addr, bool state);
+  void clear();
 };
 
+//fast reject only: true for every address in a page that holds a code, so read() must still be asked
+bool Cheat::override(unsigned addr) const {
+  return active && (pagemask[addr >> 13] & (1u << ((addr >> 8) & 31)));
+}
+
 extern Cheat cheat;
@@ -54,10 +54,19 @@ MappedRAM::MappedRAM(const char* name) : data_(0), size_(0), write_protect_(fals
 //Bus
 
 uint8 Bus::read(unsigned addr) {
-  if(cheat.override[addr]) return cheat.read(addr);
-  return reader[lookup[addr]](target[addr]);
+  uint8 data;
+  if(cheat.override(addr) && cheat.read(addr, data)) return data;
+  Page &p = page[addr >> 8];
+  if(p.data && !wantCDL()) return p.data[addr & 0xff];
+  if(p.sparse == false) return reader[p.id](p.target + (addr & 0xff));
+  SparsePage &s = sparse[p.target];
+  return reader[s.lookup[addr & 0xff]](s.target[addr & 0xff]);
 }
 
 void Bus::write(unsigned addr, uint8 data) {
-  return writer[lookup[addr]](target[addr], data);
+  Page &p = page[addr >> 8];
+  if(p.writable) { p.data[addr & 0xff] = data; return; }
+  if(p.sparse == false) return writer[p.id](p.target + (addr & 0xff), data);
+  SparsePage &s = sparse[p.target];
+  return writer[s.lookup[addr & 0xff]](s.target[addr & 0xff], data);
 }
@@ -29,7 +29,8 @@ void Bus::map(
   unsigned addr_lo, unsigned addr_hi,
   const function<uint8 (unsigned)> &rd,
   const function<void (unsigned, uint8)> &wr,
-  unsigned base, unsigned length
+  unsigned base, unsigned length,
+  uint8 *data, unsigned size, bool writable
 ) {
   assert(bank_lo <= bank_hi && bank_lo <= 0xff);
   assert(addr_lo <= addr_hi && addr_lo <= 0xffff);
@@ -37,18 +38,96 @@ void Bus::map(
   assert(id < 255);
   reader[id] = rd;
   writer[id] = wr;
+  memory[id] = data;
+  memory_size[id] = data ? size : 0;
+  memory_writable[id] = writable;
 
   if(length == 0) length = (bank_hi - bank_lo + 1) * (addr_hi - addr_lo + 1);
 
+  uint32 target[256];
   unsigned offset = 0;
   for(unsigned bank = bank_lo; bank <= bank_hi; bank++) {
-    for(unsigned addr = addr_lo; addr <= addr_hi; addr++) {
-      unsigned destaddr = (bank << 16) | addr;
-      if(mode == MapMode::Linear) destaddr = mirror(base + offset++, length);
-      if(mode == MapMode::Shadow) destaddr = mirror(base + destaddr, length);
-      lookup[(bank << 16) | addr] = id;
-      target[(bank << 16) | addr] = destaddr;
+    for(unsigned addr = addr_lo; addr <= addr_hi;) {
+      unsigned pageid = (bank << 8) | (addr >> 8);
+      unsigned lo = addr & 0xff;
+      unsigned hi = min(addr_hi, addr | 0xff) & 0xff;
+      for(unsigned n = lo; n <= hi; n++, addr++) {
+        unsigned destaddr = (bank << 16) | addr;
+        if(mode == MapMode::Linear) destaddr = mirror(base + offset++, length);
+        if(mode == MapMode::Shadow) destaddr = mirror(base + destaddr, length);
+        target[n] = destaddr;
+      }
+      map_page(pageid, id, target, lo, hi);
+    }
+  }
+}
+
+void Bus::map_page(unsigned pageid, unsigned id, const uint32 *target, unsigned lo, unsigned hi) {
+  Page &p = page[pageid];
+
+  if(lo == 0x00 && hi == 0xff) {
+    bool uniform = true;
+    for(unsigned n = 1; n <= 0xff; n++) uniform &= target[n] == target[0] + n;
+    if(uniform) {
+      release_sparse(p);
+      p.id = id;
+      p.target = target[0];
+      update_data(p);
+      return;
+    }
+  }
+
+  if(p.sparse == false) {
+    unsigned index;
+    if(sparse_free.size()) {
+      index = sparse_free[sparse_free.size() - 1];
+      sparse_free.remove(sparse_free.size() - 1);
+    } else {
+      index = sparse.size();
+      sparse.resize(index + 1);
+    }
+    SparsePage &s = sparse[index];
+    for(unsigned n = 0; n <= 0xff; n++) {
+      s.lookup[n] = p.id;
+      s.target[n] = p.target + n;
     }
+    p.data = nullptr;
+    p.writable = false;
+    p.sparse = true;
+    p.target = index;
+  }
+
+  SparsePage &s = sparse[p.target];
+  for(unsigned n = lo; n <= hi; n++) {
+    s.lookup[n] = id;
+    s.target[n] = target[n];
+  }
+
+  //a later mapping can cover up whatever made the page sparse
+  for(unsigned n = 1; n <= 0xff; n++) {
+    if(s.lookup[n] != s.lookup[0] || s.target[n] != s.target[0] + n) return;
+  }
+  unsigned first_id = s.lookup[0];
+  uint32 first_target = s.target[0];
+  release_sparse(p);
+  p.id = first_id;
+  p.target = first_target;
+  update_data(p);
+}
+
+void Bus::release_sparse(Page &p) {
+  if(p.sparse == false) return;
+  sparse_free.append(p.target);
+  p.sparse = false;
+}
+
+void Bus::update_data(Page &p) {
+  if(memory[p.id] && p.target + 0x100 <= memory_size[p.id]) {
+    p.data = memory[p.id] + p.target;
+    p.writable = memory_writable[p.id];
+  } else {
+    p.data = nullptr;
+    p.writable = false;
   }
 }
 
@@ -57,23 +136,27 @@ void Bus::map_reset() {
   function<void (unsigned, uint8)> writer = [](unsigned, uint8) {};
 
   idcount = 0;
+  memset(page, 0, 65536 * sizeof(Page));
+  sparse.reset();
+  sparse_free.reset();
   map(MapMode::Direct, 0x00, 0xff, 0x0000, 0xffff, reader, writer);
 }
 
 void Bus::map_xml() {
   for(auto &m : cartridge.mapping) {
-    map(m.mode, m.banklo, m.bankhi, m.addrlo, m.addrhi, m.read, m.write, m.offset, m.size);
+    uint8 *data = m.backing ? m.backing->data() : nullptr;
+    unsigned size = m.backing ? m.backing->size() : 0;
+    map(m.mode, m.banklo, m.bankhi, m.addrlo, m.addrhi, m.read, m.write, m.offset, m.size, data, size);
   }
 }
 
 Bus::Bus() {
-  lookup = new uint8 [16 * 1024 * 1024];
-  target = new uint32[16 * 1024 * 1024];
+  page = new Page[65536]();
+  idcount = 0;
 }
 
 Bus::~Bus() {
-  delete[] lookup;
-  delete[] target;
+  delete[] page;
 }
 
 }
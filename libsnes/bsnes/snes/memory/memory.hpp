@@ -50,21 +50,44 @@ struct Bus {
   alwaysinline uint8 read(unsigned addr);
   alwaysinline void write(unsigned addr, uint8 data);
 
-  uint8 *lookup;
-  uint32 *target;
+  //the address space is split into 256-byte pages. a page whose addresses all
+  //go to the same handler at consecutive targets is stored as one entry, and
+  //when that handler is plain memory the page also points straight at it.
+  //pages that mix handlers (mostly the MMIO pages) keep per-address tables.
+  struct Page {
+    uint8 *data;      //host memory for target, or nullptr to use the handler
+    uint32 target;    //target of the first address, or index into sparse
+    uint8 id;
+    bool sparse;
+    bool writable;    //whether writes may also go to data
+  };
+
+  struct SparsePage {
+    uint8 lookup[256];
+    uint32 target[256];
+  };
+
+  Page *page;
+  linear_vector<SparsePage> sparse;
+  linear_vector<unsigned> sparse_free;
 
   unsigned idcount;
   function<uint8 (unsigned)> reader[256];
   function<void (unsigned, uint8)> writer[256];
 
   enum class MapMode : unsigned { Direct, Linear, Shadow };
+  //data, when given, is the memory that rd and wr access at target.
+  //reads of it skip rd unless code/data logging is active, and writes skip wr
+  //when writable is set, so only pass memory whose handlers have no other
+  //side effects.
   void map(
     MapMode mode,
     unsigned bank_lo, unsigned bank_hi,
     unsigned addr_lo, unsigned addr_hi,
     const function<uint8 (unsigned)> &read,
     const function<void (unsigned, uint8)> &write,
-    unsigned base = 0, unsigned length = 0
+    unsigned base = 0, unsigned length = 0,
+    uint8 *data = nullptr, unsigned size = 0, bool writable = false
   );
 
   void map_reset();
@@ -72,6 +95,15 @@ struct Bus {
 
   Bus();
   ~Bus();
+
+private:
+  uint8 *memory[256];
+  unsigned memory_size[256];
+  bool memory_writable[256];
+
+  void map_page(unsigned pageid, unsigned id, const uint32 *target, unsigned lo, unsigned hi);
+  void release_sparse(Page &p);
+  void update_data(Page &p);
 };
 
 extern Bus bus;
@@ -0,0 +1,267 @@
+#include <snes/snes.hpp>
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace nall;
+
+struct BenchInterface : public SNES::Interface {
+  string path(SNES::Cartridge::Slot, const string &hint) { return hint; }
+  void scanlineStart(int) {}
+  void* allocSharedMemory(const char*, size_t amt, int initialByte = -1) {
+    void *ret = calloc(amt, 1);
+    if(initialByte != -1) memset(ret, initialByte, amt);
+    return ret;
+  }
+  void freeSharedMemory(void *ptr) { free(ptr); }
+};
+
+SNES::Interface *SNES::interface() {
+  static BenchInterface *iface = new BenchInterface;
+  return iface;
+}
+
+//the bus as it was before it was paged: one handler id and one target per address
+struct FlatBus {
+  uint8 *lookup;
+  uint32 *target;
+  unsigned idcount;
+  function<uint8 (unsigned)> reader[256];
+  function<void (unsigned, uint8)> writer[256];
+
+  uint8 read(unsigned addr) {
+    uint8 data;
+    if(SNES::cheat.override(addr) && SNES::cheat.read(addr, data)) return data;
+    return reader[lookup[addr]](target[addr]);
+  }
+  void write(unsigned addr, uint8 data) { return writer[lookup[addr]](target[addr], data); }
+
+  void map(
+    SNES::Bus::MapMode mode,
+    unsigned bank_lo, unsigned bank_hi,
+    unsigned addr_lo, unsigned addr_hi,
+    const function<uint8 (unsigned)> &rd,
+    const function<void (unsigned, uint8)> &wr,
+    unsigned base = 0, unsigned length = 0,
+    uint8* = nullptr, unsigned = 0, bool = false
+  ) {
+    unsigned id = idcount++;
+    reader[id] = rd;
+    writer[id] = wr;
+    if(length == 0) length = (bank_hi - bank_lo + 1) * (addr_hi - addr_lo + 1);
+    unsigned offset = 0;
+    for(unsigned bank = bank_lo; bank <= bank_hi; bank++) {
+      for(unsigned addr = addr_lo; addr <= addr_hi; addr++) {
+        unsigned destaddr = (bank << 16) | addr;
+        if(mode == SNES::Bus::MapMode::Linear) destaddr = SNES::bus.mirror(base + offset++, length);
+        if(mode == SNES::Bus::MapMode::Shadow) destaddr = SNES::bus.mirror(base + destaddr, length);
+        lookup[(bank << 16) | addr] = id;
+        target[(bank << 16) | addr] = destaddr;
+      }
+    }
+  }
+
+  void map_reset(const function<uint8 (unsigned)> &rd, const function<void (unsigned, uint8)> &wr) {
+    idcount = 0;
+    map(SNES::Bus::MapMode::Direct, 0x00, 0xff, 0x0000, 0xffff, rd, wr);
+  }
+
+  FlatBus() {
+    lookup = new uint8 [16 * 1024 * 1024];
+    target = new uint32[16 * 1024 * 1024];
+  }
+
+  ~FlatBus() {
+    delete[] lookup;
+    delete[] target;
+  }
+};
+
+static uint8 wram[128 * 1024];
+static uint8 rom[2 * 1024 * 1024];
+static uint8 sram[8 * 1024];
+
+//the handler that ran last and the target it was given, for the comparison pass
+static unsigned last_handler, last_target;
+
+static function<uint8 (unsigned)> recorder(unsigned handler, uint8 *memory) {
+  return [=](unsigned addr) {
+    last_handler = handler;
+    last_target = addr;
+    return memory ? memory[addr] : (uint8)handler;
+  };
+}
+
+static void ignore(unsigned, uint8) {}
+
+//what a LoROM cartridge with save RAM and the CPU and PPU end up mapping
+template<typename B> static void map_layout(B &bus, bool direct) {
+  using SNES::Bus;
+  function<void (unsigned, uint8)> wr = ignore;
+  function<void (unsigned, uint8)> wram_write = [](unsigned addr, uint8 data) { wram[addr] = data; };
+
+  bus.map(Bus::MapMode::Linear, 0x00, 0x7d, 0x8000, 0xffff, recorder(1, rom), wr, 0, sizeof rom, direct ? rom : nullptr, sizeof rom);
+  bus.map(Bus::MapMode::Linear, 0x80, 0xff, 0x8000, 0xffff, recorder(2, rom), wr, 0, sizeof rom, direct ? rom : nullptr, sizeof rom);
+  bus.map(Bus::MapMode::Linear, 0x70, 0x7d, 0x0000, 0x7fff, recorder(3, sram), wr, 0, sizeof sram, direct ? sram : nullptr, sizeof sram);
+  bus.map(Bus::MapMode::Linear, 0xf0, 0xff, 0x0000, 0x7fff, recorder(4, sram), wr, 0, sizeof sram, direct ? sram : nullptr, sizeof sram);
+
+  bus.map(Bus::MapMode::Direct, 0x00, 0x3f, 0x2140, 0x2183, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x80, 0xbf, 0x2140, 0x2183, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x00, 0x3f, 0x4016, 0x4017, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x80, 0xbf, 0x4016, 0x4017, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x00, 0x3f, 0x4200, 0x421f, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x80, 0xbf, 0x4200, 0x421f, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x00, 0x3f, 0x4300, 0x437f, recorder(5, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x80, 0xbf, 0x4300, 0x437f, recorder(5, nullptr), wr);
+
+  bus.map(Bus::MapMode::Linear, 0x00, 0x3f, 0x0000, 0x1fff, recorder(6, wram), wram_write, 0x000000, 0x002000, direct ? wram : nullptr, sizeof wram, true);
+  bus.map(Bus::MapMode::Linear, 0x80, 0xbf, 0x0000, 0x1fff, recorder(6, wram), wram_write, 0x000000, 0x002000, direct ? wram : nullptr, sizeof wram, true);
+  bus.map(Bus::MapMode::Linear, 0x7e, 0x7f, 0x0000, 0xffff, recorder(6, wram), wram_write, 0, 0, direct ? wram : nullptr, sizeof wram, true);
+
+  bus.map(Bus::MapMode::Direct, 0x00, 0x3f, 0x2100, 0x213f, recorder(7, nullptr), wr);
+  bus.map(Bus::MapMode::Direct, 0x80, 0xbf, 0x2100, 0x213f, recorder(7, nullptr), wr);
+}
+
+static void reset_paged(bool direct) {
+  SNES::bus.map_reset();
+  SNES::bus.reader[0] = recorder(0, nullptr);
+  SNES::bus.writer[0] = ignore;
+  map_layout(SNES::bus, direct);
+}
+
+static void reset_flat(FlatBus &flat) {
+  flat.map_reset(recorder(0, nullptr), ignore);
+  map_layout(flat, false);
+}
+
+//resident set size in bytes, or 0 where it can't be read
+static uint64_t resident() {
+  FILE *fp = fopen("/proc/self/statm", "r");
+  if(!fp) return 0;
+  unsigned long pages = 0, rss = 0;
+  if(fscanf(fp, "%lu %lu", &pages, &rss) != 2) rss = 0;
+  fclose(fp);
+  return (uint64_t)rss * 4096;
+}
+
+//a mix of instruction fetches from ROM, work RAM and stack traffic, and register polling
+static void make_trace(uint32 *trace, unsigned count) {
+  uint32 seed = 0x2a;
+  uint32 pc = 0x808000;
+  for(unsigned n = 0; n < count; n++) {
+    seed = seed * 1103515245 + 12345;
+    unsigned r = (seed >> 16) % 100;
+    if(r < 60) {
+      if((seed >> 8) % 16 == 0) pc = 0x800000 | ((seed >> 4) & 0x3f0000) | 0x8000 | (seed & 0x7fff);
+      trace[n] = pc++;
+      if((pc & 0xffff) == 0) pc |= 0x8000;
+    } else if(r < 85) {
+      trace[n] = (seed >> 4) & 0x1fff;
+    } else if(r < 95) {
+      trace[n] = 0x7e0000 | ((seed >> 3) & 0x1ffff);
+    } else if(r < 98) {
+      trace[n] = 0x700000 | ((seed >> 5) & 0x1fff);
+    } else {
+      static const uint32 regs[] = { 0x2137, 0x213f, 0x4212, 0x4218, 0x4210, 0x2140 };
+      trace[n] = regs[(seed >> 9) % 6];
+    }
+  }
+}
+
+template<typename F> static double time_reads(F read, const uint32 *trace, unsigned count, unsigned passes, unsigned &sum) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for(unsigned pass = 0; pass < passes; pass++) {
+    for(unsigned n = 0; n < count; n++) sum += read(trace[n]);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / ((double)count * passes);
+}
+
+int main() {
+  for(unsigned n = 0; n < sizeof rom; n++) rom[n] = n * 7 + (n >> 9);
+  for(unsigned n = 0; n < sizeof wram; n++) wram[n] = n * 13 + (n >> 7);
+  for(unsigned n = 0; n < sizeof sram; n++) sram[n] = n * 3 + (n >> 5);
+
+  uint64_t before = resident();
+  SNES::Bus *paged = new SNES::Bus;
+  paged->map_reset();
+  map_layout(*paged, true);
+  uint64_t paged_rss = resident() - before;
+  delete paged;
+  reset_paged(false);
+
+  before = resident();
+  FlatBus *flat = new FlatBus;
+  reset_flat(*flat);
+  uint64_t flat_rss = resident() - before;
+
+  //every address must reach the same handler with the same target
+  unsigned mismatches = 0;
+  for(unsigned addr = 0; addr < 0x1000000; addr++) {
+    flat->read(addr);
+    unsigned handler = last_handler, target = last_target;
+    SNES::bus.read(addr);
+    if(last_handler != handler || last_target != target) {
+      if(mismatches++ < 8) printf("mismatch at %.6x: %u:%.6x vs %u:%.6x\n", addr, handler, target, last_handler, last_target);
+    }
+  }
+
+  //and with host pointers, every read must return the same byte
+  reset_paged(true);
+  for(unsigned addr = 0; addr < 0x1000000; addr++) {
+    if(flat->read(addr) != SNES::bus.read(addr)) {
+      if(mismatches++ < 8) printf("value mismatch at %.6x\n", addr);
+    }
+  }
+
+  //a code replaces only its own byte; the rest of its page, and of the WRAM mirror pages, reads through
+  SNES::cheat.add(0x7e0010, 0x5a);
+  SNES::cheat.add(0x808123, 0xa5);
+  static const unsigned pages[] = { 0x7e0000, 0x000000, 0x3f0000, 0x800000, 0xbf0000, 0x808100 };
+  for(unsigned page : pages) {
+    for(unsigned low = 0; low < 0x100; low++) {
+      unsigned addr = page | low;
+      uint8 expect = page == 0x808100
+        ? (low == 0x23 ? 0xa5 : rom[addr & 0x7fff])
+        : (low == 0x10 ? 0x5a : wram[low]);
+      if(SNES::bus.read(addr) != expect || flat->read(addr) != expect) {
+        if(mismatches++ < 8) printf("cheat mismatch at %.6x: %.2x/%.2x, expected %.2x\n", addr, SNES::bus.read(addr), flat->read(addr), expect);
+      }
+    }
+  }
+  for(unsigned addr = 0; addr < 0x1000000; addr++) {
+    if(flat->read(addr) != SNES::bus.read(addr)) {
+      if(mismatches++ < 8) printf("value mismatch with cheats at %.6x\n", addr);
+    }
+  }
+  SNES::cheat.remove(0x7e0010);
+  SNES::cheat.remove(0x808123);
+
+  printf("%u mismatches over the 24-bit address space\n", mismatches);
+  printf("resident bytes after mapping: flat %llu, paged %llu\n",
+    (unsigned long long)flat_rss, (unsigned long long)paged_rss);
+  printf("paged bus tables: %u bytes page table, %u sparse pages of %u bytes\n",
+    (unsigned)(65536 * sizeof(SNES::Bus::Page)), SNES::bus.sparse.size(), (unsigned)sizeof(SNES::Bus::SparsePage));
+
+  const unsigned count = 1 << 20, passes = 64;
+  uint32 *trace = new uint32[count];
+  make_trace(trace, count);
+
+  unsigned flat_sum = 0, paged_sum = 0;
+  double flat_ns = time_reads([&](unsigned addr) { return flat->read(addr); }, trace, count, passes, flat_sum);
+  double paged_ns = time_reads([&](unsigned addr) { return SNES::bus.read(addr); }, trace, count, passes, paged_sum);
+  reset_paged(false);
+  unsigned handler_sum = 0;
+  double handler_ns = time_reads([&](unsigned addr) { return SNES::bus.read(addr); }, trace, count, passes, handler_sum);
+
+  printf("ns per read: flat %.2f, paged %.2f, paged without host pointers %.2f\n", flat_ns, paged_ns, handler_ns);
+  if(flat_sum != paged_sum || flat_sum != handler_sum) {
+    printf("checksum mismatch\n");
+    mismatches++;
+  }
+
+  delete[] trace;
+  delete flat;
+  return mismatches ? 1 : 0;
+}
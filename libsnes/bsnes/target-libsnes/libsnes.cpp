@@ -306,6 +306,16 @@ struct CheatList {
 
 static linear_vector<CheatList> cheatList;
 
+//appends the SNES bus codes of one cheat list entry
+static void snes_cheat_decode(const string &code, linear_vector<SNES::CheatCode> &codes) {
+  lstring codelist;
+  codelist.split("+", code);
+  for(auto &part : codelist) {
+    unsigned addr, data;
+    if(SNES::Cheat::decode(part, addr, data)) codes.append({ addr, data });
+  }
+}
+
 void snes_cheat_reset(void) {
   cheatList.reset();
   GameBoy::cheat.reset();
@@ -315,14 +325,16 @@ void snes_cheat_reset(void) {
 }
 
 void snes_cheat_set(unsigned index, bool enable, const char *code) {
+  CheatList previous = cheatList[index];
   cheatList[index].enable = enable;
   cheatList[index].code = code;
-  lstring list;
-  for(unsigned n = 0; n < cheatList.size(); n++) {
-    if(cheatList[n].enable) list.append(cheatList[n].code);
-  }
 
   if(SNES::cartridge.mode() == SNES::Cartridge::Mode::SuperGameBoy) {
+    lstring list;
+    for(unsigned n = 0; n < cheatList.size(); n++) {
+      if(cheatList[n].enable) list.append(cheatList[n].code);
+    }
+
     GameBoy::cheat.reset();
     for(auto &code : list) {
       lstring codelist;
@@ -338,18 +350,28 @@ void snes_cheat_set(unsigned index, bool enable, const char *code) {
     return;
   }
 
-  SNES::cheat.reset();
-  for(auto &code : list) {
-    lstring codelist;
-    codelist.split("+", code);
-    for(auto &part : codelist) {
-      unsigned addr, data;
-      if(SNES::Cheat::decode(part, addr, data)) {
-        SNES::cheat.append({ addr, data });
+  //only the addresses this entry had or now has can change.  the first enabled code for an
+  //address in list order wins, so those addresses are filled again from the whole list
+  linear_vector<SNES::CheatCode> changed;
+  if(previous.enable) snes_cheat_decode(previous.code, changed);
+  if(enable) snes_cheat_decode(code, changed);
+  if(changed.size() == 0) return;
+  for(unsigned i = 0; i < changed.size(); i++) SNES::cheat.remove(changed[i].addr);
+
+  for(unsigned n = 0; n < cheatList.size(); n++) {
+    if(!cheatList[n].enable) continue;
+    linear_vector<SNES::CheatCode> codes;
+    snes_cheat_decode(cheatList[n].code, codes);
+    for(unsigned i = 0; i < codes.size(); i++) {
+      unsigned addr = SNES::cheat.mirror(codes[i].addr);
+      for(unsigned c = 0; c < changed.size(); c++) {
+        if(SNES::cheat.mirror(changed[c].addr) == addr) {
+          SNES::cheat.add(codes[i].addr, codes[i].data);
+          break;
+        }
       }
     }
   }
-  SNES::cheat.synchronize();
 }
 
 //zero 21-sep-2012
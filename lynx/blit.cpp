@@ -0,0 +1,94 @@
+#include "blit.h"
+#include <cstring>
+
+namespace
+{
+	const int W = BLIT_WIDTH;
+	const int H = BLIT_HEIGHT;
+
+	// the palette is copied to a local so that stores to dest can't be assumed to alias it
+	void ConvertLine(uint32 *dest, const LynxLine &line)
+	{
+		uint32 palette[16];
+		std::memcpy(palette, line.palette, sizeof(palette));
+		for (int i = 0; i < W; i++)
+			dest[i] = palette[line.pixels[i]];
+	}
+
+	void ConvertLineReversed(uint32 *dest, const LynxLine &line)
+	{
+		uint32 palette[16];
+		std::memcpy(palette, line.palette, sizeof(palette));
+		for (int i = 0; i < W; i++)
+			dest[W - 1 - i] = palette[line.pixels[i]];
+	}
+
+	// source line j, pixel i goes to dest[(W - 1 - i) * H + j]
+	void Rotate90Lines(uint32 *dest, const LynxLine *lines, int j0, int j1)
+	{
+		for (int j = j0; j < j1; j++)
+		{
+			const LynxLine &line = lines[j];
+			uint32 *d = dest + H * (W - 1) + j;
+			for (int i = 0; i < W; i++)
+			{
+				*d = line.palette[line.pixels[i]];
+				d -= H;
+			}
+		}
+	}
+
+	// source line j, pixel i goes to dest[i * H + H - 1 - j]
+	void Rotate270Lines(uint32 *dest, const LynxLine *lines, int j0, int j1)
+	{
+		for (int j = j0; j < j1; j++)
+		{
+			const LynxLine &line = lines[j];
+			uint32 *d = dest + H - 1 - j;
+			for (int i = 0; i < W; i++)
+			{
+				*d = line.palette[line.pixels[i]];
+				d += H;
+			}
+		}
+	}
+
+	// the rotated cases stride through dest a whole output line per pixel, so work on bands
+	// of source lines small enough that every output line they touch stays in cache
+	const int BAND = 8;
+
+	void Rotate90Banded(uint32 *dest, const LynxLine *lines)
+	{
+		for (int j = 0; j < H; j += BAND)
+			Rotate90Lines(dest, lines, j, j + BAND < H ? j + BAND : H);
+	}
+
+	void Rotate270Banded(uint32 *dest, const LynxLine *lines)
+	{
+		for (int j = 0; j < H; j += BAND)
+			Rotate270Lines(dest, lines, j, j + BAND < H ? j + BAND : H);
+	}
+
+	void Blit0(uint32 *dest, const LynxLine *lines)
+	{
+		for (int j = 0; j < H; j++)
+			ConvertLine(dest + j * W, lines[j]);
+	}
+
+	void Blit180(uint32 *dest, const LynxLine *lines)
+	{
+		for (int j = 0; j < H; j++)
+			ConvertLineReversed(dest + (H - 1 - j) * W, lines[j]);
+	}
+}
+
+void LynxBlit(uint32 *dest, const LynxLine *lines, int rotate)
+{
+	switch (rotate)
+	{
+	case 0: Blit0(dest, lines); break;
+	case 1: Rotate90Banded(dest, lines); break;
+	case 2: Blit180(dest, lines); break;
+	case 3: Rotate270Banded(dest, lines); break;
+	}
+}
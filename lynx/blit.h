@@ -0,0 +1,22 @@
+#ifndef BLIT_H
+#define BLIT_H
+
+#include "mednafen.h"
+
+#define BLIT_WIDTH	160
+#define BLIT_HEIGHT	102
+
+// one line of mikie's screen dma output: 4 bit pixel indices, and the 16 colours
+// that the palette registers mapped to when the line was fetched
+struct LynxLine
+{
+	uint8 pixels[BLIT_WIDTH];
+	uint32 palette[16];
+};
+
+// convert a whole frame of lines to 32 bit pixels and rotate it into dest in one pass.
+// rotate: 0 = none, 1 = 90 degrees, 2 = 180 degrees, 3 = 270 degrees; in the rotated
+// cases dest is BLIT_HEIGHT pixels wide
+void LynxBlit(uint32 *dest, const LynxLine *lines, int rotate);
+
+#endif
@@ -47,8 +47,10 @@
 #include "system.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <string.h>
 #include "cart.h"
+#include "romimage.h"
 
 /*
 bool CCart::TestMagic(const uint8 *data, uint32 size)
@@ -139,58 +141,75 @@ CCart::CCart(const uint8 *gamedata, uint32 gamesize, int pagesize0, int pagesize
 		break;
 	}
 
-	// Make some space for the new carts
-	mCartBank0 = new uint8[mMaskBank0+1];
-	mCartBank1 = new uint8[mMaskBank1+1];
-
 	// Set default bank
 	mBank=bank0;
 
-	// Initialiase
-	std::memset(mCartBank0, DEFAULT_CART_CONTENTS, mMaskBank0 + 1);
-	std::memset(mCartBank1, DEFAULT_CART_CONTENTS, mMaskBank1 + 1);
+	// The rom banks are built once and then shared read only with every other
+	// instance that loads the same cart; both are keyed on the whole file
+	const uint8 *file = gamedata;
+	const uint32 filesize = gamesize;
 
 	// Read in the BANK0 bytes
+	mCartBank0Owner = romimage::Registry::acquire(file, filesize, pagesize0 << 1, mMaskBank0 + 1, [&](uint8 *bank)
+	{
+		std::memset(bank, DEFAULT_CART_CONTENTS, mMaskBank0 + 1);
+		if(mMaskBank0)
+			std::memcpy(bank, file, std::min(filesize, mMaskBank0+1));
+	});
+	mCartBank0 = mCartBank0Owner.get();
+	if(!mCartBank0)
+		std::abort(); // out of memory, as new would
 	if(mMaskBank0)
 	{
 		int size = std::min(gamesize, mMaskBank0+1);
-		std::memcpy(mCartBank0, gamedata, size);
 		gamedata += size;
 		gamesize -= size;
 	}
 
-	// Read in the BANK1 bytes
-	if(mMaskBank1)
-	{
-		int size = std::min(gamesize, mMaskBank1+1);
-		std::memcpy(mCartBank1, gamedata, size);
-		gamedata += size;
-	}
-
 	// As this is a cartridge boot unset the boot address
 	// mSystem.gCPUBootAddress=0;
 
-	// Dont allow an empty Bank1 - Use it for shadow SRAM/EEPROM
-	if(banktype1==UNUSED)
+	if(banktype1!=UNUSED)
+	{
+		// Read in the BANK1 bytes
+		mCartBank1Owner = romimage::Registry::acquire(file, filesize, 1 | pagesize0 << 1 | pagesize1 << 16, mMaskBank1 + 1, [&](uint8 *bank)
+		{
+			std::memset(bank, DEFAULT_CART_CONTENTS, mMaskBank1 + 1);
+			std::memcpy(bank, gamedata, std::min(gamesize, mMaskBank1+1));
+		});
+		mCartBank1 = mCartBank1Owner.get();
+		if(!mCartBank1)
+			std::abort(); // out of memory, as new would
+	}
+	else
 	{
-		// Delete the single byte allocated  earlier
-		delete[] mCartBank1;
-		// Allocate some new memory for us
+		// Dont allow an empty Bank1 - Use it for shadow SRAM/EEPROM
 		banktype1=C64K;
 		mMaskBank1=0x00ffff;
 		mShiftCount1=8;
 		mCountMask1=0x0ff;
-		mCartBank1 = (uint8*) new uint8[mMaskBank1+1];
+		mCartBank1 = new uint8[mMaskBank1+1];
 		std::memset(mCartBank1, DEFAULT_RAM_CONTENTS, mMaskBank1 + 1);
+		mCartBank1Owner.reset(mCartBank1, std::default_delete<uint8[]>());
 		mWriteEnableBank1=TRUE;
 		mCartRAM=TRUE;
 	}
 }
 
+// shares the rom banks of src; cart ram gets a buffer of its own
+CCart::CCart(const CCart &src)
+{
+	*this = src;
+	if(mCartRAM)
+	{
+		mCartBank1 = new uint8[mMaskBank1+1];
+		std::memcpy(mCartBank1, src.mCartBank1, mMaskBank1 + 1);
+		mCartBank1Owner.reset(mCartBank1, std::default_delete<uint8[]>());
+	}
+}
+
 CCart::~CCart()
 {
-	delete[] mCartBank0;
-	delete[] mCartBank1;
 }
 
 
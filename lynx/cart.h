@@ -73,6 +73,7 @@ class CCart : public CLynxBase
 
 public:
 	CCart(const uint8 *gamedata, uint32 gamesize, int pagesize0, int pagesize1) MDFN_COLD;
+	CCart(const CCart &src) MDFN_COLD;
 	~CCart() MDFN_COLD;
 
 public:
@@ -109,6 +110,10 @@ public:
 
 	bool GetSaveRamPtr(int &size, uint8 *&data);
 	void GetReadOnlyPtrs(int &s0, uint8 *&p0, int &s1, uint8 *&p1);
+	bool SameLayout(const CCart &other) const
+	{
+		return mMaskBank0 == other.mMaskBank0 && mMaskBank1 == other.mMaskBank1 && mCartRAM == other.mCartRAM;
+	}
 
 	template<bool isReader>void SyncState(NewState *ns);
 
@@ -118,6 +123,8 @@ private:
 	uint32	mMaskBank1;
 	uint8	*mCartBank0;
 	uint8	*mCartBank1;
+	std::shared_ptr<uint8> mCartBank0Owner; // rom is shared with any clones
+	std::shared_ptr<uint8> mCartBank1Owner;
 
 	uint32	mCounter;
 	uint32	mShifter;
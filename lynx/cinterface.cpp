@@ -27,6 +27,16 @@ EXPORT void Destroy(CSystem *s)
 	delete s;
 }
 
+EXPORT CSystem *Clone(CSystem *s)
+{
+	return s->Clone();
+}
+
+EXPORT int CopyInto(CSystem *dst, CSystem *src)
+{
+	return dst->CopyFrom(*src);
+}
+
 EXPORT void Reset(CSystem *s)
 {
 	s->Reset();
@@ -42,6 +52,12 @@ EXPORT int Advance(CSystem *s, int buttons, uint32 *vbuff, int16 *sbuff, int *sb
 	return s->Advance(buttons, vbuff, sbuff, *sbuffsize);
 }
 
+EXPORT int AdvanceBatch(CSystem *s, const int *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+	uint8 *dest, int destsize, uint32 *vbuff, int16 *sbuff, int *sbuffsize)
+{
+	return s->AdvanceBatch(buttons, nframes, flags, ram, nram, dest, destsize, vbuff, sbuff, *sbuffsize);
+}
+
 EXPORT int GetSaveRamPtr(CSystem *s, int *size, uint8 **data)
 {
 	return s->GetSaveRamPtr(*size, *data);
@@ -73,6 +89,40 @@ EXPORT int BinStateLoad(CSystem *s, const char *data, int length)
 	return !loader.Overflow() && loader.GetLength() == length;
 }
 
+// hash of the complete state, equal to XXH64 of what BinStateSave writes.
+// cb, if not null, receives a hash for each section as well
+EXPORT uint64_t StateHash(CSystem *s, NewStateHasher::SectionCallback cb)
+{
+	NewStateHasher hasher(cb);
+	s->SyncState<false>(&hasher);
+	return hasher.GetHash();
+}
+
+// an indexed state: the same data as BinStateSave, after a table of its sections and
+// larger fields.  a load leaves the fields named in skip as they are
+EXPORT int IndexedStateSize(CSystem *s)
+{
+	NewStateIndexedWriter writer;
+	s->SyncState<false>(&writer);
+	return writer.GetLength();
+}
+
+EXPORT int IndexedStateSave(CSystem *s, char *data, int length)
+{
+	NewStateIndexedWriter writer;
+	s->SyncState<false>(&writer);
+	return writer.Write(data, length);
+}
+
+EXPORT int IndexedStateLoad(CSystem *s, const char *data, int length, const char *const *skip, int skipcount)
+{
+	NewStateIndexedReader loader(data, length);
+	for (int i = 0; i < skipcount; i++)
+		loader.Skip(skip[i]);
+	s->SyncState<true>(&loader);
+	return loader.Done();
+}
+
 EXPORT void TxtStateSave(CSystem *s, FPtrs *ff)
 {
 	NewStateExternalFunctions saver(ff);
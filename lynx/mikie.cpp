@@ -371,14 +371,20 @@ void CMikie::DisplaySetAttributes()
 
 void CMikie::BlankLineSurface()
 {
-	uint32* bitmap_tmp = framebuffer + mpDisplayCurrentLine * SCREEN_WIDTH;
-	for (int i = 0; i < SCREEN_WIDTH; i++)
-		bitmap_tmp[i] = 0xff000000;
+	LynxLine &line = lines[mpDisplayCurrentLine];
+	std::memset(line.pixels, 0, sizeof(line.pixels));
+	for (int i = 0; i < 16; i++)
+		line.palette[i] = 0xff000000;
 }
 
 void CMikie::CopyLineSurface()
 {
-	uint32* bitmap_tmp = framebuffer + mpDisplayCurrentLine * SCREEN_WIDTH;
+	// only the pixel indices are stored here; conversion to 32 bit happens in the final blit
+	LynxLine &line = lines[mpDisplayCurrentLine];
+	uint8* bitmap_tmp = line.pixels;
+
+	for (int i = 0; i < 16; i++)
+		line.palette[i] = mColourMap[mPalette[i].Index];
 
 	for (int loop = 0; loop < SCREEN_WIDTH / 2; loop++)
 	{
@@ -386,17 +392,17 @@ void CMikie::CopyLineSurface()
 		if(mDISPCTL_Flip)
 		{
 			mLynxAddr--;
-			*bitmap_tmp=mColourMap[mPalette[source&0x0f].Index];
+			*bitmap_tmp=source&0x0f;
 			bitmap_tmp++;
-			*bitmap_tmp=mColourMap[mPalette[source>>4].Index];
+			*bitmap_tmp=source>>4;
 			bitmap_tmp++;
 		}
 		else
 		{
 			mLynxAddr++;
-			*bitmap_tmp = mColourMap[mPalette[source>>4].Index];
+			*bitmap_tmp = source>>4;
 			bitmap_tmp++;
-			*bitmap_tmp = mColourMap[mPalette[source&0x0f].Index];
+			*bitmap_tmp = source&0x0f;
 			bitmap_tmp++;
 		}
 	}
@@ -488,7 +494,7 @@ uint32 CMikie::DisplayEndOfFrame()
 		mpDisplayCurrentLine++;
 	}
 
-	mSystem.Blit(framebuffer);
+	mSystem.Blit(lines);
 
 	mpDisplayCurrentLine = 0;
 	return 0;
@@ -2572,7 +2578,7 @@ SYNCFUNC(CMikie)
 
 	// mpDisplayCurrent;
 	NSS(mpDisplayCurrentLine);
-	NSS(framebuffer);
+	NSS(lines);
 
 	NSS(last_lsample);
 	NSS(last_rsample);
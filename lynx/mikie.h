@@ -52,6 +52,7 @@
 //#include <crtdbg.h>
 //#define	TRACE_MIKIE
 #include <math.h>
+#include "blit.h"
 
 #ifdef TRACE_MIKIE
 
@@ -218,7 +219,7 @@ public:
 	void CheckWrap();
 
 	uint32		mpDisplayCurrentLine;
-	uint32		framebuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+	LynxLine	lines[SCREEN_HEIGHT];
 
 	template<bool isReader>void SyncState(NewState *ns);
 
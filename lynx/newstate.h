@@ -3,6 +3,9 @@
 
 #include <cstring>
 #include <cstddef>
+#include <vector>
+#include <stdint.h>
+#include "xxhash.h"
 
 class NewState
 {
@@ -40,6 +43,126 @@ public:
 	virtual void Load(void *ptr, size_t size, const char *name);
 };
 
+class NewStateCopier : public NewState
+{
+private:
+	struct Block
+	{
+		const char *src; // null when the value was captured into smalls
+		size_t offs;
+		size_t size;
+	};
+	std::vector<Block> blocks;
+	std::vector<char> smalls;
+	size_t pos;
+	bool mismatch;
+public:
+	// run SyncState<false> on the source, then SyncState<true> on the destination.
+	// large blocks are read straight out of the source during the second pass, so
+	// the source must not run in between.  small values are captured during the
+	// first pass, as some of the macros below save stack temporaries
+	NewStateCopier();
+	void Rewind() { blocks.clear(); smalls.clear(); pos = 0; mismatch = false; }
+	bool Mismatch() { return mismatch || pos != blocks.size(); }
+	virtual void Save(const void *ptr, size_t size, const char *name);
+	virtual void Load(void *ptr, size_t size, const char *name);
+};
+
+// feeds every saved value into a 64 bit hash, without building the state buffer.
+// the result equals XXH64 (seed 0) of the binary savestate.  with a callback, each
+// section also gets a hash of its own, reported as it closes; depth 1 is outermost
+class NewStateHasher : public NewState
+{
+public:
+	typedef void (*SectionCallback)(const char *name, int depth, uint64_t hash);
+private:
+	xxh64_state whole;
+	std::vector<xxh64_state> sections; // one per open section, only kept with a callback
+	SectionCallback sectioncb;
+public:
+	NewStateHasher(SectionCallback sectioncb);
+	void Rewind() { xxh64_reset(&whole); sections.clear(); }
+	uint64_t GetHash() const { return xxh64_digest(&whole); }
+	static uint64_t Hash(const void *ptr, size_t size);
+	virtual void Save(const void *ptr, size_t size, const char *name);
+	virtual void Load(void *ptr, size_t size, const char *name);
+	virtual void EnterSection(const char *name);
+	virtual void ExitSection(const char *name);
+};
+
+// an indexed binary savestate is a header, a table of entries, and then the same
+// data a binary savestate holds.  there is an entry for every section and one for
+// every field of at least IndexedStateFieldMin bytes, in the order they open, so
+// a section comes before what it holds.  offsets are from the start of the data
+static const uint32_t IndexedStateVersion = 1;
+static const size_t IndexedStateFieldMin = 1024;
+static const size_t IndexedStateNameSize = 48;
+
+enum
+{
+	IndexedStateSection = 0,
+	IndexedStateField = 1
+};
+
+struct IndexedStateHeader
+{
+	char magic[4]; // "EWSI"
+	uint32_t version;
+	uint32_t entrycount;
+	uint32_t entrysize; // sizeof(IndexedStateEntry)
+	uint64_t datasize;
+	uint64_t datahash; // XXH64 of the data
+};
+
+struct IndexedStateEntry
+{
+	char name[IndexedStateNameSize]; // truncated if need be, always terminated
+	uint32_t depth; // 1 is outermost; a field is one deeper than its section
+	uint32_t kind;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t hash; // XXH64 of the bytes the entry covers
+};
+
+class NewStateIndexedWriter : public NewState
+{
+private:
+	std::vector<char> data;
+	std::vector<IndexedStateEntry> entries;
+	std::vector<size_t> open; // entries of the sections not yet closed
+	void AddEntry(const char *name, uint32_t kind, size_t offset, size_t size);
+public:
+	NewStateIndexedWriter();
+	void Rewind() { data.clear(); entries.clear(); open.clear(); }
+	long GetLength() const;
+	// writes the whole thing; false if maxlength is not exactly GetLength()
+	bool Write(char *buffer, long maxlength) const;
+	virtual void Save(const void *ptr, size_t size, const char *name);
+	virtual void Load(void *ptr, size_t size, const char *name);
+	virtual void EnterSection(const char *name);
+	virtual void ExitSection(const char *name);
+};
+
+// loads the data of an indexed savestate.  fields given to Skip() are stepped over,
+// which leaves that memory in the core as it was.  only fields can be skipped, as
+// sections hold values that are loaded into temporaries and then converted
+class NewStateIndexedReader : public NewState
+{
+private:
+	const char *data;
+	long length;
+	long pos;
+	bool bad;
+	std::vector<const char *> skips;
+public:
+	NewStateIndexedReader(const char *buffer, long buflength);
+	void Skip(const char *name) { skips.push_back(name); }
+	// true if the header was good and the load used exactly all of the data
+	bool Done() const { return !bad && pos == length; }
+	virtual void Save(const void *ptr, size_t size, const char *name);
+	virtual void Load(void *ptr, size_t size, const char *name);
+};
+
 struct FPtrs
 {
 	void (*Save_)(const void *ptr, size_t size, const char *name);
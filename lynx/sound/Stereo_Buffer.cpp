@@ -100,6 +100,27 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long max_samples )
 	return count * 2;
 }
 
+void Stereo_Buffer::discard_samples()
+{
+	long count = bufs [0].samples_avail();
+	if ( count )
+	{
+		bufs [0].remove_samples( count );
+		if ( stereo_added || was_stereo )
+		{
+			bufs [1].remove_samples( count );
+			bufs [2].remove_samples( count );
+		}
+		else
+		{
+			bufs [1].remove_silence( count );
+			bufs [2].remove_silence( count );
+		}
+		was_stereo = stereo_added;
+		stereo_added = false;
+	}
+}
+
 void Stereo_Buffer::mix_stereo( blip_sample_t* out, long count )
 {
 	Blip_Reader l_left; 
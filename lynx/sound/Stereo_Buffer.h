@@ -35,6 +35,9 @@ public:
 	long samples_avail() const;
 	long read_samples( blip_sample_t*, long );
 	
+	// Drop all available samples
+	void discard_samples();
+	
 private:
 	// noncopyable
 	Stereo_Buffer( const Stereo_Buffer& );
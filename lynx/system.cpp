@@ -73,14 +73,64 @@ CSystem::CSystem(const uint8 *game, uint32 gamesize, const uint8 *bios, uint32 b
 	// Now the handlers are set we can instantiate the CPU as is will use handlers on reset
 	mCpu = new C65C02(*this);
 
+	mLowpass = lowpass;
+	SetupSound();
+
+	// Now init is complete do a reset, this will cause many things to be reset twice
+	Reset();
+}
+
+// a new system on the same cart as src, which still needs src's state copied in
+CSystem::CSystem(const CSystem &src)
+{
+	mRom = new CRom(*src.mRom);
+
+	mCart = new CCart(*src.mCart);
+	mRam = new CRam();
+
+	mMikie = new CMikie(*this);
+	mSusie = new CSusie(*this);
+
+	mMemMap = new CMemMap(*this);
+
+	mCpu = new C65C02(*this);
+
+	rotate = src.rotate;
+	mLowpass = src.mLowpass;
+	SetupSound();
+
+	Reset();
+}
+
+void CSystem::SetupSound()
+{
 	mMikie->mikbuf.set_sample_rate(44100, 60);
 	mMikie->mikbuf.clock_rate((long int)(16000000 / 4));
 	mMikie->mikbuf.bass_freq(60);
 	mMikie->miksynth.volume(0.50);
-	mMikie->miksynth.treble_eq(lowpass ? -35 : 0);
+	mMikie->miksynth.treble_eq(mLowpass ? -35 : 0);
+}
 
-	// Now init is complete do a reset, this will cause many things to be reset twice
-	Reset();
+// an independent instance sharing this one's cart rom and bios, starting from its current state.
+// comlynx callbacks are not carried over
+CSystem *CSystem::Clone()
+{
+	CSystem *s = new CSystem(*this);
+	s->CopyFrom(*this);
+	return s;
+}
+
+// copy the complete emulation state of another system running the same cart
+// directly into this one, without going through a savestate buffer
+bool CSystem::CopyFrom(CSystem &src)
+{
+	if(!mCart->SameLayout(*src.mCart))
+		return false;
+
+	copier.Rewind();
+	src.SyncState<false>(&copier);
+	SyncState<true>(&copier);
+	return !copier.Mismatch();
 }
 
 CSystem::~CSystem()
@@ -183,66 +233,100 @@ bool CSystem::Advance(int buttons, uint32 *vbuff, int16 *sbuff, int &sbuffsize)
 	frameoverflow = gSystemCycleCount - target;
 
 	mMikie->mikbuf.end_frame((gSystemCycleCount - start) >> 2);
-	sbuffsize = mMikie->mikbuf.read_samples(sbuff, sbuffsize);
+	if (sbuff)
+	{
+		sbuffsize = mMikie->mikbuf.read_samples(sbuff, sbuffsize);
+	}
+	else
+	{
+		mMikie->mikbuf.discard_samples();
+		sbuffsize = 0;
+	}
 
 	return mSusie->lagged;
 }
 
-void CSystem::Blit(const uint32 *src)
+// dest receives one record per frame: uint32 flags (1 = lagged, 2 = sound didn't fit), uint32 HashRam()
+// and then the bytes of each ram range, padded to a multiple of 4.  only the last frame goes to vbuff.
+// returns the number of frames run, or -1 if the ram ranges or dest are bad
+int CSystem::AdvanceBatch(const int *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+	uint8 *dest, int destsize, uint32 *vbuff, int16 *sbuff, int &sbuffsize)
 {
-	if (!videobuffer)
+	auto records = framebatch::writer(ram, nram, [this](int area, const uint8 *&data, int &size)
 	{
-		// a game shouldn't be able to get two frames in in the length of time we traverse in a single
-		// call to advance.  what is going on here?
-		return;
+		uint8 *p = nullptr;
+		bool ret = GetMemoryArea(area, size, p);
+		data = p;
+		return ret;
+	});
+	if (!records.fits(nframes, destsize))
+		return -1;
+
+	if (flags & BATCH_NOAUDIO)
+		sbuff = nullptr;
+	const int smax = sbuff ? sbuffsize : 0;
+	int spos = 0;
+
+	for (int n = 0; n < nframes; n++)
+	{
+		uint32 *frame = flags & BATCH_NOVIDEO || n < nframes - 1 ? nullptr : vbuff;
+		int count = smax - spos;
+		uint32 frameflags = Advance(buttons[n], frame, sbuff ? sbuff + spos : nullptr, count);
+		if (sbuff)
+		{
+			spos += count;
+			if (mMikie->mikbuf.samples_avail())
+			{
+				mMikie->mikbuf.discard_samples();
+				frameflags |= framebatch::audio_overflow;
+			}
+		}
+
+		dest = records.write(dest, frameflags, flags & BATCH_NOHASH ? 0 : HashRam());
 	}
 
-	const int W = 160;
-	const int H = 102;
+	sbuffsize = spos;
+	return nframes;
+}
 
-	switch (rotate)
+uint32 CSystem::HashRam()
+{
+	return framebatch::hash(GetRamPointer(), SYSTEM_SIZE);
+}
+
+bool CSystem::GetMemoryArea(int area, int &size, uint8 *&data)
+{
+	int s0, s1;
+	uint8 *p0, *p1;
+	switch (area)
 	{
 	case 0:
-		std::memcpy(videobuffer, src, sizeof(uint32) * W * H);
-		break;
+		size = SYSTEM_SIZE;
+		data = GetRamPointer();
+		return true;
 	case 1:
-		{
-			uint32 *dest = videobuffer + H * (W - 1);
-			for (int j = 0; j < H; j++)
-			{
-				for (int i = 0; i < W; i++)
-				{
-					*dest = *src++;
-					dest -= H;
-				}
-				dest += H * W + 1;
-			}
-		}
-		break;
+		return GetSaveRamPtr(size, data);
 	case 2:
-		{
-			uint32 *dest = videobuffer + H * W - 1;
-			for (int i = 0; i < W * H; i++)
-			{
-				*dest-- = *src++;
-			}
-		}
-		break;
 	case 3:
-		{
-			uint32 *dest = videobuffer + H - 1;
-			for (int j = 0; j < H; j++)
-			{
-				for (int i = 0; i < W; i++)
-				{
-					*dest = *src++;
-					dest += H;
-				}
-				dest -= H * W + 1;
-			}
-		}
-		break;
+		GetReadOnlyCartPtrs(s0, p0, s1, p1);
+		size = area == 2 ? s0 : s1;
+		data = area == 2 ? p0 : p1;
+		return data != nullptr;
+	default:
+		return false;
 	}
+}
+
+void CSystem::Blit(const LynxLine *lines)
+{
+	if (!videobuffer)
+	{
+		// a game shouldn't be able to get two frames in in the length of time we traverse in a single
+		// call to advance.  what is going on here?
+		return;
+	}
+
+	LynxBlit(videobuffer, lines, rotate);
 
 	videobuffer = nullptr;
 }
@@ -49,6 +49,8 @@
 #include "machine.h"
 
 #include <string>
+#include <memory>
+#include "framebatch.h"
 
 #define HANDY_SYSTEM_FREQ						16000000
 #define HANDY_TIMER_FREQ						20
@@ -95,6 +97,17 @@ extern uint32	gSystemHalt;
 
 class CSystem;
 
+// one range of memory sampled after every frame of CSystem::AdvanceBatch()
+// area: 0 = RAM, 1 = save RAM, 2 = cart bank 0, 3 = cart bank 1
+typedef framebatch::Range BatchRam;
+
+enum
+{
+	BATCH_NOVIDEO = 1, // don't render the last frame of the batch either
+	BATCH_NOAUDIO = 2,
+	BATCH_NOHASH = 4
+};
+
 //
 // Now pull in the parts that build the system
 //
@@ -117,9 +130,14 @@ class CSystem : public CSystemBase
 public:
 	CSystem(const uint8 *, uint32, const uint8*, uint32, int, int, bool) MDFN_COLD;
 	~CSystem() MDFN_COLD;
+private:
+	CSystem(const CSystem &) MDFN_COLD;
+	void SetupSound() MDFN_COLD;
 
 public:
 	void Reset() MDFN_COLD;
+	CSystem *Clone() MDFN_COLD;
+	bool CopyFrom(CSystem &src);
 
 	inline void Update(uint32 targetclock)
 	{
@@ -139,9 +157,13 @@ public:
 		}
 	}
 
-	void Blit(const uint32 *src);
+	void Blit(const LynxLine *lines);
 
 	bool Advance(int buttons, uint32 *vbuff, int16 *sbuff, int &sbuffsize);
+	int AdvanceBatch(const int *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+		uint8 *dest, int destsize, uint32 *vbuff, int16 *sbuff, int &sbuffsize);
+	uint32 HashRam();
+	bool GetMemoryArea(int area, int &size, uint8 *&data);
 	bool GetSaveRamPtr(int &size, uint8 *&data) { return mCart->GetSaveRamPtr(size, data); }
 	void GetReadOnlyCartPtrs(int &s0, uint8 *&p0, int &s1, uint8 *&p1) { mCart->GetReadOnlyPtrs(s0, p0, s1, p1); }
 
@@ -223,6 +245,9 @@ public:
 	int rotate;
 	// video dest
 	uint32 *videobuffer;
+	bool mLowpass;
+
+	NewStateCopier copier; // reused by CopyFrom()
 
 	template<bool isReader>void SyncState(NewState *ns);
 };
@@ -0,0 +1,115 @@
+// compares LynxBlit against the old two pass path (palette conversion into a 32 bit
+// framebuffer, then a separate rotating copy), checking that the output is identical
+// and timing both.  build with "make blitbench" from mingw/
+
+#include "../blit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const int W = BLIT_WIDTH;
+	const int H = BLIT_HEIGHT;
+
+	// the old path, as mikie's CopyLineSurface() and CSystem::Blit() used to do it
+	void OldBlit(uint32 *videobuffer, uint32 *framebuffer, const LynxLine *lines, int rotate)
+	{
+		for (int j = 0; j < H; j++)
+			for (int i = 0; i < W; i++)
+				framebuffer[j * W + i] = lines[j].palette[lines[j].pixels[i]];
+
+		const uint32 *src = framebuffer;
+		switch (rotate)
+		{
+		case 0:
+			std::memcpy(videobuffer, src, sizeof(uint32) * W * H);
+			break;
+		case 1:
+			{
+				uint32 *dest = videobuffer + H * (W - 1);
+				for (int j = 0; j < H; j++)
+				{
+					for (int i = 0; i < W; i++)
+					{
+						*dest = *src++;
+						dest -= H;
+					}
+					dest += H * W + 1;
+				}
+			}
+			break;
+		case 2:
+			{
+				uint32 *dest = videobuffer + H * W - 1;
+				for (int i = 0; i < W * H; i++)
+				{
+					*dest-- = *src++;
+				}
+			}
+			break;
+		case 3:
+			{
+				uint32 *dest = videobuffer + H - 1;
+				for (int j = 0; j < H; j++)
+				{
+					for (int i = 0; i < W; i++)
+					{
+						*dest = *src++;
+						dest += H;
+					}
+					dest -= H * W + 1;
+				}
+			}
+			break;
+		}
+	}
+
+	template<typename F>
+	double Time(int iterations, F f)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; i++)
+			f();
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+	std::vector<LynxLine> lines(H);
+	std::srand(1);
+	for (int j = 0; j < H; j++)
+	{
+		for (int i = 0; i < W; i++)
+			lines[j].pixels[i] = std::rand() & 15;
+		for (int c = 0; c < 16; c++)
+			lines[j].palette[c] = 0xff000000 | (std::rand() << 8 ^ std::rand());
+	}
+
+	std::vector<uint32> framebuffer(W * H), expected(W * H), actual(W * H);
+	int ret = 0;
+
+	for (int rotate = 0; rotate < 4; rotate++)
+	{
+		OldBlit(&expected[0], &framebuffer[0], &lines[0], rotate);
+		LynxBlit(&actual[0], &lines[0], rotate);
+
+		bool ok = expected == actual;
+		if (!ok)
+			ret = 1;
+
+		double told = Time(iterations, [&] { OldBlit(&actual[0], &framebuffer[0], &lines[0], rotate); });
+		double tnew = Time(iterations, [&] { LynxBlit(&actual[0], &lines[0], rotate); });
+
+		std::printf("rotate %d: %s  old %7.2fus  fused %7.2fus  (%.2fx)\n",
+			rotate, ok ? "match   " : "MISMATCH", told, tnew, told / tnew);
+	}
+	return ret;
+}
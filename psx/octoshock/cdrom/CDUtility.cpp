@@ -113,6 +113,11 @@ bool edc_lec_check_and_correct(uint8 *sector_data, bool xa)
 	return !!ValidateRawSector(sector_data, xa);
 }
 
+bool edc_check(const uint8 *sector_data, bool xa)
+{
+	return !!CheckEDC(sector_data, xa);
+}
+
 bool subq_check_checksum(const uint8 *SubQBuf)
 {
  uint16 crc = 0;
@@ -158,6 +158,9 @@ namespace CDUtility
  //  sector_data should contain 2352 bytes of raw sector data.
  bool edc_lec_check_and_correct(uint8 *sector_data, bool xa);
 
+ // Returns true if the EDC of a mode 1 or mode 2 form 1 sector matches, without attempting any correction.
+ bool edc_check(const uint8 *sector_data, bool xa);
+
  // Returns false on checksum mismatch, true on match.
  bool subq_check_checksum(const uint8 *subq_buf);
 
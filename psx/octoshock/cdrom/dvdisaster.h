@@ -136,6 +136,7 @@ void AndQVector(unsigned char*, unsigned char, int);
 void OrQVector(unsigned char*, unsigned char, int);
 
 int DecodePQ(ReedSolomonTables*, unsigned char*, int, int*, int);
+void GetPSyndromes(const unsigned char*, unsigned char*, unsigned char*);
 
 int CountC2Errors(unsigned char*);
 
@@ -38,3 +38,12 @@ static inline int mod_fieldmax(int x)
 
   return x;
 }
+
+/*
+ * Multiply by alpha in the L-EC field (generator 0x11d).
+ */
+
+static inline int gf_mul_alpha(int x)
+{
+  return (x << 1) ^ ((x & 0x80) ? 0x11d : 0);
+}
@@ -26,6 +26,11 @@
 
 #include "galois-inlines.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEC_SSE2
+#endif
+
 #define MIN(a, b)  (((a) < (b)) ? (a) : (b))
 
 /***
@@ -186,6 +191,53 @@ void AndQVector(unsigned char *frame, unsigned char data, int n)
    frame[2300 + n] &= data;
 }
 
+/*
+ * Syndromes of all 86 P vectors at once. P vector n is column n of
+ * the 26 rows of 86 bytes starting at frame offset 12, so 16 adjacent
+ * vectors are one unaligned 16 byte load per row. A vector whose two
+ * syndromes are zero is error free; DecodePQ() would return 0 for it.
+ */
+
+void GetPSyndromes(const unsigned char *frame, unsigned char *syn0, unsigned char *syn1)
+{  int p,i;
+
+#ifdef LEC_SSE2
+   const __m128i poly = _mm_set1_epi8(0x1d);
+
+   for(p=0; p<N_P_VECTORS; p+=16)
+   {  const int n = MIN(p, N_P_VECTORS-16);  /* last block overlaps the previous one */
+      const unsigned char *row = frame + 12 + n;
+      __m128i s0 = _mm_setzero_si128();
+      __m128i s1 = _mm_setzero_si128();
+
+      for(i=0; i<P_VECTOR_SIZE; i++, row+=86)
+      {  const __m128i d = _mm_loadu_si128((const __m128i*)row);
+	 const __m128i carry = _mm_cmplt_epi8(s1, _mm_setzero_si128());
+
+	 s0 = _mm_xor_si128(s0, d);
+	 s1 = _mm_xor_si128(_mm_add_epi8(s1, s1), _mm_and_si128(carry, poly));
+	 s1 = _mm_xor_si128(s1, d);
+      }
+
+      _mm_storeu_si128((__m128i*)(syn0 + n), s0);
+      _mm_storeu_si128((__m128i*)(syn1 + n), s1);
+   }
+#else
+   for(p=0; p<N_P_VECTORS; p++)
+   {  const unsigned char *row = frame + 12 + p;
+      int s0 = 0, s1 = 0;
+
+      for(i=0; i<P_VECTOR_SIZE; i++, row+=86)
+      {  s0 ^= *row;
+	 s1 = gf_mul_alpha(s1) ^ *row;
+      }
+
+      syn0[p] = s0;
+      syn1[p] = s1;
+   }
+#endif
+}
+
 /***
  *** C2 error counting
  ***/
@@ -244,17 +296,16 @@ int DecodePQ(ReedSolomonTables *rt, unsigned char *data, int padding,
    int i,j,k;
    int r,el;
   
-   /*** Form the syndromes: Evaluate data(x) at roots of g(x) */
+   /*** Form the syndromes: Evaluate data(x) at roots of g(x).
+	With the roots 1 and alpha this is a running xor and a
+	multiply by alpha per byte, without the log tables. */
 
-   for(i=0; i<NROOTS; i++)
-     syndrome[i] = data[0];
+   syndrome[0] = syndrome[1] = data[0];
 
    for(j=1; j<shortened_size; j++)
-     for(i=0; i<NROOTS; i++)
-       if(syndrome[i] == 0) 
-             syndrome[i] = data[j];
-        else syndrome[i] = data[j] ^ gt->alphaTo[mod_fieldmax(gt->indexOf[syndrome[i]] 
-							      + (LEC_FIRST_ROOT+i)*LEC_PRIM_ELEM)];
+   {  syndrome[0] ^= data[j];
+      syndrome[1] = gf_mul_alpha(syndrome[1]) ^ data[j];
+   }
 
    /*** Convert syndrome to index form, check for nonzero condition. */
 
@@ -25,6 +25,7 @@
 #include <sys/types.h>
 
 #include "lec.h"
+#include "dvdisaster.h"
 
 #define GF8_PRIM_POLY 0x11d /* x^8 + x^4 + x^3 + x^2 + 1 */
 
@@ -58,16 +59,6 @@ public:
   operator const u_int16_t *() const	    { return &table[0][0]; }
 } CF8_Q_COEFFS_RESULTS_01;
 
-static const class CrcTable {
-private:
-  u_int32_t table[256];
-public:
-  CrcTable();
-  ~CrcTable() {}
-  u_int32_t operator[](int i) const	{ return table[i]; }
-  operator const u_int32_t *() const	{ return table;    }
-} CRCTABLE;
-
 static const class ScrambleTable {
 private:
   u_int8_t table[2340];
@@ -223,67 +214,14 @@ Gf8_Q_Coeffs_Results_01::Gf8_Q_Coeffs_Results_01()
   }
 }
 
-/* Reverses the bits in 'd'. 'bits' defines the bit width of 'd'.
- */
-static u_int32_t mirror_bits(u_int32_t d, int bits)
-{
-  int i;
-  u_int32_t r = 0;
-
-  for (i = 0; i < bits; i++) {
-    r <<= 1;
-
-    if ((d & 0x1) != 0)
-      r |= 0x1;
-
-    d >>= 1;
-  }
-
-  return r;
-}
-
-/* Build the CRC lookup table for EDC_POLY poly. The CRC is 32 bit wide
- * and reversed (i.e. the bit stream is divided by the EDC_POLY with the
- * LSB first order).
- */
-CrcTable::CrcTable ()
-{
-  u_int32_t i, j;
-  u_int32_t r;
-  
-  for (i = 0; i < 256; i++) {
-    r = mirror_bits(i, 8);
-
-    r <<= 24;
-
-    for (j = 0; j < 8; j++) {
-      if ((r & 0x80000000) != 0) {
-	r <<= 1;
-	r ^= EDC_POLY;
-      }
-      else {
-	r <<= 1;
-      }
-    }
-
-    r = mirror_bits(r, 32);
-
-    table[i] = r;
-  }
-}
-
-/* Calculates the CRC of given data with given lengths based on the
- * table lookup algorithm.
+/* Calculates the CRC of given data with given lengths. The CRC is 32 bit
+ * wide and reversed (i.e. the bit stream is divided by the EDC_POLY with
+ * the LSB first order); EDCCrc32() shares its slicing-by-8 tables with the
+ * EDC check.
  */
 static u_int32_t calc_edc(u_int8_t *data, int len)
 {
-  u_int32_t crc = 0;
-
-  while (len--) {
-    crc = CRCTABLE[(int)(crc ^ *data++) & 0xff] ^ (crc >> 8);
-  }
-
-  return crc;
+  return EDCCrc32(data, len);
 }
 
 /* Build the scramble table as defined in the yellow book. The bytes
@@ -85,6 +85,7 @@ static int simple_lec(unsigned char *frame)
    unsigned char p_vector[P_VECTOR_SIZE];
    unsigned char q_vector[Q_VECTOR_SIZE];
    unsigned char p_state[P_VECTOR_SIZE];
+   unsigned char p_syn0[N_P_VECTORS], p_syn1[N_P_VECTORS];
    int erasures[Q_VECTOR_SIZE], erasure_count;
    int ignore[2];
    int p_failures, q_failures;
@@ -122,11 +123,17 @@ static int simple_lec(unsigned char *frame)
      }
    }
 
-   /* Perform P-Parity error correction */
+   /* Perform P-Parity error correction.
+      Vectors with zero syndromes are clean and skipped up front. */
+
+   GetPSyndromes(frame, p_syn0, p_syn1);
 
    for(p=0; p<N_P_VECTORS; p++)
    {  int err,i;
 
+      if(!(p_syn0[p] | p_syn1[p]))
+	continue;
+
       /* Try error correction without erasure information */
 
       GetPVector(frame, p_vector, p);
@@ -29,6 +29,12 @@ typedef unsigned __int32 uint32;
 typedef unsigned __int16 uint16;
 typedef unsigned __int8 uint8;
 #else
+#define SIZEOF_CHAR sizeof(char)
+#define SIZEOF_SHORT sizeof(short)
+#define SIZEOF_INT sizeof(int)
+#define SIZEOF_LONG sizeof(long)
+#define SIZEOF_LONG_LONG sizeof(long long)
+#define SIZEOF_OFF_T sizeof(off_t)
 typedef __int64_t s64;
 typedef __int32_t s32;
 typedef __int16_t s16;
@@ -84,9 +90,10 @@ typedef __uint8_t uint8;
 
 #if defined(_MSC_VER)
 	#define strncasecmp _strnicmp
-	#define NO_CLONE
 #endif
 
+#define NO_CLONE
+
 #if defined(_MSC_VER) && _MSC_VER < 1900
   #define snprintf _snprintf
   #define vsnprintf _vsnprintf
@@ -119,12 +126,17 @@ char (*BLAHBLAHBLAH( UNALIGNED T (&)[N] ))[N];
 #endif
 //---------------------------------------------
 
+#ifdef _MSC_VER
 #ifdef EW_EXPORT
 #undef EW_EXPORT
 #define EW_EXPORT extern "C" __declspec(dllexport)
 #else
 #define EW_EXPORT extern "C" __declspec(dllimport)
 #endif
+#else
+#undef EW_EXPORT
+#define EW_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
 
 //http://stackoverflow.com/questions/1537964/visual-c-equivalent-of-gccs-attribute-packed
 #ifdef _MSC_VER
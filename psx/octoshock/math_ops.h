@@ -1,6 +1,8 @@
 #pragma once
 
+#ifdef _MSC_VER
 #include <intrin.h>
+#endif
 
 //
 // Result is defined for all possible inputs(including 0).
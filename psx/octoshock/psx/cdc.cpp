@@ -64,6 +64,9 @@ PS_CDC::PS_CDC() : DMABuffer(4096)
  Cur_disc = NULL;
  Open_disc = NULL;
  EnableLEC = false;
+ memset(LEC_Verified, 0, sizeof(LEC_Verified));
+ for(unsigned i = 0; i < SectorPipe_Count; i++)
+  SectorPipe_LBA[i] = -1;
 
  DriveStatus = DS_STOPPED;
  PendingCommandPhase = 0;
@@ -154,6 +157,9 @@ void PS_CDC::SetDisc(ShockDiscRef *disc, const char *disc_id, bool poke)
 	Open_disc = disc;
 	strncpy((char*)Open_DiscID,disc_id,4);
 
+	//sectors verified on the old disc say nothing about the new one
+	memset(LEC_Verified, 0, sizeof(LEC_Verified));
+
 	if(poke)
 		CloseTray(true);
 }
@@ -368,6 +374,11 @@ SYNCFUNC(PS_CDC)
   NSS(ReportLastF);
 
 	//(%= crap about file format recovery in case SectorPipe_Pos changes)
+
+	//the pipe's LBAs aren't saved, so sectors already in it get checked again
+	if(isReader)
+		for(unsigned i = 0; i < SectorPipe_Count; i++)
+			SectorPipe_LBA[i] = -1;
 }
 
 void PS_CDC::ResetTS(void)
@@ -1024,9 +1035,22 @@ void PS_CDC::HandlePlayRead(void)
 			#ifdef WANT_LEC_CHECK
 			 if (EnableLEC)
 			 {
-				 if (!edc_lec_check_and_correct(buf, true))
+				 //sectors that were clean before are still clean, since disc images don't change under us.
+				 //corrected sectors aren't remembered, as the next read returns the same errors again.
+				 const int32 lba = SectorPipe_LBA[SectorPipe_Pos];
+				 const bool cacheable = lba >= 0 && lba < LEC_MaxSectors;
+
+				 if (!cacheable || !(LEC_Verified[lba >> 3] & (1 << (lba & 7))))
 				 {
-					 printf("Bad sector? - %d", CurSector);
+					 if (edc_check(buf, true))
+					 {
+						 if (cacheable)
+							 LEC_Verified[lba >> 3] |= 1 << (lba & 7);
+					 }
+					 else if (!edc_lec_check_and_correct(buf, true))
+					 {
+						 printf("Bad sector? - %d", CurSector);
+					 }
 				 }
 			 }
 			#endif
@@ -1065,6 +1089,7 @@ void PS_CDC::HandlePlayRead(void)
  }
 
  memcpy(SectorPipe[SectorPipe_Pos], read_buf, 2352);
+ SectorPipe_LBA[SectorPipe_Pos] = CurSector;
  SectorPipe_Pos = (SectorPipe_Pos + 1) % SectorPipe_Count;
  SectorPipe_In++;
 
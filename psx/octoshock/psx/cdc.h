@@ -52,6 +52,12 @@ class PS_CDC
  CDIF *Cur_CDIF;
  ShockDiscRef* Cur_disc;
  bool EnableLEC;
+
+ // Sectors of the current disc that already passed the EDC check, one bit per LBA, so re-reads skip it.
+ // Cleared on disc change; not savestated.
+ enum { LEC_MaxSectors = 75 * 60 * 75 };
+ uint8 LEC_Verified[(LEC_MaxSectors + 7) / 8];
+
  bool TrayOpen;
 
  ShockDiscRef* Open_disc; //the disc that's in the tray, while the tray is open. pending, kind of. used because Cur_disc != NULL is used as a tray-closed marker in the CDC code
@@ -101,6 +107,7 @@ class PS_CDC
  uint8 SectorPipe[SectorPipe_Count][2352];
  uint8 SectorPipe_Pos;
  uint8 SectorPipe_In;
+ int32 SectorPipe_LBA[SectorPipe_Count];	// For LEC_Verified; not savestated, -1 if unknown.
 
  //uint8 SubQBuf[0xC];
  uint8 SubQBuf_Safe[0xC];
@@ -38,6 +38,14 @@
 #include <stdarg.h>
 #include <ctype.h>
 
+#ifdef PSX_EVENT_PROFILE
+#include <chrono>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 //I apologize for the absolute madness of the resolution management and framebuffer management and normalizing in here.
 //It's grown entirely out of control. The main justification for the original design was not wrecking mednafen internals too much.
 
@@ -339,6 +347,21 @@ void ForceEventUpdates(const pscpu_timestamp_t timestamp)
  CPU->SetEventNT(events[PSX_EVENT__SYNFIRST].next->event_time);
 }
 
+#ifdef PSX_EVENT_PROFILE
+static uint64 EventProfileNS[PSX_EVENT__COUNT];
+
+static INLINE uint64 EventProfileNow(void)
+{
+ return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PSX_GetEventProfile(uint64 (&ns)[PSX_EVENT__COUNT])
+{
+ memcpy(ns, EventProfileNS, sizeof(ns));
+ memset(EventProfileNS, 0, sizeof(EventProfileNS));
+}
+#endif
+
 bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
 {
  event_list_entry *e = events[PSX_EVENT__SYNFIRST].next;
@@ -347,6 +370,9 @@ bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
  {
   event_list_entry *prev = e->prev;
   pscpu_timestamp_t nt;
+#ifdef PSX_EVENT_PROFILE
+  const uint64 profile_start = EventProfileNow();
+#endif
 
   switch(e->which)
   {
@@ -372,6 +398,9 @@ bool PSX_EventHandler(const pscpu_timestamp_t timestamp)
 	nt = FIO->Update(e->event_time);
 	break;
   }
+#ifdef PSX_EVENT_PROFILE
+  EventProfileNS[e->which] += EventProfileNow() - profile_start;
+#endif
 #if PSX_EVENT_SYSTEM_CHECKS
   assert(nt > e->event_time);
 #endif
@@ -1285,9 +1314,6 @@ static void MountCPUAddressSpace()
 
 static MDFN_Surface *VTBuffer[2] = { NULL, NULL };
 static int *VTLineWidths[2] = { NULL, NULL };
-static bool s_FramebufferNormalized;
-static int s_FramebufferCurrent;
-static int s_FramebufferCurrentWidth;
 
 EW_EXPORT s32 shock_Create(void** psx, s32 region, void* firmware512k)
 {
@@ -1389,7 +1415,7 @@ EW_EXPORT s32 shock_Step(void* psx, eShockStep step)
 	espec.MasterCycles = 0;
 
 	espec.SoundBufMaxSize = 1024*1024;
-	espec.SoundRate = 44100;
+	espec.SoundRate = (step & eShockStep_Flag_NoAudio) ? 0 : 44100;
 	espec.SoundBuf = soundbuf;
 	espec.SoundBufSize = 0;
 	espec.SoundVolume = 1.0;
@@ -1457,11 +1483,6 @@ EW_EXPORT s32 shock_Step(void* psx, eShockStep step)
 		espec.InterlaceField = 0;
 	}
 
-	//new frame, hasnt been normalized
-	s_FramebufferNormalized = false;
-	s_FramebufferCurrent = 0;
-	s_FramebufferCurrentWidth = FB_WIDTH;
-
 	//just in case we debug printed or something like that
 	fflush(stdout);
 	fflush(stderr);
@@ -1521,8 +1542,18 @@ static void _shock_AnalyzeFramebufferCropInfo(int fbIndex, FramebufferCropInfo*
 }
 
 
+//layout of the normalized framebuffer: the cropped image, pixel doubled by xs and ys, floated by xm and ym inside virtual_width x virtual_height
+struct NormalizedFramebufferInfo
+{
+	int width, height, xs, ys, xm, ym;
+	int virtual_width, virtual_height;
+	const uint32* src;
+	int pitch;
+};
+
 //`normalizes` the framebuffer to 700x480 (or 800x576 for PAL) by pixel doubling and wrecking the AR a little bit as needed
-void NormalizeFramebuffer()
+//this only works out the layout; EmitNormalizedFramebuffer() writes the pixels straight to the output in one pass
+static void _shock_AnalyzeNormalizedFramebuffer(NormalizedFramebufferInfo* info)
 {
 	//mednafen's advised solution for smooth gaming: "scale the output width to z * nominal_width, and the output height to z * nominal_height, where nominal_width and nominal_height are members of the MDFNGI struct"
 	//IOW, mednafen's strategy is to put everything in a 320x240 and scale it up 3x to 960x720 by default (which is adequate to contain the largest PSX framebuffer of 700x480)
@@ -1597,104 +1628,69 @@ void NormalizeFramebuffer()
 	int xm = (virtual_width - width*xs) / 2;
 	int ym = (virtual_height - height*ys) / 2;
 
-	int curr = 0;
+	info->width = width;
+	info->height = height;
+	info->xs = xs;
+	info->ys = ys;
+	info->xm = xm;
+	info->ym = ym;
+	info->virtual_width = virtual_width;
+	info->virtual_height = virtual_height;
+	info->pitch = VTBuffer[0]->pitch32;
+	info->src = VTBuffer[0]->pixels + info->pitch * cropInfo.yo + espec.DisplayRect.x;
+}
 
-	//1. double the height, while cropping down
-	if(height != virtual_height)
+static void DoublePixelsHorizontally(uint32* dst, const uint32* src, int width)
+{
+	int x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+	for(;x+4<=width;x+=4)
 	{
-		uint32* src = VTBuffer[curr]->pixels + (s_FramebufferCurrentWidth * (espec.DisplayRect.y + cropInfo.yo)) + espec.DisplayRect.x; //?
-		uint32* dst = VTBuffer[curr^1]->pixels;
-		int tocopy = width*4;
-
-		//float from top as needed
-		memset(dst, 0, ym*tocopy);
-		dst += width * ym;
-
-		if(ys==2)
-		{
-			for(int y=0;y<height;y++)
-			{
-				memcpy(dst,src,tocopy);
-				dst += width;
-				memcpy(dst,src,tocopy);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
-		}
-		else
-		{
-			for(int y=0;y<height;y++)
-			{
-				memcpy(dst, src, tocopy);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
-		}
-
+		__m128i p = _mm_loadu_si128((const __m128i*)(src + x));
+		_mm_storeu_si128((__m128i*)(dst + x*2), _mm_unpacklo_epi32(p, p));
+		_mm_storeu_si128((__m128i*)(dst + x*2 + 4), _mm_unpackhi_epi32(p, p));
+	}
+#endif
+	for(;x<width;x++)
+		dst[x*2] = dst[x*2+1] = src[x];
+}
 
-		//fill bottom
-		int remaining_lines = virtual_height - ym - height*ys;
-		memset(dst, 0, remaining_lines*tocopy);
+static void EmitNormalizedFramebuffer(const NormalizedFramebufferInfo& info, uint32* dst)
+{
+	const uint32* src = info.src;
+	int pitch = info.virtual_width;
+	int xm = info.xm;
+	int line = info.width * info.xs;
+	int remaining_pixels = info.virtual_width - xm - line;
 
-		//patch up the metrics
-		height = virtual_height; //we floated the content vertically, so this becomes the new height
-		espec.DisplayRect.x = 0;
-		espec.DisplayRect.y = 0;
-		espec.DisplayRect.h = height;
-		s_FramebufferCurrentWidth = width;
-		VTLineWidths[curr^1][0] = VTLineWidths[curr][0];
-		VTLineWidths[curr^1][kScanlineWidthHeuristicIndex] = VTLineWidths[curr][kScanlineWidthHeuristicIndex];
-
-		curr ^= 1;
-	}
+	//float from top as needed
+	memset(dst, 0, info.ym*pitch*4);
+	dst += info.ym*pitch;
 
-	//2. double the width as needed. but always float it.
-	//note, theres nothing to be done here if the framebuffer is already wide enough
-	if(width != virtual_width)
+	for(int y=0;y<info.height;y++)
 	{
-		uint32* src = VTBuffer[curr]->pixels + (s_ShockConfig.fb_width*espec.DisplayRect.y) + espec.DisplayRect.x;
-		uint32* dst = VTBuffer[curr^1]->pixels;
-
-		for(int y=0;y<height;y++)
-		{
-			//float the content horizontally
-			for(int x=0;x<xm;x++)
-				*dst++ = 0;
+		//float the content horizontally
+		memset(dst, 0, xm*4);
+		if(info.xs==2)
+			DoublePixelsHorizontally(dst+xm, src, info.width);
+		else
+			memcpy(dst+xm, src, info.width*4);
+		memset(dst+xm+line, 0, remaining_pixels*4);
 
-			if(xs==2)
-			{
-				for(int x=0;x<width;x++)
-				{
-					*dst++ = *src;
-					*dst++ = *src++;
-				}
-				src += s_FramebufferCurrentWidth - width;
-			}
-			else
-			{
-				memcpy(dst,src,width*4);
-				dst += width;
-				src += s_FramebufferCurrentWidth;
-			}
+		src += info.pitch;
+		dst += pitch;
 
-			//float the content horizontally
-			int remaining_pixels = virtual_width - xm - width*xs;
-			for(int x=0;x<remaining_pixels;x++)
-				*dst++ = 0;
+		//double the height by repeating the finished line
+		if(info.ys==2)
+		{
+			memcpy(dst, dst-pitch, pitch*4);
+			dst += pitch;
 		}
-
-		//patch up the metrics
-		width = virtual_width; //we floated the content horizontally, so this becomes the new width
-		espec.DisplayRect.x = 0;
-		espec.DisplayRect.y = 0;
-		VTLineWidths[curr^1][0] = width;
-		VTLineWidths[curr ^ 1][kScanlineWidthHeuristicIndex] = width;
-		s_FramebufferCurrentWidth = width;
-
-		curr ^= 1;
 	}
 
-	s_FramebufferCurrent = curr;
+	//fill bottom
+	int remaining_lines = info.virtual_height - info.ym - info.height*info.ys;
+	memset(dst, 0, remaining_lines*pitch*4);
 }
 
 EW_EXPORT s32 shock_GetSamples(void* psx, void* buffer)
@@ -1711,33 +1707,27 @@ EW_EXPORT s32 shock_GetSamples(void* psx, void* buffer)
 
 EW_EXPORT s32 shock_GetFramebuffer(void* psx, ShockFramebufferInfo* fb)
 {
-	//TODO - fastpath for emitting to the final framebuffer, although if we did that, we'd have to regenerate it every time
 	//TODO - let the frontend do this, anyway. need a new filter for it. this was in the plans from the beginning, i just havent done it yet
 
-	//if user requires normalization, do it now
+	//if user requires normalization, emit it straight to the target; nothing is cached, so asking again is just as cheap
 	if(fb->flags & eShockFramebufferFlags_Normalize)
-		if(!s_FramebufferNormalized)
-		{
-			NormalizeFramebuffer();
-			s_FramebufferNormalized = true;
-		}
-
-	int fbIndex = s_FramebufferCurrent;
+	{
+		NormalizedFramebufferInfo info;
+		_shock_AnalyzeNormalizedFramebuffer(&info);
+		fb->width = info.virtual_width;
+		fb->height = info.virtual_height;
+		if(fb->ptr != NULL)
+			EmitNormalizedFramebuffer(info, (u32*)fb->ptr);
+		return SHOCK_OK;
+	}
 
 	//always fetch description
 	FramebufferCropInfo cropInfo;
-	_shock_AnalyzeFramebufferCropInfo(fbIndex, &cropInfo);
+	_shock_AnalyzeFramebufferCropInfo(0, &cropInfo);
 	int width = cropInfo.width;
 	int height = cropInfo.height;
 	int yo = cropInfo.yo;
 
-	//sloppy, but the above AnalyzeFramebufferCropInfo() will give us too short of a buffer
-	if(fb->flags & eShockFramebufferFlags_Normalize)
-	{
-		height = espec.DisplayRect.h;
-		yo = 0;
-	}
-
 	fb->width = width;
 	fb->height = height;
 		
@@ -1749,19 +1739,36 @@ EW_EXPORT s32 shock_GetFramebuffer(void* psx, ShockFramebufferInfo* fb)
 
 	//maybe we need to output the framebuffer
 	//do a raster loop and copy it to the target
-	uint32* src = VTBuffer[fbIndex]->pixels + (s_FramebufferCurrentWidth*yo) + espec.DisplayRect.x;
+	int pitch = VTBuffer[0]->pitch32;
+	uint32* src = VTBuffer[0]->pixels + (pitch*yo) + espec.DisplayRect.x;
 	uint32* dst = (u32*)fb->ptr;
 	int tocopy = width*4;
 	for(int y=0;y<height;y++)
 	{
 		memcpy(dst,src,tocopy);
-		src += s_FramebufferCurrentWidth;
+		src += pitch;
 		dst += width;
 	}
 
 	return SHOCK_OK;
 }
 
+#ifdef PSX_FRAMEBUFFER_TEST
+bool MDFN_IEN_PSX::PSX_TestShiftDisplayRect(int lines)
+{
+	int y = espec.DisplayRect.y + lines;
+	if(y < 0 || y + espec.DisplayRect.h > FB_HEIGHT)
+		return false;
+
+	//only the lines of the frame move; the width comes from fixed line indices, so the line widths stay put
+	int pitch = VTBuffer[0]->pitch32;
+	uint32* pixels = VTBuffer[0]->pixels;
+	memmove(pixels + y*pitch, pixels + espec.DisplayRect.y*pitch, espec.DisplayRect.h*pitch*4);
+	espec.DisplayRect.y = y;
+	return true;
+}
+#endif
+
 static void LoadEXE(const uint8 *data, const uint32 size, bool ignore_pcsp = false)
 {
  uint32 PC;
@@ -2506,14 +2513,10 @@ s32 ShockDiscRef::ReadLBA2048(s32 lba, void* dst2048)
 		u8 buf[2352];
 	};
 
+	//the sector, followed by 96 bytes of subcode
 	static union {
-		struct {
-			union {
-				XASector xasector;
-				Sector sector;
-			};
-			u8 subcode[96];
-		};
+		XASector xasector;
+		Sector sector;
 		u8 buf2448[2448];
 	};
 
@@ -2672,11 +2675,50 @@ EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transacti
 		}
 		return SHOCK_ERROR;
 
+	case eShockStateTransaction_IndexedSize:
+		{
+			EW::NewStateIndexedWriter writer;
+			s_PSX.SyncState<false>(&writer);
+			return writer.GetLength();
+		}
+	case eShockStateTransaction_IndexedLoad:
+		return shock_StateLoadIndexed(psx, transaction->buffer, transaction->bufferLength, NULL, 0);
+	case eShockStateTransaction_IndexedSave:
+		{
+			if(transaction->buffer == NULL) return SHOCK_ERROR;
+			EW::NewStateIndexedWriter writer;
+			s_PSX.SyncState<false>(&writer);
+			if(writer.Write((char*)transaction->buffer, transaction->bufferLength))
+				return SHOCK_OK;
+			else return SHOCK_ERROR;
+		}
+
 	default:
 		return SHOCK_ERROR;
 	}
 }
 
+EW_EXPORT s32 shock_StateLoadIndexed(void *psx, const void *buffer, s32 bufferLength, const char* const* skip, s32 skipCount)
+{
+	if(buffer == NULL) return SHOCK_ERROR;
+	EW::NewStateIndexedReader loader((const char*)buffer, bufferLength);
+	for(s32 i = 0; i < skipCount; i++)
+		loader.Skip(skip[i]);
+	s_PSX.SyncState<true>(&loader);
+	if(loader.Done())
+		return SHOCK_OK;
+	else return SHOCK_ERROR;
+}
+
+EW_EXPORT s32 shock_StateHash(void *psx, EW::NewStateHasher::SectionCallback callback, u64* hash)
+{
+	if(hash == NULL) return SHOCK_ERROR;
+	EW::NewStateHasher hasher(callback);
+	s_PSX.SyncState<false>(&hasher);
+	*hash = hasher.GetHash();
+	return SHOCK_OK;
+}
+
 EW_EXPORT s32 shock_GetRegisters_CPU(void* psx, ShockRegisters_CPU* buffer)
 {
 	memcpy(buffer->GPR,CPU->debug_GetGPRPtr(),32*4);
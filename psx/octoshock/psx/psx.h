@@ -85,6 +85,17 @@ namespace MDFN_IEN_PSX
  };
 
  #define PSX_EVENT_MAXTS       		0x20000000
+
+#ifdef PSX_EVENT_PROFILE
+ // Host time spent in each event handler, in nanoseconds, since the last call (which clears it).
+ // Time outside of the handlers is the CPU, along with whatever it drives directly (GPU commands, MDEC and SPU register writes, etc.)
+ void PSX_GetEventProfile(uint64 (&ns)[PSX_EVENT__COUNT]);
+#endif
+#ifdef PSX_FRAMEBUFFER_TEST
+ // Moves the last frame down by lines rows in its surface, and DisplayRect.y along with it (a negative count moves it back).
+ // Returns false, changing nothing, if the frame doesn't fit. Lets the headless harness check the framebuffer exports with a nonzero DisplayRect.y
+ bool PSX_TestShiftDisplayRect(int lines);
+#endif
  void PSX_SetEventNT(const int type, const pscpu_timestamp_t next_timestamp);
 
  void PSX_SetDMACycleSteal(unsigned stealage);
@@ -132,7 +143,10 @@ enum eShockDeinterlaceMode
 
 enum eShockStep
 {
-	eShockStep_Frame
+	eShockStep_Frame,
+
+	//flag, OR with the step: run without producing audio. The SPU keeps all guest-visible state exact, and shock_GetSamples returns 0 samples.
+	eShockStep_Flag_NoAudio = 0x100
 };
 
 enum eShockFramebufferFlags
@@ -180,7 +194,10 @@ enum eShockStateTransaction : s32
 	eShockStateTransaction_BinaryLoad = 1,
 	eShockStateTransaction_BinarySave = 2,
 	eShockStateTransaction_TextLoad = 3,
-	eShockStateTransaction_TextSave = 4
+	eShockStateTransaction_TextSave = 4,
+	eShockStateTransaction_IndexedSize = 5, //size of an indexed binary state; see EW::IndexedStateHeader
+	eShockStateTransaction_IndexedLoad = 6,
+	eShockStateTransaction_IndexedSave = 7
 };
 
 enum eShockMemcardTransaction
@@ -418,6 +435,14 @@ EW_EXPORT s32 shock_GetMemData(void* psx, void** ptr, s32* size, s32 memType);
 //Savestate work. Returns the size if that's what was requested, otherwise error codes
 EW_EXPORT s32 shock_StateTransaction(void *psx, ShockStateTransaction* transaction);
 
+//Hashes the state without saving it. The hash equals XXH64 of a binary savestate.
+//If a section callback is given, it also receives the hash of every section, for finding where two states diverge
+EW_EXPORT s32 shock_StateHash(void *psx, EW::NewStateHasher::SectionCallback callback, u64* hash);
+
+//Loads an indexed binary state, but leaves the fields named in skip as they are (for instance "MainRAM.data8" or "SPURAM").
+//Only fields of at least EW::IndexedStateFieldMin bytes can be skipped; for anything else, the name is ignored
+EW_EXPORT s32 shock_StateLoadIndexed(void *psx, const void *buffer, s32 bufferLength, const char* const* skip, s32 skipCount);
+
 //Retrieves the CPU registers in a compact struct
 EW_EXPORT s32 shock_GetRegisters_CPU(void* psx, ShockRegisters_CPU* buffer);
 
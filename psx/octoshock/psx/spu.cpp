@@ -86,6 +86,8 @@ PS_SPU::PS_SPU()
 
  IntermediateBufferPos = 0;
  memset(IntermediateBuffer, 0, sizeof(IntermediateBuffer));
+
+ DeferredSampleMask = 0;
 }
 
 PS_SPU::~PS_SPU()
@@ -135,6 +137,8 @@ void PS_SPU::Power(void)
   memset(&Voices[i].ADSR, 0, sizeof(SPU_ADSR));
  }
 
+ DeferredSampleMask = 0;
+
  GlobalSweep[0].Power();
  GlobalSweep[1].Power();
 
@@ -596,6 +600,34 @@ INLINE void PS_SPU::RunNoise(void)
  }
 }
 
+INLINE int32 PS_SPU::Interpolate(const SPU_Voice *voice, uint32 read_pos, uint32 phase)
+{
+ const int si = read_pos;
+ const int pi = ((phase & 0xFFF) >> 4);
+
+ return ((voice->DecodeBuffer[(si + 0) & 0x1F] * FIR_Table[pi][0]) +
+	 (voice->DecodeBuffer[(si + 1) & 0x1F] * FIR_Table[pi][1]) +
+	 (voice->DecodeBuffer[(si + 2) & 0x1F] * FIR_Table[pi][2]) +   
+ 	 (voice->DecodeBuffer[(si + 3) & 0x1F] * FIR_Table[pi][3])) >> 15;
+}
+
+// PreLRSample is savestated, so voices skipped while audio is off get it filled in before a save.
+// The decode buffer can't have changed since, RunDecoder() only runs at the start of the next sample.
+void PS_SPU::ResolveDeferredSamples(void)
+{
+ for(unsigned voice_num = 0; voice_num < 24; voice_num++)
+ {
+  if(DeferredSampleMask & (1U << voice_num))
+  {
+   const DeferredSample &ds = Deferred[voice_num];
+
+   Voices[voice_num].PreLRSample = (Interpolate(&Voices[voice_num], ds.ReadPos, ds.Phase) * (int16)ds.EnvLevel) >> 15;
+  }
+ }
+
+ DeferredSampleMask = 0;
+}
+
 int32 PS_SPU::UpdateFromCDC(int32 clocks)
 //pscpu_timestamp_t PS_SPU::Update(const pscpu_timestamp_t timestamp)
 {
@@ -611,6 +643,11 @@ int32 PS_SPU::UpdateFromCDC(int32 clocks)
   sample_clocks++;
  }
 
+ // EndFrame() throws the samples away at any rate but 44100, and shock_Step() passes 0 for frames without audio.
+ // Without mixing, only what the guest can observe is kept up to date: decoding, envelopes, sweeps, IRQs, the
+ // voice 1/3 and CD capture writes, and the reverb work area, which needs the reverb input mix.
+ const bool mix = (last_rate == 44100);
+
 while(sample_clocks > 0)
  {
   // xxx[0] = left, xxx[1] = right
@@ -628,6 +665,9 @@ while(sample_clocks > 0)
   int32 output[2] = { 0, 0 };
 
   const uint32 PhaseModCache = FM_Mode & ~ 1;
+
+  // Voices whose sample is needed even without mixing: FM modulators, reverb sources, and the voice 1/3 capture.
+  const uint32 NeedSampleMask = mix ? ~0U : ((PhaseModCache >> 1) | Reverb_Mode | 0xA);
 /*
 **
 ** 0x1F801DAE Notes and Conjecture:
@@ -680,18 +720,20 @@ while(sample_clocks > 0)
    //
    int l, r;
 
+   DeferredSampleMask &= ~(1U << voice_num);
+
    if(Noise_Mode & (1 << voice_num))
     voice_pvs = (int16)LFSR;
-   else
+   else if(!(NeedSampleMask & (1U << voice_num)))
    {
-    const int si = voice->DecodeReadPos;
-    const int pi = ((voice->CurPhase & 0xFFF) >> 4);
-
-    voice_pvs = ((voice->DecodeBuffer[(si + 0) & 0x1F] * FIR_Table[pi][0]) +
-	         (voice->DecodeBuffer[(si + 1) & 0x1F] * FIR_Table[pi][1]) +
-	         (voice->DecodeBuffer[(si + 2) & 0x1F] * FIR_Table[pi][2]) +   
- 	         (voice->DecodeBuffer[(si + 3) & 0x1F] * FIR_Table[pi][3])) >> 15;
+    Deferred[voice_num].ReadPos = voice->DecodeReadPos;
+    Deferred[voice_num].Phase = voice->CurPhase;
+    Deferred[voice_num].EnvLevel = voice->ADSR.EnvLevel;
+    DeferredSampleMask |= 1U << voice_num;
+    voice_pvs = 0;
    }
+   else
+    voice_pvs = Interpolate(voice, voice->DecodeReadPos, voice->CurPhase);
 
    voice_pvs = (voice_pvs * (int16)voice->ADSR.EnvLevel) >> 15;
    voice->PreLRSample = voice_pvs;
@@ -704,17 +746,20 @@ while(sample_clocks > 0)
    }
 
 
-   l = (voice_pvs * voice->Sweep[0].ReadVolume()) >> 15;
-   r = (voice_pvs * voice->Sweep[1].ReadVolume()) >> 15;
+   if(mix || (Reverb_Mode & (1 << voice_num)))
+   {
+    l = (voice_pvs * voice->Sweep[0].ReadVolume()) >> 15;
+    r = (voice_pvs * voice->Sweep[1].ReadVolume()) >> 15;
 
-   accum[0] += l;
-   accum[1] += r;
+    accum[0] += l;
+    accum[1] += r;
 
-   if(Reverb_Mode & (1 << voice_num))
-   {
-    accum_fv[0] += l;
-    accum_fv[1] += r;
-	 }
+    if(Reverb_Mode & (1 << voice_num))
+    {
+     accum_fv[0] += l;
+     accum_fv[1] += r;
+    }
+   }
 
    // Run sweep
    for(int lr = 0; lr < 2; lr++)
@@ -839,17 +884,20 @@ while(sample_clocks > 0)
   for(unsigned lr = 0; lr < 2; lr++)
    clamp(&accum_fv[lr], -32768, 32767);
   
-  RunReverb(accum_fv, reverb);
+  RunReverb(accum_fv, mix ? reverb : NULL);
 
-  for(unsigned lr = 0; lr < 2; lr++)
+  if(mix)
   {
-   accum[lr] += ((reverb[lr] * ReverbVol[lr]) >> 15);
-   clamp(&accum[lr], -32768, 32767);
-   output[lr] = (accum[lr] * GlobalSweep[lr].ReadVolume()) >> 15;
-   clamp(&output[lr], -32768, 32767);
+   for(unsigned lr = 0; lr < 2; lr++)
+   {
+    accum[lr] += ((reverb[lr] * ReverbVol[lr]) >> 15);
+    clamp(&accum[lr], -32768, 32767);
+    output[lr] = (accum[lr] * GlobalSweep[lr].ReadVolume()) >> 15;
+    clamp(&output[lr], -32768, 32767);
+   }
   }
 
-  if(IntermediateBufferPos < 4096)	// Overflow might occur in some debugger use cases.
+  if(mix && IntermediateBufferPos < 4096)	// Overflow might occur in some debugger use cases.
   {
    // 75%, for some (resampling) headroom.
    for(unsigned lr = 0; lr < 2; lr++)
@@ -1187,8 +1235,14 @@ int32 PS_SPU::EndFrame(int16 *SoundBuf)
 
 SYNCFUNC(PS_SPU)
 {
+	if(isReader)
+		DeferredSampleMask = 0;
+	else
+		ResolveDeferredSamples();
+
 	NSS(Voices);
 
+	NSS(NoiseDivider);
   NSS(NoiseCounter);
   NSS(LFSR);
 
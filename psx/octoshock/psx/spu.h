@@ -132,10 +132,23 @@ private:
 
 void RunReverb(const int32* in, int32* out);
  void RunNoise(void);
+
+ int32 Interpolate(const SPU_Voice *voice, uint32 read_pos, uint32 phase);
+ void ResolveDeferredSamples(void);
  bool GetCDAudio(int32 &l, int32 &r);
 
  SPU_Voice Voices[24];
 
+ // Interpolation inputs of voices whose PreLRSample was skipped with audio off; not savestated.
+ struct DeferredSample
+ {
+  uint32 ReadPos;
+  uint32 Phase;
+  uint16 EnvLevel;
+ };
+ DeferredSample Deferred[24];
+ uint32 DeferredSampleMask;
+
  uint32 NoiseDivider;
  uint32 NoiseCounter;
  uint16 LFSR;
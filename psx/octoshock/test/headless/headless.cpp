@@ -0,0 +1,699 @@
+// Headless benchmark and regression harness for octoshock.
+//
+// Boots a BIOS with a raw single-track disc image (2352 byte sectors, like miniclient) or a PS-EXE and runs it
+// for a number of frames with scripted pad input, going through the same exports the frontend uses. Reports:
+//   - frames per second, and the time per frame spent fetching video and audio
+//   - host time per subsystem (event handler), when built with PSX_EVENT_PROFILE
+//   - savestate size and save/load throughput
+//   - state hashes every few frames and at the end, with per-section hashes of the final state
+// It also checks that a savestate round trip leaves the state unchanged, that replaying the second half of
+// the run from a savestate taken midway ends in the same state, and that the framebuffer exports give the same
+// image when the last frame is moved down to a nonzero DisplayRect.y.
+//
+// -write stores the results as a baseline; -baseline compares against one, reporting the first frame whose
+// state hash differs, the sections that differ at the end, and the speed change. The exit code is nonzero when
+// anything mismatched.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "octoshock.h"
+#include "psx/psx.h"
+#include "cdrom/CDUtility.h"
+
+using namespace MDFN_IEN_PSX;
+
+static double Now(void)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool ReadFile(const char* path, std::vector<u8>& data)
+{
+	FILE* inf = fopen(path, "rb");
+	if(!inf)
+		return false;
+	fseek(inf, 0, SEEK_END);
+	long size = ftell(inf);
+	fseek(inf, 0, SEEK_SET);
+	data.resize(size);
+	bool ok = size > 0 && fread(&data[0], 1, size, inf) == (size_t)size;
+	fclose(inf);
+	return ok;
+}
+
+// Single data track image with 2352 byte sectors. Subcode Q is synthesized, and handed over deinterleaved.
+class BinDisc
+{
+public:
+	BinDisc() : inf(NULL), disc(NULL), lbaCount(0) {}
+
+	~BinDisc()
+	{
+		if(disc)
+			shock_DestroyDisc(disc);
+		if(inf)
+			fclose(inf);
+	}
+
+	bool Open(const char* path)
+	{
+		inf = fopen(path, "rb");
+		if(!inf)
+			return false;
+		fseek(inf, 0, SEEK_END);
+		lbaCount = (s32)(ftell(inf) / 2352);
+		if(lbaCount == 0)
+			return false;
+		return shock_CreateDisc(&disc, this, lbaCount, s_ReadTOC, s_ReadLBA2448, true) == SHOCK_OK;
+	}
+
+	ShockDiscRef* disc;
+
+private:
+	FILE* inf;
+	s32 lbaCount;
+
+	static s32 s_ReadTOC(void* opaque, ShockTOC* read_target, ShockTOCTrack tracks[100 + 1]) { return ((BinDisc*)opaque)->ReadTOC(read_target, tracks); }
+	static s32 s_ReadLBA2448(void* opaque, s32 lba, void* dst) { return ((BinDisc*)opaque)->ReadLBA2448(lba, (u8*)dst); }
+
+	s32 ReadTOC(ShockTOC* read_target, ShockTOCTrack tracks[100 + 1])
+	{
+		memset(read_target, 0, sizeof(*read_target));
+		read_target->first_track = 1;
+		read_target->last_track = 1;
+		tracks[1].adr = 1;
+		tracks[1].control = 4;
+		tracks[1].lba = 0;
+		tracks[100].adr = 1;
+		tracks[100].control = 0;
+		tracks[100].lba = lbaCount;
+		return SHOCK_OK;
+	}
+
+	s32 ReadLBA2448(s32 lba, u8* dst)
+	{
+		memset(dst, 0, 2448);
+		if(lba >= 0 && lba < lbaCount)
+		{
+			fseek(inf, (long)lba * 2352, SEEK_SET);
+			if(fread(dst, 1, 2352, inf) != 2352)
+				return SHOCK_ERROR;
+		}
+
+		// Q channel, the second 12 bytes of the deinterleaved subcode
+		using namespace CDUtility;
+		u8* q = dst + 2352 + 12;
+		u32 rel = lba < 0 ? -lba : lba;
+		u8 m, s, f;
+		q[0] = 0x41; // data track, position
+		q[1] = U8_to_BCD(1);
+		q[2] = U8_to_BCD(1);
+		q[3] = U8_to_BCD(rel / 75 / 60);
+		q[4] = U8_to_BCD((rel / 75) % 60);
+		q[5] = U8_to_BCD(rel % 75);
+		LBA_to_AMSF(lba, &m, &s, &f);
+		q[7] = U8_to_BCD(m);
+		q[8] = U8_to_BCD(s);
+		q[9] = U8_to_BCD(f);
+		subq_generate_checksum(q);
+		return SHOCK_OK;
+	}
+};
+
+// Pad input script: lines of "<frame> <buttons>", the buttons (in shock_Peripheral_SetPadInput format) holding
+// from that frame until the next line. Blank lines and lines starting with # are skipped.
+struct InputEvent
+{
+	int frame;
+	u32 buttons;
+};
+
+static bool LoadInputScript(const char* path, std::vector<InputEvent>& script)
+{
+	FILE* inf = fopen(path, "r");
+	if(!inf)
+		return false;
+	char line[256];
+	while(fgets(line, sizeof(line), inf))
+	{
+		char* p = line;
+		while(*p == ' ' || *p == '\t') p++;
+		if(*p == '#' || *p == '\n' || *p == '\r' || *p == 0)
+			continue;
+		InputEvent ev;
+		char* end;
+		ev.frame = (int)strtol(p, &end, 0);
+		ev.buttons = (u32)strtoul(end, NULL, 0);
+		script.push_back(ev);
+	}
+	fclose(inf);
+	return true;
+}
+
+static u32 ButtonsAt(const std::vector<InputEvent>& script, int frame)
+{
+	u32 buttons = 0;
+	for(size_t i = 0; i < script.size() && script[i].frame <= frame; i++)
+		buttons = script[i].buttons;
+	return buttons;
+}
+
+struct Section
+{
+	std::string name;
+	u64 hash;
+};
+
+static std::vector<Section> s_Sections;
+
+static void SectionCallback(const char* name, int depth, uint64_t hash)
+{
+	Section section;
+	section.name = std::string(depth * 2, ' ') + name;
+	section.hash = hash;
+	s_Sections.push_back(section);
+}
+
+static u64 StateHash(std::vector<Section>* sections = NULL)
+{
+	u64 hash;
+	s_Sections.clear();
+	shock_StateHash(NULL, sections ? SectionCallback : NULL, &hash);
+	if(sections)
+		*sections = s_Sections;
+	return hash;
+}
+
+static bool SaveState(std::vector<u8>& buf)
+{
+	ShockStateTransaction transaction;
+	memset(&transaction, 0, sizeof(transaction));
+	transaction.transaction = eShockStateTransaction_BinarySize;
+	s32 size = shock_StateTransaction(NULL, &transaction);
+	if(size <= 0)
+		return false;
+	buf.resize(size);
+	transaction.transaction = eShockStateTransaction_BinarySave;
+	transaction.buffer = &buf[0];
+	transaction.bufferLength = size;
+	return shock_StateTransaction(NULL, &transaction) == SHOCK_OK;
+}
+
+static bool LoadState(std::vector<u8>& buf)
+{
+	ShockStateTransaction transaction;
+	memset(&transaction, 0, sizeof(transaction));
+	transaction.transaction = eShockStateTransaction_BinaryLoad;
+	transaction.buffer = &buf[0];
+	transaction.bufferLength = (s32)buf.size();
+	return shock_StateTransaction(NULL, &transaction) == SHOCK_OK;
+}
+
+static bool SaveStateIndexed(std::vector<u8>& buf)
+{
+	ShockStateTransaction transaction;
+	memset(&transaction, 0, sizeof(transaction));
+	transaction.transaction = eShockStateTransaction_IndexedSize;
+	s32 size = shock_StateTransaction(NULL, &transaction);
+	if(size <= 0)
+		return false;
+	buf.resize(size);
+	transaction.transaction = eShockStateTransaction_IndexedSave;
+	transaction.buffer = &buf[0];
+	transaction.bufferLength = size;
+	return shock_StateTransaction(NULL, &transaction) == SHOCK_OK;
+}
+
+// the table of an indexed state must describe the same data a binary state holds
+static bool CheckIndexed(const std::vector<u8>& indexed, const std::vector<u8>& binary)
+{
+	EW::IndexedStateHeader h;
+	if(indexed.size() < sizeof(h))
+		return false;
+	memcpy(&h, &indexed[0], sizeof(h));
+	size_t start = sizeof(h) + h.entrycount * sizeof(EW::IndexedStateEntry);
+	if(h.datasize != binary.size() || start + h.datasize != indexed.size())
+		return false;
+	if(memcmp(&indexed[start], &binary[0], binary.size()))
+		return false;
+	if(h.datahash != EW::NewStateHasher::Hash(&binary[0], binary.size()))
+		return false;
+	bool mainram = false;
+	for(u32 i = 0; i < h.entrycount; i++)
+	{
+		EW::IndexedStateEntry e;
+		memcpy(&e, &indexed[sizeof(h) + i * sizeof(e)], sizeof(e));
+		if(e.offset + e.size > h.datasize || e.hash != EW::NewStateHasher::Hash(&binary[0] + e.offset, e.size))
+			return false;
+		if(!strcmp(e.name, "MainRAM.data8") && e.kind == EW::IndexedStateField && e.size == 2048 * 1024)
+			mainram = true;
+	}
+	return mainram;
+}
+
+struct Options
+{
+	const char* bios;
+	const char* disc;
+	const char* exe;
+	const char* input;
+	const char* write;
+	const char* baseline;
+	s32 region;
+	int frames;
+	int hash_every;
+	int states;
+	bool noaudio;
+	bool normalize;
+};
+
+struct Results
+{
+	double fps;
+	std::vector<std::pair<int, u64> > hashes;
+	u64 final_hash;
+	std::vector<Section> sections;
+};
+
+static const char* const s_EventNames[PSX_EVENT__COUNT] = { NULL, "GPU", "CDC+SPU", "timers", "DMA+MDEC", "FIO", NULL };
+
+static bool RunFrame(const Options& opts, const std::vector<InputEvent>& script, int frame, u32* fb, s16* samples, double* av_time)
+{
+	shock_Peripheral_SetPadInput(NULL, 0x01, ButtonsAt(script, frame), 128, 128, 128, 128);
+	if(shock_Step(NULL, (eShockStep)(opts.noaudio ? eShockStep_Flag_NoAudio : eShockStep_Frame)) != SHOCK_OK)
+		return false;
+
+	// fetch the output the way the frontend does: query the size, then copy
+	double start = Now();
+	ShockFramebufferInfo fbinfo;
+	fbinfo.flags = opts.normalize ? eShockFramebufferFlags_Normalize : eShockFramebufferFlags_None;
+	fbinfo.ptr = NULL;
+	shock_GetFramebuffer(NULL, &fbinfo);
+	fbinfo.ptr = fb;
+	shock_GetFramebuffer(NULL, &fbinfo);
+	if(shock_GetSamples(NULL, NULL) <= 4096)
+		shock_GetSamples(NULL, samples);
+	*av_time += Now() - start;
+	return true;
+}
+
+// Fetches the last frame with the given flags, moves it down in the output surface so DisplayRect.y is nonzero, and
+// checks that the export finds the same image. Returns false on a mismatch; a frame too tall to move passes
+static bool CheckDisplayRectOffset(s32 flags, u32* fb, u32* moved, bool* skipped)
+{
+	const int lines = 16;
+	ShockFramebufferInfo a, b;
+	a.flags = b.flags = flags;
+	a.ptr = b.ptr = NULL;
+	shock_GetFramebuffer(NULL, &a);
+	a.ptr = fb;
+	shock_GetFramebuffer(NULL, &a);
+
+	*skipped = !PSX_TestShiftDisplayRect(lines);
+	if(*skipped)
+		return true;
+	shock_GetFramebuffer(NULL, &b);
+	b.ptr = moved;
+	shock_GetFramebuffer(NULL, &b);
+	PSX_TestShiftDisplayRect(-lines);
+
+	return a.width == b.width && a.height == b.height && !memcmp(fb, moved, (size_t)a.width * a.height * 4);
+}
+
+static int Usage(void)
+{
+	fprintf(stderr,
+		"usage: headless -bios <file> (-disc <image.bin> | -exe <file>) [options]\n"
+		"  -region jp|na|eu   console region (default na)\n"
+		"  -frames <n>        frames to run (default 3600)\n"
+		"  -input <file>      pad script, lines of \"<frame> <buttons>\"\n"
+		"  -hash-every <n>    record the state hash every n frames (default 60, 0 for none)\n"
+		"  -states <n>        savestate round trips to time (default 100)\n"
+		"  -noaudio           step with eShockStep_Flag_NoAudio\n"
+		"  -normalize         fetch the normalized framebuffer\n"
+		"  -write <file>      write the results as a baseline\n"
+		"  -baseline <file>   compare the results against a baseline\n");
+	return 2;
+}
+
+static bool ParseOptions(int argc, char** argv, Options& opts)
+{
+	memset(&opts, 0, sizeof(opts));
+	opts.region = REGION_NA;
+	opts.frames = 3600;
+	opts.hash_every = 60;
+	opts.states = 100;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+		if(!strcmp(arg, "-noaudio")) { opts.noaudio = true; continue; }
+		if(!strcmp(arg, "-normalize")) { opts.normalize = true; continue; }
+		if(!value)
+			return false;
+		i++;
+		if(!strcmp(arg, "-bios")) opts.bios = value;
+		else if(!strcmp(arg, "-disc")) opts.disc = value;
+		else if(!strcmp(arg, "-exe")) opts.exe = value;
+		else if(!strcmp(arg, "-input")) opts.input = value;
+		else if(!strcmp(arg, "-write")) opts.write = value;
+		else if(!strcmp(arg, "-baseline")) opts.baseline = value;
+		else if(!strcmp(arg, "-frames")) opts.frames = atoi(value);
+		else if(!strcmp(arg, "-hash-every")) opts.hash_every = atoi(value);
+		else if(!strcmp(arg, "-states")) opts.states = atoi(value);
+		else if(!strcmp(arg, "-region"))
+		{
+			if(!strcmp(value, "jp")) opts.region = REGION_JP;
+			else if(!strcmp(value, "na")) opts.region = REGION_NA;
+			else if(!strcmp(value, "eu")) opts.region = REGION_EU;
+			else return false;
+		}
+		else return false;
+	}
+
+	return opts.bios && (opts.disc || opts.exe) && opts.frames > 0;
+}
+
+static bool WriteBaseline(const char* path, const Options& opts, const Results& res)
+{
+	FILE* outf = fopen(path, "w");
+	if(!outf)
+		return false;
+	fprintf(outf, "# octoshock headless baseline\n");
+	fprintf(outf, "frames %d\n", opts.frames);
+	fprintf(outf, "fps %.3f\n", res.fps);
+	for(size_t i = 0; i < res.hashes.size(); i++)
+		fprintf(outf, "hash %d %016llx\n", res.hashes[i].first, (unsigned long long)res.hashes[i].second);
+	fprintf(outf, "final %016llx\n", (unsigned long long)res.final_hash);
+	for(size_t i = 0; i < res.sections.size(); i++)
+		fprintf(outf, "section %016llx %s\n", (unsigned long long)res.sections[i].hash, res.sections[i].name.c_str());
+	fclose(outf);
+	return true;
+}
+
+static void PrintSectionDiffs(const char* what, const std::vector<Section>& a, const std::vector<Section>& b)
+{
+	for(size_t i = 0; i < a.size(); i++)
+	{
+		for(size_t j = 0; j < b.size(); j++)
+		{
+			if(b[j].name == a[i].name)
+			{
+				if(b[j].hash != a[i].hash)
+					printf("%s:   section %s\n", what, a[i].name.c_str());
+				break;
+			}
+		}
+	}
+}
+
+// Returns the number of mismatches, or -1 if the baseline could not be read
+static int CompareBaseline(const char* path, const Options& opts, const Results& res)
+{
+	FILE* inf = fopen(path, "r");
+	if(!inf)
+		return -1;
+
+	Results base;
+	base.fps = 0;
+	base.final_hash = 0;
+	int base_frames = 0;
+	char line[1024];
+	while(fgets(line, sizeof(line), inf))
+	{
+		line[strcspn(line, "\r\n")] = 0;
+		unsigned long long hash;
+		int frame, pos;
+		if(sscanf(line, "frames %d", &base_frames) == 1) {}
+		else if(sscanf(line, "fps %lf", &base.fps) == 1) {}
+		else if(sscanf(line, "hash %d %llx", &frame, &hash) == 2) base.hashes.push_back(std::make_pair(frame, (u64)hash));
+		else if(sscanf(line, "final %llx", &hash) == 1) base.final_hash = hash;
+		else if(sscanf(line, "section %llx%n", &hash, &pos) == 1 && line[pos] == ' ')
+		{
+			// the name keeps its indentation, after the one separating space
+			Section section;
+			section.hash = hash;
+			section.name = line + pos + 1;
+			base.sections.push_back(section);
+		}
+	}
+	fclose(inf);
+
+	int mismatches = 0;
+	if(base_frames != opts.frames)
+		printf("baseline: ran %d frames, baseline has %d; comparing the frames in common\n", opts.frames, base_frames);
+
+	for(size_t i = 0; i < base.hashes.size(); i++)
+	{
+		for(size_t j = 0; j < res.hashes.size(); j++)
+		{
+			if(res.hashes[j].first != base.hashes[i].first)
+				continue;
+			if(res.hashes[j].second != base.hashes[i].second)
+			{
+				printf("baseline: state first differs at frame %d\n", base.hashes[i].first);
+				mismatches++;
+			}
+			break;
+		}
+		if(mismatches)
+			break;
+	}
+
+	if(base_frames == opts.frames)
+	{
+		if(base.final_hash != res.final_hash)
+		{
+			printf("baseline: final state differs\n");
+			mismatches++;
+			PrintSectionDiffs("baseline", base.sections, res.sections);
+		}
+		else
+			printf("baseline: final state matches\n");
+	}
+
+	if(base.fps > 0)
+		printf("baseline: %.1f fps, now %.1f fps (%+.1f%%)\n", base.fps, res.fps, (res.fps / base.fps - 1) * 100);
+
+	return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+	Options opts;
+	if(!ParseOptions(argc, argv, opts))
+		return Usage();
+
+	std::vector<u8> firmware, exe;
+	if(!ReadFile(opts.bios, firmware) || firmware.size() != 512 * 1024)
+	{
+		fprintf(stderr, "couldn't read a 512KB BIOS from %s\n", opts.bios);
+		return 2;
+	}
+	if(opts.exe && !ReadFile(opts.exe, exe))
+	{
+		fprintf(stderr, "couldn't read %s\n", opts.exe);
+		return 2;
+	}
+
+	std::vector<InputEvent> script;
+	if(opts.input && !LoadInputScript(opts.input, script))
+	{
+		fprintf(stderr, "couldn't read %s\n", opts.input);
+		return 2;
+	}
+
+	BinDisc bin;
+	if(opts.disc && !bin.Open(opts.disc))
+	{
+		fprintf(stderr, "couldn't open %s\n", opts.disc);
+		return 2;
+	}
+
+	void* psx = NULL;
+	shock_Create(&psx, opts.region, &firmware[0]);
+	if(opts.disc)
+	{
+		ShockDiscInfo info;
+		if(shock_AnalyzeDisc(bin.disc, &info) == SHOCK_OK)
+			printf("disc id: %s\n", info.id);
+		shock_OpenTray(NULL);
+		shock_SetDisc(NULL, bin.disc);
+	}
+	else
+		shock_MountEXE(NULL, &exe[0], (s32)exe.size(), false);
+	shock_CloseTray(NULL);
+	shock_Peripheral_Connect(NULL, 0x01, ePeripheralType_DualShock);
+	shock_PowerOn(NULL);
+
+	static u32 fb[1024 * 1024];
+	static s16 samples[4096 * 2];
+
+	Results res;
+	std::vector<u8> midstate;
+	int mid = opts.frames / 2;
+	double av_time = 0, run_time = 0;
+	u64 events[PSX_EVENT__COUNT] = {};
+#ifdef PSX_EVENT_PROFILE
+	PSX_GetEventProfile(events);
+#endif
+
+	for(int frame = 0; frame < opts.frames; frame++)
+	{
+		if(frame == mid)
+			SaveState(midstate);
+
+		double start = Now();
+		if(!RunFrame(opts, script, frame, fb, samples, &av_time))
+		{
+			fprintf(stderr, "shock_Step failed at frame %d\n", frame);
+			return 2;
+		}
+		run_time += Now() - start;
+
+		if(opts.hash_every > 0 && (frame + 1) % opts.hash_every == 0)
+			res.hashes.push_back(std::make_pair(frame + 1, StateHash()));
+	}
+
+#ifdef PSX_EVENT_PROFILE
+	PSX_GetEventProfile(events);
+#endif
+
+	res.fps = opts.frames / run_time;
+	res.final_hash = StateHash(&res.sections);
+
+	printf("frames: %d in %.3f s, %.1f fps (%.3f ms/frame)\n", opts.frames, run_time, res.fps, run_time * 1000 / opts.frames);
+	printf("  video/audio fetch: %.3f ms/frame\n", av_time * 1000 / opts.frames);
+#ifdef PSX_EVENT_PROFILE
+	double emu_time = run_time - av_time;
+	for(int i = 0; i < PSX_EVENT__COUNT; i++)
+	{
+		if(!s_EventNames[i])
+			continue;
+		printf("  %-17s  %.3f ms/frame (%.1f%%)\n", s_EventNames[i], events[i] / 1e6 / opts.frames, events[i] / 1e9 / emu_time * 100);
+	}
+	double cpu_time = emu_time;
+	for(int i = 0; i < PSX_EVENT__COUNT; i++)
+		cpu_time -= events[i] / 1e9;
+	printf("  %-17s  %.3f ms/frame (%.1f%%)\n", "CPU and the rest", cpu_time * 1000 / opts.frames, cpu_time / emu_time * 100);
+#endif
+
+	int mismatches = 0;
+
+	// framebuffer: the exports must honor a nonzero DisplayRect.y, which the GPU itself never sets
+	static u32 moved[1024 * 1024];
+	const s32 fbflags[] = { eShockFramebufferFlags_None, eShockFramebufferFlags_Normalize };
+	for(int i = 0; i < 2; i++)
+	{
+		bool skipped;
+		bool ok = CheckDisplayRectOffset(fbflags[i], fb, moved, &skipped);
+		const char* what = fbflags[i] == eShockFramebufferFlags_Normalize ? "normalized" : "raw";
+		printf("framebuffer: %s output with DisplayRect.y offset %s\n", what, skipped ? "skipped, no room" : ok ? "ok" : "DIFFERS");
+		if(!ok)
+			mismatches++;
+	}
+
+	// savestates: throughput, then a round trip must not change the state
+	std::vector<u8> state;
+	u64 before = StateHash();
+	double start = Now();
+	for(int i = 0; i < opts.states; i++)
+		SaveState(state);
+	double save_time = Now() - start;
+	start = Now();
+	for(int i = 0; i < opts.states; i++)
+		LoadState(state);
+	double load_time = Now() - start;
+	if(!LoadState(state) || StateHash() != before)
+	{
+		printf("savestate: round trip changed the state\n");
+		mismatches++;
+	}
+	// the same through an indexed state, and a partial load must leave what it skips alone
+	std::vector<u8> indexed;
+	if(!SaveStateIndexed(indexed) || !CheckIndexed(indexed, state))
+	{
+		printf("savestate: indexed state doesn't match the binary one\n");
+		mismatches++;
+	}
+	else
+	{
+		void* mainram;
+		s32 size;
+		shock_GetMemData(NULL, &mainram, &size, eMemType_MainRAM);
+		u8* poked = (u8*)mainram + 0x1000;
+		*poked ^= 0xFF;
+		const char* const skip[] = { "MainRAM.data8", "SPURAM", "GPURAM" };
+		bool partial = shock_StateLoadIndexed(NULL, &indexed[0], (s32)indexed.size(), skip, 3) == SHOCK_OK;
+		partial = partial && StateHash() != before;
+		*poked ^= 0xFF;
+		partial = partial && StateHash() == before;
+		if(!partial || shock_StateLoadIndexed(NULL, &indexed[0], (s32)indexed.size(), NULL, 0) != SHOCK_OK || StateHash() != before)
+		{
+			printf("savestate: indexed round trip changed the state\n");
+			mismatches++;
+		}
+		else
+			printf("savestate: indexed %u bytes, round trip and partial load ok\n", (unsigned)indexed.size());
+	}
+	if(opts.states > 0)
+	{
+		double mb = (double)state.size() * opts.states / (1024 * 1024);
+		printf("savestate: %u bytes, save %.1f MB/s (%.3f ms), load %.1f MB/s (%.3f ms)\n", (unsigned)state.size(),
+			mb / save_time, save_time * 1000 / opts.states, mb / load_time, load_time * 1000 / opts.states);
+	}
+
+	// replay the second half from the midway state, with the same input
+	if(!LoadState(midstate))
+	{
+		printf("replay: couldn't load the midway savestate\n");
+		mismatches++;
+	}
+	else
+	{
+		double unused = 0;
+		for(int frame = mid; frame < opts.frames; frame++)
+			RunFrame(opts, script, frame, fb, samples, &unused);
+		std::vector<Section> sections;
+		u64 replay = StateHash(&sections);
+		printf("replay: from frame %d %s\n", mid, replay == res.final_hash ? "matches" : "DIFFERS");
+		if(replay != res.final_hash)
+		{
+			PrintSectionDiffs("replay", res.sections, sections);
+			mismatches++;
+		}
+	}
+
+	printf("final state hash: %016llx\n", (unsigned long long)res.final_hash);
+
+	if(opts.write)
+	{
+		if(!WriteBaseline(opts.write, opts, res))
+		{
+			fprintf(stderr, "couldn't write %s\n", opts.write);
+			return 2;
+		}
+		printf("baseline written to %s\n", opts.write);
+	}
+
+	if(opts.baseline)
+	{
+		int n = CompareBaseline(opts.baseline, opts, res);
+		if(n < 0)
+		{
+			fprintf(stderr, "couldn't read %s\n", opts.baseline);
+			return 2;
+		}
+		mismatches += n;
+	}
+
+	shock_Destroy(NULL);
+
+	return mismatches ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+// Determinism test for eShockStep_Flag_NoAudio.
+//
+// Runs the SPU over random register writes, key-ons, FM, noise, reverb, IRQs and CD audio input twice from
+// the same seed: once mixing at 44100Hz, once with audio off (rate 0). After every frame the savestate hashes
+// and the IRQ line history have to match, so skipping the mix changes nothing the guest can observe.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "octoshock.h"
+#include "psx/psx.h"
+#include "psx/cdc.h"
+#include "psx/spu.h"
+
+namespace MDFN_IEN_PSX
+{
+ PS_CDC *CDC;
+
+ static uint32 cd_phase;
+ static std::vector<uint8> irq_log;
+
+ void IRQ_Assert(int which, bool asserted)
+ {
+  irq_log.push_back(asserted);
+ }
+
+ // Stand-in CD-DA input, a pair of square waves
+ void PS_CDC::GetCDAudio(int32 samples[2])
+ {
+  cd_phase++;
+  samples[0] = (cd_phase & 0x40) ? 12000 : -12000;
+  samples[1] = (cd_phase & 0x100) ? -9000 : 9000;
+ }
+}
+
+using namespace MDFN_IEN_PSX;
+
+enum { Seeds = 8, Frames = 120, SampleClocks = 768, SamplesPerFrame = 735 };
+
+static uint32 rng;
+
+static uint32 rand32(void)
+{
+ rng ^= rng << 13;
+ rng ^= rng >> 17;
+ rng ^= rng << 5;
+ return rng;
+}
+
+static void SpuWrite(PS_SPU *spu, uint32 reg, uint16 value)
+{
+ spu->Write(0, 0x1F801C00 + reg, value);
+}
+
+// Random but mostly sane programming: voices with random pitch/ADSR/volume keyed on and off, and the FM,
+// noise, reverb and IRQ features toggled now and then.
+static void Program(PS_SPU *spu, int frame)
+{
+ if(frame == 0)
+ {
+  // ADPCM blocks with random shift/filter and occasional loop/end flags
+  spu->Write(0, 0x1F801DA6, 0x0200);
+  for(uint32 addr = 0x1000; addr < 0x80000; addr += 2)
+  {
+   uint16 v = rand32();
+   if((addr & 0xF) == 0)
+   {
+    v &= 0x07FF;
+    if(!(rand32() & 0x1F))
+     v |= 0x0300;
+   }
+   spu->PokeSPURAM(addr >> 1, v);
+  }
+  SpuWrite(spu, 0x180, 0x3FFF);	// main volume
+  SpuWrite(spu, 0x182, 0x3FFF);
+  SpuWrite(spu, 0x1A2, 0x4000 + (rand32() & 0x3FFF));	// reverb work area
+  for(uint32 reg = 0x1C0; reg < 0x200; reg += 2)
+   SpuWrite(spu, reg, rand32() & 0x3FFF);
+ }
+
+ for(int i = rand32() % 8; i > 0; i--)
+ {
+  const uint32 voice = rand32() % 24;
+  const uint32 base = voice << 4;
+
+  SpuWrite(spu, base + 0x0, rand32() & 0x7FFF);
+  SpuWrite(spu, base + 0x2, (rand32() & 7) ? (rand32() & 0x7FFF) : (0x8000 | (rand32() & 0x7F7F)));
+  SpuWrite(spu, base + 0x4, rand32() & 0x3FFF);
+  SpuWrite(spu, base + 0x6, 0x200 + (rand32() & 0x7FFF) / 2);
+  SpuWrite(spu, base + 0x8, rand32());
+  SpuWrite(spu, base + 0xA, rand32());
+ }
+
+ SpuWrite(spu, 0x188, rand32() & 0xFFFF);
+ SpuWrite(spu, 0x18A, rand32() & 0xFF);
+ SpuWrite(spu, 0x18C, rand32() & rand32() & 0xFFFF);
+ SpuWrite(spu, 0x18E, rand32() & 0xFF);
+
+ if(!(frame & 7))
+ {
+  SpuWrite(spu, 0x190, rand32() & 0xFFFE);	// FM
+  SpuWrite(spu, 0x192, rand32() & 0xFF);
+  SpuWrite(spu, 0x194, rand32() & rand32() & 0xFFFF);	// noise
+  SpuWrite(spu, 0x196, 0);
+  SpuWrite(spu, 0x198, rand32() & 0xFFFF);	// reverb
+  SpuWrite(spu, 0x19A, rand32() & 0xFF);
+  SpuWrite(spu, 0x184, rand32() & 0x7FFF);	// reverb volume
+  SpuWrite(spu, 0x186, rand32() & 0x7FFF);
+  SpuWrite(spu, 0x1B0, rand32() & 0x7FFF);	// CD volume
+  SpuWrite(spu, 0x1B2, rand32() & 0x7FFF);
+  SpuWrite(spu, 0x1A4, rand32() & 0xFFFF);	// IRQ address
+ }
+
+ // Keep the SPU and reverb on, the rest random; toggle the IRQ enable to rearm it
+ SpuWrite(spu, 0x1AA, 0x8080 | (rand32() & 0x4045));
+ SpuWrite(spu, 0x1AA, 0x80C0 | (rand32() & 0x4005));
+}
+
+static void Run(uint32 seed, bool audio, std::vector<uint64> &hashes, std::vector<uint8> &irqs, uint64 &sound)
+{
+ static int16 soundbuf[4096 * 2];
+ PS_SPU *spu = new PS_SPU();
+
+ rng = seed * 2654435761u + 1;
+ cd_phase = 0;
+ irq_log.clear();
+ hashes.clear();
+ sound = 0;
+
+ spu->Power();
+
+ for(int frame = 0; frame < Frames; frame++)
+ {
+  spu->StartFrame(audio ? 44100 : 0, 5);
+  Program(spu, frame);
+
+  for(int i = 0; i < SamplesPerFrame; i++)
+   spu->UpdateFromCDC(SampleClocks);
+
+  const int32 count = spu->EndFrame(soundbuf);
+  for(int32 i = 0; i < count * 2; i++)
+   sound = (sound ^ (uint16)soundbuf[i]) * 0x100000001B3ULL;
+
+  EW::NewStateHasher hasher(NULL);
+  spu->SyncState<false>(&hasher);
+  hashes.push_back(hasher.GetHash());
+ }
+
+ irqs = irq_log;
+ delete spu;
+}
+
+int main(int argc, char **argv)
+{
+ static char cdc_storage[sizeof(PS_CDC)];
+ int failures = 0;
+
+ CDC = (PS_CDC *)cdc_storage;	// only GetCDAudio() is called, which is stubbed above
+
+ for(uint32 seed = 0; seed < Seeds; seed++)
+ {
+  std::vector<uint64> hashes[2];
+  std::vector<uint8> irqs[2];
+  uint64 sound[2];
+
+  Run(seed, true, hashes[0], irqs[0], sound[0]);
+  Run(seed, false, hashes[1], irqs[1], sound[1]);
+
+  int bad_frame = -1;
+  for(int frame = 0; frame < Frames && bad_frame < 0; frame++)
+   if(hashes[0][frame] != hashes[1][frame])
+    bad_frame = frame;
+
+  printf("seed %u: state %016llx, %u IRQ changes, audio %016llx", seed, (unsigned long long)hashes[0][Frames - 1], (unsigned)irqs[0].size(), (unsigned long long)sound[0]);
+
+  if(bad_frame >= 0)
+  {
+   printf(" -- FAIL: savestate differs at frame %d\n", bad_frame);
+   failures++;
+  }
+  else if(irqs[0] != irqs[1])
+  {
+   printf(" -- FAIL: IRQ history differs\n");
+   failures++;
+  }
+  else if(sound[1] != 0)
+  {
+   printf(" -- FAIL: audio-off run produced samples\n");
+   failures++;
+  }
+  else
+   printf(" -- ok\n");
+ }
+
+ return failures ? 1 : 0;
+}
@@ -1,6 +1,12 @@
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <stdint.h>
 #include "nes_emu/Nes_Emu.h"
+#include "nes_emu/Nes_State.h"
+#include "romimage.h"
+#include "xxhash.h"
+#include "framebatch.h"
 
 // simulate the write so we'll know how long the buffer needs to be
 class Sim_Writer : public Data_Writer
@@ -16,6 +22,20 @@ public:
 	long size() const { return size_; }
 };
 
+// XXH64 (seed 0) of everything written, without keeping any of it
+class Hash_Writer : public Data_Writer
+{
+	xxh64_state state;
+public:
+	Hash_Writer() { xxh64_reset(&state); }
+	error_t write(const void *data, long size)
+	{
+		xxh64_update(&state, data, size);
+		return 0;
+	}
+	uint64_t hash() const { return xxh64_digest(&state); }
+};
+
 // 0 filled new just for kicks
 void *operator new(std::size_t n)
 {
@@ -42,9 +62,24 @@ EXPORT void qn_setup_mappers()
 	register_optional_mappers();
 }
 
+// the cart is held by reference count, so that clones can share it
+class Biz_Emu : public Nes_Emu
+{
+public:
+	std::shared_ptr<Nes_Cart> shared_cart;
+	long sample_rate;
+	Nes_State *copy_state; // reused by qn_copy_into()
+
+	~Biz_Emu()
+	{
+		close();
+		delete copy_state;
+	}
+};
+
 EXPORT Nes_Emu *qn_new()
 {
-	return new Nes_Emu();
+	return new Biz_Emu();
 }
 
 EXPORT void qn_delete(Nes_Emu *e)
@@ -52,21 +87,90 @@ EXPORT void qn_delete(Nes_Emu *e)
 	delete e;
 }
 
+// the cart is loaded once and then shared with every other instance that loads the same file
 EXPORT const char *qn_loadines(Nes_Emu *e, const void *data, int length)
 {
-	Mem_File_Reader r(data, length);
-	Auto_File_Reader a(r);
-	return e->load_ines(a);
+	const char *ret = 0;
+	std::shared_ptr<Nes_Cart> cart = romimage::Registry::share<Nes_Cart>(data, length, 0, [&]()
+	{
+		Mem_File_Reader r(data, length);
+		Auto_File_Reader a(r);
+		std::shared_ptr<Nes_Cart> made(new Nes_Cart());
+		ret = made->load_ines(a);
+		if (ret)
+			made.reset();
+		return made;
+	});
+	if (!ret)
+		ret = e->set_cart(cart.get());
+	if (!ret)
+		static_cast<Biz_Emu *>(e)->shared_cart = cart;
+	return ret;
 }
 
 EXPORT const char *qn_set_sample_rate(Nes_Emu *e, int rate)
 {
 	const char *ret = e->set_sample_rate(rate);
 	if (!ret)
+	{
 		e->set_equalizer(Nes_Emu::nes_eq);
+		static_cast<Biz_Emu *>(e)->sample_rate = rate;
+	}
 	return ret;
 }
 
+// copy the complete emulation state of src into dst, which must have the same game loaded.
+// this goes through an in-memory Nes_State, never through the savestate file format
+EXPORT const char *qn_copy_into(Nes_Emu *dst, Nes_Emu *src)
+{
+	const Nes_Cart *dc = dst->cart();
+	const Nes_Cart *sc = src->cart();
+	if (!dc || !sc)
+		return "No cart loaded!";
+	if (dc != sc && (dc->prg_size() != sc->prg_size() || dc->chr_size() != sc->chr_size() || dc->mapper_code() != sc->mapper_code()))
+		return "Carts don't match!";
+
+	Biz_Emu *d = static_cast<Biz_Emu *>(dst);
+	if (!d->copy_state)
+	{
+		d->copy_state = new Nes_State();
+		if (!d->copy_state)
+			return "Out of Memory!";
+	}
+	src->save_state(d->copy_state);
+	dst->load_state(*d->copy_state);
+	return 0;
+}
+
+// a new emulator sharing src's cart, with its sound and sprite settings and current state.
+// the trace callback and the last frame's image are not carried over
+EXPORT Nes_Emu *qn_clone(Nes_Emu *e)
+{
+	Biz_Emu *src = static_cast<Biz_Emu *>(e);
+	Biz_Emu *dst = new Biz_Emu();
+	const char *ret = 0;
+	if (src->sample_rate)
+	{
+		ret = dst->set_sample_rate(src->sample_rate);
+		dst->set_equalizer(src->equalizer());
+		dst->sample_rate = src->sample_rate;
+	}
+	dst->set_sprite_mode(src->sprite_mode());
+	if (!ret && src->shared_cart)
+	{
+		ret = dst->set_cart(src->shared_cart.get());
+		dst->shared_cart = src->shared_cart;
+		if (!ret)
+			ret = qn_copy_into(dst, src);
+	}
+	if (ret)
+	{
+		delete dst;
+		return 0;
+	}
+	return dst;
+}
+
 EXPORT const char *qn_emulate_frame(Nes_Emu *e, int pad1, int pad2)
 {
 	return e->emulate_frame(pad1, pad2);
@@ -145,6 +249,17 @@ EXPORT const char *qn_state_save(Nes_Emu *e, void *dest, int size)
 	return ret;
 }
 
+// hash of the complete state, equal to XXH64 of what qn_state_save writes
+EXPORT const char *qn_state_hash(Nes_Emu *e, uint64_t *hash)
+{
+	Hash_Writer w;
+	Auto_File_Writer a(w);
+	const char *ret = e->save_state(a);
+	if (hash)
+		*hash = w.hash();
+	return ret;
+}
+
 EXPORT const char *qn_state_load(Nes_Emu *e, const void *src, int size)
 {
 	Mem_File_Reader r(src, size);
@@ -184,6 +299,15 @@ EXPORT const char *qn_battery_ram_load(Nes_Emu *e, const void *src, int size)
 	return e->load_battery_ram(a);
 }
 
+EXPORT const void *qn_battery_ram_direct(Nes_Emu *e, int *size, unsigned *generation)
+{
+	if (size)
+		*size = e->high_mem_size;
+	if (generation)
+		*generation = e->battery_ram_generation();
+	return e->high_mem();
+}
+
 EXPORT const char *qn_battery_ram_clear(Nes_Emu *e)
 {
 	int size = 0;
@@ -337,3 +461,71 @@ EXPORT void qn_set_tracecb(Nes_Emu *e, void (*cb)(unsigned int *dest))
 {
 	e->set_tracecb(cb);
 }
+
+// batch frame advance
+
+typedef framebatch::Range qn_ram_spec; // area as in qn_get_memory_area()
+
+enum
+{
+	QN_BATCH_NOVIDEO = 1, // don't render the last frame either; frame() keeps the previous image
+	QN_BATCH_NOAUDIO = 2, // don't collect sound
+	QN_BATCH_NOHASH = 4 // leave every frame hash 0
+};
+
+// run nframes frames, taking pad1 and pad2 for each from pads[2 * n], pads[2 * n + 1]
+// dest receives one record per frame: an int of flags (1 = lagged, 2 = sound didn't fit in audio),
+// an int hash of RAM and WRAM, then the bytes of each spec entry in order, padded to a multiple of 4
+// audio (optional) collects the sound of every frame; *audio_size is its capacity in, samples written out
+EXPORT const char *qn_emulate_frames(Nes_Emu *e, const int *pads, int nframes, int flags,
+	const qn_ram_spec *spec, int nspec, void *dest, int size, short *audio, int *audio_size)
+{
+	auto records = framebatch::writer(spec, nspec, [e](int area, const uint8_t *&data, int &areasize)
+	{
+		const void *p = 0;
+		int writable;
+		const char *name;
+		int ret = qn_get_memory_area(e, area, &p, &areasize, &writable, &name);
+		data = (const uint8_t *)p;
+		return ret != 0;
+	});
+	if (records.stride() < 0)
+		return "Bad memory range";
+	if (!records.fits(nframes, size))
+		return "Buffer Underrun!";
+
+	const bool collect_audio = audio && audio_size && !(flags & QN_BATCH_NOAUDIO);
+	int audio_pos = 0;
+	uint8_t *rec = (uint8_t *)dest;
+	for (int n = 0; n < nframes; n++)
+	{
+		// only the last frame's image can be seen, so only that one is rendered
+		const char *ret = flags & QN_BATCH_NOVIDEO || n < nframes - 1
+			? e->emulate_skipped_frame(pads[n * 2], pads[n * 2 + 1])
+			: e->emulate_frame(pads[n * 2], pads[n * 2 + 1]);
+		if (ret)
+		{
+			if (audio_size)
+				*audio_size = audio_pos;
+			return ret;
+		}
+
+		unsigned frameflags = e->frame().joypad_read_count ? 0 : framebatch::lagged;
+		if (collect_audio)
+		{
+			int count = e->frame().sample_count;
+			if (count <= *audio_size - audio_pos)
+				audio_pos += e->read_samples(audio + audio_pos, count);
+			else
+				frameflags |= framebatch::audio_overflow;
+		}
+
+		unsigned hash = 0;
+		if (!(flags & QN_BATCH_NOHASH))
+			hash = framebatch::hash(e->high_mem(), e->high_mem_size, framebatch::hash(e->low_mem(), e->low_mem_size));
+		rec = records.write(rec, frameflags, hash);
+	}
+	if (audio_size)
+		*audio_size = audio_pos;
+	return 0;
+}
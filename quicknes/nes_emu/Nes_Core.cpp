@@ -36,6 +36,7 @@ Nes_Core::Nes_Core() : ppu( this )
 	cart = NULL;
 	impl = NULL;
 	mapper = NULL;
+	sram_generation = 0;
 	memset( &nes, 0, sizeof nes );
 	memset( &joypad, 0, sizeof joypad );
 }
@@ -174,6 +175,7 @@ void Nes_Core::load_state( Nes_State_ const& in )
 	{
 		sram_present = true;
 		memcpy( impl->sram, in.sram, min( (int) in.sram_size, (int) sizeof impl->sram ) );
+		sram_generation++;
 		enable_sram( true ); // mapper can override (read-only, unmapped, etc.)
 	}
 	
@@ -197,6 +199,7 @@ void Nes_Core::enable_sram( bool b, bool read_only )
 		{
 			sram_present = true;
 			memset( impl->sram, 0xFF, impl->sram_size );
+			sram_generation++;
 		}
 		sram_readable = sram_end;
 		if ( !read_only )
@@ -353,7 +356,10 @@ void Nes_Core::reset( bool full_reset, bool erase_battery_ram )
 		sram_present = true;
 		enable_sram( false );
 		if ( !cart->has_battery_ram() || erase_battery_ram )
+		{
 			memset( impl->sram, 0xFF, impl->sram_size );
+			sram_generation++;
+		}
 		
 		joypad.joypad_latches [0] = 0;
 		joypad.joypad_latches [1] = 0;
@@ -48,6 +48,7 @@ public: private: friend class Nes_Emu;
 	impl_t* impl; // keep large arrays separate
 	unsigned long error_count;
 	bool sram_present;
+	unsigned long sram_generation; // changed on every write to sram
 
 public:
 	uint32_t current_joypad [2];
@@ -179,6 +179,33 @@ blargg_err_t Nes_Emu::emulate_frame( const uint32_t joypad1, const uint32_t joyp
 	return 0;
 }
 
+blargg_err_t Nes_Emu::emulate_skipped_frame( const uint32_t joypad1, const uint32_t joypad2 )
+{
+	// the ppu keeps sprite hit and palette capture working without host pixels;
+	// restore the previous image afterwards so frame() still describes it
+	frame_t* f = frame_;
+	frame_t image;
+	if ( f )
+		image = *f;
+	
+	char* saved_pixels = host_pixels;
+	host_pixels = NULL;
+	blargg_err_t err = emulate_frame( joypad1, joypad2 );
+	host_pixels = saved_pixels;
+	
+	if ( f )
+	{
+		if ( !image.pixels )
+			image.pixels = (unsigned char*) host_pixels + emu.ppu.host_row_bytes * f->top + f->left;
+		f->pixels        = image.pixels;
+		f->pitch         = image.pitch ? image.pitch : emu.ppu.host_row_bytes;
+		f->palette_begin = image.palette_begin;
+		f->palette_size  = image.palette_size;
+		memcpy( f->palette, image.palette, sizeof f->palette );
+	}
+	return err;
+}
+
 // Extras
 
 blargg_err_t Nes_Emu::load_ines( Auto_File_Reader in )
@@ -198,6 +225,7 @@ blargg_err_t Nes_Emu::load_battery_ram( Auto_File_Reader in )
 {
 	RETURN_ERR( in.open() );
 	emu.sram_present = true;
+	emu.sram_generation++;
 	return in->read( emu.impl->sram, emu.impl->sram_size );
 }
 
@@ -57,6 +57,10 @@ public:
 	// should be 0x00000000 exactly.
 	virtual blargg_err_t emulate_frame( uint32_t joypad1, uint32_t joypad2 );
 	
+	// Emulate one video frame without rendering it. Sound and everything else is the
+	// same as emulate_frame(), but the image from the last rendered frame is kept.
+	blargg_err_t emulate_skipped_frame( uint32_t joypad1, uint32_t joypad2 );
+	
 	// Maximum size of palette that can be generated
 	enum { max_palette_size = 256 };
 	
@@ -157,6 +161,9 @@ public:
 	// Load battery RAM from file. Best called just after reset() or loading cartridge.
 	blargg_err_t load_battery_ram( Auto_File_Reader );
 	
+	// Changes whenever battery RAM (high_mem()) might have been modified
+	unsigned long battery_ram_generation() const { return emu.sram_generation; }
+	
 // Graphics
 
 	// Number of frames generated per second
@@ -177,6 +184,7 @@ public:
 		sprites_enhanced = 64 // unlimited sprites per scanline (no flickering)
 	};
 	void set_sprite_mode( sprite_mode_t n ) { emu.ppu.sprite_limit = n; }
+	sprite_mode_t sprite_mode() const { return (sprite_mode_t) emu.ppu.sprite_limit; }
 	
 	// Set range of host palette entries to use in graphics buffer; default uses
 	// all of them. Begin will be rounded up to next multiple of palette_alignment.
@@ -112,6 +112,7 @@ void Nes_Core::cpu_write( nes_addr_t addr, int data, nes_time_t time )
 	if ( addr < sram_writable )
 	{
 		impl->sram [addr & (impl_t::sram_size - 1)] = data;
+		sram_generation++;
 		return;
 	}
 	
@@ -0,0 +1,572 @@
+/* Candidate filtering for RAM search. See ramsearch.h. */
+
+#include "ramsearch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define RAMSEARCH_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__)
+	#define popcount64 __builtin_popcountll
+	#define ctz64 __builtin_ctzll
+#else
+static int popcount64( uint64_t x )
+{
+	x = x - (x >> 1 & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + (x >> 2 & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (int) (x * 0x0101010101010101ULL >> 56);
+}
+
+static int ctz64( uint64_t x )
+{
+	return popcount64( (x & (0 - x)) - 1 );
+}
+#endif
+
+enum { page_bits = 12 };
+enum { page_size = 1 << page_bits };
+enum { page_words = page_size / 64 };
+
+/* words with this many candidates or fewer are checked one at a time */
+enum { sparse_count = 4 };
+
+struct ramsearch_t
+{
+	int size;
+	int width;
+	int flags;
+	int nwords;
+	int count;
+	uint64_t* bits;
+	uint8_t* prev;
+};
+
+ramsearch_t* ramsearch_new( int size, int width, int flags )
+{
+	ramsearch_t* s;
+	if ( size <= 0 || (width != 1 && width != 2 && width != 4) )
+		return NULL;
+
+	s = (ramsearch_t*) malloc( sizeof *s );
+	if ( !s )
+		return NULL;
+
+	s->size = size;
+	s->width = width;
+	s->flags = flags;
+	s->nwords = (size + 63) / 64;
+	s->count = 0;
+	s->bits = (uint64_t*) calloc( s->nwords, sizeof *s->bits );
+	s->prev = (uint8_t*) calloc( size, 1 );
+	if ( !s->bits || !s->prev )
+	{
+		ramsearch_delete( s );
+		return NULL;
+	}
+	return s;
+}
+
+void ramsearch_delete( ramsearch_t* s )
+{
+	if ( s )
+	{
+		free( s->bits );
+		free( s->prev );
+		free( s );
+	}
+}
+
+static int recount( ramsearch_t* s )
+{
+	int i, n = 0;
+	for ( i = 0; i < s->nwords; i++ )
+		n += popcount64( s->bits [i] );
+	s->count = n;
+	return n;
+}
+
+void ramsearch_start( ramsearch_t* s, const uint8_t* mem )
+{
+	/* last address a whole value fits at */
+	int const last = s->size - s->width;
+	uint64_t pattern = ~(uint64_t) 0;
+	int i;
+
+	if ( !(s->flags & ramsearch_misaligned) )
+	{
+		if ( s->width == 2 )
+			pattern = 0x5555555555555555ULL;
+		else if ( s->width == 4 )
+			pattern = 0x1111111111111111ULL;
+	}
+
+	for ( i = 0; i < s->nwords; i++ )
+	{
+		uint64_t w = pattern;
+		int const base = i * 64;
+		if ( base > last )
+			w = 0;
+		else if ( last - base < 63 )
+			w &= ((uint64_t) 2 << (last - base)) - 1;
+		s->bits [i] = w;
+	}
+	recount( s );
+	memcpy( s->prev, mem, s->size );
+}
+
+void ramsearch_snapshot( ramsearch_t* s, const uint8_t* mem )
+{
+	int const npages = (s->size + page_size - 1) >> page_bits;
+	int p;
+	for ( p = 0; p < npages; p++ )
+	{
+		int const first = p * page_words;
+		int end = first + page_words;
+		int i;
+		if ( end > s->nwords )
+			end = s->nwords;
+
+		for ( i = first; i < end; i++ )
+		{
+			if ( s->bits [i] )
+			{
+				/* a value starting near the end of the page reaches into the next one */
+				int const start = p << page_bits;
+				int stop = ((p + 1) << page_bits) + s->width - 1;
+				if ( stop > s->size )
+					stop = s->size;
+				memcpy( s->prev + start, mem + start, stop - start );
+				break;
+			}
+		}
+	}
+}
+
+int ramsearch_count( const ramsearch_t* s )
+{
+	return s->count;
+}
+
+int ramsearch_candidates( const ramsearch_t* s, int start, int32_t* out, int max )
+{
+	int n = 0;
+	int i;
+	if ( start < 0 )
+		start = 0;
+	for ( i = start >> 6; i < s->nwords && n < max; i++ )
+	{
+		uint64_t w = s->bits [i];
+		if ( i == start >> 6 )
+			w &= ~(uint64_t) 0 << (start & 63);
+		while ( w && n < max )
+		{
+			out [n++] = i * 64 + ctz64( w );
+			w &= w - 1;
+		}
+	}
+	return n;
+}
+
+void ramsearch_remove( ramsearch_t* s, int addr )
+{
+	uint64_t bit;
+	if ( addr < 0 || addr >= s->size )
+		return;
+	bit = (uint64_t) 1 << (addr & 63);
+	if ( s->bits [addr >> 6] & bit )
+	{
+		s->bits [addr >> 6] &= ~bit;
+		s->count--;
+	}
+}
+
+const uint8_t* ramsearch_previous( const ramsearch_t* s )
+{
+	return s->prev;
+}
+
+static int64_t read_value( const ramsearch_t* s, const uint8_t* p )
+{
+	int const sign = s->flags & ramsearch_signed;
+	uint32_t v;
+	switch ( s->width )
+	{
+	case 1:
+		return sign ? (int64_t) (int8_t) p [0] : (int64_t) p [0];
+
+	case 2:
+		if ( s->flags & ramsearch_bigendian )
+			v = (uint32_t) p [0] << 8 | p [1];
+		else
+			v = (uint32_t) p [1] << 8 | p [0];
+		return sign ? (int64_t) (int16_t) v : (int64_t) v;
+
+	default:
+		if ( s->flags & ramsearch_bigendian )
+			v = (uint32_t) p [0] << 24 | (uint32_t) p [1] << 16 | (uint32_t) p [2] << 8 | p [3];
+		else
+			v = (uint32_t) p [3] << 24 | (uint32_t) p [2] << 16 | (uint32_t) p [1] << 8 | p [0];
+		return sign ? (int64_t) (int32_t) v : (int64_t) v;
+	}
+}
+
+static int compare( int op, int64_t a, int64_t b, int64_t diff )
+{
+	switch ( op )
+	{
+	default:
+	case ramsearch_equal:        return a == b;
+	case ramsearch_greater:      return a > b;
+	case ramsearch_greaterequal: return a >= b;
+	case ramsearch_less:         return a < b;
+	case ramsearch_lessequal:    return a <= b;
+	case ramsearch_notequal:     return a != b;
+	case ramsearch_differentby:  return a + diff == b || a - diff == b;
+	}
+}
+
+/* the candidates in 'w' (addresses base..base+63) that pass, one at a time */
+static uint64_t match_scalar( const ramsearch_t* s, int base, uint64_t w, const uint8_t* mem,
+		int op, int64_t value, int64_t diff, int against_prev )
+{
+	uint64_t result = 0;
+	while ( w )
+	{
+		int const bit = ctz64( w );
+		int const addr = base + bit;
+		int64_t const ref = against_prev ? read_value( s, s->prev + addr ) : value;
+		if ( compare( op, read_value( s, mem + addr ), ref, diff ) )
+			result |= (uint64_t) 1 << bit;
+		w &= w - 1;
+	}
+	return result;
+}
+
+#ifdef RAMSEARCH_SSE2
+
+/* ops only used by the vector code */
+enum { op_either = 16, op_none, op_all };
+
+typedef struct vparams_t
+{
+	int op;
+	int swap;      /* byte swap lanes into logical order before comparing */
+	__m128i ref;   /* constant to compare against, in logical order */
+	__m128i ref2;  /* second constant for op_either */
+	__m128i sbias; /* xor into lanes to make signed compares give the right order */
+	__m128i ubias; /* xor into lanes to make unsigned saturation give the right order */
+	__m128i diff;
+} vparams_t;
+
+static __m128i broadcast( int width, uint32_t v )
+{
+	switch ( width )
+	{
+	case 1:  return _mm_set1_epi8( (char) v );
+	case 2:  return _mm_set1_epi16( (short) v );
+	default: return _mm_set1_epi32( (int) v );
+	}
+}
+
+/* sets up the vector compare. constants that fall outside the range of the lanes
+are resolved here, so the lanes never need to hold them */
+static void vparams_init( vparams_t* v, const ramsearch_t* s, int op, int64_t value, int64_t diff, int against_prev )
+{
+	int const bits = s->width * 8;
+	int const sign = s->flags & ramsearch_signed;
+	int64_t const min = sign ? -((int64_t) 1 << (bits - 1)) : 0;
+	int64_t const max = sign ? ((int64_t) 1 << (bits - 1)) - 1 : ((int64_t) 1 << bits) - 1;
+	uint32_t const signbit = (uint32_t) 1 << (bits - 1);
+
+	if ( diff < 0 )
+		diff = -diff;
+
+	v->op = op;
+	v->swap = (s->flags & ramsearch_bigendian) && s->width > 1 &&
+			!(against_prev && (op == ramsearch_equal || op == ramsearch_notequal));
+	v->sbias = broadcast( s->width, sign ? 0 : signbit );
+	v->ubias = broadcast( s->width, sign ? signbit : 0 );
+	v->diff = broadcast( s->width, (uint32_t) diff );
+	v->ref = v->ref2 = _mm_setzero_si128();
+
+	if ( against_prev )
+	{
+		if ( op == ramsearch_differentby && diff > max - min )
+			v->op = op_none;
+		return;
+	}
+
+	switch ( op )
+	{
+	case ramsearch_equal:
+	case ramsearch_notequal:
+		if ( value < min || value > max )
+			v->op = op == ramsearch_equal ? op_none : op_all;
+		break;
+
+	case ramsearch_greater:
+	case ramsearch_greaterequal:
+		if ( value > max )
+			v->op = op_none;
+		else if ( value < min )
+			v->op = op_all;
+		break;
+
+	case ramsearch_less:
+	case ramsearch_lessequal:
+		if ( value < min )
+			v->op = op_none;
+		else if ( value > max )
+			v->op = op_all;
+		break;
+
+	default:
+	{
+		/* a value 'diff' away from a constant is one of two constants */
+		int64_t const lo = value - diff;
+		int64_t const hi = value + diff;
+		int const lo_ok = lo >= min && lo <= max;
+		int const hi_ok = hi >= min && hi <= max;
+		v->op = op_either;
+		if ( !lo_ok && !hi_ok )
+			v->op = op_none;
+		else
+		{
+			v->ref = broadcast( s->width, (uint32_t) (lo_ok ? lo : hi) );
+			v->ref2 = broadcast( s->width, (uint32_t) (hi_ok ? hi : lo) );
+		}
+		return;
+	}
+	}
+	v->ref = broadcast( s->width, (uint32_t) value );
+}
+
+#define VNOT( x ) _mm_xor_si128( (x), _mm_set1_epi32( -1 ) )
+
+/* one lane mask per width: all ones in each lane where a compares true against b */
+
+static __m128i cmp8( const vparams_t* v, __m128i a, __m128i b )
+{
+	switch ( v->op )
+	{
+	default:
+	case ramsearch_equal:        return _mm_cmpeq_epi8( a, b );
+	case ramsearch_notequal:     return VNOT( _mm_cmpeq_epi8( a, b ) );
+	case ramsearch_greater:      return _mm_cmpgt_epi8( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) );
+	case ramsearch_greaterequal: return VNOT( _mm_cmpgt_epi8( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) ) );
+	case ramsearch_less:         return _mm_cmpgt_epi8( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) );
+	case ramsearch_lessequal:    return VNOT( _mm_cmpgt_epi8( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) ) );
+	case op_either:              return _mm_or_si128( _mm_cmpeq_epi8( a, v->ref ), _mm_cmpeq_epi8( a, v->ref2 ) );
+	case ramsearch_differentby:
+	{
+		__m128i const ua = _mm_xor_si128( a, v->ubias );
+		__m128i const ub = _mm_xor_si128( b, v->ubias );
+		__m128i const d = _mm_or_si128( _mm_subs_epu8( ua, ub ), _mm_subs_epu8( ub, ua ) );
+		return _mm_cmpeq_epi8( d, v->diff );
+	}
+	}
+}
+
+static __m128i cmp16( const vparams_t* v, __m128i a, __m128i b )
+{
+	switch ( v->op )
+	{
+	default:
+	case ramsearch_equal:        return _mm_cmpeq_epi16( a, b );
+	case ramsearch_notequal:     return VNOT( _mm_cmpeq_epi16( a, b ) );
+	case ramsearch_greater:      return _mm_cmpgt_epi16( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) );
+	case ramsearch_greaterequal: return VNOT( _mm_cmpgt_epi16( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) ) );
+	case ramsearch_less:         return _mm_cmpgt_epi16( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) );
+	case ramsearch_lessequal:    return VNOT( _mm_cmpgt_epi16( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) ) );
+	case op_either:              return _mm_or_si128( _mm_cmpeq_epi16( a, v->ref ), _mm_cmpeq_epi16( a, v->ref2 ) );
+	case ramsearch_differentby:
+	{
+		__m128i const ua = _mm_xor_si128( a, v->ubias );
+		__m128i const ub = _mm_xor_si128( b, v->ubias );
+		__m128i const d = _mm_or_si128( _mm_subs_epu16( ua, ub ), _mm_subs_epu16( ub, ua ) );
+		return _mm_cmpeq_epi16( d, v->diff );
+	}
+	}
+}
+
+static __m128i cmp32( const vparams_t* v, __m128i a, __m128i b )
+{
+	switch ( v->op )
+	{
+	default:
+	case ramsearch_equal:        return _mm_cmpeq_epi32( a, b );
+	case ramsearch_notequal:     return VNOT( _mm_cmpeq_epi32( a, b ) );
+	case ramsearch_greater:      return _mm_cmpgt_epi32( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) );
+	case ramsearch_greaterequal: return VNOT( _mm_cmpgt_epi32( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) ) );
+	case ramsearch_less:         return _mm_cmpgt_epi32( _mm_xor_si128( b, v->sbias ), _mm_xor_si128( a, v->sbias ) );
+	case ramsearch_lessequal:    return VNOT( _mm_cmpgt_epi32( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) ) );
+	case op_either:              return _mm_or_si128( _mm_cmpeq_epi32( a, v->ref ), _mm_cmpeq_epi32( a, v->ref2 ) );
+	case ramsearch_differentby:
+	{
+		/* no unsigned saturation at this width; take whichever difference is positive */
+		__m128i const gt = _mm_cmpgt_epi32( _mm_xor_si128( a, v->sbias ), _mm_xor_si128( b, v->sbias ) );
+		__m128i const d = _mm_or_si128( _mm_and_si128( gt, _mm_sub_epi32( a, b ) ),
+				_mm_andnot_si128( gt, _mm_sub_epi32( b, a ) ) );
+		return _mm_cmpeq_epi32( d, v->diff );
+	}
+	}
+}
+
+static __m128i swap16( __m128i x )
+{
+	return _mm_or_si128( _mm_slli_epi16( x, 8 ), _mm_srli_epi16( x, 8 ) );
+}
+
+static __m128i swap32( __m128i x )
+{
+	x = _mm_shufflelo_epi16( x, 0xB1 );
+	x = _mm_shufflehi_epi16( x, 0xB1 );
+	return swap16( x );
+}
+
+/* one bit per lane, from 16 bytes at cur and ref (ref is ignored for constants) */
+
+static unsigned block8( const vparams_t* v, const uint8_t* cur, const uint8_t* ref )
+{
+	__m128i const a = _mm_loadu_si128( (const __m128i*) cur );
+	__m128i const b = ref ? _mm_loadu_si128( (const __m128i*) ref ) : v->ref;
+	return _mm_movemask_epi8( cmp8( v, a, b ) );
+}
+
+static unsigned block16( const vparams_t* v, const uint8_t* cur, const uint8_t* ref )
+{
+	__m128i a = _mm_loadu_si128( (const __m128i*) cur );
+	__m128i b = v->ref;
+	__m128i m;
+	if ( ref )
+	{
+		b = _mm_loadu_si128( (const __m128i*) ref );
+		if ( v->swap )
+			b = swap16( b );
+	}
+	if ( v->swap )
+		a = swap16( a );
+	m = cmp16( v, a, b );
+	return _mm_movemask_epi8( _mm_packs_epi16( m, m ) ) & 0xFF;
+}
+
+static unsigned block32( const vparams_t* v, const uint8_t* cur, const uint8_t* ref )
+{
+	__m128i a = _mm_loadu_si128( (const __m128i*) cur );
+	__m128i b = v->ref;
+	if ( ref )
+	{
+		b = _mm_loadu_si128( (const __m128i*) ref );
+		if ( v->swap )
+			b = swap32( b );
+	}
+	if ( v->swap )
+		a = swap32( a );
+	return _mm_movemask_ps( _mm_castsi128_ps( cmp32( v, a, b ) ) );
+}
+
+/* lane bit j to bit 2j, and to bit 4j */
+
+static unsigned spread2( unsigned x )
+{
+	x = (x | x << 4) & 0x0F0F;
+	x = (x | x << 2) & 0x3333;
+	x = (x | x << 1) & 0x5555;
+	return x;
+}
+
+static unsigned spread4( unsigned x )
+{
+	x = (x | x << 6) & 0x0303;
+	x = (x | x << 3) & 0x1111;
+	return x;
+}
+
+/* which of the 64 addresses at mem + base pass; all of them must be readable.
+with misaligned values, each 16 byte block is read once per byte of phase */
+static uint64_t match_vector( const ramsearch_t* s, const vparams_t* v, int base, uint64_t want,
+		const uint8_t* mem, int against_prev )
+{
+	const uint8_t* const cur = mem + base;
+	const uint8_t* const ref = against_prev ? s->prev + base : NULL;
+	uint64_t result = 0;
+	int const phases = (s->flags & ramsearch_misaligned) ? s->width : 1;
+	int k, blk;
+
+	if ( v->op == op_none )
+		return 0;
+	if ( v->op == op_all )
+		return want;
+
+	for ( k = 0; k < phases; k++ )
+	{
+		for ( blk = 0; blk < 64; blk += 16 )
+		{
+			unsigned m;
+			switch ( s->width )
+			{
+			case 1:
+				if ( !(want >> blk & 0xFFFF) )
+					continue;
+				m = block8( v, cur + blk, ref ? ref + blk : NULL );
+				break;
+			case 2:
+				if ( !(want >> blk & 0x5555u << k) )
+					continue;
+				m = spread2( block16( v, cur + blk + k, ref ? ref + blk + k : NULL ) ) << k;
+				break;
+			default:
+				if ( !(want >> blk & 0x1111u << k) )
+					continue;
+				m = spread4( block32( v, cur + blk + k, ref ? ref + blk + k : NULL ) ) << k;
+				break;
+			}
+			result |= (uint64_t) m << blk;
+		}
+	}
+	return result & want;
+}
+
+#endif
+
+static int filter( ramsearch_t* s, const uint8_t* mem, int op, int64_t value, int64_t diff, int against_prev )
+{
+	int i;
+#ifdef RAMSEARCH_SSE2
+	vparams_t v;
+	/* words past this one can have vector loads running off the end */
+	int const vector_words = (s->size - (s->width - 1)) / 64;
+	vparams_init( &v, s, op, value, diff, against_prev );
+#endif
+
+	for ( i = 0; i < s->nwords; i++ )
+	{
+		uint64_t const w = s->bits [i];
+		if ( !w )
+			continue;
+#ifdef RAMSEARCH_SSE2
+		if ( i < vector_words && popcount64( w ) > sparse_count )
+		{
+			s->bits [i] = match_vector( s, &v, i * 64, w, mem, against_prev );
+			continue;
+		}
+#endif
+		s->bits [i] = match_scalar( s, i * 64, w, mem, op, value, diff, against_prev );
+	}
+	return recount( s );
+}
+
+int ramsearch_filter_previous( ramsearch_t* s, const uint8_t* mem, int op, int64_t diff )
+{
+	return filter( s, mem, op, 0, diff, 1 );
+}
+
+int ramsearch_filter_value( ramsearch_t* s, const uint8_t* mem, int op, int64_t value, int64_t diff )
+{
+	return filter( s, mem, op, value, diff, 0 );
+}
@@ -0,0 +1,86 @@
+/* Candidate filtering for RAM search, over a raw memory area.
+
+Candidates are kept as a bitmap with one bit per address. Each filter compares
+every remaining candidate against a previous snapshot or a fixed value, 16
+bytes at a time where SSE2 is available, and clears the ones that fail. Only
+pages that still hold candidates are read or copied into the snapshot. */
+
+#ifndef RAMSEARCH_H
+#define RAMSEARCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#ifdef _WIN32
+	#define RAMSEARCH_EXPORT __declspec(dllexport)
+#else
+	#define RAMSEARCH_EXPORT
+#endif
+
+/** Comparison applied by the filters. ramsearch_differentby keeps values that are
+exactly 'diff' away from the reference, in either direction. */
+enum ramsearch_op
+{
+	ramsearch_equal = 0,
+	ramsearch_greater = 1,
+	ramsearch_greaterequal = 2,
+	ramsearch_less = 3,
+	ramsearch_lessequal = 4,
+	ramsearch_notequal = 5,
+	ramsearch_differentby = 6
+};
+
+/** Flags for ramsearch_new(). */
+enum
+{
+	ramsearch_bigendian = 1, /* values are stored big endian */
+	ramsearch_signed = 2, /* compare as signed values */
+	ramsearch_misaligned = 4 /* search every address, not only multiples of the width */
+};
+
+typedef struct ramsearch_t ramsearch_t;
+
+/** Creates a search over a memory area of 'size' bytes, holding values 'width'
+(1, 2 or 4) bytes wide. Returns NULL if out of memory or on bad arguments. */
+RAMSEARCH_EXPORT ramsearch_t* ramsearch_new( int size, int width, int flags );
+
+/** Makes every address a candidate again and snapshots all of 'mem'. */
+RAMSEARCH_EXPORT void ramsearch_start( ramsearch_t*, const uint8_t* mem );
+
+/** Copies 'mem' into the previous snapshot, for those pages that still hold
+candidates. Call after a filter to compare against the last search, or every
+frame to compare against the last frame. */
+RAMSEARCH_EXPORT void ramsearch_snapshot( ramsearch_t*, const uint8_t* mem );
+
+/** Keeps candidates whose current value in 'mem' compares true against the
+previous snapshot. Returns the number of candidates left. */
+RAMSEARCH_EXPORT int ramsearch_filter_previous( ramsearch_t*, const uint8_t* mem, int op, int64_t diff );
+
+/** Keeps candidates whose current value in 'mem' compares true against 'value'.
+Returns the number of candidates left. */
+RAMSEARCH_EXPORT int ramsearch_filter_value( ramsearch_t*, const uint8_t* mem, int op, int64_t value, int64_t diff );
+
+/** Number of candidates left. */
+RAMSEARCH_EXPORT int ramsearch_count( const ramsearch_t* );
+
+/** Writes up to 'max' candidate addresses no lower than 'start' to 'out', in
+ascending order. Returns the number written. */
+RAMSEARCH_EXPORT int ramsearch_candidates( const ramsearch_t*, int start, int32_t* out, int max );
+
+/** Drops the candidate at 'addr', if there is one. */
+RAMSEARCH_EXPORT void ramsearch_remove( ramsearch_t*, int addr );
+
+/** The previous snapshot, 'size' bytes. Pages without candidates may be stale. */
+RAMSEARCH_EXPORT const uint8_t* ramsearch_previous( const ramsearch_t* );
+
+/** Frees the search. No effect if NULL is passed. */
+RAMSEARCH_EXPORT void ramsearch_delete( ramsearch_t* );
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif
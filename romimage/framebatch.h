@@ -0,0 +1,109 @@
+/** \file
+The per-frame records written by the batch frame advance exports. After every frame
+a record gets a uint32 of flags, a uint32 hash of the core's RAM and then the bytes
+of each requested memory range, padded to a multiple of 4 bytes. */
+
+#ifndef FRAMEBATCH_H
+#define FRAMEBATCH_H
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace framebatch {
+
+/** Record flags */
+enum
+{
+	lagged = 1, // no input was read
+	audio_overflow = 2 // the frame's sound did not fit in the caller's buffer
+};
+
+/** One memory range copied into every record. area is numbered as in the core's
+memory area export. */
+struct Range
+{
+	int32_t area;
+	int32_t addr;
+	int32_t size;
+};
+
+/** FNV-1a of data, a little endian word at a time and any tail a byte at a time.
+Pass the previous result as h to continue over another block. */
+inline uint32_t hash( const void* data, size_t size, uint32_t h = 2166136261u )
+{
+	const unsigned char* p = static_cast<const unsigned char*>( data );
+	size_t i = 0;
+	for ( ; i + 4 <= size; i += 4 )
+		h = (h ^ (p [i] | p [i + 1] << 8 | p [i + 2] << 16 | (uint32_t) p [i + 3] << 24)) * 16777619u;
+	for ( ; i < size; i++ )
+		h = (h ^ p [i]) * 16777619u;
+	return h;
+}
+
+/** Lays out and writes the records for a list of ranges. area( int area, const uint8_t*&
+data, int& size ) looks up a memory area and returns false if there is none. */
+template<class Area>
+class Writer
+{
+	const Range* ranges;
+	int count;
+	Area area;
+	int stride_;
+
+public:
+	Writer( const Range* ranges, int count, Area area ) :
+		ranges( ranges ), count( count ), area( area ), stride_( -1 )
+	{
+		int stride = 8;
+		for ( int i = 0; i < count; i++ )
+		{
+			const uint8_t* data = nullptr;
+			int size = 0;
+			if ( !area( ranges [i].area, data, size ) || !data )
+				return;
+			if ( ranges [i].addr < 0 || ranges [i].size < 0 || ranges [i].size > size - ranges [i].addr )
+				return;
+			if ( ranges [i].size > INT_MAX - 3 - stride )
+				return;
+			stride += ranges [i].size;
+		}
+		stride_ = (stride + 3) & ~3;
+	}
+
+	/** Size of one record, or -1 if a range is outside its area */
+	int stride() const { return stride_; }
+
+	/** True if the ranges are good and nframes records fit in destsize bytes */
+	bool fits( int nframes, int destsize ) const
+	{
+		return stride_ >= 0 && (int64_t) stride_ * nframes <= destsize;
+	}
+
+	/** Writes a record at dest and returns where the next one goes */
+	uint8_t* write( uint8_t* dest, uint32_t flags, uint32_t hash ) const
+	{
+		memcpy( dest, &flags, 4 );
+		memcpy( dest + 4, &hash, 4 );
+		uint8_t* out = dest + 8;
+		for ( int i = 0; i < count; i++ )
+		{
+			const uint8_t* data = nullptr;
+			int size = 0;
+			area( ranges [i].area, data, size );
+			memcpy( out, data + ranges [i].addr, ranges [i].size );
+			out += ranges [i].size;
+		}
+		return dest + stride_;
+	}
+};
+
+template<class Area>
+inline Writer<Area> writer( const Range* ranges, int count, Area area )
+{
+	return Writer<Area>( ranges, count, area );
+}
+
+}
+
+#endif
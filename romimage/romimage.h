@@ -0,0 +1,170 @@
+/** \file
+Read-only ROM and BIOS images shared by every instance of a core in the process.
+An image is identified by the hash and length of the file it was built from and
+a core-defined tag for how it was built, so loading the same file again hands
+out the image that is already there instead of another copy. Images are freed
+with their last reference, and are write protected once built so that a stray
+store into ROM faults at once instead of changing every instance. */
+
+#ifndef ROMIMAGE_H
+#define ROMIMAGE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include "xxhash.h"
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+#endif
+
+namespace romimage {
+
+class Registry
+{
+	struct Key
+	{
+		uint64_t hash;
+		size_t length;
+		uint32_t tag;
+
+		bool operator<( const Key& k ) const
+		{
+			if ( hash != k.hash )
+				return hash < k.hash;
+			if ( length != k.length )
+				return length < k.length;
+			return tag < k.tag;
+		}
+	};
+
+	typedef std::map<Key, std::weak_ptr<void> > entries_t;
+	entries_t entries;
+	std::atomic_flag busy;
+
+	Registry() { busy.clear(); }
+
+	void lock() { while ( busy.test_and_set( std::memory_order_acquire ) ) { } }
+	void unlock() { busy.clear( std::memory_order_release ); }
+
+	static Registry& get()
+	{
+		static Registry r;
+		return r;
+	}
+
+	std::shared_ptr<void> find( const Key& key )
+	{
+		entries_t::iterator it = entries.find( key );
+		return it == entries.end() ? std::shared_ptr<void>() : it->second.lock();
+	}
+
+	void insert( const Key& key, const std::shared_ptr<void>& p )
+	{
+		for ( entries_t::iterator it = entries.begin(); it != entries.end(); )
+		{
+			if ( it->second.expired() )
+				entries.erase( it++ );
+			else
+				++it;
+		}
+		entries [key] = p;
+	}
+
+	static uint8_t* map( size_t size )
+	{
+	#ifdef _WIN32
+		return static_cast<uint8_t*>( VirtualAlloc( nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE ) );
+	#else
+		void* p = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		return p == MAP_FAILED ? nullptr : static_cast<uint8_t*>( p );
+	#endif
+	}
+
+	static void protect( uint8_t* p, size_t size )
+	{
+	#ifdef _WIN32
+		DWORD old;
+		VirtualProtect( p, size, PAGE_READONLY, &old );
+	#else
+		mprotect( p, size, PROT_READ );
+	#endif
+	}
+
+	struct Unmap
+	{
+		size_t size;
+
+		void operator()( uint8_t* p ) const
+		{
+		#ifdef _WIN32
+			VirtualFree( p, 0, MEM_RELEASE );
+		#else
+			munmap( p, size );
+		#endif
+		}
+	};
+
+public:
+	/** Returns the object made from file by make(), which returns a std::shared_ptr<T>
+	and is called only if no live object has the same file contents and tag. Tags must
+	tell apart every kind of object a core shares. Returns null if make() does. */
+	template<class T, class Make>
+	static std::shared_ptr<T> share( const void* file, size_t length, uint32_t tag, Make make )
+	{
+		Registry& r = get();
+		const Key key = { xxh64( file, length ), length, tag };
+
+		r.lock();
+		std::shared_ptr<void> found = r.find( key );
+		r.unlock();
+		if ( found )
+			return std::static_pointer_cast<T>( found );
+
+		// made outside the lock, so a large image does not hold up other loads
+		std::shared_ptr<T> made = make();
+		if ( !made )
+			return made;
+
+		r.lock();
+		found = r.find( key );
+		if ( !found )
+			r.insert( key, found = made );
+		r.unlock();
+		return std::static_pointer_cast<T>( found ); // if another thread got there first, ours is freed here
+	}
+
+	/** Returns the image of size bytes built from file by fill( uint8_t* image ), as
+	share() does. fill gets zeroed pages, which are write protected when it returns.
+	Returns null if size is 0 or out of memory. */
+	template<class Fill>
+	static std::shared_ptr<uint8_t> acquire( const void* file, size_t length, uint32_t tag,
+			size_t size, Fill fill )
+	{
+		return share<uint8_t>( file, length, tag, [&]() -> std::shared_ptr<uint8_t>
+		{
+			uint8_t* const p = size ? map( size ) : nullptr;
+			if ( !p )
+				return std::shared_ptr<uint8_t>();
+			fill( p );
+			protect( p, size );
+			const Unmap d = { size };
+			return std::shared_ptr<uint8_t>( p, d );
+		} );
+	}
+};
+
+}
+
+#endif
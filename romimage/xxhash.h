@@ -0,0 +1,175 @@
+/** \file
+XXH64 with seed 0, of one block or streamed a piece at a time, for the ROM image
+registry and the savestate hash exports. Plain C so the C cores can include it too;
+everything is inline, so there is nothing to link. Reads are little endian, the same
+as the savestates themselves. */
+
+#ifndef XXHASH_H
+#define XXHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined( _MSC_VER ) && !defined( __cplusplus )
+	#define XXH_INLINE static __inline
+#else
+	#define XXH_INLINE static inline
+#endif
+
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+/** Streaming state. Start it with xxh64_reset(). */
+typedef struct xxh64_state
+{
+	uint64_t v [4];
+	uint64_t total;
+	unsigned char mem [32];
+	size_t memsize;
+} xxh64_state;
+
+XXH_INLINE uint64_t xxh64_rotl( uint64_t x, int r )
+{
+	return x << r | x >> (64 - r);
+}
+
+XXH_INLINE uint64_t xxh64_read64( const unsigned char* p )
+{
+	uint64_t v;
+	memcpy( &v, p, 8 );
+	return v;
+}
+
+XXH_INLINE uint32_t xxh64_read32( const unsigned char* p )
+{
+	uint32_t v;
+	memcpy( &v, p, 4 );
+	return v;
+}
+
+XXH_INLINE uint64_t xxh64_round( uint64_t acc, uint64_t in )
+{
+	return xxh64_rotl( acc + in * XXH_PRIME64_2, 31 ) * XXH_PRIME64_1;
+}
+
+XXH_INLINE uint64_t xxh64_merge( uint64_t acc, uint64_t v )
+{
+	return (acc ^ xxh64_round( 0, v )) * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+XXH_INLINE void xxh64_stripe( uint64_t* v, const unsigned char* p )
+{
+	v [0] = xxh64_round( v [0], xxh64_read64( p ) );
+	v [1] = xxh64_round( v [1], xxh64_read64( p + 8 ) );
+	v [2] = xxh64_round( v [2], xxh64_read64( p + 16 ) );
+	v [3] = xxh64_round( v [3], xxh64_read64( p + 24 ) );
+}
+
+/** Hash of the last of the input, under 32 bytes, on top of the accumulated h */
+XXH_INLINE uint64_t xxh64_finish( uint64_t h, const unsigned char* p, const unsigned char* end )
+{
+	for ( ; end - p >= 8; p += 8 )
+		h = xxh64_rotl( h ^ xxh64_round( 0, xxh64_read64( p ) ), 27 ) * XXH_PRIME64_1 + XXH_PRIME64_4;
+	if ( end - p >= 4 )
+	{
+		h = xxh64_rotl( h ^ (xxh64_read32( p ) * XXH_PRIME64_1), 23 ) * XXH_PRIME64_2 + XXH_PRIME64_3;
+		p += 4;
+	}
+	for ( ; p < end; p++ )
+		h = xxh64_rotl( h ^ (*p * XXH_PRIME64_5), 11 ) * XXH_PRIME64_1;
+
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+	return h;
+}
+
+XXH_INLINE uint64_t xxh64_converge( const uint64_t* v )
+{
+	uint64_t h = xxh64_rotl( v [0], 1 ) + xxh64_rotl( v [1], 7 ) + xxh64_rotl( v [2], 12 ) + xxh64_rotl( v [3], 18 );
+	h = xxh64_merge( h, v [0] );
+	h = xxh64_merge( h, v [1] );
+	h = xxh64_merge( h, v [2] );
+	h = xxh64_merge( h, v [3] );
+	return h;
+}
+
+/** Starts a new hash */
+XXH_INLINE void xxh64_reset( xxh64_state* s )
+{
+	s->v [0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+	s->v [1] = XXH_PRIME64_2;
+	s->v [2] = 0;
+	s->v [3] = 0 - XXH_PRIME64_1;
+	s->total = 0;
+	s->memsize = 0;
+}
+
+/** Adds size bytes at data */
+XXH_INLINE void xxh64_update( xxh64_state* s, const void* data, size_t size )
+{
+	const unsigned char* p = (const unsigned char*) data;
+	const unsigned char* const end = p + size;
+
+	s->total += size;
+	if ( s->memsize + size < 32 )
+	{
+		if ( size )
+			memcpy( s->mem + s->memsize, p, size );
+		s->memsize += size;
+		return;
+	}
+	if ( s->memsize )
+	{
+		size_t fill = 32 - s->memsize;
+		memcpy( s->mem + s->memsize, p, fill );
+		xxh64_stripe( s->v, s->mem );
+		p += fill;
+	}
+	for ( ; end - p >= 32; p += 32 )
+		xxh64_stripe( s->v, p );
+	s->memsize = end - p;
+	if ( s->memsize )
+		memcpy( s->mem, p, s->memsize );
+}
+
+/** Hash of everything added so far. More can still be added afterwards. */
+XXH_INLINE uint64_t xxh64_digest( const xxh64_state* s )
+{
+	uint64_t h = s->total >= 32 ? xxh64_converge( s->v ) : s->v [2] + XXH_PRIME64_5;
+	return xxh64_finish( h + s->total, s->mem, s->mem + s->memsize );
+}
+
+/** Hash of one block */
+XXH_INLINE uint64_t xxh64( const void* data, size_t size )
+{
+	const unsigned char* p = (const unsigned char*) data;
+	const unsigned char* const end = p + size;
+	uint64_t h;
+
+	if ( size >= 32 )
+	{
+		uint64_t v [4];
+		v [0] = XXH_PRIME64_1 + XXH_PRIME64_2;
+		v [1] = XXH_PRIME64_2;
+		v [2] = 0;
+		v [3] = 0 - XXH_PRIME64_1;
+		for ( ; end - p >= 32; p += 32 )
+			xxh64_stripe( v, p );
+		h = xxh64_converge( v );
+	}
+	else
+	{
+		h = XXH_PRIME64_5;
+	}
+
+	return xxh64_finish( h + size, p, end );
+}
+
+#endif
@@ -0,0 +1,129 @@
+/** \file
+Lock-free ring of fixed-size binary instruction trace records, shared by the
+cores. The core writes one record per instruction without formatting anything;
+the frontend drains the ring in bulk and disassembles the records later. */
+
+#ifndef TRACERING_H
+#define TRACERING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/** One executed instruction. 64 bytes; the meaning of regs[] and flags is
+defined by each core, and unused fields are zero. */
+typedef struct trace_record
+{
+	uint64_t cycle;     /**< core's cycle counter before the instruction */
+	uint32_t pc;        /**< address of the first opcode byte */
+	uint8_t opcode [8]; /**< opcode and operand bytes, as fetched */
+	uint8_t oplen;      /**< number of valid bytes in opcode[] */
+	uint8_t nregs;      /**< number of valid entries in regs[] */
+	uint16_t flags;     /**< core-specific */
+	uint32_t regs [10]; /**< register snapshot before the instruction */
+} trace_record;
+
+/** Called by the producer when the ring is full, so that a consumer on the same
+thread can drain it before the record is dropped. */
+typedef void (*trace_ring_full_t)( void );
+
+/** Ring header, followed directly by the records. head is only written by the
+producer and tail only by the consumer, each on its own cache line; layout is
+fixed so that managed code can read it through a pointer. */
+typedef struct trace_ring
+{
+	uint32_t volatile head;  /**< count of records written */
+	uint32_t head_pad [15];
+	uint32_t volatile tail;  /**< count of records consumed */
+	uint32_t tail_pad [15];
+	uint32_t mask;           /**< capacity - 1 */
+	uint32_t volatile dropped; /**< records lost because the ring was full */
+	trace_ring_full_t full;  /**< optional, see trace_ring_full_t */
+	uint8_t pad [64 - 8 - sizeof (trace_ring_full_t)];
+	trace_record records [1];
+} trace_ring;
+
+#if defined(__GNUC__)
+	#define TRACE_RING_LOAD_ACQUIRE( p ) __atomic_load_n( &(p), __ATOMIC_ACQUIRE )
+	#define TRACE_RING_STORE_RELEASE( p, v ) __atomic_store_n( &(p), (v), __ATOMIC_RELEASE )
+#elif defined(_MSC_VER)
+	/* volatile accesses are acquire/release on MSVC's x86 and x64 targets */
+	#define TRACE_RING_LOAD_ACQUIRE( p ) (p)
+	#define TRACE_RING_STORE_RELEASE( p, v ) ((p) = (v))
+#else
+	#error "tracering.h needs acquire/release loads and stores for this compiler"
+#endif
+
+/** Creates a ring holding capacity records, rounded up to a power of two.
+Returns NULL if insufficient memory. */
+static inline trace_ring* trace_ring_new( uint32_t capacity )
+{
+	uint32_t size = 1;
+	trace_ring* r;
+	while ( size < capacity )
+		size <<= 1;
+
+	r = (trace_ring*) calloc( 1, sizeof (trace_ring) + (size - 1) * sizeof (trace_record) );
+	if ( r )
+		r->mask = size - 1;
+	return r;
+}
+
+/** Frees ring. Safe to pass NULL. */
+static inline void trace_ring_delete( trace_ring* r )
+{
+	free( r );
+}
+
+/** Returns the slot for the next record, or NULL if the ring is still full
+after calling the full callback. The slot is zeroed; fill it in and call
+trace_ring_commit(). */
+static inline trace_record* trace_ring_begin( trace_ring* r )
+{
+	uint32_t head = r->head;
+	trace_record* rec;
+	if ( head - TRACE_RING_LOAD_ACQUIRE( r->tail ) > r->mask )
+	{
+		if ( r->full )
+			r->full();
+		if ( head - TRACE_RING_LOAD_ACQUIRE( r->tail ) > r->mask )
+		{
+			r->dropped++;
+			return NULL;
+		}
+	}
+	rec = &r->records [head & r->mask];
+	memset( rec, 0, sizeof *rec );
+	return rec;
+}
+
+/** Publishes the record returned by the last trace_ring_begin(). */
+static inline void trace_ring_commit( trace_ring* r )
+{
+	TRACE_RING_STORE_RELEASE( r->head, r->head + 1 );
+}
+
+/** Copies up to count of the oldest records to out and removes them from the
+ring. Returns number of records copied. */
+static inline uint32_t trace_ring_read( trace_ring* r, trace_record* out, uint32_t count )
+{
+	uint32_t tail = r->tail;
+	uint32_t avail = TRACE_RING_LOAD_ACQUIRE( r->head ) - tail;
+	uint32_t i;
+	if ( count > avail )
+		count = avail;
+	for ( i = 0; i < count; i++ )
+		out [i] = r->records [(tail + i) & r->mask];
+	TRACE_RING_STORE_RELEASE( r->tail, tail + count );
+	return count;
+}
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif
@@ -3,6 +3,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <memory>
 
 #include <stdint.h>
 #include <limits.h>
@@ -23,6 +24,7 @@
 #include "constarrays.h"
 
 #include "newstate.h"
+#include "romimage.h"
 
 #define INLINE
 
@@ -50,6 +52,7 @@ class Gigazoid
 #define FLASH_SETBANK            9
 
 uint8_t flashSaveMemory[FLASH_128K_SZ];
+u32 saveRamGeneration; // bumped on every write to flashSaveMemory or eepromData; not savestated
 
 int flashState; // = FLASH_READ_ARRAY;
 int flashReadState; // = FLASH_READ_ARRAY;
@@ -165,10 +168,12 @@ void flashWrite(uint32_t address, uint8_t byte)
 				memset(&flashSaveMemory[(flashBank << 16) + (address & 0xF000)],
 						0,
 						0x1000);
+				saveRamGeneration++;
 				flashReadState = FLASH_ERASE_COMPLETE;
 			} else if(byte == 0x10) {
 				// CHIP ERASE
 				memset(flashSaveMemory, 0, flashSize);
+				saveRamGeneration++;
 				flashReadState = FLASH_ERASE_COMPLETE;
 			} else {
 				flashState = FLASH_READ_ARRAY;
@@ -188,6 +193,7 @@ void flashWrite(uint32_t address, uint8_t byte)
 			break;
 		case FLASH_PROGRAM:
 			flashSaveMemory[(flashBank<<16)+address] = byte;
+			saveRamGeneration++;
 			flashState = FLASH_READ_ARRAY;
 			flashReadState = FLASH_READ_ARRAY;
 			break;
@@ -337,6 +343,7 @@ void eepromWrite(u8 value)
 				// write data;
 				for(int i = 0; i < 8; i++)
 					eepromData[(eepromAddress << 3) + i] = eepromBuffer[i];
+				saveRamGeneration++;
 			}
 			else if(eepromBits == 0x41)
 			{
@@ -360,6 +367,7 @@ u8 sramRead(u32 address)
 void sramWrite(u32 address, u8 byte)
 {
 	flashSaveMemory[address & 0xFFFF] = byte;
+	saveRamGeneration++;
 }
 
 void dummyWrite(u32 address, u8 byte)
@@ -8930,7 +8938,8 @@ bool mirroringEnable;
 int cpuDmaCount;
 
 uint8_t bios[0x4000];
-uint8_t rom[0x2000000];
+uint8_t *rom;
+std::shared_ptr<uint8_t> romOwner; // shared with any clones
 uint8_t internalRAM[0x8000];
 uint8_t workRAM[0x40000];
 uint8_t vram[0x20000];
@@ -9011,7 +9020,7 @@ INLINE int CPUUpdateTicks (void)
           graphics.layerEnable = io_registers[REG_DISPCNT]; \
   }
 
-int CPULoadRom(const u8 *romfile, const u32 romfilelen)
+int CPULoadRom(const u8 *romfile, const u32 romfilelen, const bool mirroring)
 {
 	if (cpuIsMultiBoot)
 	{
@@ -9024,19 +9033,44 @@ int CPULoadRom(const u8 *romfile, const u32 romfilelen)
 			return 0;
 	}
 
-	uint8_t *whereToLoad = cpuIsMultiBoot ? workRAM : rom;
-	
-	memcpy(whereToLoad, romfile, romfilelen);
 	romSize = romfilelen;
 
-	uint16_t *temp = (uint16_t *)(rom+((romSize+1)&~1));
-	int i;
-	for(i = (romSize+1)&~1; i < 0x2000000; i+=2) {
-		WRITE16LE(temp, (i >> 1) & 0xFFFF);
-		temp++;
-	}
+	// the whole 32MB image, mirroring included, is built once and then shared
+	// read only with every other instance that loads the same rom
+	romOwner = romimage::Registry::acquire(romfile, romfilelen, mirroring, 0x2000000, [&](uint8_t *image)
+	{
+		rom = image;
+
+		uint8_t *whereToLoad = cpuIsMultiBoot ? workRAM : rom;
+	
+		memcpy(whereToLoad, romfile, romfilelen);
+
+		uint16_t *temp = (uint16_t *)(rom+((romSize+1)&~1));
+		int i;
+		for(i = (romSize+1)&~1; i < 0x2000000; i+=2) {
+			WRITE16LE(temp, (i >> 1) & 0xFFFF);
+			temp++;
+		}
 
+		// what is this?
+		if(romSize < 0x1fe2000) {
+			*((uint16_t *)&rom[0x1fe209c]) = 0xdffa; // SWI 0xFA
+			*((uint16_t *)&rom[0x1fe209e]) = 0x4770; // BX LR
+		}
 
+		doMirroring(mirroring);
+	});
+	rom = romOwner.get();
+	if (!rom)
+		return 0;
+
+	CPUInitBuffers();
+
+	return romSize;
+}
+
+void CPUInitBuffers()
+{
 	flashInit();
 	eepromInit();
 
@@ -9044,8 +9078,6 @@ int CPULoadRom(const u8 *romfile, const u32 romfilelen)
 	memset(line[1], -1, 240 * sizeof(u32));
 	memset(line[2], -1, 240 * sizeof(u32));
 	memset(line[3], -1, 240 * sizeof(u32));
-
-	return romSize;
 }
 
 void doMirroring (bool b)
@@ -12214,12 +12246,6 @@ void CPUInit(const u8 *biosfile, const u32 biosfilelen)
 	for(i = 0x304; i < 0x400; i++)
 		ioReadable[i] = false;
 
-	// what is this?
-	if(romSize < 0x1fe2000) {
-		*((uint16_t *)&rom[0x1fe209c]) = 0xdffa; // SWI 0xFA
-		*((uint16_t *)&rom[0x1fe209e]) = 0x4770; // BX LR
-	}
-
 	graphics.layerEnable = 0xff00;
 	graphics.layerEnableDelay = 1;
 	io_registers[REG_DISPCNT] = 0x0080;
@@ -12934,6 +12960,8 @@ void Gigazoid_Init()
 	eepromInUse = false;
 	eepromSize = 512;
 
+	saveRamGeneration = 0;
+
 	// this is constant now
 	// soundSampleRate    = 22050;
 
@@ -12957,6 +12985,7 @@ u32 *systemVideoFrameDest;
 u32 *systemVideoFramePalette;
 s16 *systemAudioFrameDest;
 int *systemAudioFrameSamp;
+bool systemFrameDrawn;
 bool lagged;
 
 void (*scanlineCallback)();
@@ -12969,31 +12998,42 @@ void (*traceCallback)(u32 addr, u32 opcode);
 
 void (*padCallback)();
 
+FrontEndSettings frontEndSettings; // as given to LoadRom(), for Clone()
+NewStateCopier copier; // reused by CopyFrom()
+
 void systemDrawScreen (void)
 {
-	// upconvert 555->888 (TODO: BETTER)
-	for (int i = 0; i < 240 * 160; i++)
+	// no destination means the frame is being skipped
+	if (systemVideoFrameDest)
 	{
-		u32 input = pix[i];
-		/*
-		u32 output = 0xff000000 |
-			input << 9 & 0xf80000 |
-			input << 6 & 0xf800 |
-			input << 3 & 0xf8;
-		*/
-		u32 output = systemVideoFramePalette[input];
-		systemVideoFrameDest[i] = output;
+		// upconvert 555->888 (TODO: BETTER)
+		for (int i = 0; i < 240 * 160; i++)
+		{
+			u32 input = pix[i];
+			/*
+			u32 output = 0xff000000 |
+				input << 9 & 0xf80000 |
+				input << 6 & 0xf800 |
+				input << 3 & 0xf8;
+			*/
+			u32 output = systemVideoFramePalette[input];
+			systemVideoFrameDest[i] = output;
+		}
 	}
 	systemVideoFrameDest = nullptr;
 	systemVideoFramePalette = nullptr;
+	systemFrameDrawn = true;
 }
 
 // called at regular intervals on sound clock
 void systemOnWriteDataToSoundBuffer(int16_t * finalWave, int length)
 {
-	memcpy(systemAudioFrameDest, finalWave, length * 2);
+	if (systemAudioFrameDest)
+	{
+		memcpy(systemAudioFrameDest, finalWave, length * 2);
+		*systemAudioFrameSamp = length / 2;
+	}
 	systemAudioFrameDest = nullptr;
-	*systemAudioFrameSamp = length / 2;
 	systemAudioFrameSamp = nullptr;
 }
 
@@ -13237,6 +13277,9 @@ template<bool isReader>void SyncState(NewState *ns)
 	// address_lut; // values never change
 	
 	NSS(lagged);
+
+	if (isReader)
+		saveRamGeneration++;
 }
 
 // load a legacy battery ram file to a place where it might work, who knows
@@ -13249,6 +13292,7 @@ void LoadLegacyBatteryRam(const char *data, int len)
 		// can salvage broken pokeymans saves in some cases
 		std::memcpy(flashSaveMemory + 0x10000, data, std::min<int>(len, 0x10000));
 	}
+	saveRamGeneration++;
 }
 
 bool HasBatteryRam()
@@ -13277,6 +13321,26 @@ int BatteryRamSize()
 	}
 }
 
+u32 SaveRamGeneration() const
+{
+	return saveRamGeneration;
+}
+
+// the memory SaveLegacyBatteryRam() copies from, BatteryRamSize() bytes of it
+const u8 *BatteryRamDirect() const
+{
+	switch (cpuSaveType)
+	{
+	case 1:
+	case 4: // eeprom
+		return eepromData;
+	case 5: // none
+		return nullptr;
+	default:
+		return flashSaveMemory;
+	}
+}
+
 void SaveLegacyBatteryRam(char *dest)
 {
 	switch (cpuSaveType)
@@ -13355,6 +13419,8 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 	PSS(flashSaveMemory, flashFileSize);
 	PSS(eepromData, eepromFileSize);
 
+	if (isReader)
+		saveRamGeneration++;
 	return true;
 }
 
@@ -13372,9 +13438,53 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 		if (biosfilelen != 16384)
 			return false;
 
-		if (!CPULoadRom(romfile, romfilelen))
+		if (!CPULoadRom(romfile, romfilelen, settings.mirroringEnable))
 			return false;
 
+		ApplySettings(settings);
+
+		CPUInit(biosfile, biosfilelen);
+		CPUReset();
+		
+		// CPUReset already calls this, but if that were to change
+		// soundReset();
+		
+		return true;
+	}
+
+	// an independent instance sharing this one's rom, starting from its current state.
+	// frontend callbacks are not carried over
+	Gigazoid *Clone()
+	{
+		Gigazoid *g = new Gigazoid();
+		g->romOwner = romOwner;
+		g->rom = rom;
+		g->romSize = romSize;
+		g->CPUInitBuffers();
+		g->ApplySettings(frontEndSettings);
+		g->CPUInit(bios, sizeof(bios));
+		g->CPUReset();
+		g->CopyFrom(*this);
+		return g;
+	}
+
+	// copy the complete emulation state of another instance running the same game
+	// directly into this one, without going through a savestate buffer
+	bool CopyFrom(Gigazoid &src)
+	{
+		if (!rom || !src.rom || romSize != src.romSize || cpuSaveType != src.cpuSaveType)
+			return false;
+
+		copier.Rewind();
+		src.SyncState<false>(&copier);
+		SyncState<true>(&copier);
+		return !copier.Mismatch();
+	}
+
+	void ApplySettings(const FrontEndSettings &settings)
+	{
+		frontEndSettings = settings;
+
 		cpuSaveType = settings.cpuSaveType;
 		flashSize = settings.flashSize;
 		rtcEnabled = settings.enableRtc;
@@ -13400,16 +13510,6 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 			flashDeviceID = 0x13; //0x09;
 			flashManufacturerID = 0x62; //0xc2;
 		}
-
-		doMirroring(mirroringEnable);
-
-		CPUInit(biosfile, biosfilelen);
-		CPUReset();
-		
-		// CPUReset already calls this, but if that were to change
-		// soundReset();
-		
-		return true;
 	}
 
 	void Reset()
@@ -13424,15 +13524,101 @@ template<bool isReader>bool SyncBatteryRam(NewState *ns)
 		systemVideoFramePalette = videopalette;
 		systemAudioFrameDest = audiobuffer;
 		systemAudioFrameSamp = numsamp;
+		systemFrameDrawn = false;
 		lagged = true;
 		UpdateJoypad();
 		do
 		{
 			CPULoop();
-		} while (systemVideoFrameDest);
+		} while (!systemFrameDrawn);
 		return lagged;
 	}
 
+	// dest receives one record per frame: u32 flags (1 = lagged, 2 = sound didn't fit), u32 HashRam()
+	// and then the bytes of each ram range, padded to a multiple of 4.  only the last frame goes to
+	// videobuffer.  returns the number of frames run, or -1 if the ram ranges or dest are bad
+	int AdvanceBatch(const int *input, int nframes, int flags, const BatchRam *ram, int nram, u8 *dest, int destsize,
+		u32 *videobuffer, u32 *videopalette, s16 *audiobuffer, int *numsamp)
+	{
+		auto records = framebatch::writer(ram, nram, [this](int area, const u8 *&data, int &size)
+		{
+			u8 *p = nullptr;
+			bool ret = GetMemoryArea(area, p, size);
+			data = p;
+			return ret;
+		});
+		if (!records.fits(nframes, destsize))
+			return -1;
+
+		if (flags & BATCH_NOAUDIO)
+			audiobuffer = nullptr;
+		const int audiomax = audiobuffer ? *numsamp : 0;
+		int audiopos = 0;
+
+		for (int n = 0; n < nframes; n++)
+		{
+			bool novideo = flags & BATCH_NOVIDEO || n < nframes - 1;
+			u32 frameflags = 0;
+			if (audiobuffer)
+			{
+				// a frame of sound is never more than soundFinalWave holds.  when that much doesn't fit in
+				// audiobuffer, it goes to scratch first: the sound flush copies out of soundFinalWave itself
+				s16 scratch[sizeof soundFinalWave / sizeof soundFinalWave[0]];
+				int count = 0;
+				s16 *out = audiobuffer + audiopos * 2;
+				bool direct = (audiomax - audiopos) * 2 >= (int)(sizeof scratch / sizeof scratch[0]);
+				frameflags = FrameAdvance(input[n], novideo ? nullptr : videobuffer, direct ? out : scratch,
+					&count, novideo ? nullptr : videopalette);
+				if (!direct)
+				{
+					if (count > audiomax - audiopos)
+					{
+						count = audiomax - audiopos;
+						frameflags |= framebatch::audio_overflow;
+					}
+					memcpy(out, scratch, count * 4);
+				}
+				audiopos += count;
+			}
+			else
+			{
+				frameflags = FrameAdvance(input[n], novideo ? nullptr : videobuffer, nullptr, nullptr, novideo ? nullptr : videopalette);
+			}
+
+			dest = records.write(dest, frameflags, flags & BATCH_NOHASH ? 0 : HashRam());
+		}
+
+		if (numsamp)
+			*numsamp = audiopos;
+		return nframes;
+	}
+
+	u32 HashRam()
+	{
+		return framebatch::hash(workRAM, 0x40000, framebatch::hash(internalRAM, 0x8000));
+	}
+
+	bool GetMemoryArea(int area, u8 *&data, int &size)
+	{
+		MemoryAreas mem;
+		memset(&mem, 0, sizeof mem);
+		FillMemoryAreas(mem);
+		switch (area)
+		{
+			case 0: data = (u8 *)mem.iwram; size = 0x8000; break;
+			case 1: data = (u8 *)mem.ewram; size = 0x40000; break;
+			case 2: data = (u8 *)mem.bios; size = 0x4000; break;
+			case 3: data = (u8 *)mem.palram; size = 0x400; break;
+			case 4: data = (u8 *)mem.vram; size = 0x18000; break;
+			case 5: data = (u8 *)mem.oam; size = 0x400; break;
+			case 6: data = (u8 *)mem.rom; size = 0x2000000; break;
+			case 7: data = (u8 *)mem.sram; size = mem.sram_size; break;
+			case 8: data = (u8 *)mem.mmio; size = 0x400; break;
+			default: return false;
+		}
+		return data != nullptr;
+	}
+
 	void FillMemoryAreas(MemoryAreas &mem)
 	{
 		mem.bios = bios;
@@ -13555,6 +13741,16 @@ EXPORT int LoadRom(Gigazoid *g, const u8 *romfile, const u32 romfilelen, const u
 	return g->LoadRom(romfile, romfilelen, biosfile, biosfilelen, *settings);
 }
 
+EXPORT Gigazoid *Clone(Gigazoid *g)
+{
+	return g->Clone();
+}
+
+EXPORT int CopyInto(Gigazoid *dst, Gigazoid *src)
+{
+	return dst->CopyFrom(*src);
+}
+
 EXPORT void Reset(Gigazoid *g)
 {
 	// TODO: this calls a soundreset that seems to remake some buffers.  that seems like it should be fixed?
@@ -13566,6 +13762,12 @@ EXPORT int FrameAdvance(Gigazoid *g, int input, u32 *videobuffer, s16 *audiobuff
 	return g->FrameAdvance(input, videobuffer, audiobuffer, numsamp, videopalette);
 }
 
+EXPORT int AdvanceBatch(Gigazoid *g, const int *input, int nframes, int flags, const BatchRam *ram, int nram, u8 *dest, int destsize,
+	u32 *videobuffer, u32 *videopalette, s16 *audiobuffer, int *numsamp)
+{
+	return g->AdvanceBatch(input, nframes, flags, ram, nram, dest, destsize, videobuffer, videopalette, audiobuffer, numsamp);
+}
+
 EXPORT int SaveRamSize(Gigazoid *g)
 {
 	/*
@@ -13601,6 +13803,14 @@ EXPORT int SaveRamSave(Gigazoid *g, char *data, int length)
 	return true;
 }
 
+// the battery ram in place, as SaveRamSave() would copy it, and a count that changes whenever it may have been written
+EXPORT const u8 *SaveRamDirect(Gigazoid *g, int *length, u32 *generation)
+{
+	*length = g->HasBatteryRam() ? g->BatteryRamSize() : 0;
+	*generation = g->SaveRamGeneration();
+	return g->BatteryRamDirect();
+}
+
 EXPORT int SaveRamLoad(Gigazoid *g, const char *data, int length)
 {
 	if (g->HasBatteryRam())
@@ -13644,6 +13854,40 @@ EXPORT int BinStateLoad(Gigazoid *g, const char *data, int length)
 	return !loader.Overflow() && loader.GetLength() == length;
 }
 
+// hash of the complete state, equal to XXH64 of what BinStateSave writes.
+// cb, if not null, receives a hash for each section as well
+EXPORT uint64_t StateHash(Gigazoid *g, NewStateHasher::SectionCallback cb)
+{
+	NewStateHasher hasher(cb);
+	g->SyncState<false>(&hasher);
+	return hasher.GetHash();
+}
+
+// an indexed state: the same data as BinStateSave, after a table of its sections and
+// larger fields.  a load leaves the fields named in skip as they are
+EXPORT int IndexedStateSize(Gigazoid *g)
+{
+	NewStateIndexedWriter writer;
+	g->SyncState<false>(&writer);
+	return writer.GetLength();
+}
+
+EXPORT int IndexedStateSave(Gigazoid *g, char *data, int length)
+{
+	NewStateIndexedWriter writer;
+	g->SyncState<false>(&writer);
+	return writer.Write(data, length);
+}
+
+EXPORT int IndexedStateLoad(Gigazoid *g, const char *data, int length, const char *const *skip, int skipcount)
+{
+	NewStateIndexedReader loader(data, length);
+	for (int i = 0; i < skipcount; i++)
+		loader.Skip(skip[i]);
+	g->SyncState<true>(&loader);
+	return loader.Done();
+}
+
 EXPORT void TxtStateSave(Gigazoid *g, FPtrs *ff)
 {
 	NewStateExternalFunctions saver(ff);
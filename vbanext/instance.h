@@ -1,6 +1,8 @@
 #ifndef INSTANCE_H
 #define INSTANCE_H
 
+#include "framebatch.h"
+
 struct FrontEndSettings
 {
 	int cpuSaveType; // [0auto] 1eeprom 2sram 3flash 4eeprom+sensor 5none
@@ -34,6 +36,17 @@ struct MemoryAreas
 	uint32_t sram_size;
 };
 
+// one range of memory sampled after every frame of a batch advance
+// area: 0 iwram, 1 ewram, 2 bios, 3 palram, 4 vram, 5 oam, 6 rom, 7 sram, 8 mmio
+typedef framebatch::Range BatchRam;
+
+enum
+{
+	BATCH_NOVIDEO = 1, // don't render the last frame of the batch either
+	BATCH_NOAUDIO = 2,
+	BATCH_NOHASH = 4
+};
+
 #define FLASH_128K_SZ 0x20000
 
 #define EEPROM_IDLE           0
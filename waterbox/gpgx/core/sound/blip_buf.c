@@ -5,6 +5,7 @@
 /*    - fixed multiple time-frames support & removed m->avail         */
 /*    - modified blip_read_samples to always output to stereo streams */
 /*    - added blip_mix_samples function (see blip_buf.h)              */
+/*    - added batched and multi-channel functions, SSE2 synthesis     */
 
 #include "blip_buf.h"
 
@@ -15,6 +16,14 @@
 #include <string.h>
 #include <stdlib.h>
 
+/* SSE2 paths give output identical to the scalar code. Define BLIP_NO_SSE2
+to build the scalar code only. */
+#if !defined (BLIP_NO_SSE2) && (defined (__SSE2__) || defined (_M_X64) || \
+		(defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define BLIP_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 /* Library Copyright (C) 2003-2009 Shay Green. This library is free software;
 you can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -299,6 +308,162 @@ int blip_mix_samples( blip_t* m, short out [], int count)
 	return count;
 }
 
+/* Integrates samples [first, first + count) of m into every step-th element
+of out, without removing them. Same as blip_read_samples(). */
+static void integrate( blip_t* m, int first, short out [], int count, int step )
+{
+	buf_t const* in  = SAMPLES( m ) + first;
+	buf_t const* end = in + count;
+	int sum = m->integrator;
+	while ( in != end )
+	{
+		/* Eliminate fraction */
+		int s = ARITH_SHIFT( sum, delta_bits );
+		
+		sum += *in++;
+		
+		CLAMP( s );
+		
+		*out = s;
+		out += step;
+		
+		/* High-pass filter */
+		sum -= s << (delta_bits - bass_shift);
+	}
+	m->integrator = sum;
+}
+
+/* Same as integrate(), but adds to the previous value of out like
+blip_mix_samples() */
+static void integrate_mix( blip_t* m, int first, short out [], int count, int step )
+{
+	buf_t const* in  = SAMPLES( m ) + first;
+	buf_t const* end = in + count;
+	int sum = m->integrator;
+	while ( in != end )
+	{
+		/* Eliminate fraction */
+		int s = ARITH_SHIFT( sum, delta_bits );
+		
+		sum += *in++;
+		
+		/* High-pass filter */
+		sum -= s << (delta_bits - bass_shift);
+		
+		/* Add current buffer value */
+		s += *out;
+		
+		CLAMP( s );
+		
+		*out = s;
+		out += step;
+	}
+	m->integrator = sum;
+}
+
+#ifdef BLIP_SSE2
+/* Integrates the first count & ~3 samples of a stereo pair with both channels
+side by side in one register, and writes them interleaved. The integrator is a
+serial recurrence, so channels are the only thing to run in parallel. Returns
+number of samples done. */
+static int integrate_stereo( blip_t* left, blip_t* right, short out [], int count, int mix )
+{
+	buf_t const* inl = SAMPLES( left );
+	buf_t const* inr = SAMPLES( right );
+	__m128i sum = _mm_setr_epi32( left->integrator, right->integrator, 0, 0 );
+	int i;
+	
+	for ( i = 0; i + 4 <= count; i += 4 )
+	{
+		__m128i l = _mm_loadu_si128( (__m128i const*) (inl + i) );
+		__m128i r = _mm_loadu_si128( (__m128i const*) (inr + i) );
+		__m128i* p = (__m128i*) (out + i * 2);
+		__m128i in [4];
+		__m128i s [4];
+		__m128i s01, s23;
+		int j;
+		
+		in [0] = _mm_unpacklo_epi32( l, r );
+		in [1] = _mm_srli_si128( in [0], 8 );
+		in [2] = _mm_unpackhi_epi32( l, r );
+		in [3] = _mm_srli_si128( in [2], 8 );
+		
+		for ( j = 0; j < 4; j++ )
+		{
+			__m128i t = _mm_srai_epi32( sum, delta_bits );
+			if ( !mix )
+			{
+				/* blip_read_samples() filters the clamped sample */
+				t = _mm_packs_epi32( t, t );
+				t = _mm_srai_epi32( _mm_unpacklo_epi16( t, t ), 16 );
+			}
+			s [j] = t;
+			sum = _mm_add_epi32( sum, in [j] );
+			sum = _mm_sub_epi32( sum, _mm_slli_epi32( t, delta_bits - bass_shift ) );
+		}
+		
+		s01 = _mm_unpacklo_epi64( s [0], s [1] );
+		s23 = _mm_unpacklo_epi64( s [2], s [3] );
+		if ( mix )
+		{
+			__m128i o = _mm_loadu_si128( p );
+			s01 = _mm_add_epi32( s01, _mm_srai_epi32( _mm_unpacklo_epi16( o, o ), 16 ) );
+			s23 = _mm_add_epi32( s23, _mm_srai_epi32( _mm_unpackhi_epi16( o, o ), 16 ) );
+		}
+		
+		/* CLAMP by saturating */
+		_mm_storeu_si128( p, _mm_packs_epi32( s01, s23 ) );
+	}
+	
+	left->integrator  = _mm_cvtsi128_si32( sum );
+	right->integrator = _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) );
+	return i;
+}
+#endif
+
+static int read_multi( blip_t* const bufs [], int channels, short out [], int count, int mix )
+{
+	int c, done = 0;
+	
+#ifdef BLIP_ASSERT
+	assert( channels > 0 && count >= 0 );
+	
+	if ( count > (bufs [0]->offset >> time_bits) )
+		count = bufs [0]->offset >> time_bits;
+#endif
+	
+#ifdef BLIP_SSE2
+	if ( channels == 2 )
+		done = integrate_stereo( bufs [0], bufs [1], out, count, mix );
+#endif
+	
+	for ( c = 0; c < channels; c++ )
+	{
+#ifdef BLIP_ASSERT
+		assert( bufs [c]->offset == bufs [0]->offset );
+#endif
+		if ( mix )
+			integrate_mix( bufs [c], done, out + done * channels + c, count - done, channels );
+		else
+			integrate( bufs [c], done, out + done * channels + c, count - done, channels );
+	}
+	
+	for ( c = 0; c < channels; c++ )
+		remove_samples( bufs [c], count );
+	
+	return count;
+}
+
+int blip_read_samples_multi( blip_t* const bufs [], int channels, short out [], int count )
+{
+	return read_multi( bufs, channels, out, count, 0 );
+}
+
+int blip_mix_samples_multi( blip_t* const bufs [], int channels, short out [], int count )
+{
+	return read_multi( bufs, channels, out, count, 1 );
+}
+
 /* Things that didn't help performance on x86:
 	__attribute__((aligned(128)))
 	#define short int
@@ -348,25 +513,69 @@ possibly-wider fixed_t. On 32-bit platforms, this is likely more efficient.
 And by having pre_shift 32, a 32-bit platform can easily do the shift by
 simply ignoring the low half. */
 
-void blip_add_delta( blip_t* m, unsigned time, int delta )
+enum { phase_shift = frac_bits - phase_bits };
+
+#ifdef BLIP_SSE2
+
+/* Step of one phase, as (in [i], in [half_width+i]) pairs of 16-bit
+coefficients for each of the 16 outputs, ready for _mm_madd_epi16 */
+typedef struct kernel_t
 {
-	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
-	buf_t* out = SAMPLES( m ) + (fixed >> frac_bits);
-	
-	int const phase_shift = frac_bits - phase_bits;
-	int phase = fixed >> phase_shift & (phase_count - 1);
-	short const* in  = bl_step [phase];
-	short const* rev = bl_step [phase_count - phase];
+	__m128i k [4];
+} kernel_t;
+
+static void make_kernel( kernel_t* k, int phase )
+{
+	__m128i in   = _mm_loadu_si128( (__m128i const*) bl_step [phase] );
+	__m128i next = _mm_loadu_si128( (__m128i const*) bl_step [phase + 1] );
+	__m128i rev  = _mm_loadu_si128( (__m128i const*) bl_step [phase_count - phase] );
+	__m128i prev = _mm_loadu_si128( (__m128i const*) bl_step [phase_count - phase - 1] );
 	
-	int interp = fixed >> (phase_shift - delta_bits) & (delta_unit - 1);
-	int delta2 = (delta * interp) >> delta_bits;
-	delta -= delta2;
+	k->k [0] = _mm_unpacklo_epi16( in, next );
+	k->k [1] = _mm_unpackhi_epi16( in, next );
+	k->k [2] = _mm_shuffle_epi32( _mm_unpackhi_epi16( rev, prev ), 0x1B );
+	k->k [3] = _mm_shuffle_epi32( _mm_unpacklo_epi16( rev, prev ), 0x1B );
+}
+
+static void add_kernel( buf_t* out, kernel_t const* k, int delta, int delta2 )
+{
+	/* Deltas are split into signed 16-bit halves so every product fits
+	_mm_madd_epi16. Shifting the high half back up wraps exactly as the
+	scalar multiply does. */
+	unsigned lo = (delta  & 0xFFFF) | (unsigned) (delta2 & 0xFFFF) << 16;
+	unsigned hi = (((unsigned) delta  + 0x8000) >> 16 & 0xFFFF) |
+			(((unsigned) delta2 + 0x8000) >> 16) << 16;
+	__m128i dlo = _mm_set1_epi32( (int) lo );
+	__m128i dhi = _mm_set1_epi32( (int) hi );
+	int i;
 	
-#ifdef BLIP_ASSERT
-	/* Fails if buffer size was exceeded */
-	assert( out <= &SAMPLES( m ) [m->size + end_frame_extra] );
-#endif
+	for ( i = 0; i < 4; i++ )
+	{
+		__m128i* p = (__m128i*) out + i;
+		__m128i sum = _mm_add_epi32( _mm_madd_epi16( k->k [i], dlo ),
+				_mm_slli_epi32( _mm_madd_epi16( k->k [i], dhi ), 16 ) );
+		_mm_storeu_si128( p, _mm_add_epi32( _mm_loadu_si128( p ), sum ) );
+	}
+}
+
+#else
+
+typedef struct kernel_t
+{
+	short const* in;
+	short const* rev;
+} kernel_t;
 
+static void make_kernel( kernel_t* k, int phase )
+{
+	k->in  = bl_step [phase];
+	k->rev = bl_step [phase_count - phase];
+}
+
+static void add_kernel( buf_t* out, kernel_t const* k, int delta, int delta2 )
+{
+	short const* in = k->in;
+	
 	out [0] += in[0]*delta + in[half_width+0]*delta2;
 	out [1] += in[1]*delta + in[half_width+1]*delta2;
 	out [2] += in[2]*delta + in[half_width+2]*delta2;
@@ -376,7 +585,7 @@ void blip_add_delta( blip_t* m, unsigned time, int delta )
 	out [6] += in[6]*delta + in[half_width+6]*delta2;
 	out [7] += in[7]*delta + in[half_width+7]*delta2;
 	
-	in = rev;
+	in = k->rev;
 	out [ 8] += in[7]*delta + in[7-half_width]*delta2;
 	out [ 9] += in[6]*delta + in[6-half_width]*delta2;
 	out [10] += in[5]*delta + in[5-half_width]*delta2;
@@ -387,7 +596,30 @@ void blip_add_delta( blip_t* m, unsigned time, int delta )
 	out [15] += in[0]*delta + in[0-half_width]*delta2;
 }
 
-void blip_add_delta_fast( blip_t* m, unsigned time, int delta )
+#endif
+
+static void add_delta( blip_t* m, unsigned time, int delta )
+{
+	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
+	buf_t* out = SAMPLES( m ) + (fixed >> frac_bits);
+	
+	int phase = fixed >> phase_shift & (phase_count - 1);
+	kernel_t k;
+	
+	int interp = fixed >> (phase_shift - delta_bits) & (delta_unit - 1);
+	int delta2 = (delta * interp) >> delta_bits;
+	delta -= delta2;
+	
+#ifdef BLIP_ASSERT
+	/* Fails if buffer size was exceeded */
+	assert( out <= &SAMPLES( m ) [m->size + end_frame_extra] );
+#endif
+
+	make_kernel( &k, phase );
+	add_kernel( out, &k, delta, delta2 );
+}
+
+static void add_delta_fast( blip_t* m, unsigned time, int delta )
 {
 	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
 	buf_t* out = SAMPLES( m ) + (fixed >> frac_bits);
@@ -403,3 +635,87 @@ void blip_add_delta_fast( blip_t* m, unsigned time, int delta )
 	out [7] += delta * delta_unit - delta2;
 	out [8] += delta2;
 }
+
+void blip_add_delta( blip_t* m, unsigned time, int delta )
+{
+	add_delta( m, time, delta );
+}
+
+void blip_add_delta_fast( blip_t* m, unsigned time, int delta )
+{
+	add_delta_fast( m, time, delta );
+}
+
+void blip_add_deltas( blip_t* m, unsigned const times [], int const deltas [], int count )
+{
+	int i;
+	for ( i = 0; i < count; i++ )
+		add_delta( m, times [i], deltas [i] );
+}
+
+void blip_add_deltas_fast( blip_t* m, unsigned const times [], int const deltas [], int count )
+{
+	int i;
+	for ( i = 0; i < count; i++ )
+		add_delta_fast( m, times [i], deltas [i] );
+}
+
+/* The step's position and phase depend only on time and the rate settings,
+which are the same for every buffer, so they're worked out once */
+
+void blip_add_delta_multi( blip_t* const bufs [], int channels, unsigned time, int const deltas [] )
+{
+	blip_t const* m = bufs [0];
+	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
+	int pos = fixed >> frac_bits;
+	
+	int phase = fixed >> phase_shift & (phase_count - 1);
+	int interp = fixed >> (phase_shift - delta_bits) & (delta_unit - 1);
+	kernel_t k;
+	int c;
+	
+#ifdef BLIP_ASSERT
+	/* Fails if buffer size was exceeded */
+	assert( pos <= m->size + end_frame_extra );
+#endif
+
+	make_kernel( &k, phase );
+	for ( c = 0; c < channels; c++ )
+	{
+		int delta  = deltas [c];
+		int delta2 = (delta * interp) >> delta_bits;
+		
+#ifdef BLIP_ASSERT
+		assert( bufs [c]->factor == m->factor && bufs [c]->offset == m->offset );
+#endif
+		add_kernel( SAMPLES( bufs [c] ) + pos, &k, delta - delta2, delta2 );
+	}
+}
+
+void blip_add_delta_fast_multi( blip_t* const bufs [], int channels, unsigned time, int const deltas [] )
+{
+	blip_t const* m = bufs [0];
+	unsigned fixed = (unsigned) ((time * m->factor + m->offset) >> pre_shift);
+	int pos = fixed >> frac_bits;
+	
+	int interp = fixed >> (frac_bits - delta_bits) & (delta_unit - 1);
+	int c;
+	
+#ifdef BLIP_ASSERT
+	/* Fails if buffer size was exceeded */
+	assert( pos <= m->size + end_frame_extra );
+#endif
+
+	for ( c = 0; c < channels; c++ )
+	{
+		buf_t* out = SAMPLES( bufs [c] ) + pos;
+		int delta  = deltas [c];
+		int delta2 = delta * interp;
+		
+#ifdef BLIP_ASSERT
+		assert( bufs [c]->factor == m->factor && bufs [c]->offset == m->offset );
+#endif
+		out [7] += delta * delta_unit - delta2;
+		out [8] += delta2;
+	}
+}
@@ -34,6 +34,26 @@ void blip_add_delta( blip_t*, unsigned int clock_time, int delta );
 /** Same as blip_add_delta(), but uses faster, lower-quality synthesis. */
 void blip_add_delta_fast( blip_t*, unsigned int clock_time, int delta );
 
+/** Adds 'count' deltas, each at the clock time with the same index. Same as
+calling blip_add_delta() for each in turn. */
+void blip_add_deltas( blip_t*, unsigned int const clock_times [],
+		int const deltas [], int count );
+
+/** Same as blip_add_deltas(), but uses faster, lower-quality synthesis. */
+void blip_add_deltas_fast( blip_t*, unsigned int const clock_times [],
+		int const deltas [], int count );
+
+/** Adds deltas [i] to bufs [i] for each of 'channels' buffers, all at the same
+clock time. The buffers must have the same rates and have been cleared, ended
+and read together, such as the left and right buffers of a stereo stream. Same
+as calling blip_add_delta() on each, but the step is only worked out once. */
+void blip_add_delta_multi( blip_t* const bufs [], int channels,
+		unsigned int clock_time, int const deltas [] );
+
+/** Same as blip_add_delta_multi(), but uses faster, lower-quality synthesis. */
+void blip_add_delta_fast_multi( blip_t* const bufs [], int channels,
+		unsigned int clock_time, int const deltas [] );
+
 /** Length of time frame, in clocks, needed to make sample_count additional
 samples available. */
 int blip_clocks_needed( const blip_t*, int sample_count );
@@ -60,6 +80,15 @@ int blip_read_samples( blip_t*, short out [], int count);
 /* This allows easy mixing of different blip buffers into a single output stream */
 int blip_mix_samples( blip_t* m, short out [], int count);
 
+/** Reads and removes 'count' samples from each of 'channels' buffers kept in
+step as for blip_add_delta_multi(), and writes them interleaved to 'out',
+sample i of bufs [c] going to out [i*channels + c]. With two channels, gives
+the same output as blip_read_samples() on each. Returns 'count'. */
+int blip_read_samples_multi( blip_t* const bufs [], int channels, short out [], int count);
+
+/* Same as above function except samples are added to output buffer previous values */
+int blip_mix_samples_multi( blip_t* const bufs [], int channels, short out [], int count);
+
 /** Frees buffer. No effect if NULL is passed. */
 void blip_delete( blip_t* );
 
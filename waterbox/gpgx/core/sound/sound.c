@@ -123,7 +123,7 @@ void sound_reset(void)
 
 int sound_update(unsigned int cycles)
 {
-  int delta, preamp, time, l, r, *ptr;
+  int delta[2], preamp, time, l, r, *ptr;
 
   /* Run PSG & FM chips until end of frame */
   SN76489_Update(cycles);
@@ -149,14 +149,15 @@ int sound_update(unsigned int cycles)
     do
     {
       /* left channel */
-      delta = ((*ptr++ * preamp) / 100) - l;
-      l += delta;
-      blip_add_delta(snd.blips[0][0], time, delta);
+      delta[0] = ((*ptr++ * preamp) / 100) - l;
+      l += delta[0];
 
       /* right channel */
-      delta = ((*ptr++ * preamp) / 100) - r;
-      r += delta;
-      blip_add_delta(snd.blips[0][1], time, delta);
+      delta[1] = ((*ptr++ * preamp) / 100) - r;
+      r += delta[1];
+
+      /* both channels in one pass */
+      blip_add_delta_multi(snd.blips[0], 2, time, delta);
 
       /* increment time counter */
       time += fm_cycles_ratio;
@@ -169,14 +170,15 @@ int sound_update(unsigned int cycles)
     do
     {
       /* left channel */
-      delta = ((*ptr++ * preamp) / 100) - l;
-      l += delta;
-      blip_add_delta_fast(snd.blips[0][0], time, delta);
+      delta[0] = ((*ptr++ * preamp) / 100) - l;
+      l += delta[0];
 
       /* right channel */
-      delta = ((*ptr++ * preamp) / 100) - r;
-      r += delta;
-      blip_add_delta_fast(snd.blips[0][1], time, delta);
+      delta[1] = ((*ptr++ * preamp) / 100) - r;
+      r += delta[1];
+
+      /* both channels in one pass */
+      blip_add_delta_fast_multi(snd.blips[0], 2, time, delta);
 
       /* increment time counter */
       time += fm_cycles_ratio;
@@ -212,8 +212,7 @@ int audio_update(int16 *buffer)
 
   /* resample FM & PSG mixed stream to output buffer */
 #ifdef LSB_FIRST
-  blip_read_samples(snd.blips[0][0], buffer, size);
-  blip_read_samples(snd.blips[0][1], buffer + 1, size);
+  blip_read_samples_multi(snd.blips[0], 2, buffer, size);
 #else
   blip_read_samples(snd.blips[0][0], buffer + 1, size);
   blip_read_samples(snd.blips[0][1], buffer, size);
@@ -224,10 +223,8 @@ int audio_update(int16 *buffer)
   {
     /* resample PCM & CD-DA streams to output buffer */
 #ifdef LSB_FIRST
-    blip_mix_samples(snd.blips[1][0], buffer, size);
-    blip_mix_samples(snd.blips[1][1], buffer + 1, size);
-    blip_mix_samples(snd.blips[2][0], buffer, size);
-    blip_mix_samples(snd.blips[2][1], buffer + 1, size);
+    blip_mix_samples_multi(snd.blips[1], 2, buffer, size);
+    blip_mix_samples_multi(snd.blips[2], 2, buffer, size);
 #else
     blip_mix_samples(snd.blips[1][0], buffer + 1, size);
     blip_mix_samples(snd.blips[1][1], buffer, size);
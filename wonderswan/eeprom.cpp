@@ -146,14 +146,14 @@ namespace MDFN_IEN_WSWAN
 	{
 		switch(A)
 		{
-		case 0xBA: iEEPROM[(iEEPROM_Address << 1) & 0x3FF] = V; break;
-		case 0xBB: iEEPROM[((iEEPROM_Address << 1) | 1) & 0x3FF] = V; break;
+		case 0xBA: iEEPROM[(iEEPROM_Address << 1) & 0x3FF] = V; sys->saveramgeneration++; break;
+		case 0xBB: iEEPROM[((iEEPROM_Address << 1) | 1) & 0x3FF] = V; sys->saveramgeneration++; break;
 		case 0xBC: iEEPROM_Address &= 0xFF00; iEEPROM_Address |= (V << 0); break;
 		case 0xBD: iEEPROM_Address &= 0x00FF; iEEPROM_Address |= (V << 8); break;
 		case 0xBE: iEEPROM_Command = V; break;
 
-		case 0xC4: wsEEPROM[(EEPROM_Address << 1) & (eeprom_size - 1)] = V; break;
-		case 0xC5: wsEEPROM[((EEPROM_Address << 1) | 1) & (eeprom_size - 1)] = V; break;
+		case 0xC4: wsEEPROM[(EEPROM_Address << 1) & (eeprom_size - 1)] = V; sys->saveramgeneration++; break;
+		case 0xC5: wsEEPROM[((EEPROM_Address << 1) | 1) & (eeprom_size - 1)] = V; sys->saveramgeneration++; break;
 
 		case 0xC6: EEPROM_Address &= 0xFF00; EEPROM_Address |= (V << 0); break;
 		case 0xC7: EEPROM_Address &= 0x00FF; EEPROM_Address |= (V << 8); break;
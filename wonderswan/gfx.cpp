@@ -33,11 +33,24 @@ namespace MDFN_IEN_WSWAN
 	void GFX::PaletteRAMWrite(uint32 ws_offset, uint8 data)
 	{
 		ws_offset=(ws_offset&0xfffe)-0xfe00;
-		wsCols[(ws_offset>>1)>>4][(ws_offset>>1)&15] = sys->memory.wsRAM[ws_offset+0xfe00] | ((sys->memory.wsRAM[ws_offset+0xfe01]&0x0f) << 8);
+		uint32 &col = wsCols[(ws_offset>>1)>>4][(ws_offset>>1)&15];
+		uint32 newcol = sys->memory.wsRAM[ws_offset+0xfe00] | ((sys->memory.wsRAM[ws_offset+0xfe01]&0x0f) << 8);
+		if(col != newcol)
+		{
+			col = newcol;
+			if(!CacheSuspended)
+			{
+				ColorCache[(ws_offset>>1)>>4][(ws_offset>>1)&15] = ColorMap[newcol];
+				VideoGen++;
+			}
+		}
 	}
 
 	void GFX::Write(uint32 A, uint8 V)
 	{
+		if(A < 0xa0 && Read(A) != V)
+			VideoGen++; // timer registers aside, everything here can change what a scanline looks like
+
 		if(A >= 0x1C && A <= 0x1F)
 		{
 			wsColors[(A - 0x1C) * 2 + 0] = 0xF - (V & 0xf);
@@ -156,8 +169,9 @@ namespace MDFN_IEN_WSWAN
 
 		if(wsLine < 144)
 		{
-			if(!skip)
+			if(!skip && LineGen[wsLine] != VideoGen)
 			{
+				LineGen[wsLine] = VideoGen;
 				if (sys->rotate)
 					Scanline(surface + 223 * 144 + wsLine);
 				else
@@ -170,12 +184,18 @@ namespace MDFN_IEN_WSWAN
 		// Update sprite data table
 		if(wsLine == 142)
 		{
+			const uint32 oldcount = SpriteCountCache;
 			SpriteCountCache = SpriteCount;
 
 			if(SpriteCountCache > 0x80)
 				SpriteCountCache = 0x80;
 
-			memcpy(SpriteTable, &sys->memory.wsRAM[(SPRBase << 9) + (SpriteStart << 2)], SpriteCountCache << 2);
+			const uint8 *src = &sys->memory.wsRAM[(SPRBase << 9) + (SpriteStart << 2)];
+			if(SpriteCountCache != oldcount || memcmp(SpriteTable, src, SpriteCountCache << 2))
+			{
+				memcpy(SpriteTable, src, SpriteCountCache << 2);
+				VideoGen++;
+			}
 		}
 
 		if(wsLine == 144)
@@ -234,18 +254,60 @@ namespace MDFN_IEN_WSWAN
 		return ret;
 	}
 
+	void GFX::BeginFrame(uint32 *surface, bool skip)
+	{
+		if(skip)
+		{
+			// nothing is drawn until the next rendered frame, so stop maintaining the caches
+			// until then and throw them out wholesale when rendering resumes
+			CacheSuspended = true;
+		}
+		else if(CacheSuspended || surface != LastSurface || sys->rotate != LastRotate)
+		{
+			CacheSuspended = false;
+			LastSurface = surface;
+			LastRotate = sys->rotate;
+			FlushCaches();
+		}
+	}
+
+	void GFX::FlushCaches()
+	{
+		std::memset(wsTCacheUpdate, 0, sizeof(wsTCacheUpdate));
+		std::memset(wsTCacheUpdate2, 0, sizeof(wsTCacheUpdate2));
+		RefreshColorCache();
+	}
+
+	void GFX::RefreshColorCache()
+	{
+		for(int p = 0; p < 16; p++)
+			for(int c = 0; c < 16; c++)
+				ColorCache[p][c] = ColorMap[wsCols[p][c]];
+		VideoGen++;
+	}
+
 	void GFX::SetLayerEnableMask(uint32 mask)
 	{
 		LayerEnabled = mask;
+		VideoGen++;
 	}
 
 	void GFX::SetBWPalette(const uint32 *colors)
 	{
 		std::memcpy(ColorMapG, colors, sizeof(ColorMapG));
+		VideoGen++;
 	}
 	void GFX::SetColorPalette(const uint32 *colors)
 	{
 		std::memcpy(ColorMap, colors, sizeof(ColorMap));
+		RefreshColorCache();
+	}
+	void GFX::CopyOutputSettings(const GFX &src)
+	{
+		LayerEnabled = src.LayerEnabled;
+		std::memcpy(ColorMapG, src.ColorMapG, sizeof(ColorMapG));
+		std::memcpy(ColorMap, src.ColorMap, sizeof(ColorMap));
+		RefreshColorCache();
 	}
 
 	/*
@@ -551,7 +613,7 @@ namespace MDFN_IEN_WSWAN
 		{
 			for(l=0;l<224;l++)
 			{
-				target[0] = ColorMap[wsCols[b_bg_pal[l+7]][b_bg[(l+7)]&0xf]];
+				target[0] = ColorCache[b_bg_pal[l+7]][b_bg[(l+7)]&0xf];
 				target += hinc;
 			}
 		}
@@ -608,6 +670,7 @@ namespace MDFN_IEN_WSWAN
 		VBCounter = 0;
 
 		std::memset(wsCols, 0, sizeof(wsCols));
+		RefreshColorCache();
 	}
 
 	SYNCFUNC(GFX)
@@ -620,7 +683,6 @@ namespace MDFN_IEN_WSWAN
 			std::memset(wsTCacheUpdate2, 0, sizeof(wsTCacheUpdate2));
 		}
 		/*
-		NSS(tiles);
 		NSS(wsTCache);			
 		NSS(wsTCache2);			
 		NSS(wsTCacheFlipped);
@@ -677,5 +739,9 @@ namespace MDFN_IEN_WSWAN
 		NSS(VideoMode);
 
 		NSS(wsc); // mono / color
+
+		// line cache is rebuilt from the loaded palette instead of being saved
+		if (isReader)
+			RefreshColorCache();
 	}
 }
@@ -14,10 +14,10 @@ public:
 	// TCACHE ====================================
 	void InvalidByAddr(uint32);
 	void SetVideo(int, bool);
-	void MakeTiles();
 	void GetTile(uint32 number,uint32 line,int flipv,int fliph,int bank);
 	// TCACHE/====================================
 	void Scanline(uint32 *target);
+	void BeginFrame(uint32 *surface, bool skip);
 	void SetPixelFormat();
 
 	void Init(bool color);
@@ -31,10 +31,13 @@ public:
 	void SetLayerEnableMask(uint32 mask);
 	void SetBWPalette(const uint32 *colors);
 	void SetColorPalette(const uint32 *colors);
+	void CopyOutputSettings(const GFX &src);
 
 private:
+	void FlushCaches();
+	void RefreshColorCache();
+
 	// TCACHE ====================================
-	uint8	tiles[256][256][2][8];
 	uint8	wsTCache[512*64];			
 	uint8	wsTCache2[512*64];			
 	uint8	wsTCacheFlipped[512*64];
@@ -53,6 +56,15 @@ private:
 	uint32 ColorMap[16*16*16];
 	uint32 LayerEnabled;
 
+	// LINE CACHE ================================
+	uint32 ColorCache[16][16]; // ColorMap[wsCols[][]], kept current while not suspended
+	uint32 VideoGen; // bumped whenever anything a scanline reads may have changed
+	uint32 LineGen[144]; // VideoGen at the time each line was last drawn
+	uint32 *LastSurface;
+	bool LastRotate;
+	bool CacheSuspended; // set by skipped frames; caches are not maintained until the next rendered frame
+	// LINE CACHE/================================
+
 	uint8 wsLine;                 /*current scanline*/
 
 	uint8 SpriteTable[0x80][4];
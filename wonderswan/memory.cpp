@@ -37,9 +37,11 @@ namespace MDFN_IEN_WSWAN
 		if(!bank) /*RAM*/
 		{
 			sys->sound.CheckRAMWrite(offset);
-			wsRAM[offset] = V;
-
-			sys->gfx.InvalidByAddr(offset);
+			if(wsRAM[offset] != V)
+			{
+				wsRAM[offset] = V;
+				sys->gfx.InvalidByAddr(offset);
+			}
 
 			if(offset>=0xfe00) /*WSC palettes*/
 				sys->gfx.PaletteRAMWrite(offset, V);
@@ -49,6 +51,7 @@ namespace MDFN_IEN_WSWAN
 			if(sram_size)
 			{
 				wsSRAM[(offset | (BankSelector[1] << 16)) & (sram_size - 1)] = V;
+				sys->saveramgeneration++;
 			}
 		}
 	}
@@ -277,11 +280,6 @@ namespace MDFN_IEN_WSWAN
 
 	Memory::~Memory()
 	{
-		if (wsCartROM)
-		{
-			std::free(wsCartROM);
-			wsCartROM = nullptr;
-		}
 		if (wsSRAM)
 		{
 			std::free(wsSRAM);
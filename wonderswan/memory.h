@@ -2,6 +2,7 @@
 #define __WSWAN_MEMORY_H
 
 #include "system.h"
+#include <memory>
 
 namespace MDFN_IEN_WSWAN
 {
@@ -25,6 +26,7 @@ public:
 public:
 	uint8 wsRAM[65536];
 	uint8 *wsCartROM;
+	std::shared_ptr<uint8> wsCartROMOwner; // shared with any clones
 	uint32 rom_size;
 	uint32 sram_size;
 	uint8 *wsSRAM; // = NULL;
@@ -40,6 +40,198 @@ void NewStateExternalBuffer::Load(void *ptr, size_t size, const char *name)
 	length += size;
 }
 
+NewStateCopier::NewStateCopier()
+	:pos(0), mismatch(false)
+{
+}
+
+void NewStateCopier::Save(const void *ptr, size_t size, const char *name)
+{
+	Block b;
+	b.size = size;
+	if (size <= 16)
+	{
+		b.src = nullptr;
+		b.offs = smalls.size();
+		smalls.insert(smalls.end(), static_cast<const char *>(ptr), static_cast<const char *>(ptr) + size);
+	}
+	else
+	{
+		b.src = static_cast<const char *>(ptr);
+		b.offs = 0;
+	}
+	blocks.push_back(b);
+}
+
+void NewStateCopier::Load(void *ptr, size_t size, const char *name)
+{
+	if (pos >= blocks.size() || blocks[pos].size != size)
+	{
+		mismatch = true;
+		return;
+	}
+	const Block &b = blocks[pos++];
+	std::memcpy(ptr, b.src ? b.src : &smalls[b.offs], size);
+}
+
+NewStateHasher::NewStateHasher(SectionCallback sectioncb)
+	:sectioncb(sectioncb)
+{
+	xxh64_reset(&whole);
+}
+
+void NewStateHasher::Save(const void *ptr, size_t size, const char *name)
+{
+	xxh64_update(&whole, ptr, size);
+	for (size_t i = 0; i < sections.size(); i++)
+		xxh64_update(&sections[i], ptr, size);
+}
+
+void NewStateHasher::Load(void *ptr, size_t size, const char *name)
+{
+}
+
+void NewStateHasher::EnterSection(const char *name)
+{
+	if (sectioncb)
+	{
+		sections.push_back(xxh64_state());
+		xxh64_reset(&sections.back());
+	}
+}
+
+void NewStateHasher::ExitSection(const char *name)
+{
+	if (sectioncb && !sections.empty())
+	{
+		sectioncb(name, (int)sections.size(), xxh64_digest(&sections.back()));
+		sections.pop_back();
+	}
+}
+
+uint64_t NewStateHasher::Hash(const void *ptr, size_t size)
+{
+	return xxh64(ptr, size);
+}
+
+NewStateIndexedWriter::NewStateIndexedWriter()
+{
+}
+
+void NewStateIndexedWriter::AddEntry(const char *name, uint32_t kind, size_t offset, size_t size)
+{
+	IndexedStateEntry e;
+	std::memset(&e, 0, sizeof(e));
+	std::strncpy(e.name, name, sizeof(e.name) - 1);
+	e.depth = open.size() + 1;
+	e.kind = kind;
+	e.offset = offset;
+	e.size = size;
+	entries.push_back(e);
+}
+
+long NewStateIndexedWriter::GetLength() const
+{
+	return sizeof(IndexedStateHeader) + entries.size() * sizeof(IndexedStateEntry) + data.size();
+}
+
+bool NewStateIndexedWriter::Write(char *buffer, long maxlength) const
+{
+	if (maxlength != GetLength())
+		return false;
+
+	IndexedStateHeader h;
+	std::memcpy(h.magic, "EWSI", 4);
+	h.version = IndexedStateVersion;
+	h.entrycount = entries.size();
+	h.entrysize = sizeof(IndexedStateEntry);
+	h.datasize = data.size();
+	h.datahash = NewStateHasher::Hash(data.empty() ? NULL : &data[0], data.size());
+
+	std::memcpy(buffer, &h, sizeof(h));
+	buffer += sizeof(h);
+	if (!entries.empty())
+		std::memcpy(buffer, &entries[0], entries.size() * sizeof(IndexedStateEntry));
+	buffer += entries.size() * sizeof(IndexedStateEntry);
+	if (!data.empty())
+		std::memcpy(buffer, &data[0], data.size());
+	return true;
+}
+
+void NewStateIndexedWriter::Save(const void *ptr, size_t size, const char *name)
+{
+	const char *src = static_cast<const char *>(ptr);
+	if (size >= IndexedStateFieldMin)
+	{
+		AddEntry(name, IndexedStateField, data.size(), size);
+		entries.back().hash = NewStateHasher::Hash(src, size);
+	}
+	data.insert(data.end(), src, src + size);
+}
+
+void NewStateIndexedWriter::Load(void *ptr, size_t size, const char *name)
+{
+}
+
+void NewStateIndexedWriter::EnterSection(const char *name)
+{
+	AddEntry(name, IndexedStateSection, data.size(), 0);
+	open.push_back(entries.size() - 1);
+}
+
+void NewStateIndexedWriter::ExitSection(const char *name)
+{
+	if (!open.empty())
+	{
+		IndexedStateEntry &e = entries[open.back()];
+		e.size = data.size() - e.offset;
+		e.hash = NewStateHasher::Hash(data.empty() ? NULL : &data[0] + e.offset, e.size);
+		open.pop_back();
+	}
+}
+
+NewStateIndexedReader::NewStateIndexedReader(const char *buffer, long buflength)
+	:data(NULL), length(0), pos(0), bad(true)
+{
+	// the data hash is there for consumers of the file, and not checked here
+	IndexedStateHeader h;
+	if (buflength < (long)sizeof(h))
+		return;
+	std::memcpy(&h, buffer, sizeof(h));
+	if (std::memcmp(h.magic, "EWSI", 4) || h.version != IndexedStateVersion || h.entrysize != sizeof(IndexedStateEntry))
+		return;
+	uint64_t start = sizeof(h) + (uint64_t)h.entrycount * h.entrysize;
+	if (start > (uint64_t)buflength || h.datasize != buflength - start)
+		return;
+	data = buffer + start;
+	length = h.datasize;
+	bad = false;
+}
+
+void NewStateIndexedReader::Save(const void *ptr, size_t size, const char *name)
+{
+}
+
+void NewStateIndexedReader::Load(void *ptr, size_t size, const char *name)
+{
+	if (bad)
+		return;
+	if (length - pos < (long)size)
+	{
+		bad = true;
+		return;
+	}
+	bool skip = false;
+	if (size >= IndexedStateFieldMin)
+	{
+		for (size_t i = 0; i < skips.size() && !skip; i++)
+			skip = !std::strncmp(skips[i], name, IndexedStateNameSize - 1);
+	}
+	if (!skip)
+		std::memcpy(ptr, data + pos, size);
+	pos += size;
+}
+
 NewStateExternalFunctions::NewStateExternalFunctions(const FPtrs *ff)
 	:Save_(ff->Save_),
 	Load_(ff->Load_),
@@ -283,13 +283,13 @@ namespace MDFN_IEN_WSWAN
 
 		Update();
 
-		if(SoundBuf)
+		for(int y = 0; y < 2; y++)
 		{
-			for(int y = 0; y < 2; y++)
-			{
-				sbuf[y]->end_frame(sys->cpu.timestamp);
+			sbuf[y]->end_frame(sys->cpu.timestamp);
+			if(SoundBuf)
 				FrameCount = sbuf[y]->read_samples(SoundBuf + y, MaxSoundFrames, true);
-			}
+			else
+				sbuf[y]->remove_samples(sbuf[y]->samples_avail());
 		}
 
 		last_ts = 0;
@@ -297,6 +297,15 @@ namespace MDFN_IEN_WSWAN
 		return(FrameCount);
 	}
 
+	// Drop whatever the last Flush() had no room for
+	int32 Sound::Discard()
+	{
+		int32 FrameCount = sbuf[0]->samples_avail();
+		for(int y = 0; y < 2; y++)
+			sbuf[y]->remove_samples(sbuf[y]->samples_avail());
+		return(FrameCount);
+	}
+
 	// Call before wsRAM is updated
 	void Sound::CheckRAMWrite(uint32 A)
 	{
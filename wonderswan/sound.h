@@ -14,6 +14,7 @@ public:
 	~Sound();
 
 	int32 Flush(int16 *SoundBuf, const int32 MaxSoundFrames);
+	int32 Discard();
 
 	void SetMultiplier(double multiplier);
 	bool SetRate(uint32 rate);
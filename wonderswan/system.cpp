@@ -19,6 +19,7 @@
 */
 
 #include "system.h"
+#include "romimage.h"
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
@@ -74,6 +75,7 @@ namespace MDFN_IEN_WSWAN
 		memory.WSButtonStatus = rotate ? buttons >> 16 : buttons;
 		memory.WSButtonStatus &= 0x7ff; // mask out "rotate" bit and other unused bits
 		memory.Lagged = true;
+		gfx.BeginFrame(surface, novideo);
 		while (!gfx.ExecuteLine(surface, novideo))
 		{
 		}
@@ -86,6 +88,52 @@ namespace MDFN_IEN_WSWAN
 		cpu.timestamp = 0;
 		return memory.Lagged;
 	}
+
+	// dest receives one record per frame: uint32 flags (1 = lagged, 2 = sound didn't fit), uint32 HashRam()
+	// and then the bytes of each ram range, padded to a multiple of 4 bytes.  only the last frame is rendered.
+	// returns the number of frames run, or -1 if the ram ranges or dest are bad
+	int System::AdvanceBatch(const uint32 *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+		uint8 *dest, int destsize, uint32 *surface, int16 *soundbuff, int &soundbuffsize)
+	{
+		auto records = framebatch::writer(ram, nram, [this](int area, const uint8 *&data, int &size)
+		{
+			const char *name;
+			uint8 *p = nullptr;
+			bool ret = GetMemoryArea(area, name, size, p);
+			data = p;
+			return ret;
+		});
+		if (!records.fits(nframes, destsize))
+			return -1;
+
+		if (flags & BATCH_NOAUDIO)
+			soundbuff = nullptr;
+		const int soundmax = soundbuff ? soundbuffsize : 0;
+		int soundpos = 0;
+
+		for (int n = 0; n < nframes; n++)
+		{
+			bool novideo = (flags & BATCH_NOVIDEO) || n < nframes - 1;
+			int count = soundmax - soundpos;
+			uint32 frameflags = Advance(buttons[n], novideo, surface, soundbuff ? soundbuff + soundpos * 2 : nullptr, count);
+			if (soundbuff)
+			{
+				soundpos += count;
+				if (sound.Discard())
+					frameflags |= framebatch::audio_overflow;
+			}
+
+			dest = records.write(dest, frameflags, flags & BATCH_NOHASH ? 0 : HashRam());
+		}
+
+		soundbuffsize = soundpos;
+		return nframes;
+	}
+
+	uint32 System::HashRam() const
+	{
+		return framebatch::hash(memory.wsRAM, 65536);
+	}
 
 	// Source: http://graphics.stanford.edu/~seander/bithacks.html#RoundUpPowerOf2
 	// Rounds up to the nearest power of 2.
@@ -104,6 +152,11 @@ namespace MDFN_IEN_WSWAN
 		return(v);
 	}
 
+	static bool IsDetectiveConan(const uint8 *header)
+	{
+		return (header[8] | (header[9] << 8)) == 0x8de1 && (header[0]==0x01)&&(header[2]==0x27);
+	}
+
 	bool System::Load(const uint8 *data, int length, const SyncSettings &settings)
 	{
 		uint32 real_rom_size;
@@ -123,14 +176,27 @@ namespace MDFN_IEN_WSWAN
 		real_rom_size = (length + 0xFFFF) & ~0xFFFF;
 		memory.rom_size = round_up_pow2(real_rom_size);
 
-		memory.wsCartROM = (uint8 *)std::calloc(1, memory.rom_size);
-
-
-		if(real_rom_size < memory.rom_size)
-			memset(memory.wsCartROM, 0xFF, memory.rom_size - real_rom_size);
+		// read only, and shared with every other instance that loads the same rom
+		memory.wsCartROMOwner = romimage::Registry::acquire(data, length, 0, memory.rom_size, [&](uint8 *rom)
+		{
+			if(real_rom_size < memory.rom_size)
+				memset(rom, 0xFF, memory.rom_size - real_rom_size);
 
-		memcpy(memory.wsCartROM + (memory.rom_size - real_rom_size), data, length);
+			memcpy(rom + (memory.rom_size - real_rom_size), data, length);
 
+			if(IsDetectiveConan(rom + memory.rom_size - 10))
+			{
+				/* WS cpu is using cache/pipeline or there's protected ROM bank where pointing CS */
+				rom[0xfffe8]=0xea;
+				rom[0xfffe9]=0x00;
+				rom[0xfffea]=0x00;
+				rom[0xfffeb]=0x00;
+				rom[0xfffec]=0x20;
+			}
+		});
+		memory.wsCartROM = memory.wsCartROMOwner.get();
+		if(!memory.wsCartROM)
+			return false;
 
 		uint8 header[10];
 		memcpy(header, memory.wsCartROM + memory.rom_size - 10, 10);
@@ -180,16 +246,8 @@ namespace MDFN_IEN_WSWAN
 			Debug::printf("Real Checksum:      0x%04x\n", real_crc);
 		}
 
-		if((header[8] | (header[9] << 8)) == 0x8de1 && (header[0]==0x01)&&(header[2]==0x27)) /* Detective Conan */
-		{
+		if(IsDetectiveConan(header)) // patched when the rom image was built
 			Debug::printf("Activating Detective Conan Hack\n");
-			/* WS cpu is using cache/pipeline or there's protected ROM bank where pointing CS */
-			memory.wsCartROM[0xfffe8]=0xea;
-			memory.wsCartROM[0xfffe9]=0x00;
-			memory.wsCartROM[0xfffea]=0x00;
-			memory.wsCartROM[0xfffeb]=0x00;
-			memory.wsCartROM[0xfffec]=0x20;
-		}
 
 		rotate = header[6] & 1;
 
@@ -197,11 +255,40 @@ namespace MDFN_IEN_WSWAN
 		gfx.Init(settings.color);
 		rtc.Init(settings.initialtime, settings.userealtime);
 
-		gfx.MakeTiles();
-
 		Reset();
 
 		return true;
+	}
+
+	// a new instance that shares this one's rom and starts from its current state.
+	// frontend hooks are not carried over
+	System *System::Clone()
+	{
+		System *s = new System();
+		s->memory.wsCartROMOwner = memory.wsCartROMOwner;
+		s->memory.wsCartROM = memory.wsCartROM;
+		s->memory.rom_size = memory.rom_size;
+		s->memory.sram_size = memory.sram_size;
+		if (memory.sram_size)
+			s->memory.wsSRAM = (uint8 *)std::malloc(memory.sram_size);
+		s->eeprom.eeprom_size = eeprom.eeprom_size;
+		s->gfx.CopyOutputSettings(gfx);
+		s->CopyFrom(*this);
+		return s;
+	}
+
+	// copy the complete emulation state of another instance of the same game
+	// directly into this one, without going through a savestate buffer
+	bool System::CopyFrom(System &src)
+	{
+		if (memory.rom_size != src.memory.rom_size || memory.sram_size != src.memory.sram_size
+			|| eeprom.eeprom_size != src.eeprom.eeprom_size)
+			return false;
+
+		copier.Rewind();
+		src.SyncState<false>(&copier);
+		SyncState<true>(&copier);
+		return !copier.Mismatch();
 	}
 
 	// this is more than just being defensive; these classes do
@@ -222,6 +309,7 @@ namespace MDFN_IEN_WSWAN
 		sound.sys = this;
 		cpu.sys = this;
 		interrupt.sys = this;
+		saveramgeneration = 0;
 	}
 
 	System::~System()
@@ -246,6 +334,8 @@ namespace MDFN_IEN_WSWAN
 
 		#undef LOAD
 
+		saveramgeneration++;
+
 		return true;
 	}
 
@@ -265,6 +355,18 @@ namespace MDFN_IEN_WSWAN
 		return true;
 	}
 
+	// the pieces of SaveRamSave()'s output, in order, in place
+	bool System::SaveRamArea(int index, uint8 *&data, int &size)
+	{
+		switch (index)
+		{
+			case 0: data = eeprom.iEEPROM; size = eeprom.ieeprom_size; return true;
+			case 1: data = eeprom.wsEEPROM; size = eeprom.eeprom_size; return true;
+			case 2: data = memory.wsSRAM; size = memory.sram_size; return true;
+			default: return false;
+		}
+	}
+
 	void System::PutSettings(const Settings &s)
 	{
 		gfx.SetLayerEnableMask(s.LayerMask);
@@ -304,6 +406,9 @@ namespace MDFN_IEN_WSWAN
 	
 		NSS(rotate);
 		NSS(oldbuttons);
+
+		if (isReader)
+			saveramgeneration++;
 	}
 
 	EXPORT System *bizswan_new()
@@ -328,6 +433,14 @@ namespace MDFN_IEN_WSWAN
 		return ret;
 	}
 
+	EXPORT int bizswan_advance_batch(System *s, const uint32 *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+		uint8 *dest, int destsize, uint32 *surface, int16 *soundbuff, int *soundbuffsize, int *IsRotated)
+	{
+		int ret = s->AdvanceBatch(buttons, nframes, flags, ram, nram, dest, destsize, surface, soundbuff, *soundbuffsize);
+		*IsRotated = s->rotate;
+		return ret;
+	}
+
 	EXPORT int bizswan_load(System *s, const uint8 *data, int length, const SyncSettings *settings, int *IsRotated)
 	{
 		bool ret = s->Load(data, length, *settings);
@@ -335,6 +448,16 @@ namespace MDFN_IEN_WSWAN
 		return ret;
 	}
 
+	EXPORT System *bizswan_clone(System *s)
+	{
+		return s->Clone();
+	}
+
+	EXPORT int bizswan_copyinto(System *dst, System *src)
+	{
+		return dst->CopyFrom(*src);
+	}
+
 	EXPORT int bizswan_saveramsize(System *s)
 	{
 		return s->SaveRamSize();
@@ -350,6 +473,14 @@ namespace MDFN_IEN_WSWAN
 		return s->SaveRamSave(dest, maxsize);
 	}
 
+	// data and size of one piece of the saveram, as bizswan_saveramsave() lays them out;
+	// generation changes whenever any of them may have been written
+	EXPORT int bizswan_saveramarea(System *s, int index, uint8 **data, int *size, uint32 *generation)
+	{
+		*generation = s->saveramgeneration;
+		return s->SaveRamArea(index, *data, *size);
+	}
+
 	EXPORT void bizswan_putsettings(System *s, const Settings *settings)
 	{
 		s->PutSettings(*settings);
@@ -365,6 +496,12 @@ namespace MDFN_IEN_WSWAN
 		return s->GetMemoryArea(index, *name, *size, *data);
 	}
 
+	// write a byte of RAM the way the cpu does, so the tile cache and the video generation see it
+	EXPORT void bizswan_pokeram(System *s, uint32 addr, uint8 val)
+	{
+		s->memory.Write20(addr & 0xffff, val);
+	}
+
 	EXPORT int bizswan_binstatesize(System *s)
 	{
 		NewStateDummy dummy;
@@ -386,6 +523,40 @@ namespace MDFN_IEN_WSWAN
 		return !loader.Overflow() && loader.GetLength() == length;
 	}
 
+	// hash of the complete state, equal to XXH64 of what bizswan_binstatesave writes.
+	// cb, if not null, receives a hash for each section as well
+	EXPORT uint64_t bizswan_statehash(System *s, NewStateHasher::SectionCallback cb)
+	{
+		NewStateHasher hasher(cb);
+		s->SyncState<false>(&hasher);
+		return hasher.GetHash();
+	}
+
+	// an indexed state: the same data as bizswan_binstatesave, after a table of its sections and
+	// larger fields.  a load leaves the fields named in skip as they are
+	EXPORT int bizswan_indexedstatesize(System *s)
+	{
+		NewStateIndexedWriter writer;
+		s->SyncState<false>(&writer);
+		return writer.GetLength();
+	}
+
+	EXPORT int bizswan_indexedstatesave(System *s, char *data, int length)
+	{
+		NewStateIndexedWriter writer;
+		s->SyncState<false>(&writer);
+		return writer.Write(data, length);
+	}
+
+	EXPORT int bizswan_indexedstateload(System *s, const char *data, int length, const char *const *skip, int skipcount)
+	{
+		NewStateIndexedReader loader(data, length);
+		for (int i = 0; i < skipcount; i++)
+			loader.Skip(skip[i]);
+		s->SyncState<true>(&loader);
+		return loader.Done();
+	}
+
 	EXPORT void bizswan_txtstatesave(System *s, FPtrs *ff)
 	{
 		NewStateExternalFunctions saver(ff);
@@ -21,9 +21,13 @@ struct Settings;
 #include "interrupt.h"
 
 #include <cstddef>
+#include "framebatch.h"
 
 namespace MDFN_IEN_WSWAN
 {
+// one range of memory sampled after every frame of AdvanceBatch(); area is as in GetMemoryArea()
+typedef framebatch::Range BatchRam;
+
 class System
 {
 public:
@@ -34,12 +38,18 @@ public:
 
 	void Reset();
 	bool Advance(uint32 buttons, bool novideo, uint32 *surface, int16 *soundbuff, int &soundbuffsize);
+	int AdvanceBatch(const uint32 *buttons, int nframes, int flags, const BatchRam *ram, int nram,
+		uint8 *dest, int destsize, uint32 *surface, int16 *soundbuff, int &soundbuffsize);
+	uint32 HashRam() const;
 	bool Load(const uint8 *data, int length, const SyncSettings &s);
+	System *Clone();
+	bool CopyFrom(System &src);
 	void PutSettings(const Settings &s);
 
 	int SaveRamSize() const;
 	bool SaveRamLoad(const uint8 *data, int size);
 	bool SaveRamSave(uint8 *dest, int maxsize) const;
+	bool SaveRamArea(int index, uint8 *&data, int &size);
 
 	uint32 GetNECReg(int which) const;
 
@@ -56,6 +66,9 @@ public:
 	
 	bool rotate; // rotate screen and controls left 90
 	uint32 oldbuttons;
+	uint32 saveramgeneration; // bumped on every write to eeprom or sram; not part of the savestate
+
+	NewStateCopier copier; // reused by CopyFrom()
 
 	template<bool isReader>void SyncState(NewState *ns);
 };
@@ -74,6 +87,13 @@ struct SyncSettings
 	char name[17]; // up to 16 chars long, most chars don't work (conversion from ascii is internal)
 };
 
+enum
+{
+	BATCH_NOVIDEO = 1, // don't render the last frame of the batch either
+	BATCH_NOAUDIO = 2,
+	BATCH_NOHASH = 4
+};
+
 struct Settings
 {
 	uint32 LayerMask; // 1 = enable bg, 2 = enable fg, 4 = enable sprites
@@ -25,27 +25,64 @@
 namespace MDFN_IEN_WSWAN
 {
 
+	namespace
+	{
+		// one plane byte of a tile row expanded to one bit per pixel byte, in display order ([0])
+		// or horizontally flipped ([1]).  planar rows are built by or-ing the shifted planes together;
+		// no bit ever crosses a byte, so this works the same on either endianness
+		struct PlanarTable
+		{
+			uint64 expand[2][256];
+			PlanarTable()
+			{
+				for(int v = 0; v < 256; v++)
+				{
+					uint8 n[8], f[8];
+					for(int k = 0; k < 8; k++)
+					{
+						n[k] = (v >> (7 - k)) & 1;
+						f[k] = (v >> k) & 1;
+					}
+					std::memcpy(&expand[0][v], n, 8);
+					std::memcpy(&expand[1][v], f, 8);
+				}
+			}
+		};
+
+		const PlanarTable Planar;
+	}
+
 	void GFX::InvalidByAddr(uint32 ws_offset)
 	{
+		if(CacheSuspended)
+			return;
+
+		if((ws_offset>>11)==(FGBGLoc&0xF)||(ws_offset>>11)==(FGBGLoc>>4)) /*tile maps*/
+			VideoGen++;
+
 		if(wsVMode  && (ws_offset>=0x4000)&&(ws_offset<0x8000))
 		{
 			wsTCacheUpdate[(ws_offset-0x4000)>>5]=FALSE; /*invalidate tile*/
+			VideoGen++;
 			return;
 		}
 		else if((ws_offset>=0x2000)&&(ws_offset<0x4000))
 		{
 			wsTCacheUpdate[(ws_offset-0x2000)>>4]=FALSE; /*invalidate tile*/
+			VideoGen++;
 			return;
 		}
 
 		if(wsVMode  && (ws_offset>=0x8000)&&(ws_offset<0xc000))
 		{
 			wsTCacheUpdate2[(ws_offset-0x8000)>>5]=FALSE; /*invalidate tile*/
+			VideoGen++;
 			return;
 		}
 		else if((ws_offset>=0x4000)&&(ws_offset<0x6000))
 		{
 			wsTCacheUpdate2[(ws_offset-0x4000)>>4]=FALSE; /*invalidate tile*/
+			VideoGen++;
 			return;
 		}
 	}
@@ -57,234 +94,91 @@ namespace MDFN_IEN_WSWAN
 			wsVMode=number;
 			std::memset(wsTCacheUpdate,0,512);
 			std::memset(wsTCacheUpdate2,0,512);
+			VideoGen++;
 		}
 	}
 
-	void GFX::MakeTiles()
-	{
-		int	x,y,b0,b1,b2,b3,b4,b5,b6,b7;
-		for(x=0;x<256;x++)
-			for(y=0;y<256;y++)
-			{
-				b0=(x&128)>>7;b1=(x&64)>>6;b2=(x&32)>>5;b3=(x&16)>>4;b4=(x&8)>>3;b5=(x&4)>>2;b6=(x&2)>>1;b7=(x&1);
-				b0|=(y&128)>>6;b1|=(y&64)>>5;b2|=(y&32)>>4;b3|=(y&16)>>3;b4|=(y&8)>>2;b5|=(y&4)>>1;b6|=(y&2);b7|=(y&1)<<1;
-				tiles[x][y][0][0]=b0;
-				tiles[x][y][0][1]=b1;
-				tiles[x][y][0][2]=b2;
-				tiles[x][y][0][3]=b3;
-				tiles[x][y][0][4]=b4;
-				tiles[x][y][0][5]=b5;
-				tiles[x][y][0][6]=b6;
-				tiles[x][y][0][7]=b7;
-				tiles[x][y][1][0]=b7;
-				tiles[x][y][1][1]=b6;
-				tiles[x][y][1][2]=b5;
-				tiles[x][y][1][3]=b4;
-				tiles[x][y][1][4]=b3;
-				tiles[x][y][1][5]=b2;
-				tiles[x][y][1][6]=b1;
-				tiles[x][y][1][7]=b0;
-			}
-	}
-
 	void GFX::GetTile(uint32 number,uint32 line,int flipv,int fliph,int bank)
 	{
-		uint32		t_adr,t_index,i;
-		uint8		byte0,byte1,byte2,byte3;
-		const uint8 *ram = sys->memory.wsRAM;
+		const bool second = bank && (wsVMode & 0x07);
+		uint8 *update = second ? wsTCacheUpdate2 : wsTCacheUpdate;
+		uint8 *cache = second ? wsTCache2 : wsTCache;
+		uint8 *cacheflipped = second ? wsTCacheFlipped2 : wsTCacheFlipped;
 
-		if((!bank)||(!(wsVMode &0x07)))
+		if(!update[number])
 		{
-			if(!wsTCacheUpdate[number])
+			uint32		t_adr,t_index,i;
+			uint8		byte0,byte1,byte2,byte3;
+			uint64		row,rowflipped;
+			const uint8 *ram = sys->memory.wsRAM;
+
+			update[number]=true;
+			t_index=number<<6;
+			switch(wsVMode)
 			{
-				wsTCacheUpdate[number]=true;
-				switch(wsVMode)
+			case 7:
+				t_adr=(second ? 0x8000 : 0x4000)+(number<<5);
+				for(i=0;i<8;i++)
 				{
-				case 7:
-					t_adr=0x4000+(number<<5);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						byte2=ram[t_adr++];
-						byte3=ram[t_adr++];
-						wsTCache[t_index]=byte0>>4;
-						wsTCacheFlipped[t_index++]=byte3&15;
-						wsTCache[t_index]=byte0&15;
-						wsTCacheFlipped[t_index++]=byte3>>4;
-						wsTCache[t_index]=byte1>>4;
-						wsTCacheFlipped[t_index++]=byte2&15;
-						wsTCache[t_index]=byte1&15;
-						wsTCacheFlipped[t_index++]=byte2>>4;
-						wsTCache[t_index]=byte2>>4;
-						wsTCacheFlipped[t_index++]=byte1&15;
-						wsTCache[t_index]=byte2&15;
-						wsTCacheFlipped[t_index++]=byte1>>4;
-						wsTCache[t_index]=byte3>>4;
-						wsTCacheFlipped[t_index++]=byte0&15;
-						wsTCache[t_index]=byte3&15;
-						wsTCacheFlipped[t_index++]=byte0>>4;
-					}
-					break;
-
-				case 6:
-					t_adr=0x4000+(number<<5);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						byte2=ram[t_adr++];
-						byte3=ram[t_adr++];
-						wsTCache[t_index]=((byte0>>7)&1)|(((byte1>>7)&1)<<1)|(((byte2>>7)&1)<<2)|(((byte3>>7)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0)&1)|(((byte1)&1)<<1)|(((byte2)&1)<<2)|(((byte3)&1)<<3);
-						wsTCache[t_index]=((byte0>>6)&1)|(((byte1>>6)&1)<<1)|(((byte2>>6)&1)<<2)|(((byte3>>6)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>1)&1)|(((byte1>>1)&1)<<1)|(((byte2>>1)&1)<<2)|(((byte3>>1)&1)<<3);
-						wsTCache[t_index]=((byte0>>5)&1)|(((byte1>>5)&1)<<1)|(((byte2>>5)&1)<<2)|(((byte3>>5)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>2)&1)|(((byte1>>2)&1)<<1)|(((byte2>>2)&1)<<2)|(((byte3>>2)&1)<<3);
-						wsTCache[t_index]=((byte0>>4)&1)|(((byte1>>4)&1)<<1)|(((byte2>>4)&1)<<2)|(((byte3>>4)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>3)&1)|(((byte1>>3)&1)<<1)|(((byte2>>3)&1)<<2)|(((byte3>>3)&1)<<3);
-						wsTCache[t_index]=((byte0>>3)&1)|(((byte1>>3)&1)<<1)|(((byte2>>3)&1)<<2)|(((byte3>>3)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>4)&1)|(((byte1>>4)&1)<<1)|(((byte2>>4)&1)<<2)|(((byte3>>4)&1)<<3);
-						wsTCache[t_index]=((byte0>>2)&1)|(((byte1>>2)&1)<<1)|(((byte2>>2)&1)<<2)|(((byte3>>2)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>5)&1)|(((byte1>>5)&1)<<1)|(((byte2>>5)&1)<<2)|(((byte3>>5)&1)<<3);
-						wsTCache[t_index]=((byte0>>1)&1)|(((byte1>>1)&1)<<1)|(((byte2>>1)&1)<<2)|(((byte3>>1)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>6)&1)|(((byte1>>6)&1)<<1)|(((byte2>>6)&1)<<2)|(((byte3>>6)&1)<<3);
-						wsTCache[t_index]=((byte0)&1)|(((byte1)&1)<<1)|(((byte2)&1)<<2)|(((byte3)&1)<<3);
-						wsTCacheFlipped[t_index++]=((byte0>>7)&1)|(((byte1>>7)&1)<<1)|(((byte2>>7)&1)<<2)|(((byte3>>7)&1)<<3);
-					}
-					break;
-
-				default:
-					t_adr=0x2000+(number<<4);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						wsTCache[t_index]=tiles[byte0][byte1][0][0];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][0];
-						wsTCache[t_index]=tiles[byte0][byte1][0][1];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][1];
-						wsTCache[t_index]=tiles[byte0][byte1][0][2];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][2];
-						wsTCache[t_index]=tiles[byte0][byte1][0][3];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][3];
-						wsTCache[t_index]=tiles[byte0][byte1][0][4];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][4];
-						wsTCache[t_index]=tiles[byte0][byte1][0][5];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][5];
-						wsTCache[t_index]=tiles[byte0][byte1][0][6];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][6];
-						wsTCache[t_index]=tiles[byte0][byte1][0][7];
-						wsTCacheFlipped[t_index++]=tiles[byte0][byte1][1][7];
-					}
+					byte0=ram[t_adr++];
+					byte1=ram[t_adr++];
+					byte2=ram[t_adr++];
+					byte3=ram[t_adr++];
+					cache[t_index]=byte0>>4;
+					cacheflipped[t_index++]=byte3&15;
+					cache[t_index]=byte0&15;
+					cacheflipped[t_index++]=byte3>>4;
+					cache[t_index]=byte1>>4;
+					cacheflipped[t_index++]=byte2&15;
+					cache[t_index]=byte1&15;
+					cacheflipped[t_index++]=byte2>>4;
+					cache[t_index]=byte2>>4;
+					cacheflipped[t_index++]=byte1&15;
+					cache[t_index]=byte2&15;
+					cacheflipped[t_index++]=byte1>>4;
+					cache[t_index]=byte3>>4;
+					cacheflipped[t_index++]=byte0&15;
+					cache[t_index]=byte3&15;
+					cacheflipped[t_index++]=byte0>>4;
 				}
-			}
-			if(flipv)
-				line=7-line;
-			if(fliph)
-				memcpy(&wsTileRow[0],&wsTCacheFlipped[(number<<6)|(line<<3)],8);
-			else
-				memcpy(&wsTileRow[0],&wsTCache[(number<<6)|(line<<3)],8);
-		}
-		else
-		{
+				break;
 
+			case 6:
+				t_adr=(second ? 0x8000 : 0x4000)+(number<<5);
+				for(i=0;i<8;i++)
+				{
+					byte0=ram[t_adr++];
+					byte1=ram[t_adr++];
+					byte2=ram[t_adr++];
+					byte3=ram[t_adr++];
+					row=Planar.expand[0][byte0]|Planar.expand[0][byte1]<<1|Planar.expand[0][byte2]<<2|Planar.expand[0][byte3]<<3;
+					rowflipped=Planar.expand[1][byte0]|Planar.expand[1][byte1]<<1|Planar.expand[1][byte2]<<2|Planar.expand[1][byte3]<<3;
+					std::memcpy(&cache[t_index],&row,8);
+					std::memcpy(&cacheflipped[t_index],&rowflipped,8);
+					t_index+=8;
+				}
+				break;
 
-			if(!wsTCacheUpdate2[number])
-			{
-				wsTCacheUpdate2[number]=TRUE;
-				switch(wsVMode)
+			default:
+				t_adr=(second ? 0x4000 : 0x2000)+(number<<4);
+				for(i=0;i<8;i++)
 				{
-				case 7:
-					t_adr=0x8000+(number<<5);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						byte2=ram[t_adr++];
-						byte3=ram[t_adr++];
-						wsTCache2[t_index]=byte0>>4;
-						wsTCacheFlipped2[t_index++]=byte3&15;
-						wsTCache2[t_index]=byte0&15;
-						wsTCacheFlipped2[t_index++]=byte3>>4;
-						wsTCache2[t_index]=byte1>>4;
-						wsTCacheFlipped2[t_index++]=byte2&15;
-						wsTCache2[t_index]=byte1&15;
-						wsTCacheFlipped2[t_index++]=byte2>>4;
-						wsTCache2[t_index]=byte2>>4;
-						wsTCacheFlipped2[t_index++]=byte1&15;
-						wsTCache2[t_index]=byte2&15;
-						wsTCacheFlipped2[t_index++]=byte1>>4;
-						wsTCache2[t_index]=byte3>>4;
-						wsTCacheFlipped2[t_index++]=byte0&15;
-						wsTCache2[t_index]=byte3&15;
-						wsTCacheFlipped2[t_index++]=byte0>>4;
-					}
-					break;
-				case 6:
-					t_adr=0x8000+(number<<5);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						byte2=ram[t_adr++];
-						byte3=ram[t_adr++];
-						wsTCache2[t_index]=((byte0>>7)&1)|(((byte1>>7)&1)<<1)|(((byte2>>7)&1)<<2)|(((byte3>>7)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0)&1)|(((byte1)&1)<<1)|(((byte2)&1)<<2)|(((byte3)&1)<<3);
-						wsTCache2[t_index]=((byte0>>6)&1)|(((byte1>>6)&1)<<1)|(((byte2>>6)&1)<<2)|(((byte3>>6)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>1)&1)|(((byte1>>1)&1)<<1)|(((byte2>>1)&1)<<2)|(((byte3>>1)&1)<<3);
-						wsTCache2[t_index]=((byte0>>5)&1)|(((byte1>>5)&1)<<1)|(((byte2>>5)&1)<<2)|(((byte3>>5)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>2)&1)|(((byte1>>2)&1)<<1)|(((byte2>>2)&1)<<2)|(((byte3>>2)&1)<<3);
-						wsTCache2[t_index]=((byte0>>4)&1)|(((byte1>>4)&1)<<1)|(((byte2>>4)&1)<<2)|(((byte3>>4)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>3)&1)|(((byte1>>3)&1)<<1)|(((byte2>>3)&1)<<2)|(((byte3>>3)&1)<<3);
-						wsTCache2[t_index]=((byte0>>3)&1)|(((byte1>>3)&1)<<1)|(((byte2>>3)&1)<<2)|(((byte3>>3)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>4)&1)|(((byte1>>4)&1)<<1)|(((byte2>>4)&1)<<2)|(((byte3>>4)&1)<<3);
-						wsTCache2[t_index]=((byte0>>2)&1)|(((byte1>>2)&1)<<1)|(((byte2>>2)&1)<<2)|(((byte3>>2)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>5)&1)|(((byte1>>5)&1)<<1)|(((byte2>>5)&1)<<2)|(((byte3>>5)&1)<<3);
-						wsTCache2[t_index]=((byte0>>1)&1)|(((byte1>>1)&1)<<1)|(((byte2>>1)&1)<<2)|(((byte3>>1)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>6)&1)|(((byte1>>6)&1)<<1)|(((byte2>>6)&1)<<2)|(((byte3>>6)&1)<<3);
-						wsTCache2[t_index]=((byte0)&1)|(((byte1)&1)<<1)|(((byte2)&1)<<2)|(((byte3)&1)<<3);
-						wsTCacheFlipped2[t_index++]=((byte0>>7)&1)|(((byte1>>7)&1)<<1)|(((byte2>>7)&1)<<2)|(((byte3>>7)&1)<<3);
-					}
-					break;
-				default:
-					t_adr=0x4000+(number<<4);
-					t_index=number<<6;
-					for(i=0;i<8;i++)
-					{
-						byte0=ram[t_adr++];
-						byte1=ram[t_adr++];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][0];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][0];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][1];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][1];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][2];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][2];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][3];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][3];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][4];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][4];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][5];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][5];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][6];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][6];
-						wsTCache2[t_index]=tiles[byte0][byte1][0][7];
-						wsTCacheFlipped2[t_index++]=tiles[byte0][byte1][1][7];
-					}
-				}	
+					byte0=ram[t_adr++];
+					byte1=ram[t_adr++];
+					row=Planar.expand[0][byte0]|Planar.expand[0][byte1]<<1;
+					rowflipped=Planar.expand[1][byte0]|Planar.expand[1][byte1]<<1;
+					std::memcpy(&cache[t_index],&row,8);
+					std::memcpy(&cacheflipped[t_index],&rowflipped,8);
+					t_index+=8;
+				}
 			}
-			if(flipv)
-				line=7-line;
-			if(fliph)
-				memcpy(&wsTileRow[0],&wsTCacheFlipped2[(number<<6)|(line<<3)],8);
-			else
-				memcpy(&wsTileRow[0],&wsTCache2[(number<<6)|(line<<3)],8);
 		}
+		if(flipv)
+			line=7-line;
+		if(fliph)
+			memcpy(&wsTileRow[0],&cacheflipped[(number<<6)|(line<<3)],8);
+		else
+			memcpy(&wsTileRow[0],&cache[(number<<6)|(line<<3)],8);
 	}
 
 }
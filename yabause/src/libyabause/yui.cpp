@@ -399,9 +399,18 @@ extern "C" __declspec(dllexport) int libyabause_savesaveram(const char *fn)
 
 extern "C" __declspec(dllexport) int libyabause_loadsaveram(const char *fn)
 {
+	BupRamGeneration++;
 	return !T123Load(BupRam, 0x10000, 1, fn);
 }
 
+// backup ram in place; it is byte ordered, so this is exactly what libyabause_savesaveram writes
+extern "C" __declspec(dllexport) void *libyabause_saveramdirect(int *size, unsigned *generation)
+{
+	*size = 0x10000;
+	*generation = BupRamGeneration;
+	return BupRam;
+}
+
 extern "C" __declspec(dllexport) int libyabause_saveramodified()
 {
 	return BupRamWritten;
@@ -410,6 +419,7 @@ extern "C" __declspec(dllexport) int libyabause_saveramodified()
 extern "C" __declspec(dllexport) void libyabause_clearsaveram()
 {
 	FormatBackupRam(BupRam, 0x10000);
+	BupRamGeneration++;
 }
 
 typedef struct
@@ -74,6 +74,11 @@ u8 *BupRam;
  * e.g. for implementing autosave of backup RAM. */
 u8 BupRamWritten;
 
+/* Unlike BupRamWritten, this is never cleared: it changes on every write to
+ * backup RAM and whenever the whole of it is replaced, so several readers can
+ * each keep the last value they saw. */
+u32 BupRamGeneration;
+
 //////////////////////////////////////////////////////////////////////////////
 
 u8 * T1MemoryInit(u32 size)
@@ -346,6 +351,7 @@ static void FASTCALL BupRamMemoryWriteByte(u32 addr, u8 val)
 {
    T1WriteByte(BupRam, (addr & 0xFFFF) | 0x1, val);
    BupRamWritten = 1;
+   BupRamGeneration++;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1290,6 +1296,7 @@ int YabLoadState(const char *filename)
    }
    // Other data
    yread(&check, (void *)BupRam, 0x10000, 1, fp);
+   BupRamGeneration++;
    yread(&check, (void *)HighWram, 0x100000, 1, fp);
    yread(&check, (void *)LowWram, 0x100000, 1, fp);
 